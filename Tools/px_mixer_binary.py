@@ -0,0 +1,205 @@
+#!/usr/bin/env python3
+############################################################################
+#
+#   Copyright (C) 2020 PX4 Development Team. All rights reserved.
+#
+
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions
+# are met:
+#
+# 1. Redistributions of source code must retain the above copyright
+#    notice, this list of conditions and the following disclaimer.
+# 2. Redistributions in binary form must reproduce the above copyright
+#    notice, this list of conditions and the following disclaimer in
+#    the documentation and/or other materials provided with the
+#    distribution.
+# 3. Neither the name PX4 nor the names of its contributors may be
+#    used to endorse or promote products derived from this software
+#    without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+# FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+# COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+# INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+# BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+# OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+# AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+# ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+# POSSIBILITY OF SUCH DAMAGE.
+#
+############################################################################
+
+
+"""
+px_mixer_binary.py:
+Precompile text mixer files (.mix) into the binary mixer format.
+
+For every X.mix file in the given folder a X.mixb file is written next to it,
+which the mixer command loads in a single read instead of parsing the text
+file (see src/lib/mixer/MixerBase/MixerBinary.hpp for the format).
+Files with content this script does not understand are skipped with a warning,
+the text file is used at runtime then.
+"""
+
+from __future__ import print_function
+import argparse
+import os
+import struct
+import sys
+
+MAGIC = 0x424d5850  # "PXMB"
+VERSION = 1
+
+# must fit into the buffer of the mixer command
+MAX_SIZE = 2048
+
+RECORD_NULL = b'Z'
+RECORD_SIMPLE = b'M'
+RECORD_MULTIROTOR = b'R'
+RECORD_TEXT = b'H'
+
+DEFAULT_OUTPUT_SCALER = [10000, 10000, 0, -10000, 10000]
+
+
+def crc32(data):
+    """ crc32() of src/lib/crc (no initial or final inversion) """
+    crc = 0
+    for byte in bytearray(data):
+        crc ^= byte
+        for _ in range(8):
+            crc = (crc >> 1) ^ (0xEDB88320 if crc & 1 else 0)
+    return crc
+
+
+def mixer_lines(file_name):
+    """ mixer definition lines, filtered the same way as load_mixer_file() """
+    lines = []
+    with open(file_name, 'r') as f:
+        for line in f:
+            if len(line) < 2 or not line[0].isupper() or line[1] != ':':
+                continue
+            if not line.endswith('\n'):
+                # the text parser drops a mixer that does not end with a new line
+                raise ValueError("missing new line at the end of '{0}'".format(line))
+            lines.append(line.rstrip('\r\n'))
+    return lines
+
+
+def parse_ints(line, tag, count):
+    values = line[2:].split()
+    if line[0] != tag or len(values) < count:
+        raise ValueError("expected '{0}:' with {1} values: '{2}'".format(tag, count, line))
+    return [int(v) for v in values[:count]]
+
+
+def pack_scaler(values):
+    return struct.pack('<5i', *values)
+
+
+def record(record_type, payload):
+    padding = b'\0' * (-len(payload) % 4)
+    return struct.pack('<cBH', record_type, 0, len(payload)) + payload + padding
+
+
+def compile_mixer(lines):
+    records = []
+    i = 0
+
+    while i < len(lines):
+        line = lines[i]
+        tag = line[0]
+
+        if tag == 'Z':
+            records.append(record(RECORD_NULL, b''))
+            i += 1
+
+        elif tag == 'M':
+            control_count = parse_ints(line, 'M', 1)[0]
+            if control_count < 1 or control_count > 255:
+                raise ValueError("invalid number of inputs: '{0}'".format(line))
+            i += 1
+
+            output_scaler = DEFAULT_OUTPUT_SCALER
+            if i < len(lines) and lines[i][0] == 'O':
+                output_scaler = parse_ints(lines[i], 'O', 5)
+                i += 1
+
+            payload = struct.pack('<B3x', control_count) + pack_scaler(output_scaler)
+            for _ in range(control_count):
+                if i >= len(lines):
+                    raise ValueError("missing 'S:' line")
+                control = parse_ints(lines[i], 'S', 7)
+                payload += struct.pack('<BB2x', control[0], control[1]) + pack_scaler(control[2:])
+                i += 1
+
+            records.append(record(RECORD_SIMPLE, payload))
+
+        elif tag == 'R':
+            values = line[2:].split()
+            if len(values) < 1 or len(values[0]) > 15:
+                raise ValueError("invalid geometry: '{0}'".format(line))
+            records.append(record(RECORD_MULTIROTOR, struct.pack('<16s', values[0].encode('ascii'))))
+            i += 1
+
+        elif tag == 'H':
+            # no binary representation, store the text definition up to the next mixer
+            text = line + '\n'
+            i += 1
+            while i < len(lines) and lines[i][0] not in 'ZMRH':
+                text += lines[i] + '\n'
+                i += 1
+            records.append(record(RECORD_TEXT, text.encode('ascii') + b'\0'))
+
+        else:
+            raise ValueError("unexpected line: '{0}'".format(line))
+
+    if len(records) == 0:
+        raise ValueError("no mixers")
+
+    data = b''.join(records)
+    header = struct.pack('<IHHII', MAGIC, VERSION, len(records), 16 + len(data), crc32(data))
+    return header + data
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Precompile text mixer files into binary mixers.")
+    parser.add_argument('--folder', action="store", required=True,
+                        help="Folder with the mixer files (searched recursively).")
+    parser.add_argument('--verbose', action='store_true',
+                        help="Print the generated files.")
+    args = parser.parse_args()
+
+    for (root, dirs, files) in os.walk(args.folder):
+        for file in sorted(files):
+            if not file.endswith(".mix"):
+                continue
+
+            file_path = os.path.join(root, file)
+            binary_path = file_path + 'b'
+
+            if os.path.exists(binary_path):
+                os.remove(binary_path)
+
+            try:
+                data = compile_mixer(mixer_lines(file_path))
+
+                if len(data) > MAX_SIZE:
+                    raise ValueError("{0} bytes exceed the maximum of {1}".format(len(data), MAX_SIZE))
+
+            except ValueError as e:
+                print("{0}: skipping, {1}".format(file_path, e), file=sys.stderr)
+                continue
+
+            with open(binary_path, 'wb') as f:
+                f.write(data)
+
+            if args.verbose:
+                print("{0}: {1} bytes".format(binary_path, len(data)))
+
+
+if __name__ == '__main__':
+    main()
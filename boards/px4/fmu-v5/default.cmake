@@ -67,6 +67,7 @@ px4_add_board(
 		battery_status
 		camera_feedback
 		commander
+		control_allocator
 		dataman
 		ekf2
 		esc_battery
@@ -95,6 +96,7 @@ px4_add_board(
 		vtol_att_control
 	SYSTEMCMDS
 		bl_update
+		boot_profile
 		dmesg
 		dumpfile
 		esc_calib
@@ -92,6 +92,7 @@ px4_add_board(
 		vtol_att_control
 	SYSTEMCMDS
 		bl_update
+		boot_profile
 		dmesg
 		dumpfile
 		esc_calib
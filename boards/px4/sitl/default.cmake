@@ -29,6 +29,7 @@ px4_add_board(
 		attitude_estimator_q
 		camera_feedback
 		commander
+		control_allocator
 		dataman
 		ekf2
 		events
@@ -57,11 +58,13 @@ px4_add_board(
 		vmount
 		vtol_att_control
 	SYSTEMCMDS
+		boot_profile
 		#dumpfile
 		dyn
 		esc_calib
 		failure
 		led_control
+		microbench
 		#mft
 		mixer
 		motor_ramp
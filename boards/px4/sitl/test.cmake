@@ -59,6 +59,7 @@ px4_add_board(
 		dyn
 		esc_calib
 		led_control
+		microbench
 		#mft
 		mixer
 		motor_ramp
@@ -282,6 +282,12 @@ function(px4_add_board)
 		foreach(systemcmd ${SYSTEMCMDS})
 			list(APPEND config_module_list systemcmds/${systemcmd})
 		endforeach()
+
+		# the startup trace hooks are compiled out unless the board can show it
+		list(FIND SYSTEMCMDS boot_profile boot_profile_index)
+		if(NOT boot_profile_index EQUAL -1)
+			add_definitions(-DPX4_BOOT_PROFILE)
+		endif()
 	endif()
 
 	if(EXAMPLES)
@@ -0,0 +1,233 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file boot_profile.cpp
+ * Implementation of the API declared in boot_profile.h.
+ */
+
+#include <px4_platform_common/boot_profile.h>
+
+#if defined(PX4_BOOT_PROFILE)
+
+#include <px4_platform_common/atomic.h>
+#include <px4_platform_common/log.h>
+#include <px4_platform_common/tasks.h>
+
+#include <drivers/drv_hrt.h>
+
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+
+struct boot_profile_entry_s {
+	char name[24];
+	uint32_t spawn;           ///< time the start command was issued
+	uint32_t spawn_us;        ///< duration of the start command
+	uint32_t init_us;         ///< duration of the initialization
+	uint32_t blocked_us;      ///< time spent waiting for other tasks
+	uint32_t first_publish;   ///< time of the first advertisement
+	uint32_t first_subscribe; ///< time of the first subscription
+	const char *first_publish_topic;
+	const char *first_subscribe_topic;
+};
+
+static constexpr int max_boot_profile_entries = 48;
+
+static pthread_mutex_t boot_profile_mutex = PTHREAD_MUTEX_INITIALIZER; // protects boot_profile_entries
+static boot_profile_entry_s boot_profile_entries[max_boot_profile_entries] {};
+static int boot_profile_count = 0;
+
+// set once the boot is complete, the uORB hooks then return without taking the lock
+static px4::atomic_bool boot_profile_complete{false};
+
+// 0 is reserved for events that were not recorded yet
+static uint32_t boot_profile_us(uint64_t time)
+{
+	return (time > 0 && time < UINT32_MAX) ? (uint32_t)time : 1;
+}
+
+// call with the lock held
+static boot_profile_entry_s *boot_profile_entry(const char *name)
+{
+	for (int i = 0; i < boot_profile_count; i++) {
+		if (strncmp(boot_profile_entries[i].name, name, sizeof(boot_profile_entries[i].name) - 1) == 0) {
+			return &boot_profile_entries[i];
+		}
+	}
+
+	if (boot_profile_count < max_boot_profile_entries) {
+		boot_profile_entry_s *entry = &boot_profile_entries[boot_profile_count++];
+		strncpy(entry->name, name, sizeof(entry->name) - 1);
+		return entry;
+	}
+
+	return nullptr;
+}
+
+void px4_boot_profile_spawn(const char *name, uint64_t start, uint64_t end)
+{
+	pthread_mutex_lock(&boot_profile_mutex);
+	boot_profile_entry_s *entry = boot_profile_entry(name);
+
+	if (entry && entry->spawn == 0) {
+		entry->spawn = boot_profile_us(start);
+		entry->spawn_us = end - start;
+	}
+
+	pthread_mutex_unlock(&boot_profile_mutex);
+}
+
+void px4_boot_profile_init(const char *name, uint64_t start, uint64_t end)
+{
+	pthread_mutex_lock(&boot_profile_mutex);
+	boot_profile_entry_s *entry = boot_profile_entry(name);
+
+	if (entry && entry->init_us == 0) {
+		if (entry->spawn == 0) {
+			// boot phases have no start command
+			entry->spawn = boot_profile_us(start);
+		}
+
+		entry->init_us = boot_profile_us(end - start);
+	}
+
+	pthread_mutex_unlock(&boot_profile_mutex);
+}
+
+void px4_boot_profile_blocked(const char *name, uint64_t start, uint64_t end)
+{
+	pthread_mutex_lock(&boot_profile_mutex);
+	boot_profile_entry_s *entry = boot_profile_entry(name);
+
+	if (entry) {
+		entry->blocked_us += end - start;
+	}
+
+	pthread_mutex_unlock(&boot_profile_mutex);
+}
+
+void px4_boot_profile_complete()
+{
+	boot_profile_complete.store(true);
+}
+
+void px4_boot_profile_publish(const char *topic)
+{
+	if (boot_profile_complete.load()) {
+		return;
+	}
+
+	const hrt_abstime now = hrt_absolute_time();
+
+	pthread_mutex_lock(&boot_profile_mutex);
+	boot_profile_entry_s *entry = boot_profile_entry(px4_get_taskname());
+
+	if (entry && entry->first_publish == 0) {
+		entry->first_publish = boot_profile_us(now);
+		entry->first_publish_topic = topic;
+	}
+
+	pthread_mutex_unlock(&boot_profile_mutex);
+}
+
+void px4_boot_profile_subscribe(const char *topic)
+{
+	if (boot_profile_complete.load()) {
+		return;
+	}
+
+	const hrt_abstime now = hrt_absolute_time();
+
+	pthread_mutex_lock(&boot_profile_mutex);
+	boot_profile_entry_s *entry = boot_profile_entry(px4_get_taskname());
+
+	if (entry && entry->first_subscribe == 0) {
+		entry->first_subscribe = boot_profile_us(now);
+		entry->first_subscribe_topic = topic;
+	}
+
+	pthread_mutex_unlock(&boot_profile_mutex);
+}
+
+int px4_boot_profile_line(int index, char *buffer, size_t buffer_length)
+{
+	if (index == 0) {
+		return snprintf(buffer, buffer_length, "%-24s %9s %9s %9s %9s %9s %9s %s\n", "name [ms]", "spawn", "start",
+				"init", "blocked", "first pub", "first sub", "topics (pub sub)");
+	}
+
+	pthread_mutex_lock(&boot_profile_mutex);
+
+	if (index < 0 || index > boot_profile_count) {
+		pthread_mutex_unlock(&boot_profile_mutex);
+		return -1;
+	}
+
+	const boot_profile_entry_s entry = boot_profile_entries[index - 1];
+	pthread_mutex_unlock(&boot_profile_mutex);
+
+	char spawn[12] {"-"};
+	char first_publish[12] {"-"};
+	char first_subscribe[12] {"-"};
+
+	if (entry.spawn > 0) {
+		snprintf(spawn, sizeof(spawn), "%.1f", (double)entry.spawn * 1e-3);
+	}
+
+	if (entry.first_publish > 0) {
+		snprintf(first_publish, sizeof(first_publish), "%.1f", (double)entry.first_publish * 1e-3);
+	}
+
+	if (entry.first_subscribe > 0) {
+		snprintf(first_subscribe, sizeof(first_subscribe), "%.1f", (double)entry.first_subscribe * 1e-3);
+	}
+
+	return snprintf(buffer, buffer_length, "%-24s %9s %9.1f %9.1f %9.1f %9s %9s %s %s\n", entry.name, spawn,
+			(double)entry.spawn_us * 1e-3, (double)entry.init_us * 1e-3, (double)entry.blocked_us * 1e-3,
+			first_publish, first_subscribe,
+			entry.first_publish_topic ? entry.first_publish_topic : "",
+			entry.first_subscribe_topic ? entry.first_subscribe_topic : "");
+}
+
+void px4_boot_profile_print()
+{
+	char buffer[200];
+
+	for (int i = 0; px4_boot_profile_line(i, buffer, sizeof(buffer)) >= 0; i++) {
+		PX4_INFO_RAW("%s", buffer);
+	}
+}
+
+#endif // PX4_BOOT_PROFILE
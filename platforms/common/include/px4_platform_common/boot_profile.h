@@ -0,0 +1,122 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file boot_profile.h
+ * Startup trace of the modules: when each module was started, how long its
+ * start command and initialization took, how long it was blocked waiting for
+ * other modules, and when it first published and subscribed to a topic.
+ * It can be printed via the 'boot_profile' utility and is written to the
+ * start of every full log.
+ *
+ * Entries are identified by name (module or task name, or a boot phase such
+ * as the parameter import), and only the first occurrence of every event is
+ * kept. Publications and subscriptions are assigned to the calling task,
+ * and are only recorded until the boot is marked complete.
+ * All times are in microseconds since boot.
+ *
+ * The trace is only compiled in on boards that include the 'boot_profile'
+ * system command (PX4_BOOT_PROFILE), elsewhere the hooks are empty.
+ */
+
+#pragma once
+
+#include <px4_platform_common/px4_config.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+__BEGIN_DECLS
+
+#if defined(PX4_BOOT_PROFILE)
+
+/**
+ * Record the start command of a module (e.g. 'commander start')
+ */
+__EXPORT void px4_boot_profile_spawn(const char *name, uint64_t start, uint64_t end);
+
+/**
+ * Record the initialization of a module or the duration of a boot phase
+ */
+__EXPORT void px4_boot_profile_init(const char *name, uint64_t start, uint64_t end);
+
+/**
+ * Record time spent blocked waiting for another task or module. Accumulates.
+ */
+__EXPORT void px4_boot_profile_blocked(const char *name, uint64_t start, uint64_t end);
+
+/**
+ * Record a topic advertisement of the calling task
+ */
+__EXPORT void px4_boot_profile_publish(const char *topic);
+
+/**
+ * Record a topic subscription of the calling task
+ */
+__EXPORT void px4_boot_profile_subscribe(const char *topic);
+
+/**
+ * Mark the boot as complete (end of rcS or first log): stops recording
+ * publications and subscriptions, which are then a lock-free no-op.
+ */
+__EXPORT void px4_boot_profile_complete(void);
+
+/**
+ * Format the boot profile as text, line by line.
+ * @param index line index, 0 is the header
+ * @param buffer output buffer
+ * @param buffer_length output buffer length
+ * @return number of characters written, or <0 if there is no such line
+ */
+__EXPORT int px4_boot_profile_line(int index, char *buffer, size_t buffer_length);
+
+/**
+ * Print the boot profile to stdout
+ */
+__EXPORT void px4_boot_profile_print(void);
+
+#else
+
+static inline void px4_boot_profile_spawn(const char *name, uint64_t start, uint64_t end) {}
+static inline void px4_boot_profile_init(const char *name, uint64_t start, uint64_t end) {}
+static inline void px4_boot_profile_blocked(const char *name, uint64_t start, uint64_t end) {}
+static inline void px4_boot_profile_publish(const char *topic) {}
+static inline void px4_boot_profile_subscribe(const char *topic) {}
+static inline void px4_boot_profile_complete(void) {}
+static inline int px4_boot_profile_line(int index, char *buffer, size_t buffer_length) { return -1; }
+static inline void px4_boot_profile_print(void) {}
+
+#endif /* PX4_BOOT_PROFILE */
+
+__END_DECLS
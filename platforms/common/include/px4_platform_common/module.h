@@ -42,6 +42,7 @@
 #include <stdbool.h>
 
 #include <px4_platform_common/atomic.h>
+#include <px4_platform_common/boot_profile.h>
 #include <px4_platform_common/time.h>
 #include <px4_platform_common/log.h>
 #include <px4_platform_common/tasks.h>
@@ -173,8 +174,10 @@ public:
 		argc -= 1;
 		argv += 1;
 
+		const hrt_abstime instantiate_start = hrt_absolute_time();
 		T *object = T::instantiate(argc, argv);
 		_object.store(object);
+		px4_boot_profile_init(MODULE_NAME, instantiate_start, hrt_absolute_time());
 
 		if (object) {
 			object->run();
@@ -206,7 +209,9 @@ public:
 			PX4_ERR("Task already running");
 
 		} else {
+			const hrt_abstime spawn_start = hrt_absolute_time();
 			ret = T::task_spawn(argc, argv);
+			px4_boot_profile_spawn(MODULE_NAME, spawn_start, hrt_absolute_time());
 
 			if (ret < 0) {
 				PX4_ERR("Task start failed (%i)", ret);
@@ -364,6 +369,7 @@ protected:
 	 */
 	static int wait_until_running()
 	{
+		const hrt_abstime wait_start = hrt_absolute_time();
 		int i = 0;
 
 		do {
@@ -372,6 +378,8 @@ protected:
 
 		} while (!_object.load() && ++i < 400);
 
+		px4_boot_profile_blocked(MODULE_NAME, wait_start, hrt_absolute_time());
+
 		if (i == 400) {
 			PX4_ERR("Timed out while waiting for thread to start");
 			return -1;
@@ -144,7 +144,7 @@ function(px4_posix_generate_alias)
 		endforeach()
 		if (MAIN)
 			set(alias_string
-				"${alias_string}alias ${MAIN}='${PREFIX}${MAIN} --instance $px4_instance'\n"
+				"${alias_string}alias ${MAIN}='_px4_run ${MAIN}'\n"
 			)
 		endif()
 	endforeach()
@@ -75,6 +75,7 @@
 #include <px4_platform_common/posix.h>
 
 #include "apps.h"
+#include "px4_daemon/batch_executor.h"
 #include "px4_daemon/client.h"
 #include "px4_daemon/server.h"
 #include "px4_daemon/pxh.h"
@@ -531,22 +532,22 @@ int run_startup_script(const std::string &commands_file, const std::string &abso
 
 	PX4_INFO("Calling startup script: %s", shell_command.c_str());
 
-	int ret = 0;
+	// The PX4 commands of the script are executed in-process (see px4-alias.sh), which avoids
+	// a client process and a socket round trip per command.
+	px4_daemon::BatchExecutor executor;
+	int ret = executor.run(commands_file, instance);
 
-	if (!shell_command.empty()) {
-		ret = system(shell_command.c_str());
-
-		if (ret == 0) {
-			PX4_INFO("Startup script returned successfully");
-
-		} else {
-			PX4_ERR("Startup script returned with return value: %d", ret);
-		}
+	if (ret == 0) {
+		PX4_INFO("Startup script returned successfully");
 
 	} else {
-		PX4_INFO("Startup script empty");
+		PX4_ERR("Startup script returned with return value: %d", ret);
 	}
 
+	// set PX4_BOOT_TIMELINE=1 to print every command
+	const char *timeline = getenv("PX4_BOOT_TIMELINE");
+	executor.print_timeline(timeline && strcmp(timeline, "0") != 0);
+
 	return ret;
 }
 
@@ -0,0 +1,305 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file batch_executor.cpp
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <algorithm>
+#include <chrono>
+
+#include <px4_platform_common/log.h>
+
+#include "batch_executor.h"
+#include "pxh.h"
+#include "server.h"
+
+namespace px4_daemon
+{
+
+// file descriptors of the pipes within the script, see px4-alias.sh
+static constexpr int SCRIPT_CMD_FD = 3;
+static constexpr int SCRIPT_OUT_FD = 4;
+
+// marks the end of the output of a command, followed by the return value on the next line
+static constexpr char END_MARKER[] = "@@px4_ret\n";
+
+static uint64_t monotonic_us()
+{
+	// not hrt_absolute_time(): with lockstep the time does not advance until the simulator connects
+	return std::chrono::duration_cast<std::chrono::microseconds>(
+		       std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int
+BatchExecutor::run(const std::string &script, int instance_id)
+{
+	int cmd_pipe[2];
+	int out_pipe[2];
+
+	if (pipe(cmd_pipe) != 0) {
+		PX4_ERR("pipe() failed: %s", strerror(errno));
+		return -1;
+	}
+
+	if (pipe(out_pipe) != 0) {
+		PX4_ERR("pipe() failed: %s", strerror(errno));
+		close(cmd_pipe[0]);
+		close(cmd_pipe[1]);
+		return -1;
+	}
+
+	for (int fd : {cmd_pipe[0], cmd_pipe[1], out_pipe[0], out_pipe[1]}) {
+		fcntl(fd, F_SETFD, FD_CLOEXEC);
+	}
+
+	// everything the child needs is prepared before fork(), as only async-signal-safe calls are allowed after
+	const std::string instance_arg = std::to_string(instance_id);
+	setenv("PX4_BATCH", "1", 1);
+
+	_timeline.clear();
+	_script_start_us = monotonic_us();
+
+	const pid_t pid = fork();
+
+	if (pid == 0) {
+		// move the pipe ends out of the way first, so that the dup2() calls below cannot clobber them
+		const int cmd_fd = fcntl(cmd_pipe[1], F_DUPFD, 10);
+		const int out_fd = fcntl(out_pipe[0], F_DUPFD, 10);
+
+		if (cmd_fd < 0 || out_fd < 0 || dup2(cmd_fd, SCRIPT_CMD_FD) < 0 || dup2(out_fd, SCRIPT_OUT_FD) < 0) {
+			_exit(127);
+		}
+
+		close(cmd_fd);
+		close(out_fd);
+
+		execl("/bin/sh", "sh", script.c_str(), instance_arg.c_str(), (char *)nullptr);
+		_exit(127);
+	}
+
+	unsetenv("PX4_BATCH");
+	close(cmd_pipe[1]);
+	close(out_pipe[0]);
+
+	const int cmd_fd = cmd_pipe[0];
+	const int out_fd = out_pipe[1];
+
+	if (pid < 0) {
+		PX4_ERR("fork() failed: %s", strerror(errno));
+		close(cmd_fd);
+		close(out_fd);
+		return -1;
+	}
+
+	std::string pending;
+	char buf[512];
+	int status = 0;
+	bool exited = false;
+
+	while (true) {
+		pollfd fds{cmd_fd, POLLIN, 0};
+		const int ret = poll(&fds, 1, 100);
+
+		if (ret < 0 && errno != EINTR) {
+			PX4_ERR("poll() failed: %s", strerror(errno));
+			break;
+		}
+
+		if (ret > 0) {
+			const ssize_t n_read = read(cmd_fd, buf, sizeof(buf));
+
+			if (n_read <= 0) {
+				// all writers are gone
+				break;
+			}
+
+			pending.append(buf, n_read);
+
+			size_t end;
+
+			while ((end = pending.find('\n')) != std::string::npos) {
+				_execute(pending.substr(0, end), out_fd);
+				pending.erase(0, end + 1);
+			}
+
+		} else if (waitpid(pid, &status, WNOHANG) == pid) {
+			// background processes started by the script can keep the pipe open, so check the script itself
+			exited = true;
+			break;
+		}
+	}
+
+	close(cmd_fd);
+	close(out_fd);
+
+	if (!exited && waitpid(pid, &status, 0) != pid) {
+		status = -1;
+	}
+
+	_script_duration_us = monotonic_us() - _script_start_us;
+
+	if (status == -1) {
+		return -1;
+	}
+
+	return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+void
+BatchExecutor::_execute(const std::string &line, int out_fd)
+{
+	// format: '<isatty> <command line>'
+	if (line.size() < 2 || line[1] != ' ') {
+		return;
+	}
+
+	const bool is_atty = line[0] == '1';
+	const std::string command = line.substr(2);
+
+	char *output = nullptr;
+	size_t output_len = 0;
+	FILE *out = open_memstream(&output, &output_len);
+
+	// redirect the PX4_INFO (etc.) output of this thread, as the server does for its clients
+	Server::CmdThreadSpecificData thread_data{out, is_atty};
+	const bool redirect = out != nullptr && Server::is_running();
+
+	if (redirect) {
+		pthread_setspecific(Server::get_pthread_key(), &thread_data);
+	}
+
+	const uint64_t start = monotonic_us();
+	const int retval = Pxh::process_line(command, true);
+	const uint64_t end = monotonic_us();
+
+	if (redirect) {
+		pthread_setspecific(Server::get_pthread_key(), nullptr);
+	}
+
+	_timeline.push_back(TimelineEntry{start - _script_start_us, (uint32_t)(end - start), retval, command});
+
+	if (out) {
+		fclose(out);
+
+		if (output_len > 0) {
+			_write_all(out_fd, output, output_len);
+
+			if (output[output_len - 1] != '\n') {
+				_write_all(out_fd, "\n", 1);
+			}
+		}
+
+		free(output);
+	}
+
+	char ret_line[8];
+	const int ret_len = snprintf(ret_line, sizeof(ret_line), "%u\n", (unsigned)(uint8_t)retval);
+	_write_all(out_fd, END_MARKER, sizeof(END_MARKER) - 1);
+	_write_all(out_fd, ret_line, ret_len);
+}
+
+int
+BatchExecutor::_write_all(int fd, const char *buf, size_t len)
+{
+	while (len > 0) {
+		const ssize_t n_written = write(fd, buf, len);
+
+		if (n_written < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+
+			return -1;
+		}
+
+		buf += n_written;
+		len -= n_written;
+	}
+
+	return 0;
+}
+
+void
+BatchExecutor::print_timeline(bool full) const
+{
+	uint64_t commands_us = 0;
+
+	for (const auto &entry : _timeline) {
+		commands_us += entry.duration_us;
+	}
+
+	PX4_INFO("Startup script: %.1f ms, %zu commands (%.1f ms), shell and external tools %.1f ms",
+		 _script_duration_us / 1e3, _timeline.size(), commands_us / 1e3,
+		 (_script_duration_us - std::min(commands_us, _script_duration_us)) / 1e3);
+
+	if (full) {
+		PX4_INFO_RAW("   start [ms]  duration [ms]  command\n");
+
+		for (const auto &entry : _timeline) {
+			PX4_INFO_RAW("%13.1f %14.1f  %s%s\n", entry.start_us / 1e3, entry.duration_us / 1e3, entry.command.c_str(),
+				     entry.retval != 0 ? " (failed)" : "");
+		}
+
+		return;
+	}
+
+	// only the slowest commands
+	static constexpr size_t NUM_SLOWEST = 5;
+	std::vector<const TimelineEntry *> slowest;
+
+	for (const auto &entry : _timeline) {
+		slowest.push_back(&entry);
+	}
+
+	const size_t num = std::min(NUM_SLOWEST, slowest.size());
+	std::partial_sort(slowest.begin(), slowest.begin() + num, slowest.end(),
+	[](const TimelineEntry * a, const TimelineEntry * b) { return a->duration_us > b->duration_us; });
+
+	for (size_t i = 0; i < num; ++i) {
+		PX4_INFO("  %.1f ms at %.1f ms: %s", slowest[i]->duration_us / 1e3, slowest[i]->start_us / 1e3,
+			 slowest[i]->command.c_str());
+	}
+}
+
+} // namespace px4_daemon
@@ -0,0 +1,94 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file batch_executor.h
+ *
+ * Runs the startup script and executes its PX4 commands in-process.
+ *
+ * The script is still interpreted by /bin/sh, but instead of starting a px4-<command>
+ * client for every command, px4-alias.sh writes the command line to a pipe (fd 3) and
+ * reads back the output and the return value from a second pipe (fd 4). The commands
+ * are executed sequentially by Pxh::process_line() in the calling thread.
+ *
+ * Every command is recorded in a boot timeline, which can be printed afterwards.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace px4_daemon
+{
+
+class BatchExecutor
+{
+public:
+	BatchExecutor() = default;
+	~BatchExecutor() = default;
+
+	/**
+	 * Run the script and execute its commands until it exits.
+	 *
+	 * @param script: path to the startup script
+	 * @param instance_id: instance passed as argument to the script
+	 * @return exit status of the script (0 on success, -1 if it could not be started)
+	 */
+	int run(const std::string &script, int instance_id);
+
+	/**
+	 * Print a summary of the boot timeline and the slowest commands.
+	 *
+	 * @param full: print every command with its start offset and duration
+	 */
+	void print_timeline(bool full) const;
+
+private:
+	struct TimelineEntry {
+		uint64_t start_us; ///< relative to the script start
+		uint32_t duration_us;
+		int retval;
+		std::string command;
+	};
+
+	void _execute(const std::string &line, int out_fd);
+
+	static int _write_all(int fd, const char *buf, size_t len);
+
+	std::vector<TimelineEntry> _timeline;
+	uint64_t _script_start_us{0};
+	uint64_t _script_duration_us{0};
+};
+
+} // namespace px4_daemon
@@ -103,6 +103,13 @@ Server::start()
 		return -1;
 	}
 
+	// Created here rather than in the server thread, so that it is valid as soon as start() returns
+	// (the startup script executor uses it from the main thread).
+	if (pthread_key_create(&_key, _pthread_key_destructor) != 0) {
+		PX4_ERR("failed to create pthread key");
+		return -1;
+	}
+
 	if (0 != pthread_create(&_server_main_pthread,
 				nullptr,
 				_server_main_trampoline,
@@ -129,13 +136,6 @@ void Server::_pthread_key_destructor(void *arg)
 void
 Server::_server_main()
 {
-	int ret = pthread_key_create(&_key, _pthread_key_destructor);
-
-	if (ret != 0) {
-		PX4_ERR("failed to create pthread key");
-		return;
-	}
-
 	// The list of file descriptors to watch.
 	std::vector<pollfd> poll_fds;
 
@@ -179,7 +179,7 @@ Server::_server_main()
 
 				// Start a new thread to handle the client.
 				pthread_t *thread = &_fd_to_thread[client];
-				ret = pthread_create(thread, nullptr, Server::_handle_client, thread_stdout);
+				int ret = pthread_create(thread, nullptr, Server::_handle_client, thread_stdout);
 
 				if (ret != 0) {
 					PX4_ERR("could not start pthread (%i)", ret);
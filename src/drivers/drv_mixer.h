@@ -78,6 +78,19 @@
  */
 #define MIXERIOCLOADBUF		_MIXERIOC(5)
 
+/**
+ * Atomically replace the mixer(s) with the ones described by the
+ * (const struct mixer_buffer_s *)arg. The buffer holds either a text or a
+ * binary (precompiled) mixer definition. Outputs keep running on the old
+ * mixer until the new one is fully loaded.
+ */
+#define MIXERIOCREPLACE		_MIXERIOC(6)
+
+struct mixer_buffer_s {
+	const char *buf;
+	unsigned length;
+};
+
 /*
  * XXX Thoughts for additional operations:
  *
@@ -1314,6 +1314,17 @@ int PWMOut::pwm_ioctl(file *filp, int cmd, unsigned long arg)
 			break;
 		}
 
+	case MIXERIOCREPLACE: {
+			const mixer_buffer_s *mixer = (const mixer_buffer_s *)arg;
+			ret = _mixing_output.swapMixerThreadSafe(mixer->buf, mixer->length);
+
+			if (ret == 0) {
+				update_pwm_trims();
+			}
+
+			break;
+		}
+
 	default:
 		ret = -ENOTTY;
 		break;
@@ -221,6 +221,12 @@ PWMSim::ioctl(device::file_t *filp, int cmd, unsigned long arg)
 			break;
 		}
 
+	case MIXERIOCREPLACE: {
+			const mixer_buffer_s *mixer = (const mixer_buffer_s *)arg;
+			ret = _mixing_output.swapMixerThreadSafe(mixer->buf, mixer->length);
+			break;
+		}
+
 
 	default:
 		ret = -ENOTTY;
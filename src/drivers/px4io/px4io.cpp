@@ -97,6 +97,7 @@
 #include <debug.h>
 
 #include <modules/px4iofirmware/protocol.h>
+#include <px4io_gather/px4io_gather.h>
 
 #include "uploader.h"
 
@@ -224,6 +225,7 @@ private:
 	perf_counter_t		_perf_update;		///< local performance counter for status updates
 	perf_counter_t		_perf_write;		///< local performance counter for PWM control writes
 	perf_counter_t		_perf_sample_latency;	///< total system latency (based on passed-through timestamp)
+	perf_counter_t		_perf_gather_fallback;	///< gather reads split into one read per range
 
 	/* cached IO state */
 	uint16_t		_status{0};		///< Various IO status flags
@@ -232,6 +234,21 @@ private:
 	uint16_t		_last_written_arming_s{0};	///< the last written arming state reg
 	uint16_t		_last_written_arming_c{0};	///< the last written arming state reg
 
+	/* register snapshot layout, see io_get_snapshot() */
+	static constexpr unsigned SNAPSHOT_RC_CHANNELS = 8;	///< RC channels in the snapshot, enough for the common case
+	static constexpr unsigned SNAPSHOT_STATUS = 0;		///< PX4IO_P_STATUS_FLAGS .. PX4IO_P_STATUS_MIXER
+	static constexpr unsigned SNAPSHOT_ARMING = SNAPSHOT_STATUS + PX4IO_P_STATUS_MIXER - PX4IO_P_STATUS_FLAGS + 1;
+	static constexpr unsigned SNAPSHOT_RAW_RC = SNAPSHOT_ARMING + 1;	///< PX4IO_P_RAW_RC_COUNT and the first channels
+	static constexpr unsigned SNAPSHOT_SERVOS = SNAPSHOT_RAW_RC + PX4IO_P_RAW_RC_BASE + SNAPSHOT_RC_CHANNELS;
+	static constexpr unsigned SNAPSHOT_SIZE = SNAPSHOT_SERVOS + 16;
+
+	// with the 8 servo outputs of the IO the snapshot has to fit into a single gather read
+	static_assert(SNAPSHOT_SERVOS + 8 <= (PX4IO_MAX_TRANSFER_LEN - 2) / sizeof(uint16_t),
+		      "PX4IO register snapshot exceeds the gather transfer limit");
+
+	uint16_t		_snapshot[SNAPSHOT_SIZE] {};	///< registers fetched by io_get_snapshot()
+	bool			_gather_supported{false};	///< IO firmware serves PX4IO_PAGE_GATHER reads, probed in init()
+
 	/* subscribed topics */
 	int			_t_actuator_controls_0;	///< actuator controls group 0 topic
 
@@ -311,10 +328,19 @@ private:
 	 */
 	int			io_set_rc_config();
 
+	/**
+	 * Fetch the per-cycle register snapshot from IO
+	 *
+	 * Status, arming state, the RC input prolog with the first channels and
+	 * the servo outputs are read in a single gather transaction.
+	 */
+	int			io_get_snapshot();
+
 	/**
 	 * Fetch status and alarms from IO
 	 *
-	 * Also publishes battery voltage/current.
+	 * Also refreshes the register snapshot used by io_publish_raw_rc()
+	 * and io_publish_pwm_outputs().
 	 */
 	int			io_get_status();
 
@@ -326,6 +352,8 @@ private:
 	/**
 	 * Fetch RC inputs from IO.
 	 *
+	 * Channels beyond the register snapshot are read from IO.
+	 *
 	 * @param input_rc	Input structure to populate.
 	 * @return		OK if data was returned.
 	 */
@@ -383,6 +411,28 @@ private:
 	uint32_t		io_reg_get(uint8_t page, uint8_t offset);
 	static const uint32_t	_io_reg_get_error = 0x80000000;
 
+	using io_reg_range = px4io_gather_range;
+
+	/**
+	 * read several register ranges in one transaction
+	 *
+	 * Falls back to one transaction per range if IO does not support gather reads
+	 * (see io_probe_gather()).
+	 *
+	 * @param ranges	Register ranges to read.
+	 * @param num_ranges	The number of ranges.
+	 * @param values	Pointer to array where the values of all ranges are stored back to back.
+	 * @return		OK if all values were successfully read.
+	 */
+	int			io_reg_gather(const io_reg_range *ranges, unsigned num_ranges, uint16_t *values);
+
+	/**
+	 * check once whether the IO firmware serves gather reads
+	 *
+	 * @return		true if a gather read of the config page succeeded.
+	 */
+	bool			io_probe_gather();
+
 	/**
 	 * modify a register
 	 *
@@ -449,6 +499,7 @@ PX4IO::PX4IO(device::Device *interface) :
 	_perf_update(perf_alloc(PC_ELAPSED, "io update")),
 	_perf_write(perf_alloc(PC_ELAPSED, "io write")),
 	_perf_sample_latency(perf_alloc(PC_ELAPSED, "io control latency")),
+	_perf_gather_fallback(perf_alloc(PC_COUNT, "io gather fallback")),
 	_t_actuator_controls_0(-1),
 	_param_update_force(false),
 	_primary_pwm_device(false),
@@ -494,6 +545,7 @@ PX4IO::~PX4IO()
 	perf_free(_perf_update);
 	perf_free(_perf_write);
 	perf_free(_perf_sample_latency);
+	perf_free(_perf_gather_fallback);
 
 	g_dev = nullptr;
 }
@@ -620,6 +672,12 @@ PX4IO::init()
 		_max_rc_input = input_rc_s::RC_INPUT_MAX_CHANNELS;
 	}
 
+	_gather_supported = io_probe_gather();
+
+	if (!_gather_supported) {
+		PX4_INFO("IO does not support gather reads");
+	}
+
 	param_get(param_find("RC_RSSI_PWM_CHAN"), &_rssi_pwm_chan);
 	param_get(param_find("RC_RSSI_PWM_MAX"), &_rssi_pwm_max);
 	param_get(param_find("RC_RSSI_PWM_MIN"), &_rssi_pwm_min);
@@ -924,14 +982,15 @@ PX4IO::task_main()
 			/* run at 50-250Hz */
 			poll_last = now;
 
-			/* pull status and alarms from IO */
-			io_get_status();
+			/* pull status, alarms, R/C input and PWM outputs from IO in one transaction */
+			if (io_get_status() == OK) {
 
-			/* get raw R/C input from IO */
-			io_publish_raw_rc();
+				/* publish raw R/C input */
+				io_publish_raw_rc();
 
-			/* fetch PWM outputs from IO */
-			io_publish_pwm_outputs();
+				/* publish PWM outputs */
+				io_publish_pwm_outputs();
+			}
 
 			/* check updates on uORB topics and handle it */
 			bool updated = false;
@@ -1674,20 +1733,34 @@ PX4IO::dsm_bind_ioctl(int dsmMode)
 	}
 }
 
+int
+PX4IO::io_get_snapshot()
+{
+	const io_reg_range ranges[] {
+		{PX4IO_PAGE_STATUS, PX4IO_P_STATUS_FLAGS, SNAPSHOT_ARMING - SNAPSHOT_STATUS},
+		{PX4IO_PAGE_SETUP, PX4IO_P_SETUP_ARMING, 1},
+		{PX4IO_PAGE_RAW_RC_INPUT, PX4IO_P_RAW_RC_COUNT, SNAPSHOT_SERVOS - SNAPSHOT_RAW_RC},
+		{PX4IO_PAGE_SERVOS, 0, static_cast<uint8_t>(_max_actuators)},
+	};
+
+	return io_reg_gather(ranges, sizeof(ranges) / sizeof(ranges[0]), _snapshot);
+}
+
 int
 PX4IO::io_get_status()
 {
-	/* get
-	 * STATUS_FLAGS, STATUS_ALARMS, STATUS_VBATT, STATUS_IBATT,
-	 * STATUS_VSERVO, STATUS_VRSSI
-	 * in that order */
-	uint16_t regs[6] {};
-	int ret = io_reg_get(PX4IO_PAGE_STATUS, PX4IO_P_STATUS_FLAGS, &regs[0], sizeof(regs) / sizeof(regs[0]));
+	int ret = io_get_snapshot();
 
 	if (ret != OK) {
 		return ret;
 	}
 
+	/* the snapshot starts with
+	 * STATUS_FLAGS, STATUS_ALARMS, STATUS_VBATT, STATUS_IBATT,
+	 * STATUS_VSERVO, STATUS_VRSSI
+	 * in that order */
+	const uint16_t *regs = &_snapshot[SNAPSHOT_STATUS];
+
 	const uint16_t STATUS_FLAGS  = regs[0];
 	const uint16_t STATUS_ALARMS = regs[1];
 	const uint16_t STATUS_VSERVO = regs[4];
@@ -1707,7 +1780,7 @@ PX4IO::io_get_status()
 		_analog_rc_rssi_stable = true;
 	}
 
-	const uint16_t SETUP_ARMING = io_reg_get(PX4IO_PAGE_SETUP, PX4IO_P_SETUP_ARMING);
+	const uint16_t SETUP_ARMING = _snapshot[SNAPSHOT_ARMING];
 
 	if ((hrt_elapsed_time(&_last_status_publish) >= 1_s)
 	    || (_status != STATUS_FLAGS)
@@ -1720,8 +1793,6 @@ PX4IO::io_get_status()
 		status.voltage_v = STATUS_VSERVO * 0.001f; // voltage is scaled to mV
 		status.rssi_v = rssi_v;
 
-		status.free_memory_bytes = io_reg_get(PX4IO_PAGE_STATUS, PX4IO_P_STATUS_FREEMEM);
-
 		// PX4IO_P_STATUS_FLAGS
 		status.status_outputs_armed   = STATUS_FLAGS & PX4IO_P_STATUS_FLAGS_OUTPUTS_ARMED;
 		status.status_override        = STATUS_FLAGS & PX4IO_P_STATUS_FLAGS_OVERRIDE;
@@ -1765,15 +1836,37 @@ PX4IO::io_get_status()
 		status.arming_override_immediate   = SETUP_ARMING & PX4IO_P_SETUP_ARMING_OVERRIDE_IMMEDIATE;
 
 
-		for (unsigned i = 0; i < _max_actuators; i++) {
-			status.actuators[i] = static_cast<int16_t>(io_reg_get(PX4IO_PAGE_ACTUATORS, i));
-			status.servos[i] = io_reg_get(PX4IO_PAGE_SERVOS, i);
+		const unsigned outputs = math::min(_max_actuators, (unsigned)(sizeof(status.servos) / sizeof(status.servos[0])));
+		const unsigned raw_inputs = math::min((unsigned)_snapshot[SNAPSHOT_RAW_RC + PX4IO_P_RAW_RC_COUNT],
+						      (unsigned)input_rc_s::RC_INPUT_MAX_CHANNELS);
+		const unsigned extra_inputs = (raw_inputs > SNAPSHOT_RC_CHANNELS) ? raw_inputs - SNAPSHOT_RC_CHANNELS : 0;
+
+		for (unsigned i = 0; i < outputs; i++) {
+			status.servos[i] = _snapshot[SNAPSHOT_SERVOS + i];
 		}
 
-		uint16_t raw_inputs = io_reg_get(PX4IO_PAGE_RAW_RC_INPUT, PX4IO_P_RAW_RC_COUNT);
+		for (unsigned i = 0; i < raw_inputs - extra_inputs; i++) {
+			status.raw_inputs[i] = _snapshot[SNAPSHOT_RAW_RC + PX4IO_P_RAW_RC_BASE + i];
+		}
 
-		for (unsigned i = 0; i < raw_inputs; i++) {
-			status.raw_inputs[i] = io_reg_get(PX4IO_PAGE_RAW_RC_INPUT, PX4IO_P_RAW_RC_BASE + i);
+		/* free memory, actuators and the remaining R/C channels are not part of the snapshot */
+		const io_reg_range ranges[] {
+			{PX4IO_PAGE_STATUS, PX4IO_P_STATUS_FREEMEM, 1},
+			{PX4IO_PAGE_ACTUATORS, 0, static_cast<uint8_t>(outputs)},
+			{PX4IO_PAGE_RAW_RC_INPUT, PX4IO_P_RAW_RC_BASE + SNAPSHOT_RC_CHANNELS, static_cast<uint8_t>(extra_inputs)},
+		};
+		uint16_t regs_extra[1 + 8 + input_rc_s::RC_INPUT_MAX_CHANNELS];
+
+		if (io_reg_gather(ranges, sizeof(ranges) / sizeof(ranges[0]), regs_extra) == OK) {
+			status.free_memory_bytes = regs_extra[0];
+
+			for (unsigned i = 0; i < outputs; i++) {
+				status.actuators[i] = static_cast<int16_t>(regs_extra[1 + i]);
+			}
+
+			for (unsigned i = 0; i < extra_inputs; i++) {
+				status.raw_inputs[SNAPSHOT_RC_CHANNELS + i] = regs_extra[1 + outputs + i];
+			}
 		}
 
 		status.timestamp = hrt_absolute_time();
@@ -1792,7 +1885,7 @@ int
 PX4IO::io_get_raw_rc_input(input_rc_s &input_rc)
 {
 	uint32_t channel_count;
-	int	ret;
+	int	ret = OK;
 
 	/* we don't have the status bits, so input_source has to be set elsewhere */
 	input_rc.input_source = input_rc_s::RC_INPUT_SOURCE_UNKNOWN;
@@ -1801,19 +1894,14 @@ PX4IO::io_get_raw_rc_input(input_rc_s &input_rc)
 	uint16_t regs[input_rc_s::RC_INPUT_MAX_CHANNELS + prolog];
 
 	/*
-	 * Read the channel count and the first 9 channels.
+	 * The channel count and the first 8 channels are part of the register snapshot.
 	 *
-	 * This should be the common case (9 channel R/C control being a reasonable upper bound).
+	 * This should be the common case (8 channel R/C control being a reasonable upper bound).
 	 */
-	ret = io_reg_get(PX4IO_PAGE_RAW_RC_INPUT, PX4IO_P_RAW_RC_COUNT, &regs[0], prolog + 9);
-
-	if (ret != OK) {
-		return ret;
-	}
+	memcpy(&regs[0], &_snapshot[SNAPSHOT_RAW_RC], (prolog + SNAPSHOT_RC_CHANNELS) * sizeof(regs[0]));
 
 	/*
-	 * Get the channel count any any extra channels. This is no more expensive than reading the
-	 * channel count once.
+	 * Get the channel count and read any extra channels.
 	 */
 	channel_count = regs[PX4IO_P_RAW_RC_COUNT];
 
@@ -1861,8 +1949,9 @@ PX4IO::io_get_raw_rc_input(input_rc_s &input_rc)
 	/* FIELDS NOT SET HERE */
 	/* input_rc.input_source is set after this call XXX we might want to mirror the flags in the RC struct */
 
-	if (channel_count > 9) {
-		ret = io_reg_get(PX4IO_PAGE_RAW_RC_INPUT, PX4IO_P_RAW_RC_BASE + 9, &regs[prolog + 9], channel_count - 9);
+	if (channel_count > SNAPSHOT_RC_CHANNELS) {
+		ret = io_reg_get(PX4IO_PAGE_RAW_RC_INPUT, PX4IO_P_RAW_RC_BASE + SNAPSHOT_RC_CHANNELS,
+				 &regs[prolog + SNAPSHOT_RC_CHANNELS], channel_count - SNAPSHOT_RC_CHANNELS);
 
 		if (ret != OK) {
 			return ret;
@@ -1942,32 +2031,21 @@ PX4IO::io_publish_pwm_outputs()
 		return OK;
 	}
 
-	/* get servo values from IO */
-	uint16_t ctl[_max_actuators];
-	int ret = io_reg_get(PX4IO_PAGE_SERVOS, 0, ctl, _max_actuators);
-
-	if (ret != OK) {
-		return ret;
-	}
-
+	/* servo values are part of the register snapshot */
 	actuator_outputs_s outputs = {};
 	outputs.timestamp = hrt_absolute_time();
 	outputs.noutputs = _max_actuators;
 
 	/* convert from register format to float */
 	for (unsigned i = 0; i < _max_actuators; i++) {
-		outputs.output[i] = ctl[i];
+		outputs.output[i] = _snapshot[SNAPSHOT_SERVOS + i];
 	}
 
 	_to_outputs.publish(outputs);
 
-	/* get mixer status flags from IO */
+	/* mixer status flags are the last status register of the snapshot */
 	MultirotorMixer::saturation_status saturation_status;
-	ret = io_reg_get(PX4IO_PAGE_STATUS, PX4IO_P_STATUS_MIXER, &saturation_status.value, 1);
-
-	if (ret != OK) {
-		return ret;
-	}
+	saturation_status.value = _snapshot[SNAPSHOT_STATUS + PX4IO_P_STATUS_MIXER - PX4IO_P_STATUS_FLAGS];
 
 	/* publish mixer status */
 	if (saturation_status.flags.valid) {
@@ -2025,6 +2103,64 @@ PX4IO::io_reg_get(uint8_t page, uint8_t offset, uint16_t *values, unsigned num_v
 	return OK;
 }
 
+int
+PX4IO::io_reg_gather(const io_reg_range *ranges, unsigned num_ranges, uint16_t *values)
+{
+	if (_gather_supported) {
+		const int total = px4io_gather_pack(values, ranges, num_ranges, _max_transfer / sizeof(*values));
+
+		if (total > 0) {
+			int ret = _interface->read((PX4IO_PAGE_GATHER << 8) | num_ranges, reinterpret_cast<void *>(values), total);
+
+			if (ret != total) {
+				/* support was established in init(), so this is a transfer error */
+				PX4_DEBUG("io_reg_gather(%u,%d): data error %d", num_ranges, total, ret);
+				return -1;
+			}
+
+			return OK;
+		}
+
+		/* the ranges do not fit into a single transfer */
+		perf_count(_perf_gather_fallback);
+	}
+
+	for (unsigned i = 0; i < num_ranges; i++) {
+		if (ranges[i].count > 0) {
+			int ret = io_reg_get(ranges[i].page, ranges[i].offset, values, ranges[i].count);
+
+			if (ret != OK) {
+				return ret;
+			}
+
+			values += ranges[i].count;
+		}
+	}
+
+	return OK;
+}
+
+bool
+PX4IO::io_probe_gather()
+{
+	const io_reg_range ranges[] {
+		{PX4IO_PAGE_CONFIG, PX4IO_P_CONFIG_PROTOCOL_VERSION, 2},
+	};
+	uint16_t regs[2];
+
+	/* IO firmware without gather support rejects the page, retry to tell that apart from a transfer error */
+	for (int attempt = 0; attempt < 3; attempt++) {
+		const int total = px4io_gather_pack(regs, ranges, 1, _max_transfer / sizeof(regs[0]));
+
+		if ((_interface->read((PX4IO_PAGE_GATHER << 8) | 1, reinterpret_cast<void *>(regs), total) == total)
+		    && (regs[0] == PX4IO_PROTOCOL_VERSION)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
 uint32_t
 PX4IO::io_reg_get(uint8_t page, uint8_t offset)
 {
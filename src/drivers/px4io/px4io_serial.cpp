@@ -172,6 +172,13 @@ PX4IO_serial::read(unsigned address, void *data, unsigned count)
 		return -EINVAL;
 	}
 
+	/* gather reads pass their range descriptors in, the offset being the number of ranges */
+	const bool gather = (page == PX4IO_PAGE_GATHER);
+
+	if (gather && ((offset > PX4IO_GATHER_MAX_RANGES) || (2u * offset > count))) {
+		return -EINVAL;
+	}
+
 	px4_sem_wait(&_bus_semaphore);
 
 	int result;
@@ -182,6 +189,10 @@ PX4IO_serial::read(unsigned address, void *data, unsigned count)
 		_io_buffer_ptr->page = page;
 		_io_buffer_ptr->offset = offset;
 
+		if (gather) {
+			memcpy((void *)&_io_buffer_ptr->regs[0], values, (2 * 2 * offset));
+		}
+
 		_io_buffer_ptr->crc = 0;
 		_io_buffer_ptr->crc = crc_packet(_io_buffer_ptr);
 
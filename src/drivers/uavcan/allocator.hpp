@@ -41,14 +41,32 @@
 #include <uavcan/uavcan.hpp>
 #include <uavcan/helpers/heap_based_pool_allocator.hpp>
 
+#ifndef __PX4_NUTTX
+#include <pthread.h>
+#endif
+
 // TODO: Entire UAVCAN application should be moved into a namespace later; this is the first step.
 namespace uavcan_node
 {
 
+#ifdef __PX4_NUTTX
 struct AllocatorSynchronizer {
 	const ::irqstate_t state = ::enter_critical_section();
 	~AllocatorSynchronizer() { ::leave_critical_section(state); }
 };
+#else
+// on POSIX the nodes may live in different threads (e.g. the virtual bus benchmark)
+struct AllocatorSynchronizer {
+	static pthread_mutex_t &mutex()
+	{
+		static pthread_mutex_t m = PTHREAD_MUTEX_INITIALIZER;
+		return m;
+	}
+
+	AllocatorSynchronizer() { pthread_mutex_lock(&mutex()); }
+	~AllocatorSynchronizer() { pthread_mutex_unlock(&mutex()); }
+};
+#endif
 
 struct Allocator : public uavcan::HeapBasedPoolAllocator<uavcan::MemPoolBlockSize, AllocatorSynchronizer> {
 	static constexpr unsigned CapacitySoftLimit = 250;
@@ -0,0 +1,390 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file uavcan_bench.cpp
+ *
+ * ESC RawCommand round-trip benchmark on the in-process virtual CAN bus.
+ *
+ * A commander node broadcasts RawCommand at a fixed rate. An emulated ESC node answers each
+ * command with one esc.Status per ESC. The latency is measured from publishing the command to
+ * receiving the status of the last ESC. Both nodes spin on bus events, like UavcanNode does.
+ *
+ * Each command carries the cycle sequence number as its value, which the ESCs echo back as rpm,
+ * so late replies to a previous cycle are not counted.
+ */
+
+#include "uavcan_bench.hpp"
+#include "allocator.hpp"
+
+#include <px4_platform_common/getopt.h>
+#include <px4_platform_common/log.h>
+
+#include <pthread.h>
+#include <stdlib.h>
+
+#include <uavcan/uavcan.hpp>
+#include <uavcan/equipment/esc/RawCommand.hpp>
+#include <uavcan/equipment/esc/Status.hpp>
+#include <uavcan_socketcan/uavcan_socketcan.hpp>
+
+namespace
+{
+
+using uavcan::equipment::esc::RawCommand;
+using uavcan::equipment::esc::Status;
+
+static constexpr unsigned RxQueueCapacity = 64;
+static constexpr unsigned TransferPriority = 5; ///< same as UavcanEscController
+static constexpr unsigned SequenceRange = 8192;   ///< positive range of the int14 RawCommand values
+
+static_assert(RawCommand::FieldTypes::cmd::MaxSize < 32, "reply mask too small");
+
+/**
+ * Emulated ESCs: a node that answers each RawCommand with one Status per commanded ESC.
+ */
+class EscEmulator
+{
+public:
+	EscEmulator(uavcan_socketcan::VirtualBus &bus) :
+		_node(_can.driver, uavcan_socketcan::SystemClock::instance(), _allocator),
+		_status_pub(_node),
+		_command_sub(_node)
+	{
+		_init_res = _can.init(bus);
+	}
+
+	int start(uavcan::NodeID node_id)
+	{
+		if (_init_res < 0) {
+			return _init_res;
+		}
+
+		_node.setNodeID(node_id);
+		_node.setName("org.px4.bench_esc");
+		_status_pub.setPriority(TransferPriority);
+
+		int res = _node.start();
+
+		if (res >= 0) {
+			res = _status_pub.init();
+		}
+
+		if (res >= 0) {
+			res = _command_sub.start(CommandCbBinder(this, &EscEmulator::command_cb));
+		}
+
+		if (res < 0) {
+			return res;
+		}
+
+		_node.setModeOperational();
+
+		if (pthread_create(&_thread, nullptr, &EscEmulator::thread_trampoline, this) != 0) {
+			return -1;
+		}
+
+		_running = true;
+		return 0;
+	}
+
+	void stop()
+	{
+		if (_running) {
+			_should_exit = true;
+			pthread_join(_thread, nullptr);
+			_running = false;
+		}
+	}
+
+private:
+	typedef uavcan::MethodBinder<EscEmulator *,
+		void (EscEmulator::*)(const uavcan::ReceivedDataStructure<RawCommand> &)> CommandCbBinder;
+
+	static void *thread_trampoline(void *arg)
+	{
+		EscEmulator *self = static_cast<EscEmulator *>(arg);
+
+		while (!self->_should_exit) {
+			// blocks on the bus event until a command arrives
+			self->_node.spin(uavcan::MonotonicDuration::fromMSec(10));
+		}
+
+		return nullptr;
+	}
+
+	void command_cb(const uavcan::ReceivedDataStructure<RawCommand> &msg)
+	{
+		for (unsigned i = 0; i < msg.cmd.size(); i++) {
+			Status status;
+			status.esc_index = i;
+			status.rpm = msg.cmd[i];
+			(void)_status_pub.broadcast(status);
+		}
+	}
+
+	uavcan_socketcan::CanInitHelper<RxQueueCapacity> _can;
+	uavcan_node::Allocator _allocator;
+	uavcan::Node<> _node;
+	uavcan::Publisher<Status> _status_pub;
+	uavcan::Subscriber<RawCommand, CommandCbBinder> _command_sub;
+
+	int _init_res{0};
+	pthread_t _thread{};
+	bool _running{false};
+	volatile bool _should_exit{false};
+};
+
+/**
+ * Flight controller side: publishes the commands and timestamps the status replies.
+ */
+class EscCommander
+{
+public:
+	EscCommander(uavcan_socketcan::VirtualBus &bus) :
+		_node(_can.driver, uavcan_socketcan::SystemClock::instance(), _allocator),
+		_command_pub(_node),
+		_status_sub(_node)
+	{
+		_init_res = _can.init(bus);
+	}
+
+	int start(uavcan::NodeID node_id)
+	{
+		if (_init_res < 0) {
+			return _init_res;
+		}
+
+		_node.setNodeID(node_id);
+		_node.setName("org.px4.bench_commander");
+		_command_pub.setPriority(TransferPriority);
+
+		int res = _node.start();
+
+		if (res >= 0) {
+			res = _command_pub.init();
+		}
+
+		if (res >= 0) {
+			res = _status_sub.start(StatusCbBinder(this, &EscCommander::status_cb));
+		}
+
+		if (res >= 0) {
+			_node.setModeOperational();
+		}
+
+		return res;
+	}
+
+	/**
+	 * Send one command to num_escs ESCs and spin until the deadline.
+	 * @return round-trip latency in microseconds, or -1 if not all ESCs replied in time
+	 */
+	int64_t cycle(unsigned num_escs, uavcan::MonotonicTime deadline)
+	{
+		RawCommand cmd;
+
+		_sequence = (_sequence + 1) % SequenceRange;
+
+		for (unsigned i = 0; i < num_escs; i++) {
+			cmd.cmd.push_back(int(_sequence));
+		}
+
+		_num_escs = num_escs;
+		_replies = 0;
+		_latency_us = -1;
+		_sent = uavcan_socketcan::clock::getMonotonic();
+
+		if (_command_pub.broadcast(cmd) < 0) {
+			return -1;
+		}
+
+		_node.spin(deadline);
+		return _latency_us;
+	}
+
+private:
+	typedef uavcan::MethodBinder<EscCommander *,
+		void (EscCommander::*)(const uavcan::ReceivedDataStructure<Status> &)> StatusCbBinder;
+
+	void status_cb(const uavcan::ReceivedDataStructure<Status> &msg)
+	{
+		// stale reply to an earlier command, or a duplicate
+		if (msg.rpm != int32_t(_sequence) || msg.esc_index >= _num_escs || (_replies & (1u << msg.esc_index))) {
+			return;
+		}
+
+		_replies |= 1u << msg.esc_index;
+
+		if (_replies == (1u << _num_escs) - 1u) {
+			_latency_us = (uavcan_socketcan::clock::getMonotonic() - _sent).toUSec();
+		}
+	}
+
+	uavcan_socketcan::CanInitHelper<RxQueueCapacity> _can;
+	uavcan_node::Allocator _allocator;
+	uavcan::Node<> _node;
+	uavcan::Publisher<RawCommand> _command_pub;
+	uavcan::Subscriber<Status, StatusCbBinder> _status_sub;
+
+	int _init_res{0};
+	unsigned _num_escs{0};
+	unsigned _sequence{0};
+	uint32_t _replies{0};	///< bit per ESC that answered the current command
+	int64_t _latency_us{-1};
+	uavcan::MonotonicTime _sent;
+};
+
+int compare_float(const void *a, const void *b)
+{
+	const float fa = *static_cast<const float *>(a);
+	const float fb = *static_cast<const float *>(b);
+	return (fa > fb) - (fa < fb);
+}
+
+float percentile(const float *sorted, unsigned num, float fraction)
+{
+	return sorted[(unsigned)(fraction * (num - 1) + 0.5f)];
+}
+
+int run(unsigned rate_hz, unsigned num_escs, unsigned num_cycles)
+{
+	uavcan_socketcan::VirtualBus bus;
+	EscEmulator *escs = new EscEmulator(bus);
+	EscCommander *commander = new EscCommander(bus);
+	float *samples = new float[num_cycles];
+
+	int ret = -1;
+
+	if (escs == nullptr || commander == nullptr || samples == nullptr) {
+		PX4_ERR("alloc failed");
+
+	} else if (commander->start(1) < 0 || escs->start(2) < 0) {
+		PX4_ERR("node start failed");
+
+	} else {
+		const uavcan::MonotonicDuration period = uavcan::MonotonicDuration::fromUSec(1000000 / rate_hz);
+		const uint64_t frames_start = bus.getFrameCount();
+		uavcan::MonotonicTime deadline = uavcan_socketcan::clock::getMonotonic();
+		unsigned num_samples = 0;
+
+		for (unsigned i = 0; i < num_cycles; i++) {
+			deadline = deadline + period;
+			const int64_t latency_us = commander->cycle(num_escs, deadline);
+
+			if (latency_us >= 0) {
+				samples[num_samples++] = (float)latency_us;
+			}
+		}
+
+		const float frames_per_cycle = float(bus.getFrameCount() - frames_start) / num_cycles;
+
+		if (num_samples > 0) {
+			qsort(samples, num_samples, sizeof(float), compare_float);
+
+			PX4_INFO("%u Hz, %u ESCs: %u cycles, %u lost, %.1f frames/cycle", rate_hz, num_escs, num_cycles,
+				 num_cycles - num_samples, (double)frames_per_cycle);
+			PX4_INFO("round trip [us]: min %.0f, p50 %.0f, p90 %.0f, p99 %.0f, max %.0f",
+				 (double)samples[0], (double)percentile(samples, num_samples, 0.5f),
+				 (double)percentile(samples, num_samples, 0.9f), (double)percentile(samples, num_samples, 0.99f),
+				 (double)samples[num_samples - 1]);
+			ret = 0;
+
+		} else {
+			PX4_ERR("%u Hz, %u ESCs: no replies", rate_hz, num_escs);
+		}
+	}
+
+	if (escs) {
+		escs->stop();
+	}
+
+	delete commander;
+	delete escs;
+	delete[] samples;
+
+	return ret;
+}
+
+} // namespace
+
+int uavcan_bench_esc(int argc, char *argv[])
+{
+	unsigned rate_hz = 0;
+	unsigned num_escs = 8;
+	unsigned num_cycles = 2000;
+
+	int myoptind = 1;
+	int ch;
+	const char *myoptarg = nullptr;
+
+	while ((ch = px4_getopt(argc, argv, "r:n:c:", &myoptind, &myoptarg)) != EOF) {
+		switch (ch) {
+		case 'r':
+			rate_hz = strtoul(myoptarg, nullptr, 10);
+			break;
+
+		case 'n':
+			num_escs = strtoul(myoptarg, nullptr, 10);
+			break;
+
+		case 'c':
+			num_cycles = strtoul(myoptarg, nullptr, 10);
+			break;
+
+		default:
+			PX4_INFO("usage: uavcan bench [-r <rate Hz>] [-n <number of ESCs>] [-c <cycles>]");
+			return -1;
+		}
+	}
+
+	if (num_escs < 1 || num_escs > RawCommand::FieldTypes::cmd::MaxSize || num_cycles < 1 || rate_hz > 10000) {
+		PX4_ERR("invalid arguments");
+		return -1;
+	}
+
+	if (rate_hz > 0) {
+		return run(rate_hz, num_escs, num_cycles);
+	}
+
+	// default: the range of typical ESC command rates
+	static constexpr unsigned rates[] = {400, 800};
+	int ret = 0;
+
+	for (unsigned rate : rates) {
+		ret |= run(rate, num_escs, num_cycles);
+	}
+
+	return ret;
+}
@@ -42,6 +42,8 @@
 #  include <uavcan_stm32/uavcan_stm32.hpp>
 #elif defined(UAVCAN_STM32H7_NUTTX)
 #  include <uavcan_stm32h7/uavcan_stm32h7.hpp>
+#elif defined(UAVCAN_SOCKETCAN_POSIX)
+#  include <uavcan_socketcan/uavcan_socketcan.hpp>
 #else
 #  error "Unsupported driver"
 #endif
@@ -0,0 +1,63 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+#pragma once
+
+/**
+ * OS detection
+ */
+#ifndef UAVCAN_SOCKETCAN_POSIX
+# error "Only POSIX (Linux SocketCAN) is supported"
+#endif
+
+/**
+ * Number of interfaces must be enabled explicitly
+ */
+#if !defined(UAVCAN_SOCKETCAN_NUM_IFACES) || (UAVCAN_SOCKETCAN_NUM_IFACES != 1 && UAVCAN_SOCKETCAN_NUM_IFACES != 2)
+# error "UAVCAN_SOCKETCAN_NUM_IFACES must be set to either 1 or 2"
+#endif
+
+/**
+ * Interface i is opened as UAVCAN_SOCKETCAN_IFACE_PREFIX<i>, e.g. can0
+ */
+#ifndef UAVCAN_SOCKETCAN_IFACE_PREFIX
+# define UAVCAN_SOCKETCAN_IFACE_PREFIX "can"
+#endif
+
+/**
+ * Maximum number of frames read (recvmmsg) or written (sendmmsg) with a single system call
+ */
+#ifndef UAVCAN_SOCKETCAN_BATCH_SIZE
+# define UAVCAN_SOCKETCAN_BATCH_SIZE 16
+#endif
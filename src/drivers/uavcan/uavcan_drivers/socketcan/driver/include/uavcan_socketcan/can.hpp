@@ -0,0 +1,383 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+#pragma once
+
+#include <uavcan_socketcan/build_config.hpp>
+#include <uavcan_socketcan/thread.hpp>
+#include <uavcan/driver/can.hpp>
+
+#include <atomic>
+
+namespace uavcan_socketcan
+{
+/**
+ * Driver error codes.
+ * These values can be returned from driver functions negated.
+ */
+static const uavcan::int16_t ErrNotImplemented          = 1001; ///< Feature not implemented
+static const uavcan::int16_t ErrLogic                   = 1003; ///< Internal logic error
+static const uavcan::int16_t ErrUnsupportedFrame        = 1004; ///< Frame not supported (e.g. RTR, CAN FD, etc)
+static const uavcan::int16_t ErrFilterNumConfigs        = 1008; ///< Number of filters is more than supported
+static const uavcan::int16_t ErrSocket                  = 1010; ///< Socket operation failed, see errno
+static const uavcan::int16_t ErrVirtualBusFull          = 1011; ///< No free member slot on the virtual bus
+
+class VirtualBus;
+
+/**
+ * RX queue item.
+ * The application shall not use this directly.
+ */
+struct CanRxItem {
+	uavcan::uint64_t utc_usec;
+	uavcan::CanFrame frame;
+	uavcan::CanIOFlags flags;
+	CanRxItem()
+		: utc_usec(0)
+		, flags(0)
+	{ }
+};
+
+/**
+ * Single CAN iface, either a SocketCAN socket or a member of a @ref VirtualBus.
+ * The application shall not use this directly.
+ *
+ * Received frames are read in batches (recvmmsg) by the RX thread of the @ref CanDriver into the
+ * RX queue. Frames to send are queued and written in batches (sendmmsg) once a transfer is complete,
+ * the queue is full or on select().
+ */
+class CanIface : public uavcan::ICanIface, uavcan::Noncopyable
+{
+	class RxQueue
+	{
+		CanRxItem *const buf_;
+		const uavcan::uint8_t capacity_;
+		uavcan::uint8_t in_;
+		uavcan::uint8_t out_;
+		uavcan::uint8_t len_;
+		uavcan::uint32_t overflow_cnt_;
+
+		void registerOverflow();
+
+	public:
+		RxQueue(CanRxItem *buf, uavcan::uint8_t capacity)
+			: buf_(buf)
+			, capacity_(capacity)
+			, in_(0)
+			, out_(0)
+			, len_(0)
+			, overflow_cnt_(0)
+		{ }
+
+		void push(const uavcan::CanFrame &frame, const uint64_t &utc_usec, uavcan::CanIOFlags flags);
+		void pop(uavcan::CanFrame &out_frame, uavcan::uint64_t &out_utc_usec, uavcan::CanIOFlags &out_flags);
+
+		void reset();
+
+		unsigned getLength() const { return len_; }
+
+		uavcan::uint32_t getOverflowCount() const { return overflow_cnt_; }
+	};
+
+	struct TxItem {
+		uavcan::MonotonicTime deadline;
+		uavcan::CanFrame frame;
+		uavcan::CanIOFlags flags;
+
+		TxItem()
+			: flags(0)
+		{ }
+	};
+
+	enum { TxQueueCapacity = UAVCAN_SOCKETCAN_BATCH_SIZE };
+	enum { NumFilters = 32 };
+
+	RxQueue rx_queue_;
+	mutable Mutex mutex_;                   ///< protects the RX queue and the statistics, shared with the RX thread
+	TxItem tx_queue_[TxQueueCapacity];
+	uavcan::uint8_t tx_len_;
+	std::atomic<bool> tx_pending_;          ///< frames are waiting for socket buffer space
+	int fd_;
+	VirtualBus *vbus_;
+	BusEvent &update_event_;
+	uavcan::uint64_t error_cnt_;
+	uavcan::uint32_t tx_timeout_cnt_;
+	uavcan::uint64_t rx_frames_;
+	uavcan::uint64_t rx_batches_;
+	uavcan::uint64_t tx_frames_;
+	uavcan::uint64_t tx_batches_;
+	const uavcan::uint8_t self_index_;
+	bool had_activity_;
+
+	virtual uavcan::int16_t send(const uavcan::CanFrame &frame, uavcan::MonotonicTime tx_deadline,
+				     uavcan::CanIOFlags flags);
+
+	virtual uavcan::int16_t receive(uavcan::CanFrame &out_frame, uavcan::MonotonicTime &out_ts_monotonic,
+					uavcan::UtcTime &out_ts_utc, uavcan::CanIOFlags &out_flags);
+
+	virtual uavcan::int16_t configureFilters(const uavcan::CanFilterConfig *filter_configs,
+			uavcan::uint16_t num_configs);
+
+	virtual uavcan::uint16_t getNumFilters() const { return NumFilters; }
+
+	void pushRx(const uavcan::CanFrame &frame, uavcan::uint64_t utc_usec, uavcan::CanIOFlags flags);
+
+public:
+	enum { MaxRxQueueCapacity = 254 };
+
+	CanIface(BusEvent &update_event, uavcan::uint8_t self_index,
+		 CanRxItem *rx_queue_buffer, uavcan::uint8_t rx_queue_capacity)
+		: rx_queue_(rx_queue_buffer, rx_queue_capacity)
+		, tx_len_(0)
+		, tx_pending_(false)
+		, fd_(-1)
+		, vbus_(UAVCAN_NULLPTR)
+		, update_event_(update_event)
+		, error_cnt_(0)
+		, tx_timeout_cnt_(0)
+		, rx_frames_(0)
+		, rx_batches_(0)
+		, tx_frames_(0)
+		, tx_batches_(0)
+		, self_index_(self_index)
+		, had_activity_(false)
+	{
+		UAVCAN_ASSERT(self_index_ < UAVCAN_SOCKETCAN_NUM_IFACES);
+	}
+
+	virtual ~CanIface() { deinit(); }
+
+	/**
+	 * Opens and binds a raw SocketCAN socket. The bit rate is configured by the OS (ip link).
+	 * @return negative Err* on error
+	 */
+	int init(const char *iface_name);
+
+	/**
+	 * Joins the in-process virtual bus instead of a socket.
+	 * @return negative Err* on error
+	 */
+	int init(VirtualBus &bus);
+
+	void deinit();
+
+	bool isOpen() const { return fd_ >= 0 || vbus_ != UAVCAN_NULLPTR; }
+
+	int getFd() const { return fd_; }
+
+	/**
+	 * Reads all frames available on the socket into the RX queue, in batches.
+	 * Called from the RX thread.
+	 * @return number of frames read, negative Err* on error
+	 */
+	int readSocket();
+
+	/**
+	 * Reads and counts the pending socket error, which clears POLLERR.
+	 * Called from the RX thread.
+	 */
+	void clearSocketError();
+
+	/**
+	 * Writes the queued frames with one sendmmsg() call, after dropping the timed out ones.
+	 * Frames that do not fit into the socket buffer stay queued.
+	 */
+	void flushTx(uavcan::MonotonicTime current_time);
+
+	/**
+	 * Delivery of a frame sent by another member of the virtual bus.
+	 */
+	void receiveFromVirtualBus(const uavcan::CanFrame &frame, uavcan::uint64_t utc_usec);
+
+	bool hasPendingTx() const { return tx_pending_.load(); }
+
+	bool canAcceptNewTxFrame() const { return tx_len_ < TxQueueCapacity; }
+	bool isRxBufferEmpty() const;
+
+	/**
+	 * Number of RX frames lost due to queue overflow.
+	 */
+	uavcan::uint32_t getRxQueueOverflowCount() const;
+
+	/**
+	 * Total number of socket errors, error frames, dropped TX frames and RX queue overruns.
+	 */
+	virtual uavcan::uint64_t getErrorCount() const;
+
+	/**
+	 * Returns the number of frames pending in the RX queue.
+	 * This is intended for debug use only.
+	 */
+	unsigned getRxQueueLength() const;
+
+	/**
+	 * Average number of frames per recvmmsg() and sendmmsg() call.
+	 * This is intended for debug use only.
+	 */
+	float getRxFramesPerBatch() const;
+	float getTxFramesPerBatch() const;
+
+	/**
+	 * Whether this iface had at least one successful IO since the previous call of this method.
+	 * This is designed for use with iface activity LEDs.
+	 */
+	bool hadActivity();
+};
+
+/**
+ * CAN driver, incorporates all available CAN ifaces.
+ * Please avoid direct use, prefer @ref CanInitHelper instead.
+ *
+ * A dedicated RX thread waits on the sockets and signals the @ref BusEvent as soon as frames
+ * arrive, so that the application can spin the node on reception instead of polling.
+ */
+class CanDriver : public uavcan::ICanDriver, uavcan::Noncopyable
+{
+	BusEvent update_event_;
+	CanIface if0_;
+#if UAVCAN_SOCKETCAN_NUM_IFACES > 1
+	CanIface if1_;
+#endif
+	uavcan::uint8_t num_ifaces_;
+
+	pthread_t rx_thread_;
+	bool rx_thread_running_;
+	std::atomic<bool> rx_thread_should_exit_;
+
+	virtual uavcan::int16_t select(uavcan::CanSelectMasks &inout_masks,
+				       const uavcan::CanFrame * (& pending_tx)[uavcan::MaxCanIfaces],
+				       uavcan::MonotonicTime blocking_deadline);
+
+	static void *rxThreadTrampoline(void *arg);
+	void rxThreadMain();
+
+	CanIface &ifaceAt(uavcan::uint8_t iface_index);
+	const CanIface &ifaceAt(uavcan::uint8_t iface_index) const;
+
+public:
+	template <unsigned RxQueueCapacity>
+	CanDriver(CanRxItem(&rx_queue_storage)[UAVCAN_SOCKETCAN_NUM_IFACES][RxQueueCapacity])
+		: update_event_(*this)
+		, if0_(update_event_, 0, rx_queue_storage[0], RxQueueCapacity)
+#if UAVCAN_SOCKETCAN_NUM_IFACES > 1
+		, if1_(update_event_, 1, rx_queue_storage[1], RxQueueCapacity)
+#endif
+		, num_ifaces_(0)
+		, rx_thread_()
+		, rx_thread_running_(false)
+		, rx_thread_should_exit_(false)
+	{
+		uavcan::StaticAssert < (RxQueueCapacity <= CanIface::MaxRxQueueCapacity) >::check();
+	}
+
+	virtual ~CanDriver() { deinit(); }
+
+	/**
+	 * Opens the enabled SocketCAN interfaces (UAVCAN_SOCKETCAN_IFACE_PREFIX<index>) and starts the RX thread.
+	 * Interfaces after the first one that cannot be opened are ignored.
+	 * Returns zero if OK.
+	 * Returns negative value if failed.
+	 */
+	int init(const uavcan::uint32_t enabled_interfaces);
+
+	/**
+	 * Attaches a single iface to the virtual bus. No RX thread is needed, the senders deliver
+	 * frames directly.
+	 */
+	int init(VirtualBus &bus);
+
+	void deinit();
+
+	/**
+	 * This function returns select masks indicating which interfaces are available for read/write.
+	 */
+	uavcan::CanSelectMasks makeSelectMasks(const uavcan::CanFrame * (& pending_tx)[uavcan::MaxCanIfaces]) const;
+
+	/**
+	 * Whether there's at least one interface where receive() would return a frame.
+	 */
+	bool hasReadableInterfaces() const;
+
+	virtual CanIface *getIface(uavcan::uint8_t iface_index);
+
+	virtual uavcan::uint8_t getNumIfaces() const { return num_ifaces_; }
+
+	/**
+	 * Whether at least one iface had at least one successful IO since previous call of this method.
+	 * This is designed for use with iface activity LEDs.
+	 */
+	bool hadActivity();
+
+	BusEvent &updateEvent() { return update_event_; }
+};
+
+/**
+ * Helper class.
+ * Normally only this class should be used by the application.
+ */
+template <unsigned RxQueueCapacity = 128>
+class CanInitHelper
+{
+	CanRxItem queue_storage_[UAVCAN_SOCKETCAN_NUM_IFACES][RxQueueCapacity];
+
+public:
+	CanDriver driver;
+	uint32_t enabledInterfaces_;
+
+	CanInitHelper(const uavcan::uint32_t EnabledInterfaces = 0x7) :
+		driver(queue_storage_),
+		enabledInterfaces_(EnabledInterfaces)
+	{ }
+
+	/**
+	 * The bit rate of a SocketCAN interface is set by the OS, the argument is accepted for
+	 * compatibility with the MCU drivers only.
+	 * @return  Negative value on error; non-negative on success. Refer to constants Err*.
+	 */
+	int init(uavcan::uint32_t bitrate)
+	{
+		(void)bitrate;
+		return driver.init(enabledInterfaces_);
+	}
+
+	/**
+	 * Joins the in-process virtual bus instead of the SocketCAN interfaces.
+	 */
+	int init(VirtualBus &bus)
+	{
+		return driver.init(bus);
+	}
+};
+
+}
@@ -0,0 +1,98 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+#pragma once
+
+#include <uavcan_socketcan/build_config.hpp>
+#include <uavcan/driver/system_clock.hpp>
+
+namespace uavcan_socketcan
+{
+
+namespace clock
+{
+/**
+ * Returns current monotonic time (CLOCK_MONOTONIC).
+ * This function is thread safe.
+ */
+uavcan::MonotonicTime getMonotonic();
+
+/**
+ * Sets the driver's notion of the system UTC.
+ * This function is thread safe.
+ */
+void setUtc(uavcan::UtcTime time);
+
+/**
+ * Returns UTC time if it has been set, otherwise returns zero time.
+ * This function is thread safe.
+ */
+uavcan::UtcTime getUtc();
+
+/**
+ * Shifts the UTC time by the adjustment. In contrast to the MCU drivers there is no rate
+ * correction: the host clock is expected to be disciplined by the OS.
+ * The UTC time will be zero until first adjustment has been performed.
+ * This function is thread safe.
+ */
+void adjustUtc(uavcan::UtcDuration adjustment);
+
+/**
+ * Number of UTC adjustments performed so far.
+ * This function is thread safe.
+ */
+uavcan::uint32_t getUtcJumpCount();
+
+}
+
+/**
+ * Adapter for uavcan::ISystemClock.
+ */
+class SystemClock : public uavcan::ISystemClock, uavcan::Noncopyable
+{
+	SystemClock() { }
+
+	virtual void adjustUtc(uavcan::UtcDuration adjustment) { clock::adjustUtc(adjustment); }
+
+public:
+	virtual uavcan::MonotonicTime getMonotonic() const { return clock::getMonotonic(); }
+	virtual uavcan::UtcTime getUtc()             const { return clock::getUtc(); }
+
+	/**
+	 * This function is thread safe.
+	 */
+	static SystemClock &instance();
+};
+
+}
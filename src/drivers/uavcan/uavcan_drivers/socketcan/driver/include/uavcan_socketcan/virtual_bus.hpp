@@ -0,0 +1,82 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+#pragma once
+
+#include <uavcan_socketcan/build_config.hpp>
+#include <uavcan_socketcan/thread.hpp>
+#include <uavcan/driver/can.hpp>
+
+namespace uavcan_socketcan
+{
+
+class CanIface;
+
+/**
+ * In-process CAN bus: a frame sent by one member is delivered to the RX queues of all other
+ * members, in the context of the sender. It is a stand-in for a physical bus, e.g. to run
+ * several nodes in one process for testing and benchmarking.
+ */
+class VirtualBus : uavcan::Noncopyable
+{
+public:
+	enum { MaxMembers = 16 };
+
+	VirtualBus()
+		: num_members_(0)
+		, num_frames_(0)
+	{ }
+
+	/**
+	 * @return negative Err* if the bus is full
+	 */
+	int attach(CanIface &iface);
+
+	void detach(CanIface &iface);
+
+	/**
+	 * Delivers a frame to all members except the sender.
+	 */
+	void broadcast(const CanIface &sender, const uavcan::CanFrame &frame);
+
+	uavcan::uint64_t getFrameCount() const;
+
+private:
+	CanIface *members_[MaxMembers];
+	unsigned num_members_;
+	uavcan::uint64_t num_frames_;
+	mutable Mutex mutex_;
+};
+
+}
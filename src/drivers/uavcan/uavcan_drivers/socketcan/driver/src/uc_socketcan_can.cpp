@@ -0,0 +1,860 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+#include <uavcan_socketcan/can.hpp>
+#include <uavcan_socketcan/clock.hpp>
+#include <uavcan_socketcan/virtual_bus.hpp>
+#include "internal.hpp"
+
+#include <errno.h>
+#include <poll.h>
+#include <string.h>
+#include <unistd.h>
+#include <net/if.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <linux/can.h>
+#include <linux/can/error.h>
+#include <linux/can/raw.h>
+
+namespace uavcan_socketcan
+{
+namespace
+{
+
+/**
+ * UAVCAN tail byte: the last data byte of each frame, bit 6 is set in the last frame of a transfer
+ */
+bool isEndOfTransfer(const uavcan::CanFrame &frame)
+{
+	return frame.dlc > 0 && (frame.data[frame.dlc - 1] & (1U << 6)) != 0;
+}
+
+/*
+ * The EFF/RTR/ERR flags of uavcan::CanFrame and struct can_frame are at the same bit positions
+ */
+void toSocketCanFrame(const uavcan::CanFrame &frame, can_frame &out)
+{
+	memset(&out, 0, sizeof(out));
+	out.can_id = frame.id;
+	out.can_dlc = frame.dlc;
+	memcpy(out.data, frame.data, frame.dlc);
+}
+
+uavcan::CanFrame fromSocketCanFrame(const can_frame &frame)
+{
+	const uavcan::uint8_t dlc = frame.can_dlc > 8 ? 8 : frame.can_dlc;
+	return uavcan::CanFrame(frame.can_id, frame.data, dlc);
+}
+
+}
+
+/*
+ * CanIface::RxQueue
+ */
+void CanIface::RxQueue::registerOverflow()
+{
+	if (overflow_cnt_ < 0xFFFFFFFF) {
+		overflow_cnt_++;
+	}
+}
+
+void CanIface::RxQueue::push(const uavcan::CanFrame &frame, const uint64_t &utc_usec, uavcan::CanIOFlags flags)
+{
+	buf_[in_].frame    = frame;
+	buf_[in_].utc_usec = utc_usec;
+	buf_[in_].flags    = flags;
+	in_++;
+
+	if (in_ >= capacity_) {
+		in_ = 0;
+	}
+
+	len_++;
+
+	if (len_ > capacity_) {
+		len_ = capacity_;
+		registerOverflow();
+		out_++;
+
+		if (out_ >= capacity_) {
+			out_ = 0;
+		}
+	}
+}
+
+void CanIface::RxQueue::pop(uavcan::CanFrame &out_frame, uavcan::uint64_t &out_utc_usec, uavcan::CanIOFlags &out_flags)
+{
+	if (len_ > 0) {
+		out_frame    = buf_[out_].frame;
+		out_utc_usec = buf_[out_].utc_usec;
+		out_flags    = buf_[out_].flags;
+		out_++;
+
+		if (out_ >= capacity_) {
+			out_ = 0;
+		}
+
+		len_--;
+
+	} else { UAVCAN_ASSERT(0); }
+}
+
+void CanIface::RxQueue::reset()
+{
+	in_ = 0;
+	out_ = 0;
+	len_ = 0;
+	overflow_cnt_ = 0;
+}
+
+/*
+ * CanIface
+ */
+int CanIface::init(const char *iface_name)
+{
+	deinit();
+
+	const int fd = socket(PF_CAN, SOCK_RAW | SOCK_NONBLOCK | SOCK_CLOEXEC, CAN_RAW);
+
+	if (fd < 0) {
+		return -ErrSocket;
+	}
+
+	ifreq ifr;
+	memset(&ifr, 0, sizeof(ifr));
+	strncpy(ifr.ifr_name, iface_name, IFNAMSIZ - 1);
+
+	if (ioctl(fd, SIOCGIFINDEX, &ifr) < 0) {
+		close(fd);
+		return -ErrSocket;
+	}
+
+	sockaddr_can addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.can_family = AF_CAN;
+	addr.can_ifindex = ifr.ifr_ifindex;
+
+	// error frames are counted, not passed to the library
+	const can_err_mask_t err_mask = CAN_ERR_TX_TIMEOUT | CAN_ERR_CRTL | CAN_ERR_BUSOFF | CAN_ERR_BUSERROR;
+
+	if (setsockopt(fd, SOL_CAN_RAW, CAN_RAW_ERR_FILTER, &err_mask, sizeof(err_mask)) < 0 ||
+	    bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0) {
+		close(fd);
+		return -ErrSocket;
+	}
+
+	{
+		MutexLocker lock(mutex_);
+		rx_queue_.reset();
+	}
+
+	tx_len_ = 0;
+	fd_ = fd;
+
+	UAVCAN_SOCKETCAN_LOG("iface %d: %s opened", int(self_index_), iface_name);
+	return 0;
+}
+
+int CanIface::init(VirtualBus &bus)
+{
+	deinit();
+
+	{
+		MutexLocker lock(mutex_);
+		rx_queue_.reset();
+	}
+
+	const int res = bus.attach(*this);
+
+	if (res < 0) {
+		return res;
+	}
+
+	vbus_ = &bus;
+	return 0;
+}
+
+void CanIface::deinit()
+{
+	if (fd_ >= 0) {
+		close(fd_);
+		fd_ = -1;
+	}
+
+	if (vbus_ != UAVCAN_NULLPTR) {
+		vbus_->detach(*this);
+		vbus_ = UAVCAN_NULLPTR;
+	}
+
+	tx_len_ = 0;
+	tx_pending_.store(false);
+}
+
+void CanIface::pushRx(const uavcan::CanFrame &frame, uavcan::uint64_t utc_usec, uavcan::CanIOFlags flags)
+{
+	MutexLocker lock(mutex_);
+	rx_queue_.push(frame, utc_usec, flags);
+	had_activity_ = true;
+}
+
+uavcan::int16_t CanIface::send(const uavcan::CanFrame &frame, uavcan::MonotonicTime tx_deadline,
+			       uavcan::CanIOFlags flags)
+{
+	if (frame.isErrorFrame() || frame.dlc > 8) {
+		return -ErrUnsupportedFrame;
+	}
+
+	if (vbus_ != UAVCAN_NULLPTR) {
+		vbus_->broadcast(*this, frame);
+
+		if (flags & uavcan::CanIOFlagLoopback) {
+			pushRx(frame, clock::getUtc().toUSec(), uavcan::CanIOFlagLoopback);
+		}
+
+		return 1;
+	}
+
+	if (fd_ < 0) {
+		return -ErrSocket;
+	}
+
+	if (tx_len_ >= TxQueueCapacity) {
+		return 0;
+	}
+
+	TxItem &txi = tx_queue_[tx_len_++];
+	txi.deadline = tx_deadline;
+	txi.frame    = frame;
+	txi.flags    = flags;
+
+	/*
+	 * The frames of a multi-frame transfer are collected and written together. The library
+	 * hands over the frames of a transfer back to back, so a transfer never waits for the
+	 * next select() call.
+	 */
+	if (isEndOfTransfer(frame) || tx_len_ >= TxQueueCapacity) {
+		flushTx(clock::getMonotonic());
+	}
+
+	return 1;
+}
+
+void CanIface::flushTx(uavcan::MonotonicTime current_time)
+{
+	if (fd_ < 0 || tx_len_ == 0) {
+		return;
+	}
+
+	// drop the timed out frames first
+	uavcan::uint8_t len = 0;
+	uavcan::uint32_t timed_out = 0;
+
+	for (uavcan::uint8_t i = 0; i < tx_len_; i++) {
+		if (tx_queue_[i].deadline < current_time) {
+			timed_out++;
+
+		} else {
+			if (len != i) {
+				tx_queue_[len] = tx_queue_[i];
+			}
+
+			len++;
+		}
+	}
+
+	tx_len_ = len;
+
+	can_frame frames[TxQueueCapacity];
+	iovec iovs[TxQueueCapacity];
+	mmsghdr msgs[TxQueueCapacity];
+	memset(msgs, 0, sizeof(msgs));
+
+	for (uavcan::uint8_t i = 0; i < tx_len_; i++) {
+		toSocketCanFrame(tx_queue_[i].frame, frames[i]);
+		iovs[i].iov_base = &frames[i];
+		iovs[i].iov_len = sizeof(can_frame);
+		msgs[i].msg_hdr.msg_iov = &iovs[i];
+		msgs[i].msg_hdr.msg_iovlen = 1;
+	}
+
+	int sent = 0;
+
+	if (tx_len_ > 0) {
+		sent = sendmmsg(fd_, msgs, tx_len_, MSG_DONTWAIT);
+
+		if (sent < 0) {
+			// ENOBUFS/EAGAIN: the socket buffer is full, retry on the next flush
+			const bool buffer_full = (errno == ENOBUFS || errno == EAGAIN || errno == EWOULDBLOCK);
+			sent = 0;
+
+			if (!buffer_full) {
+				// the frames cannot be sent at all (e.g. interface down)
+				MutexLocker lock(mutex_);
+				error_cnt_ += tx_len_;
+				tx_len_ = 0;
+			}
+		}
+	}
+
+	const uavcan::uint64_t utc_usec = clock::getUtc().toUSec();
+
+	for (int i = 0; i < sent; i++) {
+		if (tx_queue_[i].flags & uavcan::CanIOFlagLoopback) {
+			pushRx(tx_queue_[i].frame, utc_usec, uavcan::CanIOFlagLoopback);
+		}
+	}
+
+	{
+		MutexLocker lock(mutex_);
+		tx_timeout_cnt_ += timed_out;
+
+		if (sent > 0) {
+			tx_frames_ += sent;
+			tx_batches_++;
+			had_activity_ = true;
+		}
+	}
+
+	// keep the frames that did not fit into the socket buffer, in order
+	for (uavcan::uint8_t i = sent; i < tx_len_; i++) {
+		tx_queue_[i - sent] = tx_queue_[i];
+	}
+
+	tx_len_ -= sent;
+	tx_pending_.store(tx_len_ > 0);
+}
+
+int CanIface::readSocket()
+{
+	if (fd_ < 0) {
+		return -ErrSocket;
+	}
+
+	enum { BatchSize = UAVCAN_SOCKETCAN_BATCH_SIZE };
+
+	can_frame frames[BatchSize];
+	iovec iovs[BatchSize];
+	mmsghdr msgs[BatchSize];
+	int total = 0;
+
+	for (;;) {
+		memset(msgs, 0, sizeof(msgs));
+
+		for (unsigned i = 0; i < BatchSize; i++) {
+			iovs[i].iov_base = &frames[i];
+			iovs[i].iov_len = sizeof(can_frame);
+			msgs[i].msg_hdr.msg_iov = &iovs[i];
+			msgs[i].msg_hdr.msg_iovlen = 1;
+		}
+
+		const int received = recvmmsg(fd_, msgs, BatchSize, MSG_DONTWAIT, UAVCAN_NULLPTR);
+
+		if (received <= 0) {
+			if (received < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+				MutexLocker lock(mutex_);
+				error_cnt_++;
+				return -ErrSocket;
+			}
+
+			break;
+		}
+
+		const uavcan::uint64_t utc_usec = clock::getUtc().toUSec();
+
+		MutexLocker lock(mutex_);
+
+		for (int i = 0; i < received; i++) {
+			if (msgs[i].msg_len < sizeof(can_frame)) {
+				continue;
+			}
+
+			if (frames[i].can_id & CAN_ERR_FLAG) {
+				error_cnt_++;
+				continue;
+			}
+
+			rx_queue_.push(fromSocketCanFrame(frames[i]), utc_usec, 0);
+		}
+
+		rx_frames_ += received;
+		rx_batches_++;
+		had_activity_ = true;
+		total += received;
+
+		if (received < BatchSize) {
+			break;
+		}
+	}
+
+	return total;
+}
+
+void CanIface::clearSocketError()
+{
+	if (fd_ < 0) {
+		return;
+	}
+
+	// reading SO_ERROR clears the pending error, which is what keeps POLLERR set
+	int err = 0;
+	socklen_t len = sizeof(err);
+	(void)getsockopt(fd_, SOL_SOCKET, SO_ERROR, &err, &len);
+
+	MutexLocker lock(mutex_);
+	error_cnt_++;
+}
+
+void CanIface::receiveFromVirtualBus(const uavcan::CanFrame &frame, uavcan::uint64_t utc_usec)
+{
+	{
+		MutexLocker lock(mutex_);
+		rx_queue_.push(frame, utc_usec, 0);
+		rx_frames_++;
+		rx_batches_++;
+		had_activity_ = true;
+	}
+
+	update_event_.signal();
+}
+
+uavcan::int16_t CanIface::receive(uavcan::CanFrame &out_frame, uavcan::MonotonicTime &out_ts_monotonic,
+				  uavcan::UtcTime &out_ts_utc, uavcan::CanIOFlags &out_flags)
+{
+	out_ts_monotonic = clock::getMonotonic();  // High precision is not required for monotonic timestamps
+	uavcan::uint64_t utc_usec = 0;
+	{
+		MutexLocker lock(mutex_);
+
+		if (rx_queue_.getLength() == 0) {
+			return 0;
+		}
+
+		rx_queue_.pop(out_frame, utc_usec, out_flags);
+	}
+	out_ts_utc = uavcan::UtcTime::fromUSec(utc_usec);
+	return 1;
+}
+
+uavcan::int16_t CanIface::configureFilters(const uavcan::CanFilterConfig *filter_configs,
+		uavcan::uint16_t num_configs)
+{
+	if (num_configs > NumFilters) {
+		return -ErrFilterNumConfigs;
+	}
+
+	if (fd_ < 0) {
+		// the virtual bus delivers all frames, the library filters them in software
+		return 0;
+	}
+
+	can_filter filters[NumFilters];
+
+	for (uavcan::uint16_t i = 0; i < num_configs; i++) {
+		filters[i].can_id = filter_configs[i].id;
+		filters[i].can_mask = filter_configs[i].mask;
+	}
+
+	// no configs: accept everything (the default filter of a raw socket)
+	if (num_configs == 0) {
+		filters[0].can_id = 0;
+		filters[0].can_mask = 0;
+		num_configs = 1;
+	}
+
+	if (setsockopt(fd_, SOL_CAN_RAW, CAN_RAW_FILTER, filters, num_configs * sizeof(can_filter)) < 0) {
+		return -ErrSocket;
+	}
+
+	return 0;
+}
+
+bool CanIface::isRxBufferEmpty() const
+{
+	MutexLocker lock(mutex_);
+	return rx_queue_.getLength() == 0;
+}
+
+uavcan::uint32_t CanIface::getRxQueueOverflowCount() const
+{
+	MutexLocker lock(mutex_);
+	return rx_queue_.getOverflowCount();
+}
+
+uavcan::uint64_t CanIface::getErrorCount() const
+{
+	MutexLocker lock(mutex_);
+	return error_cnt_ + tx_timeout_cnt_ + rx_queue_.getOverflowCount();
+}
+
+unsigned CanIface::getRxQueueLength() const
+{
+	MutexLocker lock(mutex_);
+	return rx_queue_.getLength();
+}
+
+float CanIface::getRxFramesPerBatch() const
+{
+	MutexLocker lock(mutex_);
+	return rx_batches_ > 0 ? float(rx_frames_) / float(rx_batches_) : 0.F;
+}
+
+float CanIface::getTxFramesPerBatch() const
+{
+	MutexLocker lock(mutex_);
+	return tx_batches_ > 0 ? float(tx_frames_) / float(tx_batches_) : 0.F;
+}
+
+bool CanIface::hadActivity()
+{
+	MutexLocker lock(mutex_);
+	const bool ret = had_activity_;
+	had_activity_ = false;
+	return ret;
+}
+
+/*
+ * VirtualBus
+ */
+int VirtualBus::attach(CanIface &iface)
+{
+	MutexLocker lock(mutex_);
+
+	if (num_members_ >= MaxMembers) {
+		return -ErrVirtualBusFull;
+	}
+
+	members_[num_members_++] = &iface;
+	return 0;
+}
+
+void VirtualBus::detach(CanIface &iface)
+{
+	MutexLocker lock(mutex_);
+
+	for (unsigned i = 0; i < num_members_; i++) {
+		if (members_[i] == &iface) {
+			members_[i] = members_[--num_members_];
+			break;
+		}
+	}
+}
+
+void VirtualBus::broadcast(const CanIface &sender, const uavcan::CanFrame &frame)
+{
+	const uavcan::uint64_t utc_usec = clock::getUtc().toUSec();
+
+	MutexLocker lock(mutex_);
+
+	for (unsigned i = 0; i < num_members_; i++) {
+		if (members_[i] != &sender) {
+			members_[i]->receiveFromVirtualBus(frame, utc_usec);
+		}
+	}
+
+	num_frames_++;
+}
+
+uavcan::uint64_t VirtualBus::getFrameCount() const
+{
+	MutexLocker lock(mutex_);
+	return num_frames_;
+}
+
+/*
+ * CanDriver
+ */
+uavcan::CanSelectMasks CanDriver::makeSelectMasks(const uavcan::CanFrame * (& pending_tx)[uavcan::MaxCanIfaces]) const
+{
+	uavcan::CanSelectMasks msk;
+
+	for (uavcan::uint8_t i = 0; i < num_ifaces_; i++) {
+		const CanIface &iface = ifaceAt(i);
+
+		if (!iface.isRxBufferEmpty()) {
+			msk.read |= 1 << i;
+		}
+
+		if (pending_tx[i] != UAVCAN_NULLPTR && iface.canAcceptNewTxFrame()) {
+			msk.write |= 1 << i;
+		}
+	}
+
+	return msk;
+}
+
+bool CanDriver::hasReadableInterfaces() const
+{
+	for (uavcan::uint8_t i = 0; i < num_ifaces_; i++) {
+		if (!ifaceAt(i).isRxBufferEmpty()) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+uavcan::int16_t CanDriver::select(uavcan::CanSelectMasks &inout_masks,
+				  const uavcan::CanFrame * (& pending_tx)[uavcan::MaxCanIfaces],
+				  const uavcan::MonotonicTime blocking_deadline)
+{
+	const uavcan::CanSelectMasks in_masks = inout_masks;
+	const uavcan::MonotonicTime time = clock::getMonotonic();
+
+	for (uavcan::uint8_t i = 0; i < num_ifaces_; i++) {
+		ifaceAt(i).flushTx(time);                     // Write what is left over and drop timed out frames
+	}
+
+	inout_masks = makeSelectMasks(pending_tx);          // Check if we already have some of the requested events
+
+	if ((inout_masks.read  & in_masks.read)  != 0 ||
+	    (inout_masks.write & in_masks.write) != 0) {
+		return 1;
+	}
+
+	(void)update_event_.wait(blocking_deadline - time); // Block until timeout expires or any iface updates
+	inout_masks = makeSelectMasks(pending_tx);  // Return what we got even if none of the requested events are set
+	return 1;                                   // Return value doesn't matter as long as it is non-negative
+}
+
+void *CanDriver::rxThreadTrampoline(void *arg)
+{
+	static_cast<CanDriver *>(arg)->rxThreadMain();
+	return UAVCAN_NULLPTR;
+}
+
+void CanDriver::rxThreadMain()
+{
+	/*
+	 * An iface that keeps reporting errors (e.g. the interface is down) is left out of poll() for
+	 * an increasing time after ErrorStreakLimit consecutive errors, otherwise poll() returns
+	 * immediately and the thread spins.
+	 */
+	enum { ErrorStreakLimit = 10 };
+	enum { BackoffMinMs = 10 };
+	enum { BackoffMaxMs = 1000 };
+
+	pollfd fds[UAVCAN_SOCKETCAN_NUM_IFACES];
+	unsigned error_streak[UAVCAN_SOCKETCAN_NUM_IFACES] = {};
+	uavcan::MonotonicTime muted_until[UAVCAN_SOCKETCAN_NUM_IFACES];
+
+	while (!rx_thread_should_exit_.load()) {
+		const uavcan::MonotonicTime now = clock::getMonotonic();
+		bool tx_pending = false;
+		bool muted = false;
+
+		for (uavcan::uint8_t i = 0; i < num_ifaces_; i++) {
+			fds[i].fd = ifaceAt(i).getFd();
+			fds[i].events = POLLIN;
+			fds[i].revents = 0;
+
+			if (now < muted_until[i]) {
+				fds[i].fd = -1; // ignored by poll()
+				muted = true;
+				continue;
+			}
+
+			if (ifaceAt(i).hasPendingTx()) {
+				// wake up the application as soon as there is space in the socket buffer again
+				fds[i].events |= POLLOUT;
+				tx_pending = true;
+			}
+		}
+
+		// the timeout only bounds the reaction time to a TX backlog, to the end of a backoff and to deinit()
+		const int ret = poll(fds, num_ifaces_, tx_pending ? 1 : (muted ? BackoffMinMs : 100));
+
+		if (ret <= 0) {
+			continue;
+		}
+
+		bool signal = false;
+
+		for (uavcan::uint8_t i = 0; i < num_ifaces_; i++) {
+			bool error = (fds[i].revents & (POLLERR | POLLHUP | POLLNVAL)) != 0;
+
+			if (fds[i].revents & POLLIN) {
+				const int res = ifaceAt(i).readSocket();
+				signal |= res > 0;
+				error |= res < 0;
+			}
+
+			if (fds[i].revents & (POLLOUT | POLLERR)) {
+				signal = true;
+			}
+
+			if (!error) {
+				if (fds[i].revents != 0) {
+					error_streak[i] = 0;
+				}
+
+				continue;
+			}
+
+			if (fds[i].revents & POLLERR) {
+				ifaceAt(i).clearSocketError();
+			}
+
+			if (++error_streak[i] >= ErrorStreakLimit) {
+				// doubles with every further error, up to BackoffMaxMs
+				const unsigned doublings = error_streak[i] - ErrorStreakLimit;
+				unsigned backoff_ms = BackoffMaxMs;
+
+				if (doublings < 7) {
+					backoff_ms = unsigned(BackoffMinMs) << doublings;
+					backoff_ms = (backoff_ms > BackoffMaxMs) ? unsigned(BackoffMaxMs) : backoff_ms;
+				}
+
+				muted_until[i] = clock::getMonotonic() + uavcan::MonotonicDuration::fromMSec(backoff_ms);
+
+				if (error_streak[i] == ErrorStreakLimit) {
+					UAVCAN_SOCKETCAN_LOG("iface %d: persistent socket errors, backing off", int(i));
+				}
+			}
+		}
+
+		if (signal) {
+			update_event_.signal();
+		}
+	}
+}
+
+int CanDriver::init(const uavcan::uint32_t enabled_interfaces)
+{
+	deinit();
+
+	for (uavcan::uint8_t i = 0; i < UAVCAN_SOCKETCAN_NUM_IFACES; i++) {
+		if ((enabled_interfaces & (1 << i)) == 0) {
+			break;
+		}
+
+		char iface_name[IFNAMSIZ];
+		snprintf(iface_name, sizeof(iface_name), UAVCAN_SOCKETCAN_IFACE_PREFIX "%u", unsigned(i));
+
+		const int res = ifaceAt(i).init(iface_name);
+
+		if (res < 0) {
+			if (i == 0) {
+				return res;
+			}
+
+			UAVCAN_SOCKETCAN_LOG("%s not available, using %u iface(s)", iface_name, unsigned(i));
+			break;
+		}
+
+		num_ifaces_ = i + 1;
+	}
+
+	if (num_ifaces_ == 0) {
+		return -ErrLogic;
+	}
+
+	rx_thread_should_exit_.store(false);
+
+	if (pthread_create(&rx_thread_, UAVCAN_NULLPTR, &CanDriver::rxThreadTrampoline, this) != 0) {
+		deinit();
+		return -ErrLogic;
+	}
+
+	rx_thread_running_ = true;
+	return 0;
+}
+
+int CanDriver::init(VirtualBus &bus)
+{
+	deinit();
+
+	const int res = if0_.init(bus);
+
+	if (res < 0) {
+		return res;
+	}
+
+	num_ifaces_ = 1;
+	return 0;
+}
+
+void CanDriver::deinit()
+{
+	if (rx_thread_running_) {
+		rx_thread_should_exit_.store(true);
+		pthread_join(rx_thread_, UAVCAN_NULLPTR);
+		rx_thread_running_ = false;
+	}
+
+	if0_.deinit();
+#if UAVCAN_SOCKETCAN_NUM_IFACES > 1
+	if1_.deinit();
+#endif
+	num_ifaces_ = 0;
+}
+
+CanIface &CanDriver::ifaceAt(uavcan::uint8_t iface_index)
+{
+#if UAVCAN_SOCKETCAN_NUM_IFACES > 1
+
+	if (iface_index == 1) {
+		return if1_;
+	}
+
+#endif
+	return if0_;
+}
+
+const CanIface &CanDriver::ifaceAt(uavcan::uint8_t iface_index) const
+{
+	return const_cast<CanDriver *>(this)->ifaceAt(iface_index);
+}
+
+CanIface *CanDriver::getIface(uavcan::uint8_t iface_index)
+{
+	if (iface_index < num_ifaces_) {
+		return &ifaceAt(iface_index);
+	}
+
+	return UAVCAN_NULLPTR;
+}
+
+bool CanDriver::hadActivity()
+{
+	bool ret = false;
+
+	for (uavcan::uint8_t i = 0; i < num_ifaces_; i++) {
+		ret |= ifaceAt(i).hadActivity();
+	}
+
+	return ret;
+}
+
+}
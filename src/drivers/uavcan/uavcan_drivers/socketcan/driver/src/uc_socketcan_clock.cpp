@@ -0,0 +1,113 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+#include <uavcan_socketcan/clock.hpp>
+#include <uavcan_socketcan/thread.hpp>
+#include "internal.hpp"
+
+#include <time.h>
+
+namespace uavcan_socketcan
+{
+namespace clock
+{
+namespace
+{
+
+Mutex mutex;
+
+bool utc_set = false;
+uavcan::uint32_t utc_jump_cnt = 0;
+uavcan::int64_t utc_offset_usec = 0; ///< UTC minus monotonic time
+
+}
+
+uavcan::MonotonicTime getMonotonic()
+{
+	timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return uavcan::MonotonicTime::fromUSec(uavcan::uint64_t(ts.tv_sec) * 1000000ULL + ts.tv_nsec / 1000);
+}
+
+uavcan::UtcTime getUtc()
+{
+	const uavcan::uint64_t mono_usec = getMonotonic().toUSec();
+
+	MutexLocker locker(mutex);
+
+	if (!utc_set) {
+		return uavcan::UtcTime();
+	}
+
+	return uavcan::UtcTime::fromUSec(uavcan::uint64_t(uavcan::int64_t(mono_usec) + utc_offset_usec));
+}
+
+void setUtc(uavcan::UtcTime time)
+{
+	const uavcan::uint64_t mono_usec = getMonotonic().toUSec();
+
+	MutexLocker locker(mutex);
+	utc_offset_usec = uavcan::int64_t(time.toUSec()) - uavcan::int64_t(mono_usec);
+	utc_set = true;
+}
+
+void adjustUtc(uavcan::UtcDuration adjustment)
+{
+	MutexLocker locker(mutex);
+
+	if (!utc_set) {
+		// the first adjustment sets the time, relative to the monotonic clock (as the MCU drivers do)
+		utc_offset_usec = 0;
+		utc_set = true;
+	}
+
+	utc_offset_usec += adjustment.toUSec();
+	utc_jump_cnt++;
+}
+
+uavcan::uint32_t getUtcJumpCount()
+{
+	MutexLocker locker(mutex);
+	return utc_jump_cnt;
+}
+
+}
+
+SystemClock &SystemClock::instance()
+{
+	static SystemClock self;
+	return self;
+}
+
+}
@@ -0,0 +1,111 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+#include <uavcan_socketcan/thread.hpp>
+#include <uavcan_socketcan/clock.hpp>
+#include <uavcan_socketcan/can.hpp>
+#include "internal.hpp"
+
+#include <errno.h>
+#include <time.h>
+
+namespace uavcan_socketcan
+{
+
+BusEvent::BusEvent(CanDriver &can_driver)
+{
+	(void)can_driver;
+
+	pthread_condattr_t attr;
+	pthread_condattr_init(&attr);
+	pthread_condattr_setclock(&attr, CLOCK_MONOTONIC); // same clock as clock::getMonotonic()
+	pthread_cond_init(&cond_, &attr);
+	pthread_condattr_destroy(&attr);
+
+	pthread_mutex_init(&mutex_, UAVCAN_NULLPTR);
+}
+
+BusEvent::~BusEvent()
+{
+	pthread_cond_destroy(&cond_);
+	pthread_mutex_destroy(&mutex_);
+}
+
+bool BusEvent::wait(uavcan::MonotonicDuration duration)
+{
+	if (!duration.isPositive()) {
+		return false;
+	}
+
+	timespec abstime;
+
+	if (clock_gettime(CLOCK_MONOTONIC, &abstime) != 0) {
+		return false;
+	}
+
+	const unsigned billion = 1000 * 1000 * 1000;
+	uint64_t nsecs = abstime.tv_nsec + (uint64_t)duration.toUSec() * 1000;
+	abstime.tv_sec += nsecs / billion;
+	nsecs -= (nsecs / billion) * billion;
+	abstime.tv_nsec = nsecs;
+
+	pthread_mutex_lock(&mutex_);
+
+	int ret = 0;
+
+	while (!signalled_ && ret != ETIMEDOUT) {
+		ret = pthread_cond_timedwait(&cond_, &mutex_, &abstime);
+	}
+
+	const bool signalled = signalled_;
+	signalled_ = false;
+
+	pthread_mutex_unlock(&mutex_);
+
+	return signalled;
+}
+
+void BusEvent::signal()
+{
+	pthread_mutex_lock(&mutex_);
+	signalled_ = true;
+	pthread_cond_signal(&cond_);
+	pthread_mutex_unlock(&mutex_);
+
+	if (signal_cb_) {
+		signal_cb_();
+	}
+}
+
+}
@@ -52,7 +52,9 @@
 #include <parameters/param.h>
 #include <version/version.h>
 
+#ifdef __PX4_NUTTX
 #include <arch/chip/chip.h>
+#endif
 
 #include <uORB/topics/esc_status.h>
 
@@ -62,6 +64,9 @@
 
 #include "uavcan_module.hpp"
 #include "uavcan_main.hpp"
+#if defined(UAVCAN_SOCKETCAN_POSIX)
+#include "uavcan_bench.hpp"
+#endif
 #include <uavcan/util/templates.hpp>
 
 #include <uavcan/protocol/param/ExecuteOpcode.hpp>
@@ -153,9 +158,11 @@ UavcanNode::getHardwareVersion(uavcan::protocol::HardwareVersion &hwver)
 			; // All other values of px4_board_name() resolve to zero
 		}
 
+#ifdef __PX4_NUTTX
 		mfguid_t mfgid = {};
 		board_get_mfguid(mfgid);
 		uavcan::copy(mfgid, mfgid + sizeof(mfgid), hwver.unique_id.begin());
+#endif // on POSIX the unique ID is left zeroed
 		rv = 0;
 	}
 
@@ -554,7 +561,12 @@ UavcanNode::start(uavcan::NodeID node_id, uint32_t bitrate)
 		return node_init_res;
 	}
 
+#if defined(UAVCAN_SOCKETCAN_POSIX)
+	// from here on Run() schedules itself, see schedule_next_spin()
+	_instance->ScheduleNow();
+#else
 	_instance->ScheduleOnInterval(ScheduleIntervalMs * 1000);
+#endif
 
 	return OK;
 }
@@ -684,6 +696,38 @@ UavcanNode::node_spin_once()
 	}
 }
 
+#if defined(UAVCAN_SOCKETCAN_POSIX)
+void
+UavcanNode::schedule_next_spin()
+{
+	/*
+	 * Run upon RX (busevent_signal_trampoline), or at the latest when the earliest libuavcan timer
+	 * expires. The upper bound keeps the sensor bridges and the TX queue serviced on a quiet bus.
+	 *
+	 * SocketCAN only: the RX thread of the driver signals every received frame, whereas the NuttX
+	 * drivers keep their fixed interval, on which the TX queue servicing and the bridges were tuned.
+	 */
+	const uavcan::MonotonicTime now = UAVCAN_DRIVER::clock::getMonotonic();
+	const uavcan::MonotonicTime deadline = _node.getScheduler().getDeadlineScheduler().getEarliestDeadline();
+
+	uint32_t delay_us = MaxScheduleIntervalMs * 1000;
+
+	if (deadline <= now) {
+		delay_us = 0;
+
+	} else if ((deadline - now).toUSec() < delay_us) {
+		delay_us = (deadline - now).toUSec();
+	}
+
+	if (delay_us == 0) {
+		ScheduleNow();
+
+	} else {
+		ScheduleDelayed(delay_us);
+	}
+}
+#endif // UAVCAN_SOCKETCAN_POSIX
+
 void
 UavcanNode::handle_time_sync(const uavcan::TimerEvent &)
 {
@@ -811,7 +855,12 @@ UavcanNode::Run()
 		ScheduleClear();
 		teardown();
 		_instance = nullptr;
+		return;
 	}
+
+#if defined(UAVCAN_SOCKETCAN_POSIX)
+	schedule_next_spin();
+#endif
 }
 
 void
@@ -1019,7 +1068,11 @@ static void print_usage()
 	PX4_INFO("usage: \n"
 		 "\tuavcan {start [fw]|status|stop [all|fw]|shrink|arm|disarm|update fw|\n"
 		 "\t        param [set|get|list|save] <node-id> <name> <value>|reset <node-id>|\n"
-		 "\t        hardpoint set <id> <command>}");
+		 "\t        hardpoint set <id> <command>"
+#if defined(UAVCAN_SOCKETCAN_POSIX)
+		 "|bench [-r <rate Hz>] [-n <number of ESCs>] [-c <cycles>]"
+#endif
+		 "}");
 }
 
 extern "C" __EXPORT int uavcan_main(int argc, char *argv[]);
@@ -1033,6 +1086,15 @@ int uavcan_main(int argc, char *argv[])
 
 	bool fw = argc > 2 && !std::strcmp(argv[2], "fw");
 
+#if defined(UAVCAN_SOCKETCAN_POSIX)
+
+	if (!std::strcmp(argv[1], "bench")) {
+		// runs on its own virtual bus, independent of a running node
+		return uavcan_bench_esc(argc - 1, argv + 1);
+	}
+
+#endif
+
 	if (!std::strcmp(argv[1], "start")) {
 		if (UavcanNode::instance()) {
 			if (fw && UavcanServers::instance() == nullptr) {
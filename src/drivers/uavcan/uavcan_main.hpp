@@ -76,7 +76,7 @@ class UavcanNode;
  * UAVCAN mixing class.
  * It is separate from UavcanNode to have 2 WorkItems and therefore allowing independent scheduling
  * (I.e. UavcanMixingInterface runs upon actuator_control updates, whereas UavcanNode runs at
- * a fixed rate or upon bus updates).
+ * a fixed rate or upon bus updates, and with SocketCAN upon bus updates or libuavcan timer deadlines).
  * Both work items are expected to run on the same work queue.
  */
 class UavcanMixingInterface : public OutputModuleInterface
@@ -114,6 +114,7 @@ class UavcanNode : public cdev::CDev, public px4::ScheduledWorkItem, public Modu
 	static constexpr unsigned FramePerMSecond	= ((FramePerSecond / 1000) + 1);
 
 	static constexpr unsigned ScheduleIntervalMs		= 3;
+	static constexpr unsigned MaxScheduleIntervalMs		= 10;	///< SocketCAN: longest sleep between two spins without RX
 
 
 	/*
@@ -170,6 +171,9 @@ private:
 	void		fill_node_info();
 	int		init(uavcan::NodeID node_id, UAVCAN_DRIVER::BusEvent &bus_events);
 	void		node_spin_once();
+#if defined(UAVCAN_SOCKETCAN_POSIX)
+	void		schedule_next_spin();
+#endif
 
 	int		start_fw_server();
 	int		stop_fw_server();
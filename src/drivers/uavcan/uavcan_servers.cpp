@@ -34,7 +34,7 @@
 #include <px4_platform_common/tasks.h>
 #include <drivers/drv_hrt.h>
 
-#include <nuttx/config.h>
+#include <px4_platform_common/px4_config.h>
 
 #include <cstdlib>
 #include <cstring>
@@ -111,12 +111,23 @@ void PX4Gyroscope::updateFIFO(sensor_gyro_fifo_s &sample)
 		_last_sample[1] = sample.y[N - 1];
 		_last_sample[2] = sample.z[N - 1];
 
-		const float x = integral(0) / (float)N;
-		const float y = integral(1) / (float)N;
-		const float z = integral(2) / (float)N;
+		_fifo_average_sum += integral / (float)N;
+		_fifo_average_count++;
+
+		// FIFO consumers (the sensors pipeline) process every sample, so per block
+		// sensor_gyro publications are only needed if there are none
+		if (_sensor_fifo_pub.has_callbacks()
+		    && (sample.timestamp_sample < _last_publish + FIFO_CONSUMER_PUBLISH_INTERVAL)) {
+			return;
+		}
+
+		const Vector3f average{_fifo_average_sum / (float)_fifo_average_count};
+		_fifo_average_sum.zero();
+		_fifo_average_count = 0;
+		_last_publish = sample.timestamp_sample;
 
 		// publish
-		Publish(sample.timestamp_sample, x, y, z);
+		Publish(sample.timestamp_sample, average(0), average(1), average(2));
 	}
 }
 
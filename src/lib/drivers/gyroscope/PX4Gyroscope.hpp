@@ -64,6 +64,9 @@ public:
 private:
 	void Publish(const hrt_abstime &timestamp_sample, float x, float y, float z);
 
+	// sensor_gyro publication interval while the FIFO data is consumed directly
+	static constexpr hrt_abstime FIFO_CONSUMER_PUBLISH_INTERVAL{5000};
+
 	uORB::PublicationMulti<sensor_gyro_s> _sensor_pub;
 	uORB::PublicationMulti<sensor_gyro_fifo_s>  _sensor_fifo_pub;
 
@@ -79,4 +82,8 @@ private:
 	uint32_t		_error_count{0};
 
 	int16_t			_last_sample[3] {};
+
+	matrix::Vector3f	_fifo_average_sum{};
+	uint8_t			_fifo_average_count{0};
+	hrt_abstime		_last_publish{0};
 };
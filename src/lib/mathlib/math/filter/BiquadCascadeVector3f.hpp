@@ -0,0 +1,378 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file BiquadCascadeVector3f.hpp
+ *
+ * Cascade of second order (biquad) filter sections for 3 axes, processed in blocks.
+ *
+ * Each section is either a 2nd order butterworth low-pass (same response as
+ * LowPassFilter2p), a notch (same response as NotchFilter) or bypassed. Notch
+ * sections can be set per axis, which allows dynamic notches that track
+ * per-axis peak frequencies.
+ *
+ * Coefficients and states are stored per section with one lane per axis, and
+ * a block of samples is run through one section at a time, so that the
+ * section coefficients and states stay in registers for the whole block. On
+ * targets with 4-wide float SIMD (SSE, AArch64 NEON) the three axes are
+ * computed in a single vector operation. The sections use the transposed
+ * direct form II, which is well behaved for coefficient updates while running.
+ */
+
+#pragma once
+
+#include <px4_platform_common/defines.h>
+#include <matrix/math.hpp>
+
+#include <math.h>
+#include <stdint.h>
+
+namespace math
+{
+
+namespace biquad
+{
+
+#if defined(__SSE__) || (defined(__ARM_NEON) && defined(__aarch64__))
+
+typedef float Lanes __attribute__((vector_size(4 * sizeof(float))));
+
+static inline Lanes broadcast(float value) { return Lanes{value, value, value, value}; }
+
+#else
+
+struct Lanes {
+	float v[3];
+
+	inline float &operator[](int i) { return v[i]; }
+	inline float operator[](int i) const { return v[i]; }
+
+	inline Lanes operator+(const Lanes &o) const { return Lanes{{v[0] + o.v[0], v[1] + o.v[1], v[2] + o.v[2]}}; }
+	inline Lanes operator-(const Lanes &o) const { return Lanes{{v[0] - o.v[0], v[1] - o.v[1], v[2] - o.v[2]}}; }
+	inline Lanes operator*(const Lanes &o) const { return Lanes{{v[0] * o.v[0], v[1] * o.v[1], v[2] * o.v[2]}}; }
+};
+
+static inline Lanes broadcast(float value) { return Lanes{{value, value, value}}; }
+
+#endif
+
+struct Coefficients {
+	float b0;
+	float b1;
+	float b2;
+	float a1;
+	float a2;
+};
+
+static constexpr Coefficients bypass{1.f, 0.f, 0.f, 0.f, 0.f};
+
+} // namespace biquad
+
+template<int MAX_STAGES>
+class BiquadCascadeVector3f
+{
+public:
+	static constexpr int AXES = 3;
+	static constexpr int MAX_BLOCK_SIZE = 32;
+
+	BiquadCascadeVector3f()
+	{
+		for (int stage = 0; stage < MAX_STAGES; stage++) {
+			setBypass(stage);
+		}
+	}
+
+	~BiquadCascadeVector3f() = default;
+
+	/**
+	 * Set a stage to a 2nd order butterworth low-pass on all axes.
+	 * A cutoff frequency <= 0 bypasses the stage.
+	 */
+	void setLowPass(int stage, float sample_freq, float cutoff_freq)
+	{
+		for (int axis = 0; axis < AXES; axis++) {
+			setCoefficients(stage, axis, lowPassCoefficients(sample_freq, cutoff_freq));
+		}
+	}
+
+	/**
+	 * Set a stage to a notch on all axes.
+	 * A notch frequency <= 0 bypasses the stage.
+	 */
+	void setNotch(int stage, float sample_freq, float notch_freq, float bandwidth)
+	{
+		for (int axis = 0; axis < AXES; axis++) {
+			setCoefficients(stage, axis, notchCoefficients(sample_freq, notch_freq, bandwidth));
+		}
+	}
+
+	/**
+	 * Set a stage to a notch on a single axis, e.g. for dynamic notches tracking a per-axis peak.
+	 * A notch frequency <= 0 bypasses the axis.
+	 */
+	void setNotch(int stage, int axis, float sample_freq, float notch_freq, float bandwidth)
+	{
+		setCoefficients(stage, axis, notchCoefficients(sample_freq, notch_freq, bandwidth));
+	}
+
+	void setBypass(int stage)
+	{
+		for (int axis = 0; axis < AXES; axis++) {
+			setCoefficients(stage, axis, biquad::bypass);
+		}
+	}
+
+	bool stageEnabled(int stage) const { return (_enabled_mask & (1u << stage)) != 0; }
+
+	int enabledStages() const { return _num_active; }
+
+	/**
+	 * Initialize all stage states to the steady state of a constant input.
+	 */
+	void reset(const matrix::Vector3f &sample)
+	{
+		float u[AXES] {sample(0), sample(1), sample(2)};
+
+		for (int stage = 0; stage < MAX_STAGES; stage++) {
+			for (int axis = 0; axis < AXES; axis++) {
+				const float b0 = _b0[stage][axis];
+				const float b1 = _b1[stage][axis];
+				const float b2 = _b2[stage][axis];
+				const float a1 = _a1[stage][axis];
+				const float a2 = _a2[stage][axis];
+
+				const float y = u[axis] * (b0 + b1 + b2) / (1.f + a1 + a2);
+
+				if (PX4_ISFINITE(y)) {
+					_s1[stage][axis] = y - b0 * u[axis];
+					_s2[stage][axis] = b2 * u[axis] - a2 * y;
+					u[axis] = y;
+
+				} else {
+					_s1[stage][axis] = 0.f;
+					_s2[stage][axis] = 0.f;
+				}
+			}
+		}
+	}
+
+	/**
+	 * Filter a block of samples in place.
+	 *
+	 * @param x, y, z per axis sample arrays
+	 * @param length number of samples
+	 */
+	void apply(float x[], float y[], float z[], int length)
+	{
+		if (_num_active == 0) {
+			return;
+		}
+
+		for (int offset = 0; offset < length; offset += MAX_BLOCK_SIZE) {
+			const int n = (length - offset < MAX_BLOCK_SIZE) ? (length - offset) : MAX_BLOCK_SIZE;
+
+			for (int i = 0; i < n; i++) {
+				_block[i][0] = x[offset + i];
+				_block[i][1] = y[offset + i];
+				_block[i][2] = z[offset + i];
+			}
+
+			applyBlock(n);
+
+			for (int i = 0; i < n; i++) {
+				x[offset + i] = _block[i][0];
+				y[offset + i] = _block[i][1];
+				z[offset + i] = _block[i][2];
+			}
+		}
+	}
+
+	/**
+	 * Filter a single sample.
+	 *
+	 * @return retrieve the filtered result
+	 */
+	matrix::Vector3f apply(const matrix::Vector3f &sample)
+	{
+		if (_num_active == 0) {
+			return sample;
+		}
+
+		_block[0][0] = sample(0);
+		_block[0][1] = sample(1);
+		_block[0][2] = sample(2);
+
+		applyBlock(1);
+
+		return matrix::Vector3f{_block[0][0], _block[0][1], _block[0][2]};
+	}
+
+	static biquad::Coefficients lowPassCoefficients(float sample_freq, float cutoff_freq)
+	{
+		if ((cutoff_freq <= 0.f) || (sample_freq <= 0.f)) {
+			return biquad::bypass;
+		}
+
+		const float fr = sample_freq / cutoff_freq;
+		const float ohm = tanf(M_PI_F / fr);
+		const float c = 1.f + 2.f * cosf(M_PI_F / 4.f) * ohm + ohm * ohm;
+
+		const float b0 = ohm * ohm / c;
+
+		return biquad::Coefficients{
+			b0,
+			2.f * b0,
+			b0,
+			2.f * (ohm * ohm - 1.f) / c,
+			(1.f - 2.f * cosf(M_PI_F / 4.f) * ohm + ohm * ohm) / c
+		};
+	}
+
+	static biquad::Coefficients notchCoefficients(float sample_freq, float notch_freq, float bandwidth)
+	{
+		if ((notch_freq <= 0.f) || (sample_freq <= 0.f)) {
+			return biquad::bypass;
+		}
+
+		const float alpha = tanf(M_PI_F * bandwidth / sample_freq);
+		const float beta = -cosf(2.f * M_PI_F * notch_freq / sample_freq);
+		const float a0_inv = 1.f / (alpha + 1.f);
+
+		return biquad::Coefficients{
+			a0_inv,
+			2.f * beta * a0_inv,
+			a0_inv,
+			2.f * beta * a0_inv,
+			(1.f - alpha) * a0_inv
+		};
+	}
+
+private:
+
+	void setCoefficients(int stage, int axis, const biquad::Coefficients &c)
+	{
+		if ((stage < 0) || (stage >= MAX_STAGES) || (axis < 0) || (axis >= AXES)) {
+			return;
+		}
+
+		_b0[stage][axis] = c.b0;
+		_b1[stage][axis] = c.b1;
+		_b2[stage][axis] = c.b2;
+		_a1[stage][axis] = c.a1;
+		_a2[stage][axis] = c.a2;
+
+		const bool bypassed = (c.b0 == 1.f) && (c.b1 == 0.f) && (c.b2 == 0.f) && (c.a1 == 0.f) && (c.a2 == 0.f);
+
+		if (bypassed) {
+			_s1[stage][axis] = 0.f;
+			_s2[stage][axis] = 0.f;
+			_axis_bypassed[stage] |= (1u << axis);
+
+		} else {
+			_axis_bypassed[stage] &= ~(1u << axis);
+		}
+
+		updateActiveStages();
+	}
+
+	void updateActiveStages()
+	{
+		_num_active = 0;
+		_enabled_mask = 0;
+
+		for (int stage = 0; stage < MAX_STAGES; stage++) {
+			if (_axis_bypassed[stage] != (1u << AXES) - 1) {
+				_active[_num_active++] = stage;
+				_enabled_mask |= (1u << stage);
+			}
+		}
+	}
+
+	void applyBlock(int n)
+	{
+		using biquad::Lanes;
+
+		for (int k = 0; k < _num_active; k++) {
+			const int stage = _active[k];
+
+			const Lanes b0 = _b0[stage];
+			const Lanes b1 = _b1[stage];
+			const Lanes b2 = _b2[stage];
+			const Lanes a1 = _a1[stage];
+			const Lanes a2 = _a2[stage];
+
+			Lanes s1 = _s1[stage];
+			Lanes s2 = _s2[stage];
+
+			for (int i = 0; i < n; i++) {
+				const Lanes u = _block[i];
+				const Lanes y = b0 * u + s1;
+				s1 = b1 * u - a1 * y + s2;
+				s2 = b2 * u - a2 * y;
+				_block[i] = y;
+			}
+
+			// don't allow bad values to propagate via the filter
+			for (int axis = 0; axis < AXES; axis++) {
+				if (!PX4_ISFINITE(s1[axis]) || !PX4_ISFINITE(s2[axis])) {
+					s1[axis] = 0.f;
+					s2[axis] = 0.f;
+				}
+			}
+
+			_s1[stage] = s1;
+			_s2[stage] = s2;
+		}
+	}
+
+	static_assert(MAX_STAGES <= 32, "too many stages");
+
+	// coefficients (normalized by a0) and states, one lane per axis
+	biquad::Lanes _b0[MAX_STAGES] {};
+	biquad::Lanes _b1[MAX_STAGES] {};
+	biquad::Lanes _b2[MAX_STAGES] {};
+	biquad::Lanes _a1[MAX_STAGES] {};
+	biquad::Lanes _a2[MAX_STAGES] {};
+
+	biquad::Lanes _s1[MAX_STAGES] {};
+	biquad::Lanes _s2[MAX_STAGES] {};
+
+	biquad::Lanes _block[MAX_BLOCK_SIZE] {};
+
+	uint8_t _axis_bypassed[MAX_STAGES] {};
+	uint8_t _active[MAX_STAGES] {};
+	int _num_active{0};
+	uint32_t _enabled_mask{0};
+};
+
+} // namespace math
@@ -0,0 +1,210 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * Test code for the biquad cascade
+ * Run this test only using make tests TESTFILTER=BiquadCascadeVector3f
+ */
+
+#include <gtest/gtest.h>
+#include <matrix/matrix/math.hpp>
+
+#include "BiquadCascadeVector3f.hpp"
+#include "LowPassFilter2p.hpp"
+#include "NotchFilter.hpp"
+
+using namespace math;
+using matrix::Vector3f;
+
+class BiquadCascadeVector3fTest : public ::testing::Test
+{
+public:
+	static constexpr int BLOCK_SIZE = 20;
+
+	// deterministic test signal with content across the spectrum
+	static Vector3f signal(int i)
+	{
+		const float t = i / _sample_freq;
+		return Vector3f{
+			sinf(2.f * M_PI_F * 40.f * t) + 0.5f * sinf(2.f * M_PI_F * 150.f * t),
+			0.3f + cosf(2.f * M_PI_F * 250.f * t),
+			(i % 7) * 0.1f - 0.3f
+		};
+	}
+
+	static constexpr float _sample_freq = 2000.f;
+	const float _epsilon_near = 1e-4f;
+};
+
+TEST_F(BiquadCascadeVector3fTest, bypass)
+{
+	BiquadCascadeVector3f<3> cascade;
+	EXPECT_EQ(cascade.enabledStages(), 0);
+
+	const Vector3f in{1.f, -2.f, 3.f};
+	const Vector3f out = cascade.apply(in);
+
+	for (int axis = 0; axis < 3; axis++) {
+		EXPECT_EQ(out(axis), in(axis));
+	}
+
+	// a notch at 0 Hz is disabled
+	cascade.setNotch(0, _sample_freq, 0.f, 20.f);
+	EXPECT_EQ(cascade.enabledStages(), 0);
+	EXPECT_FALSE(cascade.stageEnabled(0));
+
+	cascade.setLowPass(2, _sample_freq, 30.f);
+	EXPECT_EQ(cascade.enabledStages(), 1);
+	EXPECT_TRUE(cascade.stageEnabled(2));
+}
+
+TEST_F(BiquadCascadeVector3fTest, matchesNotchAndLowPass)
+{
+	// reference: notch followed by low-pass per axis
+	NotchFilter<float> notch[3];
+	LowPassFilter2p lpf[3] {{_sample_freq, 60.f}, {_sample_freq, 60.f}, {_sample_freq, 60.f}};
+
+	BiquadCascadeVector3f<2> cascade;
+	cascade.setNotch(0, _sample_freq, 150.f, 20.f);
+	cascade.setLowPass(1, _sample_freq, 60.f);
+
+	for (int axis = 0; axis < 3; axis++) {
+		notch[axis].setParameters(_sample_freq, 150.f, 20.f);
+		notch[axis].reset(0.f);
+		lpf[axis].reset(0.f);
+	}
+
+	cascade.reset(Vector3f{});
+
+	for (int i = 0; i < 1000; i++) {
+		const Vector3f in = signal(i);
+		const Vector3f out = cascade.apply(in);
+
+		for (int axis = 0; axis < 3; axis++) {
+			const float expected = lpf[axis].apply(notch[axis].apply(in(axis)));
+			EXPECT_NEAR(out(axis), expected, _epsilon_near);
+		}
+	}
+}
+
+TEST_F(BiquadCascadeVector3fTest, blockMatchesSingleSample)
+{
+	BiquadCascadeVector3f<4> single;
+	BiquadCascadeVector3f<4> block;
+
+	for (auto *cascade : {&single, &block}) {
+		cascade->setNotch(0, _sample_freq, 150.f, 20.f);
+		cascade->setNotch(1, _sample_freq, 250.f, 30.f);
+		cascade->setLowPass(3, _sample_freq, 80.f);
+	}
+
+	// longer than the internal block size
+	static constexpr int LENGTH = 3 * BiquadCascadeVector3f<4>::MAX_BLOCK_SIZE + 5;
+	float x[LENGTH];
+	float y[LENGTH];
+	float z[LENGTH];
+	Vector3f expected[LENGTH];
+
+	for (int i = 0; i < LENGTH; i++) {
+		const Vector3f in = signal(i);
+		x[i] = in(0);
+		y[i] = in(1);
+		z[i] = in(2);
+		expected[i] = single.apply(in);
+	}
+
+	block.apply(x, y, z, LENGTH);
+
+	for (int i = 0; i < LENGTH; i++) {
+		EXPECT_FLOAT_EQ(x[i], expected[i](0));
+		EXPECT_FLOAT_EQ(y[i], expected[i](1));
+		EXPECT_FLOAT_EQ(z[i], expected[i](2));
+	}
+}
+
+TEST_F(BiquadCascadeVector3fTest, perAxisNotch)
+{
+	// notch only on the y axis at the frequency of its test signal
+	BiquadCascadeVector3f<1> cascade;
+	cascade.setNotch(0, 1, _sample_freq, 250.f, 20.f);
+	EXPECT_EQ(cascade.enabledStages(), 1);
+
+	cascade.reset(Vector3f{0.f, 0.3f, 0.f});
+
+	for (int i = 0; i < 2000; i++) {
+		const Vector3f in = signal(i);
+		const Vector3f out = cascade.apply(in);
+
+		// x and z pass through unchanged
+		EXPECT_EQ(out(0), in(0));
+		EXPECT_EQ(out(2), in(2));
+
+		// y: sinusoid removed, offset kept
+		if (i > 200) {
+			EXPECT_NEAR(out(1), 0.3f, 0.05f);
+		}
+	}
+}
+
+TEST_F(BiquadCascadeVector3fTest, reset)
+{
+	BiquadCascadeVector3f<2> cascade;
+	cascade.setNotch(0, _sample_freq, 100.f, 20.f);
+	cascade.setLowPass(1, _sample_freq, 30.f);
+
+	const Vector3f value{1.f, -2.f, 0.5f};
+	cascade.reset(value);
+
+	// steady state: a constant input passes without transient
+	for (int i = 0; i < 10; i++) {
+		const Vector3f out = cascade.apply(value);
+
+		for (int axis = 0; axis < 3; axis++) {
+			EXPECT_NEAR(out(axis), value(axis), _epsilon_near);
+		}
+	}
+}
+
+TEST_F(BiquadCascadeVector3fTest, nonFinite)
+{
+	BiquadCascadeVector3f<1> cascade;
+	cascade.setLowPass(0, _sample_freq, 30.f);
+	cascade.reset(Vector3f{});
+
+	cascade.apply(Vector3f{NAN, 0.f, 0.f});
+
+	// the state recovers after invalid input
+	const Vector3f out = cascade.apply(Vector3f{});
+	EXPECT_TRUE(PX4_ISFINITE(out(0)));
+	EXPECT_FLOAT_EQ(out(1), 0.f);
+}
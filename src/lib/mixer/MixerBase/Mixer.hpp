@@ -129,6 +129,8 @@
 #include <containers/List.hpp>
 #include <mathlib/mathlib.h>
 
+class MixerProgram;
+
 /**
  * Abstract class defining a mixer mixing zero or more inputs to
  * one or more outputs.
@@ -229,6 +231,27 @@ public:
 
 	virtual unsigned		get_multirotor_count()  { return 0; }
 
+	/**
+	 * Append this mixer to a flattened mixer program (see MixerProgram).
+	 *
+	 * @param program		The program being built.
+	 * @return			true if the mixer was added, false if it cannot be compiled
+	 *				and the group has to use mix() instead.
+	 */
+	virtual bool			compile(MixerProgram &program) { return false; }
+
+	/**
+	 * Perform the mixing function on control values gathered by a MixerProgram,
+	 * instead of fetching them through the control callback.
+	 * Only called for mixers that added themselves with MixerProgram::add_block().
+	 *
+	 * @param controls		The gathered control values.
+	 * @param outputs		Array into which mixed output(s) should be placed.
+	 * @param space			The number of available entries in the output array;
+	 * @return			The number of entries in the output array that were populated.
+	 */
+	virtual unsigned		mix_block(const float *controls, float *outputs, unsigned space) { return 0; }
+
 protected:
 
 	/** client-supplied callback used when fetching control values */
@@ -0,0 +1,139 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file MixerBinary.hpp
+ *
+ * Binary (precompiled) mixer file format.
+ *
+ * The binary form is generated at build time from the text mixer files by
+ * Tools/px_mixer_binary.py and can be loaded with a single read, without
+ * any text parsing (see MixerGroup::load_from_binary()).
+ *
+ * Layout (little endian, all records 4 byte aligned):
+ *
+ *   header_s
+ *   record_s, payload, padding
+ *   record_s, payload, padding
+ *   ...
+ *
+ * Scalers are stored as the integers of the text format (1/10000 units), so
+ * that the loaded mixers are identical to the ones parsed from text.
+ * Mixers without a binary payload definition (helicopter) are stored as their
+ * NUL-terminated text description.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+namespace mixer_binary
+{
+
+static constexpr uint32_t MAGIC = 0x424d5850;	///< "PXMB"
+static constexpr uint16_t VERSION = 1;
+
+struct header_s {
+	uint32_t magic;
+	uint16_t version;
+	uint16_t mixer_count;
+	uint32_t length;		///< total length in bytes, including the header
+	uint32_t crc;			///< crc32 of the records (everything after the header)
+};
+
+/** record types, the tag of the corresponding text mixer definition */
+enum RecordType : uint8_t {
+	RECORD_NULL = 'Z',
+	RECORD_SIMPLE = 'M',
+	RECORD_MULTIROTOR = 'R',
+	RECORD_TEXT = 'H',
+};
+
+struct record_s {
+	uint8_t type;			///< RecordType
+	uint8_t reserved;
+	uint16_t length;		///< payload length in bytes, excluding padding
+};
+
+struct scaler_s {
+	int32_t negative_scale;
+	int32_t positive_scale;
+	int32_t offset;
+	int32_t min_output;
+	int32_t max_output;
+};
+
+/** RECORD_SIMPLE payload, followed by control_count control_s */
+struct simple_s {
+	uint8_t control_count;
+	uint8_t reserved[3];
+	scaler_s output_scaler;
+};
+
+struct control_s {
+	uint8_t control_group;
+	uint8_t control_index;
+	uint8_t reserved[2];
+	scaler_s scaler;
+};
+
+/** RECORD_MULTIROTOR payload */
+struct multirotor_s {
+	char geometry[16];		///< geometry key as used in the text format, NUL-terminated
+};
+
+static_assert(sizeof(header_s) == 16, "unexpected header size");
+static_assert(sizeof(record_s) == 4, "unexpected record size");
+static_assert(sizeof(simple_s) == 24, "unexpected simple mixer size");
+static_assert(sizeof(control_s) == 24, "unexpected control size");
+
+static inline unsigned padded(unsigned length) { return (length + 3u) & ~3u; }
+
+/**
+ * @return true if the buffer starts with a binary mixer header
+ */
+static inline bool is_binary(const void *buf, unsigned buflen)
+{
+	uint32_t magic;
+
+	if (buf == nullptr || buflen < sizeof(header_s)) {
+		return false;
+	}
+
+	memcpy(&magic, buf, sizeof(magic));
+	return magic == MAGIC;
+}
+
+} // namespace mixer_binary
@@ -0,0 +1,328 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file MixerProgram.cpp
+ *
+ * Flattened execution form of a mixer group.
+ */
+
+#include "MixerProgram.hpp"
+
+#include <math.h>
+
+void
+MixerProgram::reset()
+{
+	delete[] _inputs;
+	delete[] _values;
+	delete[] _scalers;
+	delete[] _term_inputs;
+	delete[] _block_inputs;
+	delete[] _ops;
+
+	_inputs = nullptr;
+	_values = nullptr;
+	_scalers = nullptr;
+	_term_inputs = nullptr;
+	_block_inputs = nullptr;
+	_ops = nullptr;
+
+	_input_count = 0;
+	_input_capacity = 0;
+	_scaler_count = 0;
+	_block_input_count = 0;
+	_op_count = 0;
+
+	_control_cb = nullptr;
+	_cb_handle = 0;
+	_valid = false;
+}
+
+bool
+MixerProgram::build(List<Mixer *> &mixers)
+{
+	reset();
+
+	// first pass: size the tables (inputs are an upper bound, duplicates are only merged when filling)
+	_sizing = true;
+
+	for (auto mixer : mixers) {
+		if (!mixer->compile(*this)) {
+			_sizing = false;
+			reset();
+			return false;
+		}
+	}
+
+	_sizing = false;
+
+	const unsigned input_capacity = _input_capacity;
+	const unsigned scaler_count = _scaler_count;
+	const unsigned block_input_count = _block_input_count;
+	const unsigned op_count = _op_count;
+
+	// value slots are stored as uint8_t
+	if (input_capacity > UINT8_MAX + 1 || op_count == 0) {
+		reset();
+		return false;
+	}
+
+	reset();
+
+	_inputs = new Input[input_capacity];
+	_values = new float[input_capacity];
+	_scalers = new mixer_scaler_s[scaler_count];
+	_term_inputs = new uint8_t[scaler_count];
+	_block_inputs = new uint8_t[block_input_count];
+	_ops = new Op[op_count];
+
+	if (_inputs == nullptr || _values == nullptr || _scalers == nullptr || _term_inputs == nullptr
+	    || _block_inputs == nullptr || _ops == nullptr) {
+		reset();
+		return false;
+	}
+
+	_input_capacity = input_capacity;
+
+	// second pass: fill the tables
+	for (auto mixer : mixers) {
+		if (!mixer->compile(*this)) {
+			reset();
+			return false;
+		}
+	}
+
+	_valid = true;
+	return true;
+}
+
+bool
+MixerProgram::set_source(Mixer::ControlCallback control_cb, uintptr_t cb_handle)
+{
+	if (_control_cb == nullptr) {
+		_control_cb = control_cb;
+		_cb_handle = cb_handle;
+		return control_cb != nullptr;
+	}
+
+	// all inputs are gathered through a single callback
+	return (_control_cb == control_cb) && (_cb_handle == cb_handle);
+}
+
+int
+MixerProgram::add_input(uint8_t control_group, uint8_t control_index)
+{
+	if (_sizing) {
+		_input_capacity++;
+		return 0;
+	}
+
+	for (unsigned i = 0; i < _input_count; i++) {
+		if (_inputs[i].control_group == control_group && _inputs[i].control_index == control_index) {
+			return i;
+		}
+	}
+
+	if (_input_count >= _input_capacity) {
+		return -1;
+	}
+
+	_inputs[_input_count].control_group = control_group;
+	_inputs[_input_count].control_index = control_index;
+	return _input_count++;
+}
+
+bool
+MixerProgram::add_op(OpType type, unsigned count, unsigned first, Mixer *mixer)
+{
+	if (count > UINT8_MAX || first > UINT16_MAX) {
+		return false;
+	}
+
+	if (!_sizing) {
+		Op &op = _ops[_op_count];
+		op.type = type;
+		op.count = count;
+		op.first = first;
+		op.mixer = mixer;
+	}
+
+	_op_count++;
+	return true;
+}
+
+bool
+MixerProgram::add_sum(Mixer &mixer, Mixer::ControlCallback control_cb, uintptr_t cb_handle,
+		      const mixer_control_s *controls, unsigned control_count, const mixer_scaler_s &output_scaler)
+{
+	if (control_count > 0 && !set_source(control_cb, cb_handle)) {
+		return false;
+	}
+
+	const unsigned first = _scaler_count;
+
+	for (unsigned i = 0; i < control_count; i++) {
+		const int slot = add_input(controls[i].control_group, controls[i].control_index);
+
+		if (slot < 0) {
+			return false;
+		}
+
+		if (!_sizing) {
+			_scalers[_scaler_count] = controls[i].scaler;
+			_term_inputs[_scaler_count] = slot;
+		}
+
+		_scaler_count++;
+	}
+
+	if (!_sizing) {
+		_scalers[_scaler_count] = output_scaler;
+		_term_inputs[_scaler_count] = 0;
+	}
+
+	_scaler_count++;
+
+	return add_op(OpType::Sum, control_count, first, &mixer);
+}
+
+bool
+MixerProgram::add_null()
+{
+	return add_op(OpType::Null, 0, 0, nullptr);
+}
+
+bool
+MixerProgram::add_block(Mixer &mixer, Mixer::ControlCallback control_cb, uintptr_t cb_handle,
+			uint8_t control_group, unsigned control_count)
+{
+	if (control_count > MAX_BLOCK_INPUTS || (control_count > 0 && !set_source(control_cb, cb_handle))) {
+		return false;
+	}
+
+	const unsigned first = _block_input_count;
+
+	for (unsigned i = 0; i < control_count; i++) {
+		const int slot = add_input(control_group, i);
+
+		if (slot < 0) {
+			return false;
+		}
+
+		if (!_sizing) {
+			_block_inputs[_block_input_count] = slot;
+		}
+
+		_block_input_count++;
+	}
+
+	return add_op(OpType::Block, control_count, first, &mixer);
+}
+
+void
+MixerProgram::update_trims()
+{
+	if (!_valid) {
+		return;
+	}
+
+	for (unsigned i = 0; i < _op_count; i++) {
+		const Op &op = _ops[i];
+
+		if (op.type == OpType::Sum) {
+			float trim = 0.f;
+			op.mixer->get_trim(&trim);
+			_scalers[op.first + op.count].offset = trim;
+		}
+	}
+}
+
+unsigned
+MixerProgram::execute(float *outputs, unsigned space)
+{
+	if (space == 0) {
+		return 0;
+	}
+
+	// gather: every distinct control is fetched exactly once per cycle
+	for (unsigned i = 0; i < _input_count; i++) {
+		float value = 0.f;
+		_control_cb(_cb_handle, _inputs[i].control_group, _inputs[i].control_index, value);
+		_values[i] = value;
+	}
+
+	unsigned index = 0;
+
+	for (unsigned i = 0; i < _op_count; i++) {
+		const Op &op = _ops[i];
+
+		switch (op.type) {
+		case OpType::Sum: {
+				const mixer_scaler_s *scalers = &_scalers[op.first];
+				const uint8_t *term_inputs = &_term_inputs[op.first];
+				float sum = 0.f;
+
+				for (unsigned t = 0; t < op.count; t++) {
+					sum += SimpleMixer::scale(scalers[t], _values[term_inputs[t]]);
+				}
+
+				outputs[index++] = SimpleMixer::scale(scalers[op.count], sum);
+			}
+			break;
+
+		case OpType::Null:
+			outputs[index++] = NAN;
+			break;
+
+		case OpType::Block: {
+				float controls[MAX_BLOCK_INPUTS];
+
+				for (unsigned c = 0; c < op.count; c++) {
+					controls[c] = _values[_block_inputs[op.first + c]];
+				}
+
+				index += op.mixer->mix_block(controls, outputs + index, space - index);
+			}
+			break;
+		}
+
+		// single-output operations always fit, as index < space at this point
+		if (index >= space) {
+			break;
+		}
+	}
+
+	return index;
+}
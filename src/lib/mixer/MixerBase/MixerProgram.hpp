@@ -0,0 +1,182 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file MixerProgram.hpp
+ *
+ * Flattened execution form of a mixer group.
+ *
+ * Instead of walking the list of mixers and letting each mixer fetch its
+ * inputs through the control callback, a MixerGroup is compiled at load time
+ * into:
+ *  - a gather table of the distinct (group, index) controls read by the group,
+ *    fetched once per cycle into a dense value array,
+ *  - contiguous input/output scaler arrays for all simple (summing) mixers,
+ *  - a fixed sequence of operations writing consecutive outputs.
+ *
+ * Mixers with internal state (e.g. the multirotor mixer) are kept as block
+ * operations, which are handed the gathered inputs through Mixer::mix_block().
+ */
+
+#pragma once
+
+#include <mixer/MixerBase/Mixer.hpp>
+#include <mixer/SimpleMixer/SimpleMixer.hpp>
+
+class MixerProgram
+{
+public:
+	MixerProgram() = default;
+
+	~MixerProgram()
+	{
+		reset();
+	}
+
+	// no copy, assignment, move, move assignment
+	MixerProgram(const MixerProgram &) = delete;
+	MixerProgram &operator=(const MixerProgram &) = delete;
+	MixerProgram(MixerProgram &&) = delete;
+	MixerProgram &operator=(MixerProgram &&) = delete;
+
+	/** maximum number of gathered inputs handed to a block operation */
+	static constexpr unsigned MAX_BLOCK_INPUTS = 8;
+
+	/**
+	 * Compile a list of mixers.
+	 *
+	 * @param mixers		The mixers in output order.
+	 * @return			true on success, false if any of the mixers cannot be
+	 *				compiled (the program is then left empty).
+	 */
+	bool				build(List<Mixer *> &mixers);
+
+	/**
+	 * Release the program.
+	 */
+	void				reset();
+
+	/**
+	 * @return			true if the program was built successfully.
+	 */
+	bool				valid() const { return _valid; }
+
+	/**
+	 * Run the program, equivalent to MixerGroup::mix() on the compiled mixers.
+	 *
+	 * @param outputs		Array into which mixed output(s) should be placed.
+	 * @param space			The number of available entries in the output array.
+	 * @return			The number of entries in the output array that were populated.
+	 */
+	unsigned			execute(float *outputs, unsigned space);
+
+	/**
+	 * Refresh the copied output scaler offsets after the trims of the mixers changed.
+	 * Does not allocate, so it is safe to call while the program is in use.
+	 */
+	void				update_trims();
+
+	/**
+	 * Number of distinct controls read per cycle.
+	 */
+	unsigned			input_count() const { return _input_count; }
+
+	/*
+	 * Builder interface used by Mixer::compile() implementations.
+	 */
+
+	/**
+	 * Append a summing operation producing one output (SimpleMixer).
+	 */
+	bool				add_sum(Mixer &mixer, Mixer::ControlCallback control_cb, uintptr_t cb_handle,
+					const mixer_control_s *controls, unsigned control_count,
+					const mixer_scaler_s &output_scaler);
+
+	/**
+	 * Append an operation producing one NAN output (NullMixer).
+	 */
+	bool				add_null();
+
+	/**
+	 * Append a block operation, evaluated by calling mixer.mix_block() with
+	 * the controls 0..control_count-1 of the given control group.
+	 */
+	bool				add_block(Mixer &mixer, Mixer::ControlCallback control_cb, uintptr_t cb_handle,
+					  uint8_t control_group, unsigned control_count);
+
+private:
+
+	enum class OpType : uint8_t {
+		Sum,
+		Null,
+		Block,
+	};
+
+	struct Op {
+		OpType		type;
+		uint8_t		count;	/**< Sum: number of terms, Block: number of inputs */
+		uint16_t	first;	/**< Sum: first entry in the term arrays, Block: first entry in _block_inputs */
+		Mixer		*mixer;	/**< the compiled mixer (invoked for Block) */
+	};
+
+	struct Input {
+		uint8_t		control_group;
+		uint8_t		control_index;
+	};
+
+	bool				set_source(Mixer::ControlCallback control_cb, uintptr_t cb_handle);
+	int				add_input(uint8_t control_group, uint8_t control_index);
+	bool				add_op(OpType type, unsigned count, unsigned first, Mixer *mixer);
+
+	Mixer::ControlCallback		_control_cb{nullptr};
+	uintptr_t			_cb_handle{0};
+
+	bool				_sizing{false};	/**< first build pass, only counting */
+	bool				_valid{false};
+
+	Input				*_inputs{nullptr};	/**< gather table */
+	float				*_values{nullptr};	/**< gathered control values */
+	unsigned			_input_count{0};
+	unsigned			_input_capacity{0};
+
+	mixer_scaler_s			*_scalers{nullptr};	/**< term scalers, each sum followed by its output scaler */
+	uint8_t				*_term_inputs{nullptr};	/**< value slot per scaler entry */
+	unsigned			_scaler_count{0};
+
+	uint8_t				*_block_inputs{nullptr};	/**< value slots of block operations */
+	unsigned			_block_input_count{0};
+
+	Op				*_ops{nullptr};
+	unsigned			_op_count{0};
+};
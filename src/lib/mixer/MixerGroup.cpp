@@ -40,10 +40,15 @@
 #include "MixerGroup.hpp"
 
 #include "HelicopterMixer/HelicopterMixer.hpp"
+#include "MixerBase/MixerBinary.hpp"
 #include "MultirotorMixer/MultirotorMixer.hpp"
 #include "NullMixer/NullMixer.hpp"
 #include "SimpleMixer/SimpleMixer.hpp"
 
+#include <crc32.h>
+#include <errno.h>
+#include <string.h>
+
 #define debug(fmt, args...)	do { } while(0)
 //#define debug(fmt, args...)	do { printf("[mixer] " fmt "\n", ##args); } while(0)
 //#include <debug.h>
@@ -52,6 +57,10 @@
 unsigned
 MixerGroup::mix(float *outputs, unsigned space)
 {
+	if (_program.valid()) {
+		return _program.execute(outputs, space);
+	}
+
 	unsigned index = 0;
 
 	for (auto mixer : _mixers) {
@@ -89,6 +98,9 @@ MixerGroup::set_trims(int16_t *values, unsigned n)
 		}
 	}
 
+	// the compiled program holds a copy of the output scalers
+	_program.update_trims();
+
 	return index;
 }
 
@@ -237,6 +249,96 @@ MixerGroup::load_from_buf(Mixer::ControlCallback control_cb, uintptr_t cb_handle
 	return ret;
 }
 
+int
+MixerGroup::load_from_binary(Mixer::ControlCallback control_cb, uintptr_t cb_handle, const uint8_t *buf,
+			     unsigned buflen)
+{
+	using namespace mixer_binary;
+
+	if (!is_binary(buf, buflen)) {
+		return -EINVAL;
+	}
+
+	header_s header;
+	memcpy(&header, buf, sizeof(header));
+
+	if (header.version != VERSION) {
+		debug("unsupported binary mixer version %d", header.version);
+		return -EPROTO;
+	}
+
+	if ((header.length < sizeof(header)) || (header.length > buflen)) {
+		debug("binary mixer truncated");
+		return -EINVAL;
+	}
+
+	if (crc32(buf + sizeof(header), header.length - sizeof(header)) != header.crc) {
+		debug("binary mixer crc mismatch");
+		return -EINVAL;
+	}
+
+	unsigned offset = sizeof(header);
+
+	for (unsigned i = 0; i < header.mixer_count; i++) {
+		record_s record;
+
+		if (offset + sizeof(record) > header.length) {
+			return -EINVAL;
+		}
+
+		memcpy(&record, buf + offset, sizeof(record));
+		offset += sizeof(record);
+
+		if (offset + record.length > header.length) {
+			return -EINVAL;
+		}
+
+		const uint8_t *payload = buf + offset;
+		Mixer *m = nullptr;
+
+		switch (record.type) {
+		case RECORD_NULL:
+			if (record.length == 0) {
+				m = new NullMixer;
+			}
+
+			break;
+
+		case RECORD_SIMPLE:
+			m = SimpleMixer::from_binary(control_cb, cb_handle, payload, record.length);
+			break;
+
+		case RECORD_MULTIROTOR:
+			m = MultirotorMixer::from_binary(control_cb, cb_handle, payload, record.length);
+			break;
+
+		case RECORD_TEXT:
+
+			// NUL-terminated text definition, parsed like load_from_buf()
+			if ((record.length > 1) && (payload[record.length - 1] == '\0')) {
+				unsigned resid = record.length - 1;
+				m = HelicopterMixer::from_text(control_cb, cb_handle, (const char *)payload, resid);
+			}
+
+			break;
+
+		default:
+			break;
+		}
+
+		if (m == nullptr) {
+			debug("binary mixer record %u (type %c) invalid", i, record.type);
+			return -EINVAL;
+		}
+
+		add_mixer(m);
+
+		offset += padded(record.length);
+	}
+
+	return 0;
+}
+
 void MixerGroup::set_max_delta_out_once(float delta_out_max)
 {
 	for (auto mixer : _mixers) {
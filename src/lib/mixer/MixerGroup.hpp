@@ -34,10 +34,15 @@
 #pragma once
 
 #include "MixerBase/Mixer.hpp"
+#include "MixerBase/MixerProgram.hpp"
 
 /**
  * Group of mixers, built up from single mixers and processed
  * in order when mixing.
+ *
+ * Once loaded, the group can be compiled into a flat MixerProgram which is then
+ * used by mix(). Otherwise (or if a mixer cannot be compiled) each mixer is
+ * called in turn.
  */
 class MixerGroup
 {
@@ -66,12 +71,31 @@ public:
 	 *
 	 * @param mixer			The mixer to be added.
 	 */
-	void				add_mixer(Mixer *mixer) { _mixers.add(mixer); }
+	void				add_mixer(Mixer *mixer) { _program.reset(); _mixers.add(mixer); }
 
 	/**
 	 * Remove all the mixers from the group.
 	 */
-	void				reset() { _mixers.clear(); }
+	void				reset() { _program.reset(); _mixers.clear(); }
+
+	/**
+	 * Compile the group into its flat execution form. Needs to be called again
+	 * after adding mixers, as add_mixer(), load_from_buf() and load_from_binary() drop
+	 * the program.
+	 *
+	 * @return			true if mix() uses the compiled program.
+	 */
+	bool				compile() { return _program.build(_mixers); }
+
+	/**
+	 * Drop the compiled program, mix() then calls each mixer in turn.
+	 */
+	void				decompile() { _program.reset(); }
+
+	/**
+	 * @return			true if mix() uses the compiled program.
+	 */
+	bool				compiled() const { return _program.valid(); }
 
 	/**
 	 * Count the mixers in the group.
@@ -135,6 +159,20 @@ public:
 	 */
 	int				load_from_buf(Mixer::ControlCallback control_cb, uintptr_t cb_handle, const char *buf, unsigned &buflen);
 
+	/**
+	 * Adds mixers to the group from a binary (precompiled) mixer buffer,
+	 * see MixerBase/MixerBinary.hpp for the format.
+	 *
+	 * Unlike load_from_buf(), the buffer needs to contain the complete
+	 * mixer file. The header and checksum are verified before any mixer is added.
+	 *
+	 * @param buf			The binary mixer buffer.
+	 * @param buflen		The length of the buffer.
+	 * @return			Zero on successful load, a negative errno otherwise.
+	 */
+	int				load_from_binary(Mixer::ControlCallback control_cb, uintptr_t cb_handle, const uint8_t *buf,
+			unsigned buflen);
+
 	/**
 	 * @brief      Update slew rate parameter. This tells instances of the class MultirotorMixer
 	 *             the maximum allowed change of the output values per cycle.
@@ -167,4 +205,6 @@ public:
 
 private:
 	List<Mixer *>			_mixers;	/**< linked list of mixers */
+
+	MixerProgram			_program;	/**< flattened form of _mixers, used if valid */
 };
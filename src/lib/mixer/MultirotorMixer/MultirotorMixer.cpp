@@ -39,6 +39,9 @@
 
 #include "MultirotorMixer.hpp"
 
+#include <mixer/MixerBase/MixerBinary.hpp>
+#include <mixer/MixerBase/MixerProgram.hpp>
+
 #include <float.h>
 #include <cstring>
 #include <cstdio>
@@ -128,13 +131,7 @@ MultirotorMixer::from_text(Mixer::ControlCallback control_cb, uintptr_t cb_handl
 
 	debug("remaining in buf: %d, first char: %c", buflen, buf[0]);
 
-	for (MultirotorGeometryUnderlyingType i = 0; i < (MultirotorGeometryUnderlyingType)MultirotorGeometry::MAX_GEOMETRY;
-	     i++) {
-		if (!strcmp(geomname, _config_key[i])) {
-			geometry = (MultirotorGeometry)i;
-			break;
-		}
-	}
+	geometry = geometry_from_key(geomname);
 
 	if (geometry == MultirotorGeometry::MAX_GEOMETRY) {
 		debug("unrecognised geometry '%s'", geomname);
@@ -146,6 +143,42 @@ MultirotorMixer::from_text(Mixer::ControlCallback control_cb, uintptr_t cb_handl
 	return new MultirotorMixer(control_cb, cb_handle, geometry);
 }
 
+MultirotorMixer *
+MultirotorMixer::from_binary(Mixer::ControlCallback control_cb, uintptr_t cb_handle, const uint8_t *data,
+			     unsigned len)
+{
+	mixer_binary::multirotor_s multirotor;
+
+	if (len != sizeof(multirotor)) {
+		return nullptr;
+	}
+
+	memcpy(&multirotor, data, sizeof(multirotor));
+	multirotor.geometry[sizeof(multirotor.geometry) - 1] = '\0';
+
+	const MultirotorGeometry geometry = geometry_from_key(multirotor.geometry);
+
+	if (geometry == MultirotorGeometry::MAX_GEOMETRY) {
+		debug("unrecognised geometry '%s'", multirotor.geometry);
+		return nullptr;
+	}
+
+	return new MultirotorMixer(control_cb, cb_handle, geometry);
+}
+
+MultirotorGeometry
+MultirotorMixer::geometry_from_key(const char *key)
+{
+	for (MultirotorGeometryUnderlyingType i = 0; i < (MultirotorGeometryUnderlyingType)MultirotorGeometry::MAX_GEOMETRY;
+	     i++) {
+		if (!strcmp(key, _config_key[i])) {
+			return (MultirotorGeometry)i;
+		}
+	}
+
+	return MultirotorGeometry::MAX_GEOMETRY;
+}
+
 float
 MultirotorMixer::compute_desaturation_gain(const float *desaturation_vector, const float *outputs,
 		saturation_status &sat_status, float min_output, float max_output) const
@@ -320,10 +353,28 @@ MultirotorMixer::mix(float *outputs, unsigned space)
 		return 0;
 	}
 
-	float roll    = math::constrain(get_control(0, 0), -1.0f, 1.0f);
-	float pitch   = math::constrain(get_control(0, 1), -1.0f, 1.0f);
-	float yaw     = math::constrain(get_control(0, 2), -1.0f, 1.0f);
-	float thrust  = math::constrain(get_control(0, 3), 0.0f, 1.0f);
+	const float controls[4] {get_control(0, 0), get_control(0, 1), get_control(0, 2), get_control(0, 3)};
+
+	return mix_block(controls, outputs, space);
+}
+
+bool
+MultirotorMixer::compile(MixerProgram &program)
+{
+	return program.add_block(*this, _control_cb, _cb_handle, 0, 4);
+}
+
+unsigned
+MultirotorMixer::mix_block(const float *controls, float *outputs, unsigned space)
+{
+	if (space < _rotor_count) {
+		return 0;
+	}
+
+	float roll    = math::constrain(controls[0], -1.0f, 1.0f);
+	float pitch   = math::constrain(controls[1], -1.0f, 1.0f);
+	float yaw     = math::constrain(controls[2], -1.0f, 1.0f);
+	float thrust  = math::constrain(controls[3], 0.0f, 1.0f);
 
 	// clean out class variable used to capture saturation
 	_saturation_status.value = 0;
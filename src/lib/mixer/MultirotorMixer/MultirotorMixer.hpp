@@ -117,6 +117,20 @@ public:
 	static MultirotorMixer *from_text(Mixer::ControlCallback control_cb, uintptr_t cb_handle, const char *buf,
 					  unsigned &buflen);
 
+	/**
+	 * Factory method for the binary mixer format.
+	 *
+	 * @param control_cb		The callback to invoke when fetching a
+	 *				control value.
+	 * @param cb_handle		Handle passed to the control callback.
+	 * @param data			Record payload (mixer_binary::multirotor_s).
+	 * @param len			Length of the payload in bytes.
+	 * @return			A new MultirotorMixer instance, or nullptr
+	 *				if the payload is bad.
+	 */
+	static MultirotorMixer *from_binary(Mixer::ControlCallback control_cb, uintptr_t cb_handle, const uint8_t *data,
+					    unsigned len);
+
 	unsigned		mix(float *outputs, unsigned space) override;
 
 	uint16_t		get_saturation_status() override { return _saturation_status.value; }
@@ -149,6 +163,13 @@ public:
 
 	unsigned		get_multirotor_count() override { return _rotor_count; }
 
+	bool			compile(MixerProgram &program) override;
+
+	/**
+	 * Mix the gathered controls (roll, pitch, yaw, thrust of group 0).
+	 */
+	unsigned		mix_block(const float *controls, float *outputs, unsigned space) override;
+
 	union saturation_status {
 		struct {
 			uint16_t valid		: 1; // 0 - true when the saturation status is used
@@ -167,6 +188,13 @@ public:
 	};
 
 private:
+	/**
+	 * Look up a geometry by its mixer file key (e.g. "4x").
+	 *
+	 * @return the geometry, or MultirotorGeometry::MAX_GEOMETRY if unknown
+	 */
+	static MultirotorGeometry geometry_from_key(const char *key);
+
 	/**
 	 * Computes the gain k by which desaturation_vector has to be multiplied
 	 * in order to unsaturate the output that has the greatest saturation.
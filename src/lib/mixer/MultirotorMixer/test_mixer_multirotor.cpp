@@ -34,12 +34,22 @@
 /**
  * testing binary that runs the multirotor mixer through test cases given
  * via file or stdin and compares the mixer output against expected values.
+ *
+ * Every case is also run through the compiled form (MixerProgram), which has
+ * to produce bit-identical outputs.
+ *
+ * Usage: test_mixer_multirotor [--bench] [file]
+ * With --bench, the direct and the compiled path are timed over all test cases.
  */
 
 #include "MultirotorMixer.hpp"
 
+#include <mixer/MixerBase/MixerProgram.hpp>
+
 #include <cstdio>
+#include <cstring>
 #include <math.h>
+#include <time.h>
 
 static const unsigned output_max = 16;
 static float actuator_controls[output_max] {};
@@ -56,12 +66,67 @@ mixer_callback(uintptr_t handle, uint8_t control_group, uint8_t control_index, f
 	return 0;
 }
 
+static double time_ns()
+{
+	timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static constexpr unsigned bench_max_cases = 4096;
+static constexpr unsigned bench_iterations = 200;
+static float bench_controls[bench_max_cases][4];
+
+/**
+ * Time the direct (callback) path against the compiled path over the recorded test cases.
+ */
+static void bench(MultirotorMixer &mixer, MixerProgram &program, unsigned num_cases)
+{
+	float outputs[output_max];
+	volatile float sink = 0.f;
+
+	double elapsed[2] {};
+
+	for (int path = 0; path < 2; path++) {
+		const double start = time_ns();
+
+		for (unsigned iteration = 0; iteration < bench_iterations; iteration++) {
+			for (unsigned i = 0; i < num_cases; i++) {
+				memcpy(actuator_controls, bench_controls[i], sizeof(bench_controls[i]));
+
+				if (path == 0) {
+					mixer.mix(outputs, output_max);
+
+				} else {
+					program.execute(outputs, output_max);
+				}
+
+				sink = sink + outputs[0];
+			}
+		}
+
+		elapsed[path] = (time_ns() - start) / (double)(bench_iterations * num_cases);
+	}
+
+	printf("bench: %u cases, direct: %.1f ns/mix, compiled: %.1f ns/mix\n", num_cases, elapsed[0], elapsed[1]);
+}
+
 int main(int argc, char *argv[])
 {
 	FILE *file_in = stdin;
+	bool run_bench = false;
 
-	if (argc > 1) {
-		file_in = fopen(argv[1], "r");
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--bench") == 0) {
+			run_bench = true;
+
+		} else {
+			file_in = fopen(argv[i], "r");
+		}
+	}
+
+	if (file_in == nullptr) {
+		return -1;
 	}
 
 	unsigned rotor_count = 0;
@@ -87,6 +152,22 @@ int main(int argc, char *argv[])
 	MultirotorMixer mixer(mixer_callback, 0, rotors, rotor_count);
 	mixer.set_airmode((Mixer::Airmode)airmode);
 
+	// a second instance (the mixer has state) run through the compiled form
+	MultirotorMixer compiled_mixer(mixer_callback, 0, rotors, rotor_count);
+	compiled_mixer.set_airmode((Mixer::Airmode)airmode);
+
+	List<Mixer *> compiled_mixers;
+	compiled_mixers.add(&compiled_mixer);
+
+	MixerProgram program;
+
+	if (!program.build(compiled_mixers)) {
+		printf("failed to compile the mixer\n");
+		return -1;
+	}
+
+	float compiled_outputs[output_max];
+
 	int test_counter = 0;
 	int num_failed = 0;
 
@@ -108,6 +189,16 @@ int main(int argc, char *argv[])
 			return -1;
 		}
 
+		if (program.execute(compiled_outputs, output_max) != rotor_count) {
+			return -1;
+		}
+
+		const bool compiled_differs = memcmp(actuator_outputs, compiled_outputs, rotor_count * sizeof(float)) != 0;
+
+		if (run_bench && test_counter < (int)bench_max_cases) {
+			memcpy(bench_controls[test_counter], actuator_controls, sizeof(bench_controls[test_counter]));
+		}
+
 		// Account for MultirotorMixer outputing [-1,1] and python script [0,1]
 		for (unsigned i = 0; i < rotor_count; i++) {
 			actuator_outputs[i] = (actuator_outputs[i] + 1.f) * .5f;
@@ -130,6 +221,11 @@ int main(int argc, char *argv[])
 			break;
 		}
 
+		if (compiled_differs) {
+			printf("test %i: compiled mixer output differs\n", test_counter + 1);
+			failed = true;
+		}
+
 		if (failed) {
 			printf("test %i failed:\n", test_counter + 1);
 			printf("control input  : %.3f %.3f %.3f %.3f\n", (double)actuator_controls[0], (double)actuator_controls[1],
@@ -164,6 +260,10 @@ int main(int argc, char *argv[])
 	printf("tested %i cases: %i success, %i failed\n", test_counter,
 	       test_counter - num_failed, num_failed);
 
+	if (run_bench && test_counter > 0) {
+		bench(mixer, program, math::min((unsigned)test_counter, bench_max_cases));
+	}
+
 
 	if (file_in != stdin) {
 		fclose(file_in);
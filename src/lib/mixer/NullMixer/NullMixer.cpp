@@ -33,6 +33,8 @@
 
 #include "NullMixer.hpp"
 
+#include <mixer/MixerBase/MixerProgram.hpp>
+
 #include <math.h>
 #include <cstring>
 #include <ctype.h>
@@ -48,6 +50,12 @@ NullMixer::mix(float *outputs, unsigned space)
 	return 0;
 }
 
+bool
+NullMixer::compile(MixerProgram &program)
+{
+	return program.add_null();
+}
+
 NullMixer *
 NullMixer::from_text(const char *buf, unsigned &buflen)
 {
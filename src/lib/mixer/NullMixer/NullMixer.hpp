@@ -72,4 +72,6 @@ public:
 	unsigned			set_trim(float trim) override { return 1; }
 	unsigned			get_trim(float *trim) override { return 1; }
 
+	bool				compile(MixerProgram &program) override;
+
 };
@@ -39,8 +39,12 @@
 
 #include "SimpleMixer.hpp"
 
+#include <mixer/MixerBase/MixerBinary.hpp>
+#include <mixer/MixerBase/MixerProgram.hpp>
+
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #define debug(fmt, args...)	do { } while(0)
 //#define debug(fmt, args...)	do { printf("[mixer] " fmt "\n", ##args); } while(0)
@@ -237,6 +241,66 @@ out:
 	return sm;
 }
 
+static void
+scaler_from_binary(const mixer_binary::scaler_s &s, mixer_scaler_s &scaler)
+{
+	// same conversion as the text parser
+	scaler.negative_scale	= s.negative_scale / 10000.0f;
+	scaler.positive_scale	= s.positive_scale / 10000.0f;
+	scaler.offset		= s.offset / 10000.0f;
+	scaler.min_output	= s.min_output / 10000.0f;
+	scaler.max_output	= s.max_output / 10000.0f;
+}
+
+SimpleMixer *
+SimpleMixer::from_binary(Mixer::ControlCallback control_cb, uintptr_t cb_handle, const uint8_t *data, unsigned len)
+{
+	mixer_binary::simple_s simple;
+
+	if (len < sizeof(simple)) {
+		return nullptr;
+	}
+
+	memcpy(&simple, data, sizeof(simple));
+
+	/* at least 1 input is required */
+	if ((simple.control_count == 0)
+	    || (len != sizeof(simple) + simple.control_count * sizeof(mixer_binary::control_s))) {
+		debug("simple binary mixer has bad length");
+		return nullptr;
+	}
+
+	mixer_simple_s *mixinfo = (mixer_simple_s *)malloc(MIXER_SIMPLE_SIZE(simple.control_count));
+
+	if (mixinfo == nullptr) {
+		debug("could not allocate memory for mixer info");
+		return nullptr;
+	}
+
+	mixinfo->control_count = simple.control_count;
+	scaler_from_binary(simple.output_scaler, mixinfo->output_scaler);
+
+	const uint8_t *controls = data + sizeof(simple);
+
+	for (unsigned i = 0; i < simple.control_count; i++) {
+		mixer_binary::control_s control;
+		memcpy(&control, controls + i * sizeof(control), sizeof(control));
+
+		mixinfo->controls[i].control_group = control.control_group;
+		mixinfo->controls[i].control_index = control.control_index;
+		scaler_from_binary(control.scaler, mixinfo->controls[i].scaler);
+	}
+
+	SimpleMixer *sm = new SimpleMixer(control_cb, cb_handle, mixinfo);
+
+	if (sm == nullptr) {
+		debug("could not allocate memory for mixer");
+		free(mixinfo);
+	}
+
+	return sm;
+}
+
 unsigned
 SimpleMixer::mix(float *outputs, unsigned space)
 {
@@ -265,6 +329,17 @@ SimpleMixer::mix(float *outputs, unsigned space)
 	return 1;
 }
 
+bool
+SimpleMixer::compile(MixerProgram &program)
+{
+	if (_pinfo == nullptr) {
+		return false;
+	}
+
+	return program.add_sum(*this, _control_cb, _cb_handle, _pinfo->controls, _pinfo->control_count,
+			       _pinfo->output_scaler);
+}
+
 void
 SimpleMixer::groups_required(uint32_t &groups)
 {
@@ -313,21 +388,6 @@ SimpleMixer::check()
 	return 0;
 }
 
-float
-SimpleMixer::scale(const mixer_scaler_s &scaler, float input)
-{
-	float output;
-
-	if (input < 0.0f) {
-		output = (input * scaler.negative_scale) + scaler.offset;
-
-	} else {
-		output = (input * scaler.positive_scale) + scaler.offset;
-	}
-
-	return math::constrain(output, scaler.min_output, scaler.max_output);
-}
-
 int
 SimpleMixer::scale_check(mixer_scaler_s &scaler)
 {
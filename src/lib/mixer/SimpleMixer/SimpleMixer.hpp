@@ -103,6 +103,21 @@ public:
 	static SimpleMixer		*from_text(Mixer::ControlCallback control_cb, uintptr_t cb_handle, const char *buf,
 			unsigned &buflen);
 
+	/**
+	 * Factory method for the binary mixer format.
+	 *
+	 * @param control_cb		The callback to invoke when fetching a
+	 *				control value.
+	 * @param cb_handle		Handle passed to the control callback.
+	 * @param data			Record payload (mixer_binary::simple_s and
+	 *				its controls).
+	 * @param len			Length of the payload in bytes.
+	 * @return			A new SimpleMixer instance, or nullptr
+	 *				if the payload is bad.
+	 */
+	static SimpleMixer		*from_binary(Mixer::ControlCallback control_cb, uintptr_t cb_handle, const uint8_t *data,
+			unsigned len);
+
 	unsigned			mix(float *outputs, unsigned space) override;
 
 	void				groups_required(uint32_t &groups) override;
@@ -120,7 +135,7 @@ public:
 	unsigned			set_trim(float trim) override;
 	unsigned			get_trim(float *trim) override;
 
-private:
+	bool				compile(MixerProgram &program) override;
 
 	/**
 	 * Perform simpler linear scaling.
@@ -129,7 +144,21 @@ private:
 	 * @param input			The value to be scaled.
 	 * @return			The scaled value.
 	 */
-	static float			scale(const mixer_scaler_s &scaler, float input);
+	static inline float		scale(const mixer_scaler_s &scaler, float input)
+	{
+		float output;
+
+		if (input < 0.0f) {
+			output = (input * scaler.negative_scale) + scaler.offset;
+
+		} else {
+			output = (input * scaler.positive_scale) + scaler.offset;
+		}
+
+		return math::constrain(output, scaler.min_output, scaler.max_output);
+	}
+
+private:
 
 	/**
 	 * Validate a scaler
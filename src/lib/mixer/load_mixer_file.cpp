@@ -43,6 +43,8 @@
 
 #include "mixer_load.h"
 
+#include "MixerBase/MixerBinary.hpp"
+
 int load_mixer_file(const char *fname, char *buf, unsigned maxlen)
 {
 	FILE *fp;
@@ -110,3 +112,24 @@ int load_mixer_file(const char *fname, char *buf, unsigned maxlen)
 	fclose(fp);
 	return 0;
 }
+
+int load_mixer_file_binary(const char *fname, char *buf, unsigned maxlen)
+{
+	FILE *fp = fopen(fname, "rb");
+
+	if (fp == nullptr) {
+		return -1;
+	}
+
+	/* read the whole file at once, it needs to fit into the buffer */
+	size_t len = fread(buf, 1, maxlen, fp);
+	const bool eof = feof(fp);
+	fclose(fp);
+
+	if (!eof || !mixer_binary::is_binary(buf, len)) {
+		// not an error, the caller falls back to the text mixer
+		return -1;
+	}
+
+	return len;
+}
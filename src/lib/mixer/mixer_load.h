@@ -46,6 +46,14 @@ __BEGIN_DECLS
 
 __EXPORT int load_mixer_file(const char *fname, char *buf, unsigned maxlen);
 
+/**
+ * Read a binary (precompiled) mixer file into a buffer.
+ *
+ * @return the number of bytes read, or -1 if the file does not exist,
+ *         does not fit into the buffer or is not a binary mixer file
+ */
+__EXPORT int load_mixer_file_binary(const char *fname, char *buf, unsigned maxlen);
+
 __END_DECLS
 
 #endif
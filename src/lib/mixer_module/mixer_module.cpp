@@ -33,6 +33,7 @@
 
 #include "mixer_module.hpp"
 
+#include <lib/mixer/MixerBase/MixerBinary.hpp>
 #include <lib/mixer/MultirotorMixer/MultirotorMixer.hpp>
 
 #include <uORB/Publication.hpp>
@@ -49,7 +50,9 @@ MixingOutput::MixingOutput(uint8_t max_num_outputs, OutputModuleInterface &inter
 	{&interface, ORB_ID(actuator_controls_0)},
 	{&interface, ORB_ID(actuator_controls_1)},
 	{&interface, ORB_ID(actuator_controls_2)},
-	{&interface, ORB_ID(actuator_controls_3)}
+	{&interface, ORB_ID(actuator_controls_3)},
+	{&interface, ORB_ID(actuator_controls_4)},
+	{&interface, ORB_ID(actuator_controls_5)}
 },
 _scheduling_policy(scheduling_policy),
 _support_esc_calibration(support_esc_calibration),
@@ -88,7 +91,7 @@ void MixingOutput::printStatus() const
 {
 	perf_print_counter(_control_latency_perf);
 	PX4_INFO("Switched to rate_ctrl work queue: %i", (int)_wq_switched);
-	PX4_INFO("Mixer loaded: %s", _mixers ? "yes" : "no");
+	PX4_INFO("Mixer loaded: %s%s", _mixers ? "yes" : "no", (_mixers && _mixers->compiled()) ? " (compiled)" : "");
 	PX4_INFO("Driver instance: %i", _driver_instance);
 
 	PX4_INFO("Channel Configuration:");
@@ -129,11 +132,12 @@ bool MixingOutput::updateSubscriptions(bool allow_wq_switch, bool limit_callback
 		unregister();
 		_interface.ScheduleClear();
 
-		// if subscribed to control group 0 or 1 then move to the rate_ctrl WQ
+		// if subscribed to control group 0 or 1 (or the control allocator output) then move to the rate_ctrl WQ
 		const bool sub_group_0 = (_groups_required & (1 << 0));
 		const bool sub_group_1 = (_groups_required & (1 << 1));
+		const bool sub_group_allocated = (_groups_required & (1 << actuator_controls_s::GROUP_INDEX_ALLOCATED_PART1));
 
-		if (allow_wq_switch && !_wq_switched && (sub_group_0 || sub_group_1)) {
+		if (allow_wq_switch && !_wq_switched && (sub_group_0 || sub_group_1 || sub_group_allocated)) {
 			if (_interface.ChangeWorkQeue(px4::wq_configurations::rate_ctrl)) {
 				// let the new WQ handle the subscribe update
 				_wq_switched = true;
@@ -147,7 +151,7 @@ bool MixingOutput::updateSubscriptions(bool allow_wq_switch, bool limit_callback
 		bool sub_group_1_callback_registered = false;
 
 		// register callback to all required actuator control groups
-		for (unsigned i = 0; i < actuator_controls_s::NUM_ACTUATOR_CONTROL_GROUPS; i++) {
+		for (unsigned i = 0; i < actuator_controls_s::NUM_ACTUATOR_CONTROL_GROUPS_ALLOCATED; i++) {
 
 			if (limit_callbacks_to_primary) {
 				// don't register additional callbacks if actuator_controls_0 or actuator_controls_1 are already registered
@@ -156,6 +160,12 @@ bool MixingOutput::updateSubscriptions(bool allow_wq_switch, bool limit_callback
 				}
 			}
 
+			// both allocated groups are published together, only run on the first one
+			if ((i == actuator_controls_s::GROUP_INDEX_ALLOCATED_PART2)
+			    && (_groups_required & (1 << actuator_controls_s::GROUP_INDEX_ALLOCATED_PART1))) {
+				continue;
+			}
+
 			if (_groups_required & (1 << i)) {
 				if (_control_subs[i].registerCallback()) {
 					PX4_DEBUG("subscribed to actuator_controls_%d", i);
@@ -197,7 +207,7 @@ void MixingOutput::setMaxTopicUpdateRate(unsigned max_topic_update_interval_us)
 {
 	_max_topic_update_interval_us = max_topic_update_interval_us;
 
-	for (unsigned i = 0; i < actuator_controls_s::NUM_ACTUATOR_CONTROL_GROUPS; i++) {
+	for (unsigned i = 0; i < actuator_controls_s::NUM_ACTUATOR_CONTROL_GROUPS_ALLOCATED; i++) {
 		if (_groups_subscribed & (1 << i)) {
 			_control_subs[i].set_interval_us(_max_topic_update_interval_us);
 		}
@@ -361,7 +371,7 @@ bool MixingOutput::update()
 	unsigned n_updates = 0;
 
 	/* get controls for required topics */
-	for (unsigned i = 0; i < actuator_controls_s::NUM_ACTUATOR_CONTROL_GROUPS; i++) {
+	for (unsigned i = 0; i < actuator_controls_s::NUM_ACTUATOR_CONTROL_GROUPS_ALLOCATED; i++) {
 		if (_groups_subscribed & (1 << i)) {
 			if (_control_subs[i].copy(&_controls[i])) {
 				n_updates++;
@@ -457,7 +467,7 @@ void
 MixingOutput::updateLatencyPerfCounter(const actuator_outputs_s &actuator_outputs)
 {
 	// use first valid timestamp_sample for latency tracking
-	for (int i = 0; i < actuator_controls_s::NUM_ACTUATOR_CONTROL_GROUPS; i++) {
+	for (int i = 0; i < actuator_controls_s::NUM_ACTUATOR_CONTROL_GROUPS_ALLOCATED; i++) {
 		const bool required = _groups_required & (1 << i);
 		const hrt_abstime &timestamp_sample = _controls[i].timestamp_sample;
 
@@ -569,7 +579,7 @@ int MixingOutput::loadMixer(const char *buf, unsigned len)
 		return -ENOMEM;
 	}
 
-	int ret = _mixers->load_from_buf(controlCallback, (uintptr_t)this, buf, len);
+	int ret = loadMixerGroup(*_mixers, buf, len);
 
 	if (ret != 0) {
 		PX4_ERR("mixer load failed with %d", ret);
@@ -582,11 +592,25 @@ int MixingOutput::loadMixer(const char *buf, unsigned len)
 	_mixers->groups_required(_groups_required);
 	PX4_DEBUG("loaded mixers \n%s\n", buf);
 
+	// flatten the mixers for the output path, mix() falls back to the list of mixers otherwise
+	if (!_mixers->compile()) {
+		PX4_DEBUG("mixers not compiled");
+	}
+
 	updateParams();
 	_interface.mixerChanged();
 	return ret;
 }
 
+int MixingOutput::loadMixerGroup(MixerGroup &mixers, const char *buf, unsigned len)
+{
+	if (mixer_binary::is_binary(buf, len)) {
+		return mixers.load_from_binary(controlCallback, (uintptr_t)this, (const uint8_t *)buf, len);
+	}
+
+	return mixers.load_from_buf(controlCallback, (uintptr_t)this, buf, len);
+}
+
 void MixingOutput::handleCommands()
 {
 	if ((Command::Type)_command.command.load() == Command::Type::None) {
@@ -603,6 +627,18 @@ void MixingOutput::handleCommands()
 		_command.result = 0;
 		break;
 
+	case Command::Type::swapMixer: {
+			MixerGroup *previous = _mixers;
+			_mixers = _command.mixers;
+			_groups_required = 0;
+			_mixers->groups_required(_groups_required);
+			updateParams();
+			_interface.mixerChanged();
+			_command.mixers = previous; // freed by the caller, outside of the output path
+			_command.result = 0;
+		}
+		break;
+
 	default:
 		break;
 	}
@@ -661,3 +697,51 @@ int MixingOutput::loadMixerThreadSafe(const char *buf, unsigned len)
 
 	return _command.result;
 }
+
+int MixingOutput::swapMixerThreadSafe(const char *buf, unsigned len)
+{
+	if ((Command::Type)_command.command.load() != Command::Type::None) {
+		// Cannot happen, because we expect only one other thread to call this.
+		// But as a safety precaution we return here.
+		PX4_ERR("Command not None");
+		return -1;
+	}
+
+	MixerGroup *mixers = new MixerGroup();
+
+	if (mixers == nullptr) {
+		return -ENOMEM;
+	}
+
+	int ret = loadMixerGroup(*mixers, buf, len);
+
+	if (ret != 0 || mixers->count() == 0) {
+		PX4_ERR("mixer load failed with %d", ret);
+		delete mixers;
+		return ret != 0 ? ret : -EINVAL;
+	}
+
+	// flatten the mixers for the output path, mix() falls back to the list of mixers otherwise
+	if (!mixers->compile()) {
+		PX4_DEBUG("mixers not compiled");
+	}
+
+	lock();
+
+	_command.mixers = mixers;
+	_command.command.store((int)Command::Type::swapMixer);
+
+	_interface.ScheduleNow();
+
+	unlock();
+
+	// wait until processed
+	while ((Command::Type)_command.command.load() != Command::Type::None) {
+		usleep(1000);
+	}
+
+	delete _command.mixers;
+	_command.mixers = nullptr;
+
+	return _command.result;
+}
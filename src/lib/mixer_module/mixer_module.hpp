@@ -153,6 +153,15 @@ public:
 
 	int loadMixer(const char *buf, unsigned len);
 
+	/**
+	 * Replace the complete mixer with one loaded from a (text or binary) buffer, called from another thread.
+	 * The new mixer is loaded and compiled in the calling thread, the output path only swaps the pointer,
+	 * so outputs keep running with the old mixer until then. On failure the old mixer remains active.
+	 * This is thread-safe, as long as only one other thread at a time calls this.
+	 * @return 0 on success, <0 error otherwise
+	 */
+	int swapMixerThreadSafe(const char *buf, unsigned len);
+
 	const actuator_armed_s &armed() const { return _armed; }
 
 	MixerGroup *mixers() const { return _mixers; }
@@ -184,6 +193,12 @@ protected:
 private:
 	void handleCommands();
 
+	/**
+	 * Load mixer(s) into a group, the buffer can be either a text or a binary mixer definition
+	 * @return 0 on success, <0 error otherwise
+	 */
+	int loadMixerGroup(MixerGroup &mixers, const char *buf, unsigned len);
+
 	bool armNoThrottle() const
 	{
 		return (_armed.prearmed && !_armed.armed) || _armed.in_esc_calibration_mode;
@@ -207,11 +222,13 @@ private:
 		enum class Type : int {
 			None,
 			resetMixer,
-			loadMixer
+			loadMixer,
+			swapMixer
 		};
 		px4::atomic<int> command{(int)Type::None};
 		const char *mixer_buf;
 		unsigned mixer_buf_length;
+		MixerGroup *mixers; ///< swapMixer: new mixers in, previous mixers out
 		int result;
 	};
 	Command _command; ///< incoming commands (from another thread)
@@ -236,12 +253,12 @@ private:
 	output_limit_t _output_limit;
 
 	uORB::Subscription _armed_sub{ORB_ID(actuator_armed)};
-	uORB::SubscriptionCallbackWorkItem _control_subs[actuator_controls_s::NUM_ACTUATOR_CONTROL_GROUPS];
+	uORB::SubscriptionCallbackWorkItem _control_subs[actuator_controls_s::NUM_ACTUATOR_CONTROL_GROUPS_ALLOCATED];
 
 	uORB::PublicationMulti<actuator_outputs_s> _outputs_pub{ORB_ID(actuator_outputs)};
 	uORB::PublicationMulti<multirotor_motor_limits_s> _to_mixer_status{ORB_ID(multirotor_motor_limits)}; 	///< mixer status flags
 
-	actuator_controls_s _controls[actuator_controls_s::NUM_ACTUATOR_CONTROL_GROUPS] {};
+	actuator_controls_s _controls[actuator_controls_s::NUM_ACTUATOR_CONTROL_GROUPS_ALLOCATED] {};
 	actuator_armed_s _armed{};
 
 	hrt_abstime _time_last_mix{0};
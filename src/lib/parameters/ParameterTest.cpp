@@ -37,6 +37,7 @@
 #include <uORB/uORBManager.hpp>
 
 #include <gtest/gtest.h>
+#include <math.h>
 
 class ParameterTest : public ::testing::Test
 {
@@ -78,6 +79,52 @@ TEST_F(ParameterTest, testParamReadWrite)
 	EXPECT_FLOAT_EQ(42.f, value2);
 }
 
+TEST_F(ParameterTest, testParamHashCheck)
+{
+	// GIVEN: a used parameter
+	param_t param = param_handle(px4::params::CP_DIST);
+	param_set_used(param);
+
+	// WHEN: we request the hash twice without changes
+	const uint32_t hash_default = param_hash_check();
+
+	// THEN: the cached hash should be identical
+	EXPECT_EQ(hash_default, param_hash_check());
+
+	// WHEN: we change the parameter
+	float value = 42.f;
+	EXPECT_EQ(0, param_set(param, &value));
+
+	// THEN: the hash should change
+	const uint32_t hash_changed = param_hash_check();
+	EXPECT_NE(hash_default, hash_changed);
+	EXPECT_EQ(hash_changed, param_hash_check());
+
+	// WHEN: we reset the parameter
+	EXPECT_EQ(0, param_reset(param));
+
+	// THEN: the hash should be the one of the default value again
+	EXPECT_EQ(hash_default, param_hash_check());
+}
+
+TEST_F(ParameterTest, testParamHashCheckSmallChange)
+{
+	// GIVEN: a used parameter with a non-default value
+	param_t param = param_handle(px4::params::CP_DIST);
+	param_set_used(param);
+	float value = 0.5f;
+	EXPECT_EQ(0, param_set(param, &value));
+	const uint32_t hash_before = param_hash_check();
+
+	// WHEN: we change it by less than FLT_EPSILON (not notified, but stored)
+	value = nextafterf(value, 100.f);
+	EXPECT_EQ(0, param_set(param, &value));
+
+	// THEN: the cached hash should still be invalidated
+	EXPECT_NE(hash_before, param_hash_check());
+
+	EXPECT_EQ(0, param_reset(param));
+}
 
 TEST_F(ParameterTest, testUorbSendReceive)
 {
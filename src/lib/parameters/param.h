@@ -215,6 +215,18 @@ __EXPORT size_t		param_size(param_t param);
  */
 __EXPORT int		param_get(param_t param, void *val);
 
+union param_value_u;
+
+/**
+ * Copy the values of several parameters while taking the parameter lock only once.
+ *
+ * @param params	Array of handles returned by param_find or passed by param_foreach.
+ * @param values	Where to return the values, one entry per handle.
+ * @param count		Number of handles.
+ * @return		Number of values copied, less than count if an invalid handle was encountered.
+ */
+__EXPORT unsigned	param_get_multiple(const param_t *params, union param_value_u *values, unsigned count);
+
 /**
  * Set the value of a parameter.
  *
@@ -53,6 +53,8 @@
 
 #include <drivers/drv_hrt.h>
 #include <lib/perf/perf_counter.h>
+#include <px4_platform_common/atomic.h>
+#include <px4_platform_common/boot_profile.h>
 #include <px4_platform_common/px4_config.h>
 #include <px4_platform_common/defines.h>
 #include <px4_platform_common/posix.h>
@@ -161,6 +163,18 @@ static perf_counter_t param_find_perf;
 static perf_counter_t param_get_perf;
 static perf_counter_t param_set_perf;
 
+/**
+ * Cached result of param_hash_check(). Every change of a value or of the used
+ * flags bumps param_hash_generation (O(1)), the hash itself is only recomputed
+ * on the next request after a change, under the reader lock. The result is
+ * published without a lock: the publisher claims the cache by swapping the
+ * cached generation to 0, then stores the hash and the generation. Readers only
+ * take the hash if the cached generation matches before and after reading it.
+ */
+static px4::atomic<uint32_t> param_hash_generation{2};
+static px4::atomic<uint32_t> param_hash_cached_generation{1};
+static px4::atomic<uint32_t> param_hash_cached{0};
+
 static px4_sem_t param_sem_save; ///< this protects against concurrent param saves (file or flash access).
 ///< we use a separate lock to allow concurrent param reads and saves.
 ///< a param_set could still be blocked by a param save, because it
@@ -581,6 +595,31 @@ param_get(param_t param, void *val)
 	return result;
 }
 
+unsigned
+param_get_multiple(const param_t *params, union param_value_u *values, unsigned count)
+{
+	unsigned copied = 0;
+
+	if (params && values) {
+		param_lock_reader();
+
+		for (; copied < count; copied++) {
+			const void *v = param_get_value_ptr(params[copied]);
+
+			if (v == nullptr) {
+				break;
+			}
+
+			memcpy(&values[copied], v, param_size(params[copied]));
+			perf_count(param_get_perf);
+		}
+
+		param_unlock_reader();
+	}
+
+	return copied;
+}
+
 /**
  * worker callback method to save the parameters
  * @param arg unused
@@ -668,6 +707,7 @@ param_set_internal(param_t param, const void *val, bool mark_saved, bool notify_
 {
 	int result = -1;
 	bool params_changed = false;
+	bool value_changed = false; // any bit-level change of the stored value, for the hash cache
 
 	param_lock_writer();
 	perf_begin(param_set_perf);
@@ -703,6 +743,7 @@ param_set_internal(param_t param, const void *val, bool mark_saved, bool notify_
 				int pos = utarray_eltidx(param_values, s);
 				utarray_erase(param_values, pos, 1);
 				params_changed = true;
+				value_changed = true;
 			}
 
 			// do nothing if param not already set and being set to default
@@ -714,6 +755,7 @@ param_set_internal(param_t param, const void *val, bool mark_saved, bool notify_
 				buf.param = param;
 
 				params_changed = true;
+				value_changed = true;
 
 				/* add it to the array and sort */
 				utarray_push_back(param_values, &buf);
@@ -727,11 +769,14 @@ param_set_internal(param_t param, const void *val, bool mark_saved, bool notify_
 			switch (param_type(param)) {
 			case PARAM_TYPE_INT32:
 				params_changed = params_changed || s->val.i != *(int32_t *)val;
+				value_changed = value_changed || s->val.i != *(int32_t *)val;
 				s->val.i = *(int32_t *)val;
 				break;
 
 			case PARAM_TYPE_FLOAT:
+				// notify only on significant changes, but the hash covers the stored bits
 				params_changed = params_changed || fabsf(s->val.f - * (float *)val) > FLT_EPSILON;
+				value_changed = value_changed || memcmp(&s->val.f, val, sizeof(float)) != 0;
 				s->val.f = *(float *)val;
 				break;
 
@@ -750,6 +795,10 @@ param_set_internal(param_t param, const void *val, bool mark_saved, bool notify_
 	}
 
 out:
+	if (value_changed) {
+		param_hash_generation.fetch_add(1);
+	}
+
 	perf_end(param_set_perf);
 	param_unlock_writer();
 
@@ -814,9 +863,13 @@ void param_set_used_internal(param_t param)
 		return;
 	}
 
-	// FIXME: this needs locking too
-	param_changed_storage[param_index / bits_per_allocation_unit] |=
-		(1 << param_index % bits_per_allocation_unit);
+	const uint8_t mask = (1 << param_index % bits_per_allocation_unit);
+
+	if ((param_changed_storage[param_index / bits_per_allocation_unit] & mask) == 0) {
+		// FIXME: this needs locking too
+		param_changed_storage[param_index / bits_per_allocation_unit] |= mask;
+		param_hash_generation.fetch_add(1);
+	}
 }
 
 static int param_reset_internal(param_t param, bool notify = true)
@@ -835,6 +888,7 @@ static int param_reset_internal(param_t param, bool notify = true)
 		if (s != nullptr) {
 			int pos = utarray_eltidx(param_values, s);
 			utarray_erase(param_values, pos, 1);
+			param_hash_generation.fetch_add(1);
 		}
 
 		param_found = true;
@@ -865,6 +919,7 @@ param_reset_all_internal(bool auto_save)
 
 	/* mark as reset / deleted */
 	param_values = nullptr;
+	param_hash_generation.fetch_add(1);
 
 	if (auto_save) {
 		param_autosave();
@@ -1012,8 +1067,8 @@ int param_save_default()
 /**
  * @return 0 on success, 1 if all params have not yet been stored, -1 if device open failed, -2 if writing parameters failed
  */
-int
-param_load_default()
+static int
+param_load_default_internal()
 {
 	int res = 0;
 	const char *filename = param_get_default_file();
@@ -1045,6 +1100,15 @@ param_load_default()
 	return res;
 }
 
+int
+param_load_default()
+{
+	const hrt_abstime start = hrt_absolute_time();
+	const int ret = param_load_default_internal();
+	px4_boot_profile_init("param_load", start, hrt_absolute_time());
+	return ret;
+}
+
 int
 param_export(int fd, bool only_unsaved, param_filter_func filter)
 {
@@ -1353,10 +1417,24 @@ param_foreach(void (*func)(void *arg, param_t param), void *arg, bool only_chang
 
 uint32_t param_hash_check()
 {
+	/* nothing changed since the last request */
+	const uint32_t current_generation = param_hash_generation.load();
+
+	if (param_hash_cached_generation.load() == current_generation) {
+		const uint32_t param_hash = param_hash_cached.load();
+
+		if (param_hash_cached_generation.load() == current_generation) {
+			return param_hash;
+		}
+	}
+
 	uint32_t param_hash = 0;
 
 	param_lock_reader();
 
+	/* a change during the computation (param_set_used() is not locked) leaves the cache stale */
+	const uint32_t generation = param_hash_generation.load();
+
 	/* compute the CRC32 over all string param names and 4 byte values */
 	for (param_t param = 0; handle_in_range(param); param++) {
 		if (!param_used(param) || param_is_volatile(param)) {
@@ -1371,6 +1449,16 @@ uint32_t param_hash_check()
 
 	param_unlock_reader();
 
+	/* publish, unless the cache is being written or already holds this or a newer generation */
+	uint32_t cached_generation = param_hash_cached_generation.load();
+
+	if ((cached_generation != 0) && ((int32_t)(generation - cached_generation) > 0)
+	    && param_hash_cached_generation.compare_exchange(&cached_generation, 0)) {
+
+		param_hash_cached.store(param_hash);
+		param_hash_cached_generation.store(generation);
+	}
+
 	return param_hash;
 }
 
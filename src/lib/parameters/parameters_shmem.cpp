@@ -637,6 +637,23 @@ param_get(param_t param, void *val)
 	return result;
 }
 
+unsigned
+param_get_multiple(const param_t *params, union param_value_u *values, unsigned count)
+{
+	unsigned copied = 0;
+
+	// every value might need to be refreshed from shared memory, fall back to single gets
+	if (params && values) {
+		for (; copied < count; copied++) {
+			if (param_get(params[copied], &values[copied]) != 0) {
+				break;
+			}
+		}
+	}
+
+	return copied;
+}
+
 /**
  * worker callback method to save the parameters
  * @param arg unused
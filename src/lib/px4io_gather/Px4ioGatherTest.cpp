@@ -0,0 +1,168 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file Px4ioGatherTest.cpp
+ * Round trip of gather requests between the FMU packing and the IO serving side.
+ */
+
+#include <gtest/gtest.h>
+
+#include "px4io_gather.h"
+
+namespace
+{
+
+// two fake register pages, filled with page * 100 + offset
+uint16_t page_a[10];
+uint16_t page_b[4];
+
+int get_registers(uint8_t page, uint8_t offset, uint16_t **values, unsigned *num_values)
+{
+	uint16_t *regs;
+	unsigned count;
+
+	switch (page) {
+	case 1:
+		regs = page_a;
+		count = sizeof(page_a) / sizeof(page_a[0]);
+		break;
+
+	case 2:
+		regs = page_b;
+		count = sizeof(page_b) / sizeof(page_b[0]);
+		break;
+
+	default:
+		return -1;
+	}
+
+	if (offset >= count) {
+		return -1;
+	}
+
+	*values = regs + offset;
+	*num_values = count - offset;
+	return 0;
+}
+
+class Px4ioGatherTest : public ::testing::Test
+{
+public:
+	void SetUp() override
+	{
+		for (unsigned i = 0; i < sizeof(page_a) / sizeof(page_a[0]); i++) {
+			page_a[i] = 100 + i;
+		}
+
+		for (unsigned i = 0; i < sizeof(page_b) / sizeof(page_b[0]); i++) {
+			page_b[i] = 200 + i;
+		}
+	}
+};
+
+} // namespace
+
+TEST_F(Px4ioGatherTest, RoundTrip)
+{
+	const px4io_gather_range ranges[] {
+		{1, 2, 3},
+		{2, 0, 1},
+		{1, 8, 2},
+	};
+	uint16_t regs[PKT_MAX_REGS] {};
+
+	const int total = px4io_gather_pack(regs, ranges, 3, PKT_MAX_REGS);
+	ASSERT_EQ(total, 6);
+	EXPECT_EQ(regs[0], PX4IO_GATHER_ADDR(1, 2));
+	EXPECT_EQ(regs[1], 3);
+	EXPECT_EQ(regs[4], PX4IO_GATHER_ADDR(1, 8));
+	EXPECT_EQ(regs[5], 2);
+
+	ASSERT_EQ(px4io_gather_serve(regs, 3, total, get_registers), 0);
+
+	const uint16_t expected[] {102, 103, 104, 200, 108, 109};
+
+	for (int i = 0; i < total; i++) {
+		EXPECT_EQ(regs[i], expected[i]) << "register " << i;
+	}
+}
+
+TEST_F(Px4ioGatherTest, PackRejectsUnrepresentable)
+{
+	uint16_t regs[PKT_MAX_REGS] {};
+
+	// the descriptors of two ranges do not fit into three registers
+	const px4io_gather_range too_short[] {{1, 0, 2}, {2, 0, 1}};
+	EXPECT_EQ(px4io_gather_pack(regs, too_short, 2, PKT_MAX_REGS), -1);
+
+	// more than the transfer limit
+	const px4io_gather_range too_long[] {{1, 0, 10}, {1, 0, 10}};
+	EXPECT_EQ(px4io_gather_pack(regs, too_long, 2, 16), -1);
+
+	EXPECT_EQ(px4io_gather_pack(regs, too_long, 0, PKT_MAX_REGS), -1);
+
+	px4io_gather_range too_many[PX4IO_GATHER_MAX_RANGES + 1];
+
+	for (auto &range : too_many) {
+		range = {1, 0, 2};
+	}
+
+	EXPECT_EQ(px4io_gather_pack(regs, too_many, PX4IO_GATHER_MAX_RANGES + 1, PKT_MAX_REGS), -1);
+}
+
+TEST_F(Px4ioGatherTest, ServeRejectsBadRequests)
+{
+	uint16_t regs[PKT_MAX_REGS] {};
+
+	// unknown page
+	const px4io_gather_range unknown[] {{3, 0, 2}};
+	ASSERT_EQ(px4io_gather_pack(regs, unknown, 1, PKT_MAX_REGS), 2);
+	EXPECT_EQ(px4io_gather_serve(regs, 1, 2, get_registers), -1);
+
+	// range running past the end of the page
+	const px4io_gather_range short_range[] {{2, 2, 3}};
+	ASSERT_EQ(px4io_gather_pack(regs, short_range, 1, PKT_MAX_REGS), 3);
+	EXPECT_EQ(px4io_gather_serve(regs, 1, 3, get_registers), -1);
+
+	// request count not matching the sum of the range counts
+	const px4io_gather_range ranges[] {{1, 0, 2}, {2, 0, 2}};
+	ASSERT_EQ(px4io_gather_pack(regs, ranges, 2, PKT_MAX_REGS), 4);
+	EXPECT_EQ(px4io_gather_serve(regs, 2, 5, get_registers), -1);
+	ASSERT_EQ(px4io_gather_pack(regs, ranges, 2, PKT_MAX_REGS), 4);
+	EXPECT_EQ(px4io_gather_serve(regs, 2, 3, get_registers), -1);
+
+	// descriptors not covered by the request
+	EXPECT_EQ(px4io_gather_serve(regs, 3, 4, get_registers), -1);
+}
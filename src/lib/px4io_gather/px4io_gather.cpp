@@ -0,0 +1,101 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+#include "px4io_gather.h"
+
+#include <string.h>
+
+int
+px4io_gather_pack(uint16_t *regs, const struct px4io_gather_range *ranges, unsigned num_ranges, unsigned max_regs)
+{
+	unsigned total = 0;
+
+	for (unsigned i = 0; i < num_ranges; i++) {
+		total += ranges[i].count;
+	}
+
+	/* the descriptors travel in the request, so they have to fit into the reply */
+	if ((num_ranges == 0) || (num_ranges > PX4IO_GATHER_MAX_RANGES) || (total < 2 * num_ranges)
+	    || (total > max_regs) || (total > PKT_MAX_REGS)) {
+		return -1;
+	}
+
+	for (unsigned i = 0; i < num_ranges; i++) {
+		regs[i * 2] = PX4IO_GATHER_ADDR(ranges[i].page, ranges[i].offset);
+		regs[i * 2 + 1] = ranges[i].count;
+	}
+
+	return total;
+}
+
+int
+px4io_gather_serve(uint16_t *regs, unsigned num_ranges, unsigned num_values, px4io_gather_get_t get)
+{
+	uint16_t ranges[PX4IO_GATHER_MAX_RANGES * 2];
+
+	if ((num_ranges == 0) || (num_ranges > PX4IO_GATHER_MAX_RANGES) || (num_values < num_ranges * 2)
+	    || (num_values > PKT_MAX_REGS)) {
+		return -1;
+	}
+
+	/* the reply overwrites the descriptors */
+	memcpy(ranges, regs, num_ranges * 2 * sizeof(ranges[0]));
+
+	unsigned total = 0;
+
+	for (unsigned i = 0; i < num_ranges; i++) {
+		const uint16_t address = ranges[i * 2];
+		const unsigned count = ranges[i * 2 + 1];
+		uint16_t *values;
+		unsigned available;
+
+		if (total + count > num_values) {
+			return -1;
+		}
+
+		if (get(address >> 8, address & 0xff, &values, &available) < 0) {
+			return -1;
+		}
+
+		/* unlike plain reads, a short range is an error since the reply layout would shift */
+		if (available < count) {
+			return -1;
+		}
+
+		memmove(&regs[total], values, count * sizeof(regs[0]));
+		total += count;
+	}
+
+	return (total == num_values) ? 0 : -1;
+}
@@ -0,0 +1,88 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file px4io_gather.h
+ *
+ * Packing and serving of PX4IO_PAGE_GATHER reads, shared by the px4io
+ * driver and the IO firmware.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include <px4_platform_common/defines.h>
+#include <modules/px4iofirmware/protocol.h>
+
+__BEGIN_DECLS
+
+struct px4io_gather_range {
+	uint8_t page;
+	uint8_t offset;
+	uint8_t count;
+};
+
+/**
+ * Register lookup as done by registers_get() on IO.
+ */
+typedef int (*px4io_gather_get_t)(uint8_t page, uint8_t offset, uint16_t **values, unsigned *num_values);
+
+/**
+ * Write the range descriptors of a gather request.
+ *
+ * @param regs		Request registers, at least the returned count long.
+ * @param ranges	Register ranges to read.
+ * @param num_ranges	The number of ranges.
+ * @param max_regs	The maximum number of registers in one transaction.
+ * @return		The register count of the request (sum of the range counts),
+ *			or -1 if the ranges cannot be read with a single gather.
+ */
+__EXPORT int	px4io_gather_pack(uint16_t *regs, const struct px4io_gather_range *ranges, unsigned num_ranges,
+				  unsigned max_regs);
+
+/**
+ * Serve a gather request in place.
+ *
+ * @param regs		Holds the range descriptors on entry and the gathered
+ *			register values on return.
+ * @param num_ranges	The number of ranges (the offset of the request).
+ * @param num_values	The register count of the request.
+ * @param get		Register lookup.
+ * @return		0 on success, -1 if the request is malformed or a range
+ *			cannot be read in full.
+ */
+__EXPORT int	px4io_gather_serve(uint16_t *regs, unsigned num_ranges, unsigned num_values, px4io_gather_get_t get);
+
+__END_DECLS
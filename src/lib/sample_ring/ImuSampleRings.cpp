@@ -0,0 +1,85 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+#include "ImuSampleRings.hpp"
+
+namespace sample_ring
+{
+
+static ImuSampleRing imu_sample_rings[MAX_IMU_INSTANCES] {};
+
+static void set_device_id(px4::atomic<uint32_t> &ring_device_id, Vector3fRing &ring, uint32_t device_id)
+{
+	if (ring_device_id.load() != device_id) {
+		// unlisted while the history of the previous device is dropped
+		ring_device_id.store(0);
+		ring.reset();
+		ring_device_id.store(device_id);
+	}
+}
+
+void ImuSampleRing::set_device_ids(uint32_t accel_id, uint32_t gyro_id)
+{
+	set_device_id(accel_device_id, accel, accel_id);
+	set_device_id(gyro_device_id, gyro, gyro_id);
+}
+
+ImuSampleRing *imu(uint8_t instance)
+{
+	return (instance < MAX_IMU_INSTANCES) ? &imu_sample_rings[instance] : nullptr;
+}
+
+const Vector3fRing *find_accel(uint32_t device_id)
+{
+	for (const ImuSampleRing &ring : imu_sample_rings) {
+		if ((device_id != 0) && (ring.accel_device_id.load() == device_id)) {
+			return &ring.accel;
+		}
+	}
+
+	return nullptr;
+}
+
+const Vector3fRing *find_gyro(uint32_t device_id)
+{
+	for (const ImuSampleRing &ring : imu_sample_rings) {
+		if ((device_id != 0) && (ring.gyro_device_id.load() == device_id)) {
+			return &ring.gyro;
+		}
+	}
+
+	return nullptr;
+}
+
+} // namespace sample_ring
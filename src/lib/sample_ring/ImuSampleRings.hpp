@@ -0,0 +1,93 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file ImuSampleRings.hpp
+ *
+ * Statically allocated sample rings shared by the IMU instances. Each ring is
+ * written by the VehicleIMU instance of the same index and can be read by any
+ * consumer to compare or fuse IMUs at a common time.
+ */
+
+#pragma once
+
+#include "SampleRing.hpp"
+
+#include <lib/matrix/matrix/math.hpp>
+
+namespace sample_ring
+{
+
+static constexpr uint8_t MAX_IMU_INSTANCES = 4;
+
+/* 64 ms at the default 250 Hz integration rate */
+static constexpr size_t IMU_RING_SIZE = 16;
+
+using Vector3fRing = SampleRing<matrix::Vector3f, IMU_RING_SIZE>;
+
+struct ImuSampleRing {
+	px4::atomic<uint32_t> accel_device_id{0};
+	px4::atomic<uint32_t> gyro_device_id{0};
+
+	Vector3fRing accel{}; ///< corrected acceleration [m/s^2], mean over each integration interval
+	Vector3fRing gyro{};  ///< corrected angular velocity [rad/s], mean over each integration interval
+
+	/**
+	 * Assign the rings to an accelerometer and a gyroscope, 0 for none (writer side).
+	 * The samples of a previously assigned device are dropped.
+	 */
+	void set_device_ids(uint32_t accel_id, uint32_t gyro_id);
+};
+
+/**
+ * Get the rings of an IMU instance (writer side)
+ * @return nullptr if the instance is out of range
+ */
+ImuSampleRing *imu(uint8_t instance);
+
+/**
+ * Find the acceleration ring of an accelerometer. The ring can be reassigned
+ * at any time, so look it up again after reading to confirm the samples are
+ * still those of the device.
+ * @return nullptr if no IMU instance currently writes data of this device
+ */
+const Vector3fRing *find_accel(uint32_t device_id);
+
+/**
+ * Find the angular velocity ring of a gyroscope, see find_accel()
+ * @return nullptr if no IMU instance currently writes data of this device
+ */
+const Vector3fRing *find_gyro(uint32_t device_id);
+
+} // namespace sample_ring
@@ -0,0 +1,218 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file SampleRing.hpp
+ *
+ * Preallocated ring of timestamped samples with a single writer and any number
+ * of lock-free readers.
+ *
+ * Every slot is protected by a sequence number (seqlock): the writer marks the
+ * slot as being written, copies the sample and publishes the completed sequence
+ * number. A reader copies the slot and only accepts it if the sequence number
+ * is unchanged and matches the sample it expected, so it never blocks the
+ * writer and never returns a torn or overwritten sample.
+ */
+
+#pragma once
+
+#include <px4_platform_common/atomic.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+template<typename T, size_t N>
+class SampleRing
+{
+	static_assert(N >= 2 && (N & (N - 1)) == 0, "ring size must be a power of 2");
+
+public:
+	struct Sample {
+		uint64_t timestamp_sample{0};
+		T value{};
+	};
+
+	SampleRing() = default;
+	~SampleRing() = default;
+
+	/**
+	 * Append a sample, overwriting the oldest one if the ring is full.
+	 * Must only be called by the single writer, with increasing timestamps.
+	 */
+	void push(uint64_t timestamp_sample, const T &value)
+	{
+		const uint32_t index = _count.load();
+		Slot &slot = _slots[index & (N - 1)];
+
+		slot.sequence.store(2 * index + 1);
+		__atomic_thread_fence(__ATOMIC_RELEASE);
+
+		slot.sample.timestamp_sample = timestamp_sample;
+		slot.sample.value = value;
+
+		slot.sequence.store(2 * index + 2);
+		_count.store(index + 1);
+	}
+
+	/**
+	 * Drop all samples, e.g. when the ring is reused for another sensor.
+	 * Must only be called by the single writer. The index skips a whole ring, so
+	 * no slot matches the sequence a reader expects until it is written again.
+	 */
+	void reset()
+	{
+		_count.store(_count.load() + N);
+	}
+
+	/**
+	 * Get the newest sample
+	 * @return false if the ring is empty
+	 */
+	bool latest(Sample &sample) const
+	{
+		const uint32_t count = _count.load();
+		return (count > 0) && read(count - 1, sample);
+	}
+
+	/**
+	 * Linearly interpolate the value at a timestamp between the two neighbouring samples.
+	 * There is no extrapolation beyond the newest or oldest available sample.
+	 *
+	 * @return false if the timestamp is not covered by the ring
+	 */
+	bool interpolate(uint64_t timestamp, T &value) const
+	{
+		const uint32_t count = _count.load();
+		Sample newer;
+
+		if ((count == 0) || !read(count - 1, newer) || (timestamp > newer.timestamp_sample)) {
+			return false;
+		}
+
+		const uint32_t available = (count < N) ? count : N;
+
+		for (uint32_t i = 2; ; i++) {
+			if (timestamp == newer.timestamp_sample) {
+				value = newer.value;
+				return true;
+			}
+
+			Sample older;
+
+			if ((i > available) || !read(count - i, older)) {
+				// older than the ring or overwritten while reading
+				return false;
+			}
+
+			if (older.timestamp_sample <= timestamp) {
+				const float t = (float)(timestamp - older.timestamp_sample)
+						/ (float)(newer.timestamp_sample - older.timestamp_sample);
+				value = older.value + (newer.value - older.value) * t;
+				return true;
+			}
+
+			newer = older;
+		}
+	}
+
+	/**
+	 * Copy all samples within [timestamp_start, timestamp_end], oldest first.
+	 * If there are more than max_samples, the newest ones are returned.
+	 *
+	 * @return the number of samples copied
+	 */
+	int window(uint64_t timestamp_start, uint64_t timestamp_end, Sample samples[], int max_samples) const
+	{
+		const uint32_t count = _count.load();
+		const uint32_t available = (count < N) ? count : N;
+
+		int n = 0;
+
+		// collect newest first
+		for (uint32_t i = 1; (i <= available) && (n < max_samples); i++) {
+			Sample sample;
+
+			if (!read(count - i, sample) || (sample.timestamp_sample < timestamp_start)) {
+				break;
+			}
+
+			if (sample.timestamp_sample <= timestamp_end) {
+				samples[n++] = sample;
+			}
+		}
+
+		for (int i = 0; i < n / 2; i++) {
+			const Sample tmp = samples[i];
+			samples[i] = samples[n - 1 - i];
+			samples[n - 1 - i] = tmp;
+		}
+
+		return n;
+	}
+
+	/**
+	 * Number of samples pushed so far (wraps around)
+	 */
+	uint32_t count() const { return _count.load(); }
+
+	static constexpr size_t size() { return N; }
+
+private:
+	struct Slot {
+		px4::atomic<uint32_t> sequence{0}; ///< 2 * index + 1 while writing, 2 * index + 2 once written
+		Sample sample{};
+	};
+
+	bool read(uint32_t index, Sample &sample) const
+	{
+		const Slot &slot = _slots[index & (N - 1)];
+		const uint32_t sequence = 2 * index + 2;
+
+		if (slot.sequence.load() != sequence) {
+			return false;
+		}
+
+		sample = slot.sample;
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+		return slot.sequence.load() == sequence;
+	}
+
+	Slot _slots[N] {};
+	px4::atomic<uint32_t> _count{0};
+
+	/* we don't want this class to be copied */
+	SampleRing(const SampleRing &) = delete;
+	SampleRing &operator=(const SampleRing &) = delete;
+};
@@ -0,0 +1,187 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+#include <gtest/gtest.h>
+#include "SampleRing.hpp"
+
+#include <atomic>
+#include <thread>
+
+TEST(SampleRingTest, Empty)
+{
+	SampleRing<float, 8> ring;
+	SampleRing<float, 8>::Sample sample;
+	float value = 0.f;
+
+	EXPECT_FALSE(ring.latest(sample));
+	EXPECT_FALSE(ring.interpolate(0, value));
+	EXPECT_EQ(ring.window(0, UINT64_MAX, &sample, 1), 0);
+}
+
+TEST(SampleRingTest, Interpolate)
+{
+	SampleRing<float, 8> ring;
+
+	// value equals the timestamp in ms
+	for (uint64_t t = 1000; t <= 20000; t += 1000) {
+		ring.push(t, t / 1000.f);
+	}
+
+	SampleRing<float, 8>::Sample sample;
+	EXPECT_TRUE(ring.latest(sample));
+	EXPECT_EQ(sample.timestamp_sample, 20000u);
+	EXPECT_FLOAT_EQ(sample.value, 20.f);
+
+	float value = 0.f;
+	EXPECT_TRUE(ring.interpolate(20000, value));
+	EXPECT_FLOAT_EQ(value, 20.f);
+	EXPECT_TRUE(ring.interpolate(17250, value));
+	EXPECT_FLOAT_EQ(value, 17.25f);
+	EXPECT_TRUE(ring.interpolate(13000, value));
+	EXPECT_FLOAT_EQ(value, 13.f);
+	EXPECT_TRUE(ring.interpolate(13500, value));
+	EXPECT_FLOAT_EQ(value, 13.5f);
+
+	// no extrapolation and only the last 8 samples are kept
+	EXPECT_FALSE(ring.interpolate(20001, value));
+	EXPECT_FALSE(ring.interpolate(12999, value));
+}
+
+TEST(SampleRingTest, Window)
+{
+	SampleRing<float, 8> ring;
+
+	for (uint64_t t = 1000; t <= 20000; t += 1000) {
+		ring.push(t, t / 1000.f);
+	}
+
+	SampleRing<float, 8>::Sample samples[8];
+
+	// fixed lag window of 3.5 ms ending 2 ms in the past
+	int n = ring.window(20000 - 2000 - 3500, 20000 - 2000, samples, 8);
+	ASSERT_EQ(n, 4);
+
+	for (int i = 0; i < n; i++) {
+		EXPECT_EQ(samples[i].timestamp_sample, 15000u + i * 1000);
+		EXPECT_FLOAT_EQ(samples[i].value, 15.f + i);
+	}
+
+	// newest samples are kept if the output is too small
+	n = ring.window(0, UINT64_MAX, samples, 3);
+	ASSERT_EQ(n, 3);
+	EXPECT_EQ(samples[0].timestamp_sample, 18000u);
+	EXPECT_EQ(samples[2].timestamp_sample, 20000u);
+
+	// older than the ring
+	n = ring.window(0, 12000, samples, 8);
+	EXPECT_EQ(n, 0);
+}
+
+TEST(SampleRingTest, Reset)
+{
+	SampleRing<float, 8> ring;
+
+	// partially filled, so that old slots are still around after the reset
+	for (uint64_t t = 1000; t <= 5000; t += 1000) {
+		ring.push(t, t / 1000.f);
+	}
+
+	ring.reset();
+
+	SampleRing<float, 8>::Sample sample;
+	float value = 0.f;
+	SampleRing<float, 8>::Sample samples[8];
+	EXPECT_FALSE(ring.latest(sample));
+	EXPECT_FALSE(ring.interpolate(3000, value));
+	EXPECT_EQ(ring.window(0, UINT64_MAX, samples, 8), 0);
+
+	// the new history may start before the dropped one
+	ring.push(500, 100.f);
+	ring.push(1500, 101.f);
+
+	EXPECT_TRUE(ring.latest(sample));
+	EXPECT_EQ(sample.timestamp_sample, 1500u);
+	EXPECT_FALSE(ring.interpolate(3000, value));
+	EXPECT_TRUE(ring.interpolate(1000, value));
+	EXPECT_FLOAT_EQ(value, 100.5f);
+	EXPECT_FALSE(ring.interpolate(400, value));
+	EXPECT_EQ(ring.window(0, UINT64_MAX, samples, 8), 2);
+}
+
+TEST(SampleRingTest, ConcurrentReader)
+{
+	// every sample carries its timestamp in all components, a torn read would mix them
+	struct Value {
+		float a{0.f};
+		float b{0.f};
+		float c{0.f};
+		float d{0.f};
+	};
+
+	SampleRing<Value, 4> ring;
+	std::atomic<bool> done{false};
+
+	std::thread writer([&]() {
+		for (uint64_t t = 1; t <= 200000; t++) {
+			const float v = (float)t;
+			ring.push(t, Value{v, v, v, v});
+		}
+
+		done = true;
+	});
+
+	int reads = 0;
+
+	while (!done) {
+		SampleRing<Value, 4>::Sample samples[4];
+		const int n = ring.window(0, UINT64_MAX, samples, 4);
+
+		for (int i = 0; i < n; i++) {
+			const float v = (float)samples[i].timestamp_sample;
+			ASSERT_EQ(samples[i].value.a, v);
+			ASSERT_EQ(samples[i].value.b, v);
+			ASSERT_EQ(samples[i].value.c, v);
+			ASSERT_EQ(samples[i].value.d, v);
+
+			if (i > 0) {
+				ASSERT_EQ(samples[i].timestamp_sample, samples[i - 1].timestamp_sample + 1);
+			}
+		}
+
+		reads += n;
+	}
+
+	writer.join();
+	EXPECT_GT(reads, 0);
+}
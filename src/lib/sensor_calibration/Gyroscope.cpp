@@ -131,6 +131,21 @@ void Gyroscope::set_rotation(Rotation rotation)
 	_rotation = Dcmf(GetSensorLevelAdjustment()) * get_rot_matrix(rotation);
 }
 
+void Gyroscope::CorrectFifo(const int16_t x[], const int16_t y[], const int16_t z[], int n, Rotation sensor_rotation,
+			 float scale, const Vector3f &bias, float out_x[], float out_y[], float out_z[])
+{
+	if (sensor_rotation != _fifo_rotation_enum) {
+		_fifo_rotation = get_rot_matrix(sensor_rotation);
+		_fifo_rotation_enum = sensor_rotation;
+	}
+
+	// corrected = R * (scale * R_sensor * raw - thermal_offset - offset) - bias
+	const Matrix3f A = Matrix3f{_rotation * _fifo_rotation} * scale;
+	const Vector3f b = -(_rotation * (_thermal_offset + _offset)) - bias;
+
+	CorrectBlock(A, b, x, y, z, n, out_x, out_y, out_z);
+}
+
 void Gyroscope::ParametersUpdate()
 {
 	if (_device_id == 0) {
@@ -80,6 +80,17 @@ public:
 		return _rotation * matrix::Vector3f{data - _thermal_offset - _offset};
 	}
 
+	/**
+	 * Correct a block of raw FIFO samples in one pass. The driver rotation and raw scale, the calibration
+	 * and thermal offsets and the rotation to body frame are folded into a single affine transform per block.
+	 *
+	 * @param sensor_rotation Rotation of the raw samples (as reported by the driver)
+	 * @param scale Raw sample scale
+	 * @param bias Additional offset removed in body frame (eg. the estimated in-run bias)
+	 */
+	void CorrectFifo(const int16_t x[], const int16_t y[], const int16_t z[], int n, Rotation sensor_rotation, float scale,
+			 const matrix::Vector3f &bias, float out_x[], float out_y[], float out_z[]);
+
 	bool ParametersSave();
 	void ParametersUpdate();
 
@@ -93,6 +104,9 @@ private:
 	Rotation _rotation_enum{ROTATION_NONE};
 
 	matrix::Dcmf _rotation;
+
+	Rotation _fifo_rotation_enum{ROTATION_NONE};
+	matrix::Dcmf _fifo_rotation; ///< rotation of the raw FIFO samples, cached
 	matrix::Vector3f _offset;
 	matrix::Vector3f _thermal_offset;
 
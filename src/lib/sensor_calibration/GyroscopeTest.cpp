@@ -0,0 +1,105 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file GyroscopeTest.cpp
+ * Tests for the gyroscope block FIFO correction.
+ *
+ * to run: make tests TESTFILTER=Gyroscope
+ */
+
+#include <gtest/gtest.h>
+
+#include <lib/parameters/param.h>
+
+#include "Gyroscope.hpp"
+#include "Utilities.hpp"
+
+using namespace matrix;
+
+class GyroscopeTest : public ::testing::Test
+{
+public:
+	void SetUp() override
+	{
+		param_control_autosave(false);
+		param_reset_all();
+	}
+};
+
+TEST_F(GyroscopeTest, CorrectFifoMatchesCorrect)
+{
+	static constexpr int N = 32;
+
+	int16_t x[N], y[N], z[N];
+
+	for (int i = 0; i < N; i++) {
+		x[i] = 1000 * i - 16000;
+		y[i] = -731 * i + 250;
+		z[i] = 97 * i * i - 30000;
+	}
+
+	const float scale = 0.001f;
+	const Vector3f bias{0.001f, 0.002f, -0.003f};
+
+	calibration::Gyroscope gyro{};
+	gyro.set_offset(Vector3f{0.01f, -0.02f, 0.03f});
+
+	for (size_t c = 0; c < (size_t)Rotation::ROTATION_MAX; c++) {
+		gyro.set_rotation(static_cast<Rotation>(c));
+
+		for (size_t r = 0; r < (size_t)Rotation::ROTATION_MAX; r++) {
+			// GIVEN: raw samples with a sensor rotation
+			const enum Rotation sensor_rotation = static_cast<Rotation>(r);
+
+			// WHEN: we correct the whole block at once
+			float out_x[N], out_y[N], out_z[N];
+			gyro.CorrectFifo(x, y, z, N, sensor_rotation, scale, bias, out_x, out_y, out_z);
+
+			// THEN: the result should be the same as correcting sample by sample
+			for (int i = 0; i < N; i++) {
+				float sx = x[i];
+				float sy = y[i];
+				float sz = z[i];
+				rotate_3f(sensor_rotation, sx, sy, sz);
+
+				const Vector3f expected = gyro.Correct(Vector3f{sx, sy, sz} * scale) - bias;
+
+				EXPECT_NEAR(out_x[i], expected(0), 1e-4f);
+				EXPECT_NEAR(out_y[i], expected(1), 1e-4f);
+				EXPECT_NEAR(out_z[i], expected(2), 1e-4f);
+			}
+		}
+	}
+}
@@ -112,4 +112,41 @@ Rotation GetBoardRotation();
  */
 matrix::Dcmf GetBoardRotationMatrix();
 
+/**
+ * @brief Correct a block of raw samples (eg. from a FIFO message) with a precomputed affine transform.
+ *
+ * Computes out = A * (x, y, z) + b for every sample in a single pass. Scale, rotations and offsets are
+ * folded into A and b once per block by the caller instead of being applied sample by sample.
+ *
+ * @param A Combined scale and rotation matrix
+ * @param b Combined offset, added after A
+ * @param x Raw X-axis samples
+ * @param y Raw Y-axis samples
+ * @param z Raw Z-axis samples
+ * @param n Number of samples
+ * @param out_x Corrected X-axis samples
+ * @param out_y Corrected Y-axis samples
+ * @param out_z Corrected Z-axis samples
+ */
+inline void CorrectBlock(const matrix::Matrix3f &A, const matrix::Vector3f &b,
+			 const int16_t x[], const int16_t y[], const int16_t z[], int n,
+			 float out_x[], float out_y[], float out_z[])
+{
+	// local copies, the output can't alias the transform then
+	const float a00 = A(0, 0), a01 = A(0, 1), a02 = A(0, 2);
+	const float a10 = A(1, 0), a11 = A(1, 1), a12 = A(1, 2);
+	const float a20 = A(2, 0), a21 = A(2, 1), a22 = A(2, 2);
+	const float b0 = b(0), b1 = b(1), b2 = b(2);
+
+	for (int i = 0; i < n; i++) {
+		const float sx = x[i];
+		const float sy = y[i];
+		const float sz = z[i];
+
+		out_x[i] = a00 * sx + a01 * sy + a02 * sz + b0;
+		out_y[i] = a10 * sx + a11 * sy + a12 * sz + b1;
+		out_z[i] = a20 * sx + a21 * sy + a22 * sz + b2;
+	}
+}
+
 } // namespace calibration
@@ -281,3 +281,17 @@ PARAM_DEFINE_INT32(SYS_BL_UPDATE, 0);
  * @group System
  */
 PARAM_DEFINE_INT32(SYS_FAILURE_EN, 0);
+
+/**
+ * Enable the control allocation
+ *
+ * If enabled, the multicopter rate controller publishes torque and thrust
+ * setpoints and the control_allocator module maps them to the actuators
+ * (use the control_allocation mixer). Otherwise the geometry based mixers are used.
+ *
+ * @boolean
+ * @reboot_required true
+ *
+ * @group System
+ */
+PARAM_DEFINE_INT32(SYS_CTRL_ALLOC, 0);
@@ -36,12 +36,14 @@
  */
 
 #include "PreFlightCheck.hpp"
+#include "PreFlightCheckContext.hpp"
 
+#include <containers/LockGuard.hpp>
 #include <drivers/drv_hrt.h>
 #include <HealthFlags.h>
 #include <lib/parameters/param.h>
+#include <px4_platform_common/log.h>
 #include <systemlib/mavlink_log.h>
-#include <uORB/Subscription.hpp>
 
 using namespace time_literals;
 
@@ -54,6 +56,195 @@ static constexpr unsigned max_optional_mag_count = 4;
 static constexpr unsigned max_mandatory_baro_count = 1;
 static constexpr unsigned max_optional_baro_count = 4;
 
+static_assert((int)PreFlightCheck::CheckId::Count <= 32, "health bitmap too small");
+
+void HealthFlagsRecord::set(uint64_t subsystem, bool present, bool enabled, bool ok, vehicle_status_s &status)
+{
+	set_health_flags(subsystem, present, enabled, ok, status);
+
+	Entry *entry = find((uint32_t)subsystem);
+
+	if (entry) {
+		*entry = Entry{(uint32_t)subsystem, false, present, enabled, ok};
+	}
+}
+
+void HealthFlagsRecord::setHealthy(uint64_t subsystem, bool ok, vehicle_status_s &status)
+{
+	set_health_flags_healthy(subsystem, ok, status);
+
+	Entry *entry = find((uint32_t)subsystem);
+
+	if (entry) {
+		if (entry->subsystem == (uint32_t)subsystem && !entry->healthy_only) {
+			// keep present and enabled of the previous set()
+			entry->ok = ok;
+
+		} else {
+			*entry = Entry{(uint32_t)subsystem, true, false, false, ok};
+		}
+	}
+}
+
+HealthFlagsRecord::Entry *HealthFlagsRecord::find(uint32_t subsystem)
+{
+	for (int i = 0; i < count; i++) {
+		if (entries[i].subsystem == subsystem) {
+			return &entries[i];
+		}
+	}
+
+	if (count < MAX_ENTRIES) {
+		entries[count].subsystem = 0;
+		entries[count].healthy_only = true;
+		return &entries[count++];
+	}
+
+	PX4_ERR("health flags record full");
+	return nullptr;
+}
+
+void HealthFlagsRecord::apply(vehicle_status_s &status) const
+{
+	for (int i = 0; i < count; i++) {
+		if (entries[i].healthy_only) {
+			set_health_flags_healthy(entries[i].subsystem, entries[i].ok, status);
+
+		} else {
+			set_health_flags(entries[i].subsystem, entries[i].present, entries[i].enabled, entries[i].ok, status);
+		}
+	}
+}
+
+PreFlightCheck::Context::Context()
+{
+	pthread_mutex_init(&lock, nullptr);
+
+	params.sys_has_mag = param_find("SYS_HAS_MAG");
+	params.sys_has_baro = param_find("SYS_HAS_BARO");
+	params.sys_mc_est_group = param_find("SYS_MC_EST_GROUP");
+	params.fw_arsp_mode = param_find("FW_ARSP_MODE");
+	params.com_arm_mag_ang = param_find("COM_ARM_MAG_ANG");
+	params.com_arm_imu_acc = param_find("COM_ARM_IMU_ACC");
+	params.com_arm_imu_gyr = param_find("COM_ARM_IMU_GYR");
+	params.com_arm_mag_str = param_find("COM_ARM_MAG_STR");
+	params.com_arm_ekf_hgt = param_find("COM_ARM_EKF_HGT");
+	params.com_arm_ekf_vel = param_find("COM_ARM_EKF_VEL");
+	params.com_arm_ekf_pos = param_find("COM_ARM_EKF_POS");
+	params.com_arm_ekf_yaw = param_find("COM_ARM_EKF_YAW");
+	params.com_arm_ekf_ab = param_find("COM_ARM_EKF_AB");
+	params.com_arm_ekf_gb = param_find("COM_ARM_EKF_GB");
+	params.com_power_count = param_find("COM_POWER_COUNT");
+	params.com_cpu_max = param_find("COM_CPU_MAX");
+	params.rc_map_trans_sw = param_find("RC_MAP_TRANS_SW");
+
+	char nbuf[20];
+
+	for (unsigned i = 0; i < RC_CHANNELS; i++) {
+		sprintf(nbuf, "RC%d_MIN", i + 1);
+		params.rc_min[i] = param_find(nbuf);
+
+		sprintf(nbuf, "RC%d_TRIM", i + 1);
+		params.rc_trim[i] = param_find(nbuf);
+
+		sprintf(nbuf, "RC%d_MAX", i + 1);
+		params.rc_max[i] = param_find(nbuf);
+
+		sprintf(nbuf, "RC%d_REV", i + 1);
+		params.rc_rev[i] = param_find(nbuf);
+
+		sprintf(nbuf, "RC%d_DZ", i + 1);
+		params.rc_dz[i] = param_find(nbuf);
+	}
+}
+
+void PreFlightCheck::Context::update()
+{
+	if (parameter_update_sub.updated()) {
+		parameter_update_s param_update;
+		parameter_update_sub.copy(&param_update);
+		param_epoch++;
+	}
+}
+
+uint32_t PreFlightCheck::Context::signature(std::initializer_list<uint32_t> inputs)
+{
+	// FNV-1a
+	uint32_t hash = 2166136261u;
+
+	for (uint32_t input : inputs) {
+		for (int i = 0; i < 4; i++) {
+			hash = (hash ^ ((input >> (i * 8)) & 0xff)) * 16777619u;
+		}
+	}
+
+	return hash;
+}
+
+bool PreFlightCheck::Context::cached(CheckId id, uint32_t input_signature, bool report_fail, vehicle_status_s *status,
+				     bool &passed)
+{
+	const CachedCheck &result = results[(int)id];
+
+	if (report_fail || !result.evaluated || result.signature != input_signature) {
+		evaluations++;
+		return false;
+	}
+
+	if (status) {
+		result.health.apply(*status);
+	}
+
+	passed = result.passed;
+	cache_hits++;
+	return true;
+}
+
+void PreFlightCheck::Context::store(CheckId id, uint32_t input_signature, bool passed)
+{
+	CachedCheck &result = results[(int)id];
+	result.signature = input_signature;
+	result.evaluated = true;
+	result.passed = passed;
+
+	setResult(id, passed);
+}
+
+void PreFlightCheck::Context::setResult(CheckId id, bool passed)
+{
+	const uint32_t bit = 1u << (uint8_t)id;
+
+	evaluated_bitmap |= bit;
+
+	if (passed) {
+		health_bitmap |= bit;
+
+	} else {
+		health_bitmap &= ~bit;
+	}
+}
+
+PreFlightCheck::Context &PreFlightCheck::context()
+{
+	// created on first use (the initial preflight check in Commander::run()), when uORB and the parameters are available
+	static Context context;
+	return context;
+}
+
+uint32_t PreFlightCheck::healthBitmap()
+{
+	return context().health_bitmap;
+}
+
+void PreFlightCheck::printStatus()
+{
+	Context &ctx = context();
+	LockGuard lg{ctx.lock};
+
+	PX4_INFO("health bitmap: 0x%08x (evaluated: 0x%08x)", (unsigned)ctx.health_bitmap, (unsigned)ctx.evaluated_bitmap);
+	PX4_INFO("check evaluations: %u, cached results used: %u", (unsigned)ctx.evaluations, (unsigned)ctx.cache_hits);
+}
+
 bool PreFlightCheck::preflightCheck(orb_advert_t *mavlink_log_pub, vehicle_status_s &status,
 				    vehicle_status_flags_s &status_flags, const bool checkGNSS, bool report_failures, const bool prearm,
 				    const hrt_abstime &time_since_boot)
@@ -61,6 +252,10 @@ bool PreFlightCheck::preflightCheck(orb_advert_t *mavlink_log_pub, vehicle_statu
 	report_failures = (report_failures && status_flags.condition_system_hotplug_timeout
 			   && !status_flags.condition_calibration_enabled);
 
+	Context &ctx = context();
+	LockGuard lg{ctx.lock};
+	ctx.update();
+
 	bool failed = false;
 
 	failed = failed || !airframeCheck(mavlink_log_pub, status);
@@ -68,7 +263,7 @@ bool PreFlightCheck::preflightCheck(orb_advert_t *mavlink_log_pub, vehicle_statu
 	/* ---- MAG ---- */
 	{
 		int32_t sys_has_mag = 1;
-		param_get(param_find("SYS_HAS_MAG"), &sys_has_mag);
+		param_get(ctx.params.sys_has_mag, &sys_has_mag);
 
 		if (sys_has_mag == 1) {
 
@@ -142,7 +337,7 @@ bool PreFlightCheck::preflightCheck(orb_advert_t *mavlink_log_pub, vehicle_statu
 	/* ---- BARO ---- */
 	{
 		int32_t sys_has_baro = 1;
-		param_get(param_find("SYS_HAS_BARO"), &sys_has_baro);
+		param_get(ctx.params.sys_has_baro, &sys_has_baro);
 
 		bool baro_fail_reported = false;
 
@@ -177,7 +372,7 @@ bool PreFlightCheck::preflightCheck(orb_advert_t *mavlink_log_pub, vehicle_statu
 	    (status.vehicle_type == vehicle_status_s::VEHICLE_TYPE_FIXED_WING || status.is_vtol)) {
 
 		int32_t airspeed_mode = 0;
-		param_get(param_find("FW_ARSP_MODE"), &airspeed_mode);
+		param_get(ctx.params.fw_arsp_mode, &airspeed_mode);
 		const bool optional = (airspeed_mode == 1);
 
 		if (!airspeedCheck(mavlink_log_pub, status, optional, report_failures, prearm) && !optional) {
@@ -187,7 +382,15 @@ bool PreFlightCheck::preflightCheck(orb_advert_t *mavlink_log_pub, vehicle_statu
 
 	/* ---- RC CALIBRATION ---- */
 	if (status.rc_input_mode == vehicle_status_s::RC_IN_MODE_DEFAULT) {
-		if (rcCalibrationCheck(mavlink_log_pub, report_failures, status.is_vtol) != OK) {
+		const uint32_t rc_signature = Context::signature({ctx.param_epoch, status.is_vtol});
+		bool rc_calibration_ok = false;
+
+		if (!ctx.cached(CheckId::RcCalibration, rc_signature, report_failures, nullptr, rc_calibration_ok)) {
+			rc_calibration_ok = (rcCalibrationCheck(mavlink_log_pub, report_failures, status.is_vtol) == OK);
+			ctx.store(CheckId::RcCalibration, rc_signature, rc_calibration_ok);
+		}
+
+		if (!rc_calibration_ok) {
 			if (report_failures) {
 				mavlink_log_critical(mavlink_log_pub, "RC calibration check failed");
 			}
@@ -217,7 +420,7 @@ bool PreFlightCheck::preflightCheck(orb_advert_t *mavlink_log_pub, vehicle_statu
 	int32_t estimator_type = -1;
 
 	if (status.vehicle_type == vehicle_status_s::VEHICLE_TYPE_ROTARY_WING && !status.is_vtol) {
-		param_get(param_find("SYS_MC_EST_GROUP"), &estimator_type);
+		param_get(ctx.params.sys_mc_est_group, &estimator_type);
 
 	} else {
 		// EKF2 is currently the only supported option for FW & VTOL
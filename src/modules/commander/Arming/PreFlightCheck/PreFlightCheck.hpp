@@ -92,7 +92,50 @@ public:
 				const safety_s &safety, const arm_requirements_t &arm_requirements, vehicle_status_s &status,
 				bool report_fail = true);
 
+	/**
+	 * Checks with a bit in the health bitmap. The sensor checks have one bit per instance.
+	 */
+	enum class CheckId : uint8_t {
+		Airframe,
+		Mag0, Mag1, Mag2, Mag3,
+		MagConsistency,
+		Accel0, Accel1, Accel2, Accel3,
+		Gyro0, Gyro1, Gyro2, Gyro3,
+		Baro0, Baro1, Baro2, Baro3,
+		ImuConsistency,
+		Airspeed,
+		RcCalibration,
+		Power,
+		Ekf2,
+		Ekf2States,
+		FailureDetector,
+		ManualControl,
+		CpuResource,
+		PreArm,
+
+		Count
+	};
+
+	/**
+	 * Results of the last evaluation of each check, bit (1 << CheckId) is set if the check passed.
+	 * Checks that are not evaluated (e.g. disabled by a circuit breaker) keep their last result.
+	 */
+	static uint32_t healthBitmap();
+
+	/**
+	 * Print the health bitmap and the evaluation statistics.
+	 */
+	static void printStatus();
+
 private:
+	/**
+	 * Checks are only evaluated again if one of their inputs (subscribed topics, parameters or
+	 * arguments) changed, or if failures need to be reported. The state for this is kept in the
+	 * context, which is created on first use.
+	 */
+	struct Context;
+	static Context &context();
+
 	static bool magnetometerCheck(orb_advert_t *mavlink_log_pub, vehicle_status_s &status, const uint8_t instance,
 				      const bool optional, int32_t &device_id, const bool report_fail);
 	static bool magConsistencyCheck(orb_advert_t *mavlink_log_pub, vehicle_status_s &status, const bool report_status);
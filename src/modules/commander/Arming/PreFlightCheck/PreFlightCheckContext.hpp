@@ -0,0 +1,224 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file PreFlightCheckContext.hpp
+ *
+ * State of the preflight checks that is kept across evaluations: long-lived subscriptions,
+ * parameter handles and the cached check results.
+ */
+
+#pragma once
+
+#include "PreFlightCheck.hpp"
+
+#include <initializer_list>
+#include <pthread.h>
+
+#include <lib/parameters/param.h>
+#include <uORB/Subscription.hpp>
+#include <uORB/topics/airspeed.h>
+#include <uORB/topics/cpuload.h>
+#include <uORB/topics/estimator_selector_status.h>
+#include <uORB/topics/estimator_states.h>
+#include <uORB/topics/estimator_status.h>
+#include <uORB/topics/input_rc.h>
+#include <uORB/topics/manual_control_switches.h>
+#include <uORB/topics/parameter_update.h>
+#include <uORB/topics/sensor_accel.h>
+#include <uORB/topics/sensor_baro.h>
+#include <uORB/topics/sensor_gyro.h>
+#include <uORB/topics/sensor_mag.h>
+#include <uORB/topics/sensor_preflight_mag.h>
+#include <uORB/topics/sensors_status_imu.h>
+#include <uORB/topics/system_power.h>
+
+/**
+ * Health flags written by a check, so that they can be applied again when the cached result is used.
+ */
+struct HealthFlagsRecord {
+	static constexpr int MAX_ENTRIES = 4;
+
+	struct Entry {
+		uint32_t subsystem;
+		bool healthy_only; ///< set_health_flags_healthy(): present and enabled are left untouched
+		bool present;
+		bool enabled;
+		bool ok;
+	};
+
+	/** like set_health_flags(), and record the update */
+	void set(uint64_t subsystem, bool present, bool enabled, bool ok, vehicle_status_s &status);
+
+	/** like set_health_flags_healthy(), and record the update */
+	void setHealthy(uint64_t subsystem, bool ok, vehicle_status_s &status);
+
+	void apply(vehicle_status_s &status) const;
+
+	void reset() { count = 0; }
+
+	Entry entries[MAX_ENTRIES] {};
+	uint8_t count{0};
+
+private:
+	Entry *find(uint32_t subsystem);
+};
+
+struct PreFlightCheck::Context {
+	Context();
+	~Context() { pthread_mutex_destroy(&lock); }
+
+	/**
+	 * Poll the parameter updates, called once at the beginning of an evaluation.
+	 */
+	void update();
+
+	/**
+	 * Combine the inputs of a check into a single value, which changes whenever one of the inputs changes.
+	 */
+	static uint32_t signature(std::initializer_list<uint32_t> inputs);
+
+	struct CachedCheck {
+		uint32_t signature{0};
+		bool evaluated{false};
+		bool passed{false};
+		HealthFlagsRecord health{};
+	};
+
+	/**
+	 * Check if the cached result can be used instead of evaluating the check again: it was evaluated
+	 * before with the same inputs and no failure report is requested (reporting needs the evaluation).
+	 * On a hit the recorded health flags are applied to status.
+	 * @return true on a cache hit, with passed set to the cached result
+	 */
+	bool cached(CheckId id, uint32_t input_signature, bool report_fail, vehicle_status_s *status, bool &passed);
+
+	/**
+	 * Start the evaluation of a check after a cache miss.
+	 * @return the record for the health flags written by the check
+	 */
+	HealthFlagsRecord &startEvaluation(CheckId id)
+	{
+		results[(int)id].health.reset();
+		return results[(int)id].health;
+	}
+
+	/**
+	 * Store the result of an evaluation and update the health bitmap.
+	 */
+	void store(CheckId id, uint32_t input_signature, bool passed);
+
+	/**
+	 * Update the health bitmap for checks without cached results.
+	 */
+	void setResult(CheckId id, bool passed);
+
+	static CheckId sensorCheckId(CheckId first, uint8_t instance) { return CheckId((uint8_t)first + instance); }
+
+	static constexpr uint8_t MAX_SENSOR_INSTANCES = 4;
+	static constexpr uint8_t RC_CHANNELS = input_rc_s::RC_INPUT_MAX_CHANNELS;
+
+	pthread_mutex_t lock; ///< serializes commander and the 'commander check' command
+
+	// incremented on every parameter change, an input of all checks reading parameters
+	uint32_t param_epoch{0};
+	uORB::Subscription parameter_update_sub{ORB_ID(parameter_update)};
+
+	CachedCheck results[(int)CheckId::Count] {};
+	uint32_t health_bitmap{0};    ///< bit (1 << CheckId) set if the check passed at its last evaluation
+	uint32_t evaluated_bitmap{0}; ///< bit (1 << CheckId) set if the check has been evaluated at least once
+	uint32_t evaluations{0};
+	uint32_t cache_hits{0};
+
+	struct {
+		param_t sys_has_mag;
+		param_t sys_has_baro;
+		param_t sys_mc_est_group;
+		param_t fw_arsp_mode;
+		param_t com_arm_mag_ang;
+		param_t com_arm_imu_acc;
+		param_t com_arm_imu_gyr;
+		param_t com_arm_mag_str;
+		param_t com_arm_ekf_hgt;
+		param_t com_arm_ekf_vel;
+		param_t com_arm_ekf_pos;
+		param_t com_arm_ekf_yaw;
+		param_t com_arm_ekf_ab;
+		param_t com_arm_ekf_gb;
+		param_t com_power_count;
+		param_t com_cpu_max;
+		param_t rc_map_trans_sw;
+		param_t rc_min[RC_CHANNELS];
+		param_t rc_trim[RC_CHANNELS];
+		param_t rc_max[RC_CHANNELS];
+		param_t rc_rev[RC_CHANNELS];
+		param_t rc_dz[RC_CHANNELS];
+	} params;
+
+	uORB::SubscriptionData<sensor_mag_s> mag_subs[MAX_SENSOR_INSTANCES] {
+		{ORB_ID(sensor_mag), 0}, {ORB_ID(sensor_mag), 1}, {ORB_ID(sensor_mag), 2}, {ORB_ID(sensor_mag), 3}
+	};
+
+	uORB::SubscriptionData<sensor_accel_s> accel_subs[MAX_SENSOR_INSTANCES] {
+		{ORB_ID(sensor_accel), 0}, {ORB_ID(sensor_accel), 1}, {ORB_ID(sensor_accel), 2}, {ORB_ID(sensor_accel), 3}
+	};
+
+	uORB::SubscriptionData<sensor_gyro_s> gyro_subs[MAX_SENSOR_INSTANCES] {
+		{ORB_ID(sensor_gyro), 0}, {ORB_ID(sensor_gyro), 1}, {ORB_ID(sensor_gyro), 2}, {ORB_ID(sensor_gyro), 3}
+	};
+
+	uORB::SubscriptionData<sensor_baro_s> baro_subs[MAX_SENSOR_INSTANCES] {
+		{ORB_ID(sensor_baro), 0}, {ORB_ID(sensor_baro), 1}, {ORB_ID(sensor_baro), 2}, {ORB_ID(sensor_baro), 3}
+	};
+
+	/**
+	 * The accelerometer calibration only depends on the device ID and the parameters, while the
+	 * range check uses the live data, so only the calibration lookup is cached.
+	 */
+	struct {
+		uint32_t signature;
+		bool evaluated;
+		bool valid;
+	} accel_calibration[MAX_SENSOR_INSTANCES] {};
+
+	uORB::SubscriptionData<sensor_preflight_mag_s> sensor_preflight_mag_sub{ORB_ID(sensor_preflight_mag)};
+	uORB::SubscriptionData<sensors_status_imu_s> sensors_status_imu_sub{ORB_ID(sensors_status_imu)};
+	uORB::SubscriptionData<airspeed_s> airspeed_sub{ORB_ID(airspeed)};
+	uORB::SubscriptionData<system_power_s> system_power_sub{ORB_ID(system_power)};
+	uORB::SubscriptionData<manual_control_switches_s> manual_control_switches_sub{ORB_ID(manual_control_switches)};
+	uORB::SubscriptionData<cpuload_s> cpuload_sub{ORB_ID(cpuload)};
+	uORB::SubscriptionData<estimator_selector_status_s> estimator_selector_status_sub{ORB_ID(estimator_selector_status)};
+	uORB::SubscriptionData<estimator_status_s> estimator_status_sub{ORB_ID(estimator_status)};
+	uORB::SubscriptionData<estimator_states_s> estimator_states_sub{ORB_ID(estimator_states)};
+};
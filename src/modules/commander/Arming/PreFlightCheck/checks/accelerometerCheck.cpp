@@ -32,6 +32,7 @@
  ****************************************************************************/
 
 #include "../PreFlightCheck.hpp"
+#include "../PreFlightCheckContext.hpp"
 
 #include <drivers/drv_hrt.h>
 #include <HealthFlags.h>
@@ -39,22 +40,23 @@
 #include <px4_defines.h>
 #include <lib/sensor_calibration/Utilities.hpp>
 #include <lib/systemlib/mavlink_log.h>
-#include <uORB/Subscription.hpp>
-#include <uORB/topics/sensor_accel.h>
 
 using namespace time_literals;
 
 bool PreFlightCheck::accelerometerCheck(orb_advert_t *mavlink_log_pub, vehicle_status_s &status, const uint8_t instance,
 					const bool optional, int32_t &device_id, const bool report_fail)
 {
-	const bool exists = (orb_exists(ORB_ID(sensor_accel), instance) == PX4_OK);
+	Context &ctx = context();
+
+	uORB::SubscriptionData<sensor_accel_s> &accel = ctx.accel_subs[instance];
+	accel.update();
+
+	const bool exists = accel.advertised();
 	bool calibration_valid = false;
 	bool valid = true;
 
 	if (exists) {
 
-		uORB::SubscriptionData<sensor_accel_s> accel{ORB_ID(sensor_accel), instance};
-
 		valid = (accel.get().device_id != 0) && (accel.get().timestamp != 0);
 
 		if (!valid) {
@@ -65,7 +67,17 @@ bool PreFlightCheck::accelerometerCheck(orb_advert_t *mavlink_log_pub, vehicle_s
 
 		device_id = accel.get().device_id;
 
-		calibration_valid = (calibration::FindCalibrationIndex("ACC", device_id) >= 0);
+		// the range check below needs the live data, so only the calibration lookup is cached
+		auto &calibration = ctx.accel_calibration[instance];
+		const uint32_t calibration_signature = Context::signature({(uint32_t)device_id, ctx.param_epoch});
+
+		if (!calibration.evaluated || calibration.signature != calibration_signature) {
+			calibration.valid = (calibration::FindCalibrationIndex("ACC", device_id) >= 0);
+			calibration.signature = calibration_signature;
+			calibration.evaluated = true;
+		}
+
+		calibration_valid = calibration.valid;
 
 		if (!calibration_valid) {
 			if (report_fail) {
@@ -95,5 +107,7 @@ bool PreFlightCheck::accelerometerCheck(orb_advert_t *mavlink_log_pub, vehicle_s
 
 	const bool success = calibration_valid && valid;
 
+	ctx.setResult(Context::sensorCheckId(CheckId::Accel0, instance), success);
+
 	return success;
 }
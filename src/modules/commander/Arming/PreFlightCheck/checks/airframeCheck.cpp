@@ -32,6 +32,7 @@
  ****************************************************************************/
 
 #include "../PreFlightCheck.hpp"
+#include "../PreFlightCheckContext.hpp"
 
 #include <drivers/drv_hrt.h>
 #include <systemlib/mavlink_log.h>
@@ -54,5 +55,7 @@ bool PreFlightCheck::airframeCheck(orb_advert_t *mavlink_log_pub, const vehicle_
 
 #endif
 
+	context().setResult(CheckId::Airframe, success);
+
 	return success;
 }
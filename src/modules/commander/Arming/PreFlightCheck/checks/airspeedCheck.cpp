@@ -32,27 +32,37 @@
  ****************************************************************************/
 
 #include "../PreFlightCheck.hpp"
+#include "../PreFlightCheckContext.hpp"
 
 #include <HealthFlags.h>
 #include <drivers/drv_hrt.h>
 #include <math.h>
 #include <systemlib/mavlink_log.h>
-#include <uORB/Subscription.hpp>
-#include <uORB/topics/airspeed.h>
 
 using namespace time_literals;
 
 bool PreFlightCheck::airspeedCheck(orb_advert_t *mavlink_log_pub, vehicle_status_s &status, const bool optional,
 				   const bool report_fail, const bool prearm)
 {
+	Context &ctx = context();
+
+	ctx.airspeed_sub.update();
+	const airspeed_s &airspeed = ctx.airspeed_sub.get();
+
+	// a timeout is a change of the input as well
+	const bool timed_out = hrt_elapsed_time(&airspeed.timestamp) > 1_s;
+
+	const uint32_t signature = Context::signature({ctx.airspeed_sub.get_last_generation(), timed_out, optional, prearm});
 	bool present = true;
 	bool success = true;
 
-	uORB::SubscriptionData<airspeed_s> airspeed_sub{ORB_ID(airspeed)};
-	airspeed_sub.update();
-	const airspeed_s &airspeed = airspeed_sub.get();
+	if (ctx.cached(CheckId::Airspeed, signature, report_fail, &status, success)) {
+		return success;
+	}
+
+	HealthFlagsRecord &health = ctx.startEvaluation(CheckId::Airspeed);
 
-	if (hrt_elapsed_time(&airspeed.timestamp) > 1_s) {
+	if (timed_out) {
 		if (report_fail && !optional) {
 			mavlink_log_critical(mavlink_log_pub, "Preflight Fail: Airspeed Sensor missing");
 		}
@@ -94,7 +104,9 @@ bool PreFlightCheck::airspeedCheck(orb_advert_t *mavlink_log_pub, vehicle_status
 	}
 
 out:
-	set_health_flags(subsystem_info_s::SUBSYSTEM_TYPE_DIFFPRESSURE, present, !optional, success, status);
+	health.set(subsystem_info_s::SUBSYSTEM_TYPE_DIFFPRESSURE, present, !optional, success, status);
+
+	ctx.store(CheckId::Airspeed, signature, success);
 
 	return success;
 }
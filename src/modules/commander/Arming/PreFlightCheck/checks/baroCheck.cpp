@@ -32,25 +32,27 @@
  ****************************************************************************/
 
 #include "../PreFlightCheck.hpp"
+#include "../PreFlightCheckContext.hpp"
 
 #include <drivers/drv_hrt.h>
 #include <HealthFlags.h>
 #include <px4_defines.h>
 #include <systemlib/mavlink_log.h>
-#include <uORB/Subscription.hpp>
-#include <uORB/topics/sensor_baro.h>
 
 using namespace time_literals;
 
 bool PreFlightCheck::baroCheck(orb_advert_t *mavlink_log_pub, vehicle_status_s &status, const uint8_t instance,
 			       const bool optional, int32_t &device_id, const bool report_fail)
 {
-	const bool exists = (orb_exists(ORB_ID(sensor_baro), instance) == PX4_OK);
+	Context &ctx = context();
+
+	uORB::SubscriptionData<sensor_baro_s> &baro = ctx.baro_subs[instance];
+	baro.update();
+
+	const bool exists = baro.advertised();
 	bool valid = false;
 
 	if (exists) {
-		uORB::SubscriptionData<sensor_baro_s> baro{ORB_ID(sensor_baro), instance};
-
 		valid = (baro.get().device_id != 0) && (baro.get().timestamp != 0);
 
 		if (!valid) {
@@ -69,5 +71,7 @@ bool PreFlightCheck::baroCheck(orb_advert_t *mavlink_log_pub, vehicle_status_s &
 		set_health_flags(subsystem_info_s::SUBSYSTEM_TYPE_ABSPRESSURE, exists, !optional, valid, status);
 	}
 
+	ctx.setResult(Context::sensorCheckId(CheckId::Baro0, instance), valid);
+
 	return valid;
 }
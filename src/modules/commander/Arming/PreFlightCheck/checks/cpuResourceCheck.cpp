@@ -32,28 +32,36 @@
  ****************************************************************************/
 
 #include "../PreFlightCheck.hpp"
+#include "../PreFlightCheckContext.hpp"
 
 #include <drivers/drv_hrt.h>
 #include <systemlib/mavlink_log.h>
 #include <lib/parameters/param.h>
-#include <uORB/Subscription.hpp>
-#include <uORB/topics/cpuload.h>
 
 using namespace time_literals;
 
 bool PreFlightCheck::cpuResourceCheck(orb_advert_t *mavlink_log_pub, const bool report_fail)
 {
+	Context &ctx = context();
+	uORB::SubscriptionData<cpuload_s> &cpuload_sub = ctx.cpuload_sub;
+	cpuload_sub.update();
+
+	// a timeout is a change of the input as well
+	const bool timed_out = hrt_elapsed_time(&cpuload_sub.get().timestamp) > 2_s;
+
+	const uint32_t signature = Context::signature({cpuload_sub.get_last_generation(), timed_out, ctx.param_epoch});
 	bool success = true;
 
-	uORB::SubscriptionData<cpuload_s> cpuload_sub{ORB_ID(cpuload)};
-	cpuload_sub.update();
+	if (ctx.cached(CheckId::CpuResource, signature, report_fail, nullptr, success)) {
+		return success;
+	}
 
 	float cpuload_percent_max;
-	param_get(param_find("COM_CPU_MAX"), &cpuload_percent_max);
+	param_get(ctx.params.com_cpu_max, &cpuload_percent_max);
 
 	if (cpuload_percent_max > 0.f) {
 
-		if (hrt_elapsed_time(&cpuload_sub.get().timestamp) > 2_s) {
+		if (timed_out) {
 			success = false;
 
 			if (report_fail) {
@@ -72,5 +80,7 @@ bool PreFlightCheck::cpuResourceCheck(orb_advert_t *mavlink_log_pub, const bool
 		}
 	}
 
+	ctx.store(CheckId::CpuResource, signature, success);
+
 	return success;
 }
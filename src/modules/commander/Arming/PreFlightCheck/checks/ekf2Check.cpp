@@ -32,46 +32,69 @@
  ****************************************************************************/
 
 #include "../PreFlightCheck.hpp"
+#include "../PreFlightCheckContext.hpp"
 
 #include <HealthFlags.h>
 #include <math.h>
 #include <lib/parameters/param.h>
 #include <systemlib/mavlink_log.h>
-#include <uORB/Subscription.hpp>
-#include <uORB/topics/estimator_selector_status.h>
-#include <uORB/topics/estimator_states.h>
-#include <uORB/topics/estimator_status.h>
+
+/**
+ * Follow the primary estimator instance.
+ */
+template<typename T>
+static void updatePrimaryInstance(uORB::SubscriptionData<estimator_selector_status_s> &selector_sub,
+				  uORB::SubscriptionData<T> &sub)
+{
+	selector_sub.update();
+
+	if (sub.get_instance() != selector_sub.get().primary_instance) {
+		sub.ChangeInstance(selector_sub.get().primary_instance);
+	}
+
+	sub.update();
+}
 
 bool PreFlightCheck::ekf2Check(orb_advert_t *mavlink_log_pub, vehicle_status_s &vehicle_status, const bool optional,
 			       const bool report_fail, const bool enforce_gps_required)
 {
+	Context &ctx = context();
+
+	// Get estimator status data if available and exit with a fail recorded if not
+	updatePrimaryInstance(ctx.estimator_selector_status_sub, ctx.estimator_status_sub);
+	const estimator_status_s &status = ctx.estimator_status_sub.get();
+
+	const uint32_t signature = Context::signature({ctx.estimator_status_sub.get_instance(),
+					ctx.estimator_status_sub.get_last_generation(), ctx.param_epoch, optional, enforce_gps_required,
+					report_fail}); // reporting also evaluates the GPS checks
 	bool success = true; // start with a pass and change to a fail if any test fails
+
+	if (ctx.cached(CheckId::Ekf2, signature, report_fail, &vehicle_status, success)) {
+		return success;
+	}
+
+	HealthFlagsRecord &health = ctx.startEvaluation(CheckId::Ekf2);
+
 	bool ahrs_present = true;
 
 	int32_t mag_strength_check_enabled = 1;
-	param_get(param_find("COM_ARM_MAG_STR"), &mag_strength_check_enabled);
+	param_get(ctx.params.com_arm_mag_str, &mag_strength_check_enabled);
 
 	float hgt_test_ratio_limit = 1.f;
-	param_get(param_find("COM_ARM_EKF_HGT"), &hgt_test_ratio_limit);
+	param_get(ctx.params.com_arm_ekf_hgt, &hgt_test_ratio_limit);
 
 	float vel_test_ratio_limit = 1.f;
-	param_get(param_find("COM_ARM_EKF_VEL"), &vel_test_ratio_limit);
+	param_get(ctx.params.com_arm_ekf_vel, &vel_test_ratio_limit);
 
 	float pos_test_ratio_limit = 1.f;
-	param_get(param_find("COM_ARM_EKF_POS"), &pos_test_ratio_limit);
+	param_get(ctx.params.com_arm_ekf_pos, &pos_test_ratio_limit);
 
 	float mag_test_ratio_limit = 1.f;
-	param_get(param_find("COM_ARM_EKF_YAW"), &mag_test_ratio_limit);
+	param_get(ctx.params.com_arm_ekf_yaw, &mag_test_ratio_limit);
 
 	bool gps_success = true;
 	bool gps_present = true;
 
-	// Get estimator status data if available and exit with a fail recorded if not
-	uORB::SubscriptionData<estimator_selector_status_s> estimator_selector_status_sub{ORB_ID(estimator_selector_status)};
-	uORB::SubscriptionData<estimator_status_s> status_sub{ORB_ID(estimator_status), estimator_selector_status_sub.get().primary_instance};
-	status_sub.update();
-	const estimator_status_s &status = status_sub.get();
-
 	if (status.timestamp == 0) {
 		ahrs_present = false;
 		goto out;
@@ -225,27 +248,37 @@ bool PreFlightCheck::ekf2Check(orb_advert_t *mavlink_log_pub, vehicle_status_s &
 
 out:
 	//PX4_INFO("AHRS CHECK: %s", (success && ahrs_present) ? "OK" : "FAIL");
-	set_health_flags(subsystem_info_s::SUBSYSTEM_TYPE_AHRS, ahrs_present, true, success && ahrs_present, vehicle_status);
-	set_health_flags(subsystem_info_s::SUBSYSTEM_TYPE_GPS, gps_present, enforce_gps_required, gps_success, vehicle_status);
+	health.set(subsystem_info_s::SUBSYSTEM_TYPE_AHRS, ahrs_present, true, success && ahrs_present, vehicle_status);
+	health.set(subsystem_info_s::SUBSYSTEM_TYPE_GPS, gps_present, enforce_gps_required, gps_success, vehicle_status);
+
+	ctx.store(CheckId::Ekf2, signature, success);
 
 	return success;
 }
 
 bool PreFlightCheck::ekf2CheckStates(orb_advert_t *mavlink_log_pub, const bool report_fail)
 {
-	float ekf_ab_test_limit = 1.0f; // pass limit re-used for each test
-	param_get(param_find("COM_ARM_EKF_AB"), &ekf_ab_test_limit);
-
-	float ekf_gb_test_limit = 1.0f; // pass limit re-used for each test
-	param_get(param_find("COM_ARM_EKF_GB"), &ekf_gb_test_limit);
+	Context &ctx = context();
 
 	// Get estimator states data if available and exit with a fail recorded if not
-	uORB::SubscriptionData<estimator_selector_status_s> estimator_selector_status_sub{ORB_ID(estimator_selector_status)};
-	uORB::Subscription states_sub{ORB_ID(estimator_states), estimator_selector_status_sub.get().primary_instance};
+	updatePrimaryInstance(ctx.estimator_selector_status_sub, ctx.estimator_states_sub);
+	const estimator_states_s &states = ctx.estimator_states_sub.get();
 
-	estimator_states_s states;
+	const uint32_t signature = Context::signature({ctx.estimator_states_sub.get_instance(),
+					ctx.estimator_states_sub.get_last_generation(), ctx.param_epoch});
+	bool success = true;
 
-	if (states_sub.copy(&states)) {
+	if (ctx.cached(CheckId::Ekf2States, signature, report_fail, nullptr, success)) {
+		return success;
+	}
+
+	float ekf_ab_test_limit = 1.0f; // pass limit re-used for each test
+	param_get(ctx.params.com_arm_ekf_ab, &ekf_ab_test_limit);
+
+	float ekf_gb_test_limit = 1.0f; // pass limit re-used for each test
+	param_get(ctx.params.com_arm_ekf_gb, &ekf_gb_test_limit);
+
+	if (states.timestamp != 0) {
 
 		// check accelerometer delta velocity bias estimates
 		for (uint8_t index = 13; index < 16; index++) {
@@ -261,7 +294,8 @@ bool PreFlightCheck::ekf2CheckStates(orb_advert_t *mavlink_log_pub, const bool r
 					mavlink_log_critical(mavlink_log_pub, "Preflight Fail: High Accelerometer Bias");
 				}
 
-				return false;
+				success = false;
+				goto out;
 			}
 		}
 
@@ -276,9 +310,13 @@ bool PreFlightCheck::ekf2CheckStates(orb_advert_t *mavlink_log_pub, const bool r
 				mavlink_log_critical(mavlink_log_pub, "Preflight Fail: High Gyro Bias");
 			}
 
-			return false;
+			success = false;
+			goto out;
 		}
 	}
 
-	return true;
+out:
+	ctx.store(CheckId::Ekf2States, signature, success);
+
+	return success;
 }
@@ -32,6 +32,7 @@
  ****************************************************************************/
 
 #include "../PreFlightCheck.hpp"
+#include "../PreFlightCheckContext.hpp"
 
 #include <systemlib/mavlink_log.h>
 
@@ -43,7 +44,10 @@ bool PreFlightCheck::failureDetectorCheck(orb_advert_t *mavlink_log_pub, const v
 		return true;
 	}
 
-	if (status.failure_detector_status != vehicle_status_s::FAILURE_NONE) {
+	const bool success = (status.failure_detector_status == vehicle_status_s::FAILURE_NONE);
+	context().setResult(CheckId::FailureDetector, success);
+
+	if (!success) {
 		if (report_fail) {
 			if (status.failure_detector_status & vehicle_status_s::FAILURE_ROLL) {
 				mavlink_log_critical(mavlink_log_pub, "Preflight Fail: Roll failure detected");
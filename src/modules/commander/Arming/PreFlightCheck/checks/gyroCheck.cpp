@@ -32,28 +32,44 @@
  ****************************************************************************/
 
 #include "../PreFlightCheck.hpp"
+#include "../PreFlightCheckContext.hpp"
 
 #include <drivers/drv_hrt.h>
 #include <HealthFlags.h>
 #include <px4_defines.h>
 #include <lib/sensor_calibration/Utilities.hpp>
 #include <lib/systemlib/mavlink_log.h>
-#include <uORB/Subscription.hpp>
-#include <uORB/topics/sensor_gyro.h>
 
 using namespace time_literals;
 
 bool PreFlightCheck::gyroCheck(orb_advert_t *mavlink_log_pub, vehicle_status_s &status, const uint8_t instance,
 			       const bool optional, int32_t &device_id, const bool report_fail)
 {
-	const bool exists = (orb_exists(ORB_ID(sensor_gyro), instance) == PX4_OK);
+	Context &ctx = context();
+	const CheckId id = Context::sensorCheckId(CheckId::Gyro0, instance);
+
+	uORB::SubscriptionData<sensor_gyro_s> &gyro = ctx.gyro_subs[instance];
+	gyro.update();
+
+	const bool exists = gyro.advertised();
+
+	if (exists) {
+		device_id = gyro.get().device_id;
+	}
+
+	// the calibration lookup is only repeated if the device or the parameters changed
+	const uint32_t signature = Context::signature({exists, gyro.get().device_id, gyro.get().timestamp != 0, ctx.param_epoch});
+	bool success = false;
+
+	if (ctx.cached(id, signature, report_fail, &status, success)) {
+		return success;
+	}
+
 	bool calibration_valid = false;
 	bool valid = false;
 
 	if (exists) {
 
-		uORB::SubscriptionData<sensor_gyro_s> gyro{ORB_ID(sensor_gyro), instance};
-
 		valid = (gyro.get().device_id != 0) && (gyro.get().timestamp != 0);
 
 		if (!valid) {
@@ -62,8 +78,6 @@ bool PreFlightCheck::gyroCheck(orb_advert_t *mavlink_log_pub, vehicle_status_s &
 			}
 		}
 
-		device_id = gyro.get().device_id;
-
 		calibration_valid = (calibration::FindCalibrationIndex("GYRO", device_id) >= 0);
 
 		if (!calibration_valid) {
@@ -78,5 +92,9 @@ bool PreFlightCheck::gyroCheck(orb_advert_t *mavlink_log_pub, vehicle_status_s &
 		}
 	}
 
-	return calibration_valid && valid;
+	success = calibration_valid && valid;
+
+	ctx.store(id, signature, success);
+
+	return success;
 }
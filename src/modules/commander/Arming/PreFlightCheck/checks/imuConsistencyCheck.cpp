@@ -32,36 +32,46 @@
  ****************************************************************************/
 
 #include "../PreFlightCheck.hpp"
+#include "../PreFlightCheckContext.hpp"
 
 #include <HealthFlags.h>
 
 #include <lib/parameters/param.h>
 #include <systemlib/mavlink_log.h>
-#include <uORB/Subscription.hpp>
-#include <uORB/topics/sensors_status_imu.h>
 
 bool PreFlightCheck::imuConsistencyCheck(orb_advert_t *mavlink_log_pub, vehicle_status_s &status,
 		const bool report_status)
 {
+	Context &ctx = context();
+
+	// Get sensor_preflight data if available and exit with a fail recorded if not
+	ctx.sensors_status_imu_sub.update();
+	const sensors_status_imu_s &imu = ctx.sensors_status_imu_sub.get();
+
+	const uint32_t signature = Context::signature({ctx.sensors_status_imu_sub.get_last_generation(), ctx.param_epoch});
+	bool pass = true;
+
+	if (ctx.cached(CheckId::ImuConsistency, signature, report_status, &status, pass)) {
+		return pass;
+	}
+
+	HealthFlagsRecord &health = ctx.startEvaluation(CheckId::ImuConsistency);
+
 	float accel_test_limit = 1.f;
-	param_get(param_find("COM_ARM_IMU_ACC"), &accel_test_limit);
+	param_get(ctx.params.com_arm_imu_acc, &accel_test_limit);
 
 	float gyro_test_limit = 1.f;
-	param_get(param_find("COM_ARM_IMU_GYR"), &gyro_test_limit);
-
-	// Get sensor_preflight data if available and exit with a fail recorded if not
-	uORB::SubscriptionData<sensors_status_imu_s> sensors_status_imu_sub{ORB_ID(sensors_status_imu)};
-	const sensors_status_imu_s &imu = sensors_status_imu_sub.get();
+	param_get(ctx.params.com_arm_imu_gyr, &gyro_test_limit);
 
 	// Use the difference between IMU's to detect a bad calibration.
 	// If a single IMU is fitted, the value being checked will be zero so this check will always pass.
 	for (unsigned i = 0; i < (sizeof(imu.accel_inconsistency_m_s_s) / sizeof(imu.accel_inconsistency_m_s_s[0])); i++) {
 		if (imu.accel_device_ids[i] != 0) {
 			if (imu.accel_device_ids[i] == imu.accel_device_id_primary) {
-				set_health_flags_healthy(subsystem_info_s::SUBSYSTEM_TYPE_ACC, imu.accel_healthy[i], status);
+				health.setHealthy(subsystem_info_s::SUBSYSTEM_TYPE_ACC, imu.accel_healthy[i], status);
 
 			} else {
-				set_health_flags_healthy(subsystem_info_s::SUBSYSTEM_TYPE_ACC2, imu.accel_healthy[i], status);
+				health.setHealthy(subsystem_info_s::SUBSYSTEM_TYPE_ACC2, imu.accel_healthy[i], status);
 			}
 
 			const float accel_inconsistency_m_s_s = imu.accel_inconsistency_m_s_s[i];
@@ -71,14 +81,15 @@ bool PreFlightCheck::imuConsistencyCheck(orb_advert_t *mavlink_log_pub, vehicle_
 					mavlink_log_critical(mavlink_log_pub, "Preflight Fail: Accel %u inconsistent - Check Cal", i);
 
 					if (imu.accel_device_ids[i] == imu.accel_device_id_primary) {
-						set_health_flags_healthy(subsystem_info_s::SUBSYSTEM_TYPE_ACC, false, status);
+						health.setHealthy(subsystem_info_s::SUBSYSTEM_TYPE_ACC, false, status);
 
 					} else {
-						set_health_flags_healthy(subsystem_info_s::SUBSYSTEM_TYPE_ACC2, false, status);
+						health.setHealthy(subsystem_info_s::SUBSYSTEM_TYPE_ACC2, false, status);
 					}
 				}
 
-				return false;
+				pass = false;
+				goto out;
 
 			} else if (accel_inconsistency_m_s_s > accel_test_limit * 0.8f) {
 				if (report_status) {
@@ -92,10 +103,10 @@ bool PreFlightCheck::imuConsistencyCheck(orb_advert_t *mavlink_log_pub, vehicle_
 	for (unsigned i = 0; i < (sizeof(imu.gyro_inconsistency_rad_s) / sizeof(imu.gyro_inconsistency_rad_s[0])); i++) {
 		if (imu.gyro_device_ids[i] != 0) {
 			if (imu.gyro_device_ids[i] == imu.gyro_device_id_primary) {
-				set_health_flags_healthy(subsystem_info_s::SUBSYSTEM_TYPE_GYRO, imu.accel_healthy[i], status);
+				health.setHealthy(subsystem_info_s::SUBSYSTEM_TYPE_GYRO, imu.accel_healthy[i], status);
 
 			} else {
-				set_health_flags_healthy(subsystem_info_s::SUBSYSTEM_TYPE_GYRO2, imu.accel_healthy[i], status);
+				health.setHealthy(subsystem_info_s::SUBSYSTEM_TYPE_GYRO2, imu.accel_healthy[i], status);
 			}
 
 			const float gyro_inconsistency_rad_s = imu.gyro_inconsistency_rad_s[i];
@@ -105,14 +116,15 @@ bool PreFlightCheck::imuConsistencyCheck(orb_advert_t *mavlink_log_pub, vehicle_
 					mavlink_log_critical(mavlink_log_pub, "Preflight Fail: Gyro %u inconsistent - Check Cal", i);
 
 					if (imu.gyro_device_ids[i] == imu.gyro_device_id_primary) {
-						set_health_flags_healthy(subsystem_info_s::SUBSYSTEM_TYPE_GYRO, false, status);
+						health.setHealthy(subsystem_info_s::SUBSYSTEM_TYPE_GYRO, false, status);
 
 					} else {
-						set_health_flags_healthy(subsystem_info_s::SUBSYSTEM_TYPE_GYRO2, false, status);
+						health.setHealthy(subsystem_info_s::SUBSYSTEM_TYPE_GYRO2, false, status);
 					}
 				}
 
-				return false;
+				pass = false;
+				goto out;
 
 			} else if (gyro_inconsistency_rad_s > gyro_test_limit * 0.5f) {
 				if (report_status) {
@@ -122,5 +134,8 @@ bool PreFlightCheck::imuConsistencyCheck(orb_advert_t *mavlink_log_pub, vehicle_
 		}
 	}
 
-	return true;
+out:
+	ctx.store(CheckId::ImuConsistency, signature, pass);
+
+	return pass;
 }
@@ -32,25 +32,32 @@
  ****************************************************************************/
 
 #include "../PreFlightCheck.hpp"
+#include "../PreFlightCheckContext.hpp"
 
 #include <HealthFlags.h>
 
 #include <lib/parameters/param.h>
 #include <mathlib/mathlib.h>
 #include <systemlib/mavlink_log.h>
-#include <uORB/Subscription.hpp>
-#include <uORB/topics/sensor_preflight_mag.h>
 
 // return false if the magnetomer measurements are inconsistent
 bool PreFlightCheck::magConsistencyCheck(orb_advert_t *mavlink_log_pub, vehicle_status_s &status,
 		const bool report_status)
 {
-	bool pass = false; // flag for result of checks
+	Context &ctx = context();
 
 	// get the sensor preflight data
-	uORB::SubscriptionData<sensor_preflight_mag_s> sensors_sub{ORB_ID(sensor_preflight_mag)};
-	sensors_sub.update();
-	const sensor_preflight_mag_s &sensors = sensors_sub.get();
+	ctx.sensor_preflight_mag_sub.update();
+	const sensor_preflight_mag_s &sensors = ctx.sensor_preflight_mag_sub.get();
+
+	const uint32_t signature = Context::signature({ctx.sensor_preflight_mag_sub.get_last_generation(), ctx.param_epoch});
+	bool pass = false; // flag for result of checks
+
+	if (ctx.cached(CheckId::MagConsistency, signature, report_status, &status, pass)) {
+		return pass;
+	}
+
+	HealthFlagsRecord &health = ctx.startEvaluation(CheckId::MagConsistency);
 
 	if (sensors.timestamp == 0) {
 		// can happen if not advertised (yet)
@@ -60,7 +67,7 @@ bool PreFlightCheck::magConsistencyCheck(orb_advert_t *mavlink_log_pub, vehicle_
 	// Use the difference between sensors to detect a bad calibration, orientation or magnetic interference.
 	// If a single sensor is fitted, the value being checked will be zero so this check will always pass.
 	int32_t angle_difference_limit_deg = 90;
-	param_get(param_find("COM_ARM_MAG_ANG"), &angle_difference_limit_deg);
+	param_get(ctx.params.com_arm_mag_ang, &angle_difference_limit_deg);
 
 	pass = pass || angle_difference_limit_deg < 0; // disabled, pass check
 	pass = pass || sensors.mag_inconsistency_angle < math::radians<float>(angle_difference_limit_deg);
@@ -69,9 +76,11 @@ bool PreFlightCheck::magConsistencyCheck(orb_advert_t *mavlink_log_pub, vehicle_
 		mavlink_log_critical(mavlink_log_pub, "Preflight Fail: Compasses %d° inconsistent",
 				     static_cast<int>(math::degrees<float>(sensors.mag_inconsistency_angle)));
 		mavlink_log_critical(mavlink_log_pub, "Please check orientations and recalibrate");
-		set_health_flags_healthy(subsystem_info_s::SUBSYSTEM_TYPE_MAG, false, status);
-		set_health_flags_healthy(subsystem_info_s::SUBSYSTEM_TYPE_MAG2, false, status);
+		health.setHealthy(subsystem_info_s::SUBSYSTEM_TYPE_MAG, false, status);
+		health.setHealthy(subsystem_info_s::SUBSYSTEM_TYPE_MAG2, false, status);
 	}
 
+	ctx.store(CheckId::MagConsistency, signature, pass);
+
 	return pass;
 }
@@ -32,28 +32,47 @@
  ****************************************************************************/
 
 #include "../PreFlightCheck.hpp"
+#include "../PreFlightCheckContext.hpp"
 
 #include <drivers/drv_hrt.h>
 #include <HealthFlags.h>
 #include <px4_defines.h>
 #include <lib/sensor_calibration/Utilities.hpp>
 #include <lib/systemlib/mavlink_log.h>
-#include <uORB/Subscription.hpp>
-#include <uORB/topics/sensor_mag.h>
 
 using namespace time_literals;
 
 bool PreFlightCheck::magnetometerCheck(orb_advert_t *mavlink_log_pub, vehicle_status_s &status, const uint8_t instance,
 				       const bool optional, int32_t &device_id, const bool report_fail)
 {
-	const bool exists = (orb_exists(ORB_ID(sensor_mag), instance) == PX4_OK);
+	Context &ctx = context();
+	const CheckId id = Context::sensorCheckId(CheckId::Mag0, instance);
+
+	uORB::SubscriptionData<sensor_mag_s> &magnetometer = ctx.mag_subs[instance];
+	magnetometer.update();
+
+	const bool exists = magnetometer.advertised();
+
+	if (exists) {
+		device_id = magnetometer.get().device_id;
+	}
+
+	// the calibration lookup is only repeated if the device or the parameters changed
+	const uint32_t signature = Context::signature({exists, magnetometer.get().device_id, magnetometer.get().timestamp != 0,
+					optional, ctx.param_epoch});
+	bool success = false;
+
+	if (ctx.cached(id, signature, report_fail, &status, success)) {
+		return success;
+	}
+
+	HealthFlagsRecord &health = ctx.startEvaluation(id);
+
 	bool calibration_valid = false;
 	bool valid = false;
 
 	if (exists) {
 
-		uORB::SubscriptionData<sensor_mag_s> magnetometer{ORB_ID(sensor_mag), instance};
-
 		valid = (magnetometer.get().device_id != 0) && (magnetometer.get().timestamp != 0);
 
 		if (!valid) {
@@ -62,8 +81,6 @@ bool PreFlightCheck::magnetometerCheck(orb_advert_t *mavlink_log_pub, vehicle_st
 			}
 		}
 
-		device_id = magnetometer.get().device_id;
-
 		calibration_valid = (calibration::FindCalibrationIndex("MAG", device_id) >= 0);
 
 		if (!calibration_valid) {
@@ -78,14 +95,16 @@ bool PreFlightCheck::magnetometerCheck(orb_advert_t *mavlink_log_pub, vehicle_st
 		}
 	}
 
-	const bool success = calibration_valid && valid;
+	success = calibration_valid && valid;
 
 	if (instance == 0) {
-		set_health_flags(subsystem_info_s::SUBSYSTEM_TYPE_MAG, exists, !optional, success, status);
+		health.set(subsystem_info_s::SUBSYSTEM_TYPE_MAG, exists, !optional, success, status);
 
 	} else if (instance == 1) {
-		set_health_flags(subsystem_info_s::SUBSYSTEM_TYPE_MAG2, exists, !optional, success, status);
+		health.set(subsystem_info_s::SUBSYSTEM_TYPE_MAG2, exists, !optional, success, status);
 	}
 
+	ctx.store(id, signature, success);
+
 	return success;
 }
@@ -32,19 +32,25 @@
  ****************************************************************************/
 
 #include "../PreFlightCheck.hpp"
+#include "../PreFlightCheckContext.hpp"
 
 #include <systemlib/mavlink_log.h>
-#include <uORB/Subscription.hpp>
-#include <uORB/topics/manual_control_switches.h>
 
 using namespace time_literals;
 
 bool PreFlightCheck::manualControlCheck(orb_advert_t *mavlink_log_pub, const bool report_fail)
 {
+	Context &ctx = context();
+
+	ctx.manual_control_switches_sub.update();
+	const manual_control_switches_s &manual_control_switches = ctx.manual_control_switches_sub.get();
+
+	const uint32_t signature = Context::signature({ctx.manual_control_switches_sub.get_last_generation()});
 	bool success = true;
 
-	uORB::SubscriptionData<manual_control_switches_s> manual_control_switches_sub{ORB_ID(manual_control_switches)};
-	const manual_control_switches_s &manual_control_switches = manual_control_switches_sub.get();
+	if (ctx.cached(CheckId::ManualControl, signature, report_fail, nullptr, success)) {
+		return success;
+	}
 
 	if (manual_control_switches.timestamp != 0) {
 
@@ -75,5 +81,7 @@ bool PreFlightCheck::manualControlCheck(orb_advert_t *mavlink_log_pub, const boo
 
 	}
 
+	ctx.store(CheckId::ManualControl, signature, success);
+
 	return success;
 }
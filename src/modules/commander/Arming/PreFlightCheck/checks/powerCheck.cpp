@@ -32,12 +32,11 @@
  ****************************************************************************/
 
 #include "../PreFlightCheck.hpp"
+#include "../PreFlightCheckContext.hpp"
 
 #include <drivers/drv_hrt.h>
 #include <systemlib/mavlink_log.h>
 #include <lib/parameters/param.h>
-#include <uORB/Subscription.hpp>
-#include <uORB/topics/system_power.h>
 
 using namespace time_literals;
 
@@ -63,13 +62,20 @@ bool PreFlightCheck::powerCheck(orb_advert_t *mavlink_log_pub, const vehicle_sta
 		return true;
 	}
 
-	uORB::SubscriptionData<system_power_s> system_power_sub{ORB_ID(system_power)};
-	system_power_sub.update();
-	const system_power_s &system_power = system_power_sub.get();
+	Context &ctx = context();
+
+	ctx.system_power_sub.update();
+	const system_power_s &system_power = ctx.system_power_sub.get();
+
+	const uint32_t signature = Context::signature({ctx.system_power_sub.get_last_generation(), ctx.param_epoch});
+
+	if (ctx.cached(CheckId::Power, signature, report_fail, nullptr, success)) {
+		return success;
+	}
 
 	if (system_power.timestamp != 0) {
 		int32_t required_power_module_count = 0;
-		param_get(param_find("COM_POWER_COUNT"), &required_power_module_count);
+		param_get(ctx.params.com_power_count, &required_power_module_count);
 
 		// Check avionics rail voltages (if USB isn't connected)
 		if (!system_power.usb_connected) {
@@ -115,5 +121,7 @@ bool PreFlightCheck::powerCheck(orb_advert_t *mavlink_log_pub, const vehicle_sta
 		success = false;
 	}
 
+	ctx.store(CheckId::Power, signature, success);
+
 	return success;
 }
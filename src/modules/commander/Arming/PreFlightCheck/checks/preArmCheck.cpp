@@ -32,8 +32,10 @@
  ****************************************************************************/
 
 #include "../PreFlightCheck.hpp"
+#include "../PreFlightCheckContext.hpp"
 
 #include <ArmAuthorization.h>
+#include <containers/LockGuard.hpp>
 #include <systemlib/mavlink_log.h>
 #include <uORB/topics/vehicle_command_ack.h>
 #include <HealthFlags.h>
@@ -169,6 +171,9 @@ bool PreFlightCheck::preArmCheck(orb_advert_t *mavlink_log_pub, const vehicle_st
 		}
 	}
 
+	Context &ctx = context();
+	LockGuard lg{ctx.lock};
+	ctx.setResult(CheckId::PreArm, prearm_ok);
 
 	return prearm_ok;
 }
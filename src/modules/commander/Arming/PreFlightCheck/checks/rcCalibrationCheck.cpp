@@ -32,6 +32,7 @@
  ****************************************************************************/
 
 #include "../PreFlightCheck.hpp"
+#include "../PreFlightCheckContext.hpp"
 
 #include <parameters/param.h>
 #include <systemlib/mavlink_log.h>
@@ -54,9 +55,7 @@
 
 int PreFlightCheck::rcCalibrationCheck(orb_advert_t *mavlink_log_pub, bool report_fail, bool isVTOL)
 {
-	char nbuf[20];
-	param_t _parameter_handles_min, _parameter_handles_trim, _parameter_handles_max,
-		_parameter_handles_rev, _parameter_handles_dz;
+	const Context &ctx = context();
 
 	unsigned map_fail_count = 0;
 
@@ -69,7 +68,7 @@ int PreFlightCheck::rcCalibrationCheck(orb_advert_t *mavlink_log_pub, bool repor
 
 	/* if VTOL, check transition switch mapping */
 	if (isVTOL) {
-		param_t trans_parm = param_find("RC_MAP_TRANS_SW");
+		param_t trans_parm = ctx.params.rc_map_trans_sw;
 
 		if (trans_parm == PARAM_INVALID) {
 			if (report_fail) { mavlink_log_critical(mavlink_log_pub, "RC_MAP_TRANS_SW PARAMETER MISSING."); }
@@ -142,29 +141,19 @@ int PreFlightCheck::rcCalibrationCheck(orb_advert_t *mavlink_log_pub, bool repor
 		float param_dz = RC_INPUT_MAX_DEADZONE_US * 2.0f;
 
 		/* min values */
-		sprintf(nbuf, "RC%d_MIN", i + 1);
-		_parameter_handles_min = param_find(nbuf);
-		param_get(_parameter_handles_min, &param_min);
+		param_get(ctx.params.rc_min[i], &param_min);
 
 		/* trim values */
-		sprintf(nbuf, "RC%d_TRIM", i + 1);
-		_parameter_handles_trim = param_find(nbuf);
-		param_get(_parameter_handles_trim, &param_trim);
+		param_get(ctx.params.rc_trim[i], &param_trim);
 
 		/* max values */
-		sprintf(nbuf, "RC%d_MAX", i + 1);
-		_parameter_handles_max = param_find(nbuf);
-		param_get(_parameter_handles_max, &param_max);
+		param_get(ctx.params.rc_max[i], &param_max);
 
 		/* channel reverse */
-		sprintf(nbuf, "RC%d_REV", i + 1);
-		_parameter_handles_rev = param_find(nbuf);
-		param_get(_parameter_handles_rev, &param_rev);
+		param_get(ctx.params.rc_rev[i], &param_rev);
 
 		/* channel deadzone */
-		sprintf(nbuf, "RC%d_DZ", i + 1);
-		_parameter_handles_dz = param_find(nbuf);
-		param_get(_parameter_handles_dz, &param_dz);
+		param_get(ctx.params.rc_dz[i], &param_dz);
 
 		/* assert min..center..max ordering */
 		if (param_min < RC_INPUT_LOWEST_MIN_US) {
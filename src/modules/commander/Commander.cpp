@@ -238,6 +238,7 @@ int Commander::custom_command(int argc, char *argv[])
 		PX4_INFO("Prearm check: %s", prearm_check_res ? "OK" : "FAILED");
 
 		print_health_flags(vehicle_status);
+		PreFlightCheck::printStatus();
 
 		return 0;
 	}
@@ -0,0 +1,159 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file ActuatorEffectivenessMultirotor.cpp
+ *
+ * Actuator effectiveness computed from rotors position and orientation
+ */
+
+#include "ActuatorEffectivenessMultirotor.hpp"
+
+#include <float.h>
+
+#include <mathlib/mathlib.h>
+
+ActuatorEffectivenessMultirotor::ActuatorEffectivenessMultirotor(ModuleParams *parent) :
+	ModuleParams(parent)
+{
+	// 16 chars for parameter name + null terminator
+	char param_name[17];
+
+	for (int i = 0; i < NUM_ROTORS_MAX; i++) {
+		snprintf(param_name, sizeof(param_name), "CA_MC_R%d_PX", i);
+		_param_handles[i].position_x = param_find(param_name);
+		snprintf(param_name, sizeof(param_name), "CA_MC_R%d_PY", i);
+		_param_handles[i].position_y = param_find(param_name);
+		snprintf(param_name, sizeof(param_name), "CA_MC_R%d_PZ", i);
+		_param_handles[i].position_z = param_find(param_name);
+		snprintf(param_name, sizeof(param_name), "CA_MC_R%d_AX", i);
+		_param_handles[i].axis_x = param_find(param_name);
+		snprintf(param_name, sizeof(param_name), "CA_MC_R%d_AY", i);
+		_param_handles[i].axis_y = param_find(param_name);
+		snprintf(param_name, sizeof(param_name), "CA_MC_R%d_AZ", i);
+		_param_handles[i].axis_z = param_find(param_name);
+		snprintf(param_name, sizeof(param_name), "CA_MC_R%d_CT", i);
+		_param_handles[i].thrust_coef = param_find(param_name);
+		snprintf(param_name, sizeof(param_name), "CA_MC_R%d_KM", i);
+		_param_handles[i].moment_ratio = param_find(param_name);
+	}
+
+	_count_handle = param_find("CA_MC_R_COUNT");
+
+	updateParams();
+}
+
+void
+ActuatorEffectivenessMultirotor::updateParams()
+{
+	ModuleParams::updateParams();
+
+	int32_t count = 0;
+
+	if (param_get(_count_handle, &count) != 0) {
+		PX4_ERR("param_get failed");
+		return;
+	}
+
+	_geometry.num_rotors = math::constrain((int)count, 0, NUM_ROTORS_MAX);
+
+	for (int i = 0; i < _geometry.num_rotors; ++i) {
+		RotorGeometry &rotor = _geometry.rotors[i];
+		param_get(_param_handles[i].position_x, &rotor.position(0));
+		param_get(_param_handles[i].position_y, &rotor.position(1));
+		param_get(_param_handles[i].position_z, &rotor.position(2));
+		param_get(_param_handles[i].axis_x, &rotor.axis(0));
+		param_get(_param_handles[i].axis_y, &rotor.axis(1));
+		param_get(_param_handles[i].axis_z, &rotor.axis(2));
+		param_get(_param_handles[i].thrust_coef, &rotor.thrust_coef);
+		param_get(_param_handles[i].moment_ratio, &rotor.moment_ratio);
+	}
+
+	_updated = true;
+}
+
+bool
+ActuatorEffectivenessMultirotor::getEffectivenessMatrix(matrix::Matrix<float, NUM_AXES, NUM_ACTUATORS> &matrix,
+		bool force)
+{
+	if (_updated || force) {
+		_updated = false;
+		computeEffectivenessMatrix(_geometry, matrix);
+		return true;
+	}
+
+	return false;
+}
+
+int
+ActuatorEffectivenessMultirotor::computeEffectivenessMatrix(const MultirotorGeometry &geometry,
+		matrix::Matrix<float, NUM_AXES, NUM_ACTUATORS> &effectiveness)
+{
+	effectiveness.setZero();
+
+	int num_actuators = 0;
+
+	for (int i = 0; i < geometry.num_rotors && i < NUM_ACTUATORS; i++) {
+		const RotorGeometry &rotor = geometry.rotors[i];
+
+		// Get rotor axis
+		matrix::Vector3f axis = rotor.axis;
+		const float axis_norm = axis.norm();
+
+		if (axis_norm > FLT_EPSILON) {
+			axis /= axis_norm;
+
+		} else {
+			// Bad axis definition, ignore this rotor
+			continue;
+		}
+
+		// Compute thrust generated by this rotor
+		const matrix::Vector3f thrust = rotor.thrust_coef * axis;
+
+		// Compute moment generated by this rotor
+		const matrix::Vector3f moment = rotor.thrust_coef * rotor.position.cross(axis)
+						- rotor.thrust_coef * rotor.moment_ratio * axis;
+
+		// Fill corresponding items in effectiveness matrix
+		for (int j = 0; j < 3; j++) {
+			effectiveness(j, i) = moment(j);
+			effectiveness(j + 3, i) = thrust(j);
+		}
+
+		num_actuators = i + 1;
+	}
+
+	return num_actuators;
+}
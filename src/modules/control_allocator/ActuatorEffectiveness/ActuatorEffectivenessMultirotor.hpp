@@ -0,0 +1,103 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file ActuatorEffectivenessMultirotor.hpp
+ *
+ * Actuator effectiveness computed from rotors position and orientation
+ */
+
+#pragma once
+
+#include "ActuatorEffectiveness.hpp"
+
+#include <px4_platform_common/module_params.h>
+
+class ActuatorEffectivenessMultirotor: public ModuleParams, public ActuatorEffectiveness
+{
+public:
+	ActuatorEffectivenessMultirotor(ModuleParams *parent);
+	virtual ~ActuatorEffectivenessMultirotor() = default;
+
+	static constexpr int NUM_ROTORS_MAX = 8;
+
+	struct RotorGeometry {
+		matrix::Vector3f position;
+		matrix::Vector3f axis;
+		float thrust_coef;
+		float moment_ratio;
+	};
+
+	struct MultirotorGeometry {
+		RotorGeometry rotors[NUM_ROTORS_MAX];
+		int num_rotors{0};
+	};
+
+	/**
+	 * Fill the effectiveness matrix with the rotors, starting at the first column
+	 *
+	 * Thrust is thrust_coef * axis, torque is thrust_coef * (position x axis - moment_ratio * axis).
+	 *
+	 * @return number of columns filled
+	 */
+	static int computeEffectivenessMatrix(const MultirotorGeometry &geometry,
+					      matrix::Matrix<float, NUM_AXES, NUM_ACTUATORS> &effectiveness);
+
+	bool getEffectivenessMatrix(matrix::Matrix<float, NUM_AXES, NUM_ACTUATORS> &matrix, bool force) override;
+
+	int numActuators() const override { return _geometry.num_rotors; }
+	int numMotors() const override { return _geometry.num_rotors; }
+
+	const MultirotorGeometry &getGeometry() const { return _geometry; }
+
+private:
+	void updateParams() override;
+
+	struct ParamHandles {
+		param_t position_x;
+		param_t position_y;
+		param_t position_z;
+		param_t axis_x;
+		param_t axis_y;
+		param_t axis_z;
+		param_t thrust_coef;
+		param_t moment_ratio;
+	};
+
+	ParamHandles _param_handles[NUM_ROTORS_MAX] {};
+	param_t _count_handle{PARAM_INVALID};
+
+	MultirotorGeometry _geometry{};
+	bool _updated{true};
+};
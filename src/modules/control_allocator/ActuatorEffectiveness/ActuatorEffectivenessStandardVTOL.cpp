@@ -0,0 +1,123 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file ActuatorEffectivenessStandardVTOL.cpp
+ *
+ * Actuator effectiveness for standard VTOL
+ */
+
+#include "ActuatorEffectivenessStandardVTOL.hpp"
+
+ActuatorEffectivenessStandardVTOL::ActuatorEffectivenessStandardVTOL(ModuleParams *parent) :
+	ModuleParams(parent)
+{
+}
+
+void
+ActuatorEffectivenessStandardVTOL::updateParams()
+{
+	ModuleParams::updateParams();
+	_updated = true;
+}
+
+bool
+ActuatorEffectivenessStandardVTOL::getEffectivenessMatrix(matrix::Matrix<float, NUM_AXES, NUM_ACTUATORS> &matrix,
+		bool force)
+{
+	if (!(_updated || force)) {
+		return false;
+	}
+
+	_updated = false;
+
+	// Hover rotors first, the fixed wing actuators follow
+	const int num_rotors = ActuatorEffectivenessMultirotor::computeEffectivenessMatrix(_mc_rotors.getGeometry(), matrix);
+
+	const int pusher = num_rotors;
+	const int aileron_left = num_rotors + 1;
+	const int aileron_right = num_rotors + 2;
+	const int elevator = num_rotors + 3;
+	const int rudder = num_rotors + 4;
+
+	if (rudder >= NUM_ACTUATORS) {
+		return true;
+	}
+
+	const float ail = _param_ca_sv_ail_gain.get();
+
+	matrix(ControlAllocation::THRUST_X, pusher) = _param_ca_sv_push_ct.get();
+	matrix(ControlAllocation::ROLL, aileron_left) = -ail;
+	matrix(ControlAllocation::ROLL, aileron_right) = ail;
+	matrix(ControlAllocation::PITCH, elevator) = _param_ca_sv_elev_gain.get();
+	matrix(ControlAllocation::YAW, rudder) = _param_ca_sv_rud_gain.get();
+
+	switch (_flight_phase) {
+	case FlightPhase::HOVER_FLIGHT:
+		// control surfaces and pusher are not used in hover
+		for (int i = pusher; i <= rudder; i++) {
+			for (int axis = 0; axis < NUM_AXES; axis++) {
+				matrix(axis, i) = 0.f;
+			}
+		}
+
+		break;
+
+	case FlightPhase::FORWARD_FLIGHT:
+		// hover rotors are stopped in forward flight
+		for (int i = 0; i < num_rotors; i++) {
+			for (int axis = 0; axis < NUM_AXES; axis++) {
+				matrix(axis, i) = 0.f;
+			}
+		}
+
+		break;
+
+	case FlightPhase::TRANSITION_HF_TO_FF:
+	case FlightPhase::TRANSITION_FF_TO_HF:
+		// all actuators are used during transitions
+		break;
+	}
+
+	return true;
+}
+
+void
+ActuatorEffectivenessStandardVTOL::setFlightPhase(const FlightPhase &flight_phase)
+{
+	if (flight_phase != _flight_phase) {
+		ActuatorEffectiveness::setFlightPhase(flight_phase);
+		_updated = true;
+	}
+}
@@ -0,0 +1,81 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file ActuatorEffectivenessStandardVTOL.hpp
+ *
+ * Actuator effectiveness for standard VTOL
+ *
+ * Actuators are ordered as: hover rotors, pusher, left aileron, right aileron, elevator, rudder.
+ */
+
+#pragma once
+
+#include "ActuatorEffectiveness.hpp"
+#include "ActuatorEffectivenessMultirotor.hpp"
+
+#include <px4_platform_common/module_params.h>
+
+class ActuatorEffectivenessStandardVTOL: public ModuleParams, public ActuatorEffectiveness
+{
+public:
+	ActuatorEffectivenessStandardVTOL(ModuleParams *parent);
+	virtual ~ActuatorEffectivenessStandardVTOL() = default;
+
+	bool getEffectivenessMatrix(matrix::Matrix<float, NUM_AXES, NUM_ACTUATORS> &matrix, bool force) override;
+
+	/**
+	 * Set the current flight phase
+	 *
+	 * @param Flight phase
+	 */
+	void setFlightPhase(const FlightPhase &flight_phase) override;
+
+	int numActuators() const override { return _mc_rotors.numActuators() + 5; }
+	int numMotors() const override { return _mc_rotors.numActuators() + 1; }
+
+private:
+	void updateParams() override;
+
+	ActuatorEffectivenessMultirotor _mc_rotors{this};
+
+	bool _updated{true};
+
+	DEFINE_PARAMETERS(
+		(ParamFloat<px4::params::CA_SV_PUSH_CT>) _param_ca_sv_push_ct,
+		(ParamFloat<px4::params::CA_SV_AIL_GAIN>) _param_ca_sv_ail_gain,
+		(ParamFloat<px4::params::CA_SV_ELEV_GAIN>) _param_ca_sv_elev_gain,
+		(ParamFloat<px4::params::CA_SV_RUD_GAIN>) _param_ca_sv_rud_gain
+	)
+};
@@ -0,0 +1,132 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file ControlAllocation.cpp
+ *
+ * Interface for control allocation algorithms.
+ */
+
+#include "ControlAllocation.hpp"
+
+#include <mathlib/mathlib.h>
+
+void
+ControlAllocation::setEffectivenessMatrix(const matrix::Matrix<float, NUM_AXES, NUM_ACTUATORS> &effectiveness,
+		const ActuatorVector &actuator_trim, int num_actuators)
+{
+	_effectiveness = effectiveness;
+	_actuator_trim = actuator_trim;
+	_num_actuators = math::constrain(num_actuators, 0, (int)NUM_ACTUATORS);
+
+	// unused actuators have no effect
+	for (int i = _num_actuators; i < NUM_ACTUATORS; i++) {
+		for (int axis = 0; axis < NUM_AXES; axis++) {
+			_effectiveness(axis, i) = 0.f;
+		}
+
+		_actuator_trim(i) = 0.f;
+	}
+
+	_control_trim = _effectiveness * _actuator_trim;
+}
+
+matrix::Vector<float, ControlAllocation::NUM_AXES>
+ControlAllocation::getAllocatedControl() const
+{
+	return _effectiveness * _actuator_sp;
+}
+
+void
+ControlAllocation::setActuatorSetpoint(const ActuatorVector &actuator_sp)
+{
+	// Set actuator setpoint
+	_actuator_sp = actuator_sp;
+
+	// Clip
+	clipActuatorSetpoint(_actuator_sp);
+}
+
+void
+ControlAllocation::clipActuatorSetpoint()
+{
+	clipActuatorSetpoint(_actuator_sp);
+}
+
+void
+ControlAllocation::clipActuatorSetpoint(ActuatorVector &actuator) const
+{
+	for (int i = 0; i < _num_actuators; i++) {
+		if (_actuator_max(i) < _actuator_min(i)) {
+			actuator(i) = _actuator_trim(i);
+
+		} else if (actuator(i) < _actuator_min(i)) {
+			actuator(i) = _actuator_min(i);
+
+		} else if (actuator(i) > _actuator_max(i)) {
+			actuator(i) = _actuator_max(i);
+		}
+	}
+}
+
+ControlAllocation::ActuatorVector
+ControlAllocation::normalizeActuatorSetpoint(const ActuatorVector &actuator) const
+{
+	ActuatorVector actuator_normalized;
+
+	for (int i = 0; i < _num_actuators; i++) {
+		if (_actuator_min(i) < _actuator_max(i)) {
+			actuator_normalized(i) = -1.0f + 2.0f * (actuator(i) - _actuator_min(i)) / (_actuator_max(i) - _actuator_min(i));
+
+		} else {
+			actuator_normalized(i) = 0.f;
+		}
+	}
+
+	return actuator_normalized;
+}
+
+void
+ControlAllocation::gateMotors(ActuatorVector &actuator_normalized, int num_motors, MotorGate gate)
+{
+	if (gate == MotorGate::NONE) {
+		return;
+	}
+
+	const float value = (gate == MotorGate::IDLE) ? -1.f : NAN;
+
+	for (int i = 0; i < math::min(num_motors, (int)NUM_ACTUATORS); i++) {
+		actuator_normalized(i) = value;
+	}
+}
@@ -0,0 +1,219 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file ControlAllocation.hpp
+ *
+ * Interface for control allocation algorithms.
+ *
+ * Implementers of this interface are expected to update the members
+ * of this base class in the `allocate` method.
+ *
+ * Example usage:
+ * ```
+ * [...]
+ * // Initialization
+ * ControlAllocationMethodImpl alloc();
+ * alloc.setEffectivenessMatrix(effectiveness, actuator_trim, num_actuators);
+ * alloc.setActuatorMin(actuator_min);
+ * alloc.setActuatorMax(actuator_max);
+ *
+ * while (1) {
+ * 	[...]
+ *
+ * 	// Set control setpoint, allocate actuator setpoint, retrieve actuator setpoint
+ * 	alloc.setControlSetpoint(control_sp);
+ * 	alloc.allocate();
+ * 	alloc.clipActuatorSetpoint();
+ * 	actuator_sp = alloc.getActuatorSetpoint();
+ *
+ * 	// Check if the control setpoint was fully allocated
+ * 	unallocated_control = control_sp - alloc.getAllocatedControl();
+ *
+ * 	[...]
+ * }
+ * ```
+ */
+
+#pragma once
+
+#include <matrix/matrix/math.hpp>
+
+class ControlAllocation
+{
+public:
+	ControlAllocation() = default;
+	virtual ~ControlAllocation() = default;
+
+	static constexpr uint8_t NUM_ACTUATORS = 16;
+	static constexpr uint8_t NUM_AXES = 6;
+
+	typedef matrix::Vector<float, NUM_ACTUATORS> ActuatorVector;
+
+	enum ControlAxis {
+		ROLL = 0,
+		PITCH,
+		YAW,
+		THRUST_X,
+		THRUST_Y,
+		THRUST_Z
+	};
+
+	/**
+	 * Allocate control setpoint to actuators
+	 */
+	virtual void allocate() = 0;
+
+	/**
+	 * Set the control effectiveness matrix
+	 *
+	 * @param effectiveness Control effectiveness matrix
+	 * @param actuator_trim Actuator setpoint at which the effectiveness matrix was computed
+	 * @param num_actuators Number of actuators in use (the remaining columns are ignored)
+	 */
+	virtual void setEffectivenessMatrix(const matrix::Matrix<float, NUM_AXES, NUM_ACTUATORS> &effectiveness,
+					    const ActuatorVector &actuator_trim, int num_actuators);
+
+	/**
+	 * Get the allocated actuator vector
+	 */
+	const ActuatorVector &getActuatorSetpoint() const { return _actuator_sp; }
+
+	/**
+	 * Set the desired control vector
+	 */
+	void setControlSetpoint(const matrix::Vector<float, NUM_AXES> &control) { _control_sp = control; }
+
+	/**
+	 * Get the desired control vector
+	 */
+	const matrix::Vector<float, NUM_AXES> &getControlSetpoint() const { return _control_sp; }
+
+	/**
+	 * Get the allocated control vector
+	 *
+	 * @return Control vector
+	 */
+	matrix::Vector<float, NUM_AXES> getAllocatedControl() const;
+
+	/**
+	 * Get the control effectiveness matrix
+	 */
+	const matrix::Matrix<float, NUM_AXES, NUM_ACTUATORS> &getEffectivenessMatrix() const { return _effectiveness; }
+
+	/**
+	 * Set the minimum actuator values
+	 */
+	void setActuatorMin(const ActuatorVector &actuator_min) { _actuator_min = actuator_min; }
+
+	/**
+	 * Get the minimum actuator values
+	 */
+	const ActuatorVector &getActuatorMin() const { return _actuator_min; }
+
+	/**
+	 * Set the maximum actuator values
+	 */
+	void setActuatorMax(const ActuatorVector &actuator_max) { _actuator_max = actuator_max; }
+
+	/**
+	 * Get the maximum actuator values
+	 */
+	const ActuatorVector &getActuatorMax() const { return _actuator_max; }
+
+	/**
+	 * Set the current actuator setpoint.
+	 *
+	 * Use this when a new allocation method is started to initialize it properly.
+	 * In most cases, it is not needed to call this method before `allocate()`.
+	 * Indeed the previous actuator setpoint is expected to be stored during calls to `allocate()`.
+	 */
+	void setActuatorSetpoint(const ActuatorVector &actuator_sp);
+
+	/**
+	 * Clip the actuator setpoint between minimum and maximum values.
+	 *
+	 * The output is in the range [min; max]
+	 */
+	void clipActuatorSetpoint();
+
+	/**
+	 * Normalize the actuator setpoint between minimum and maximum values.
+	 *
+	 * The output is in the range [-1; +1]
+	 *
+	 * @param actuator Actuator vector to normalize
+	 *
+	 * @return Normalized actuator setpoint (0 for actuators without a valid range)
+	 */
+	ActuatorVector normalizeActuatorSetpoint(const ActuatorVector &actuator) const;
+
+	enum class MotorGate {
+		NONE = 0,	///< motors follow the allocation
+		IDLE,		///< motor spin-up after arming: motors held at idle (-1)
+		DISARMED,	///< not armed (incl. prearmed): motors invalid (NaN), outputs go to their disarmed value
+	};
+
+	/**
+	 * Gate the motor channels of a normalized actuator setpoint.
+	 *
+	 * This is the equivalent of the throttle handling of the mixer module for the attitude
+	 * control groups, which does not apply to the allocated groups passed through to the outputs.
+	 *
+	 * @param actuator_normalized Normalized actuator setpoint, the first num_motors entries are motors
+	 * @param num_motors Number of motors
+	 * @param gate Gating to apply
+	 */
+	static void gateMotors(ActuatorVector &actuator_normalized, int num_motors, MotorGate gate);
+
+	/**
+	 * @return the number of actuators in use
+	 */
+	int numActuators() const { return _num_actuators; }
+
+protected:
+	/**
+	 * Clip an actuator vector between minimum and maximum values.
+	 */
+	void clipActuatorSetpoint(ActuatorVector &actuator) const;
+
+	matrix::Matrix<float, NUM_AXES, NUM_ACTUATORS> _effectiveness;  //< Effectiveness matrix
+	ActuatorVector _actuator_trim; 	//< Neutral actuator values
+	ActuatorVector _actuator_min; 	//< Minimum actuator values
+	ActuatorVector _actuator_max; 	//< Maximum actuator values
+	ActuatorVector _actuator_sp;  	//< Actuator setpoint
+	matrix::Vector<float, NUM_AXES> _control_sp;   //< Control setpoint
+	matrix::Vector<float, NUM_AXES> _control_trim; //< Control at trim actuator values
+	int _num_actuators{0};
+};
@@ -0,0 +1,148 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file ControlAllocationPseudoInverse.cpp
+ *
+ * Simple Control Allocation Algorithm
+ */
+
+#include "ControlAllocationPseudoInverse.hpp"
+
+#include <float.h>
+#include <math.h>
+
+void
+ControlAllocationPseudoInverse::setEffectivenessMatrix(
+	const matrix::Matrix<float, NUM_AXES, NUM_ACTUATORS> &effectiveness,
+	const ActuatorVector &actuator_trim, int num_actuators)
+{
+	ControlAllocation::setEffectivenessMatrix(effectiveness, actuator_trim, num_actuators);
+
+	// precompute the mix matrix, this is the expensive part and only done on configuration changes
+	matrix::geninv(_effectiveness, _mix);
+	normalizeControlAllocationMatrix();
+	_mix_updates++;
+}
+
+void
+ControlAllocationPseudoInverse::normalizeControlAllocationMatrix()
+{
+	for (int axis = 0; axis < NUM_AXES; axis++) {
+		_control_allocation_scale(axis) = 1.f;
+	}
+
+	if (_normalize_rpy) {
+		// Same scale on roll and pitch
+		float roll_norm_squared = 0.f;
+		float pitch_norm_squared = 0.f;
+		int num_non_zero_roll_torque = 0;
+		int num_non_zero_pitch_torque = 0;
+		float yaw_max = 0.f;
+
+		for (int i = 0; i < _num_actuators; i++) {
+			roll_norm_squared += _mix(i, ROLL) * _mix(i, ROLL);
+			pitch_norm_squared += _mix(i, PITCH) * _mix(i, PITCH);
+
+			if (fabsf(_mix(i, ROLL)) > 1e-3f) {
+				++num_non_zero_roll_torque;
+			}
+
+			if (fabsf(_mix(i, PITCH)) > 1e-3f) {
+				++num_non_zero_pitch_torque;
+			}
+
+			yaw_max = fmaxf(yaw_max, fabsf(_mix(i, YAW)));
+		}
+
+		const float roll_norm_scale = (num_non_zero_roll_torque > 0) ?
+					      sqrtf(roll_norm_squared / (num_non_zero_roll_torque / 2.f)) : 1.f;
+		const float pitch_norm_scale = (num_non_zero_pitch_torque > 0) ?
+					       sqrtf(pitch_norm_squared / (num_non_zero_pitch_torque / 2.f)) : 1.f;
+
+		_control_allocation_scale(ROLL) = fmaxf(roll_norm_scale, pitch_norm_scale);
+		_control_allocation_scale(PITCH) = _control_allocation_scale(ROLL);
+
+		// Scale yaw separately
+		_control_allocation_scale(YAW) = yaw_max;
+
+		// Scale thrust by the mean of the non-zero entries (Z first, used for axes without actuators)
+		for (int axis = THRUST_Z; axis >= THRUST_X; axis--) {
+			int num_non_zero_thrust = 0;
+			float norm_sum = 0.f;
+
+			for (int i = 0; i < _num_actuators; i++) {
+				const float norm = fabsf(_mix(i, axis));
+				norm_sum += norm;
+
+				if (norm > FLT_EPSILON) {
+					++num_non_zero_thrust;
+				}
+			}
+
+			if (num_non_zero_thrust > 0) {
+				_control_allocation_scale(axis) = norm_sum / num_non_zero_thrust;
+
+			} else {
+				_control_allocation_scale(axis) = _control_allocation_scale(THRUST_Z);
+			}
+		}
+	}
+
+	for (int axis = 0; axis < NUM_AXES; axis++) {
+		if (_control_allocation_scale(axis) < FLT_EPSILON) {
+			_control_allocation_scale(axis) = 1.f;
+		}
+
+		for (int i = 0; i < NUM_ACTUATORS; i++) {
+			_mix(i, axis) /= _control_allocation_scale(axis);
+		}
+	}
+
+	// the allocated control is computed with the effectiveness matrix, which needs the same scaling
+	for (int axis = 0; axis < NUM_AXES; axis++) {
+		for (int i = 0; i < NUM_ACTUATORS; i++) {
+			_effectiveness(axis, i) *= _control_allocation_scale(axis);
+		}
+
+		_control_trim(axis) *= _control_allocation_scale(axis);
+	}
+}
+
+void
+ControlAllocationPseudoInverse::allocate()
+{
+	// Allocate
+	_actuator_sp = _actuator_trim + _mix * (_control_sp - _control_trim);
+}
@@ -0,0 +1,89 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file ControlAllocationPseudoInverse.hpp
+ *
+ * Simple Control Allocation Algorithm
+ *
+ * The pseudo-inverse of the effectiveness matrix is computed when the effectiveness
+ * matrix is set, each allocation is then a single matrix-vector product.
+ */
+
+#pragma once
+
+#include "ControlAllocation.hpp"
+
+class ControlAllocationPseudoInverse: public ControlAllocation
+{
+public:
+	ControlAllocationPseudoInverse() = default;
+	virtual ~ControlAllocationPseudoInverse() = default;
+
+	void allocate() override;
+
+	void setEffectivenessMatrix(const matrix::Matrix<float, NUM_AXES, NUM_ACTUATORS> &effectiveness,
+				    const ActuatorVector &actuator_trim, int num_actuators) override;
+
+	/**
+	 * Scale the columns of the mix matrix the same way as the normalized multirotor
+	 * mixers (see px_generate_mixers.py), so that the controller tuning stays valid.
+	 * Takes effect with the next call to setEffectivenessMatrix().
+	 */
+	void setNormalizeRPY(bool normalize_rpy) { _normalize_rpy = normalize_rpy; }
+
+	/**
+	 * @return the (normalized) pseudo-inverse of the effectiveness matrix
+	 */
+	const matrix::Matrix<float, NUM_ACTUATORS, NUM_AXES> &getMix() const { return _mix; }
+
+	/**
+	 * @return number of times the pseudo-inverse was computed
+	 */
+	unsigned mixUpdates() const { return _mix_updates; }
+
+protected:
+	matrix::Matrix<float, NUM_ACTUATORS, NUM_AXES> _mix;
+
+	/**
+	 * Compute the control setpoint scaling of the mix matrix and apply it.
+	 */
+	void normalizeControlAllocationMatrix();
+
+	matrix::Vector<float, NUM_AXES> _control_allocation_scale;
+
+private:
+	bool _normalize_rpy{false};
+	unsigned _mix_updates{0};
+};
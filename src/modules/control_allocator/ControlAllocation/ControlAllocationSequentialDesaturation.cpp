@@ -0,0 +1,224 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file ControlAllocationSequentialDesaturation.cpp
+ *
+ * Control Allocation Algorithm which sequentially modifies control demands in order to
+ * eliminate the saturation of the actuator setpoint vector.
+ */
+
+#include "ControlAllocationSequentialDesaturation.hpp"
+
+#include <float.h>
+#include <math.h>
+
+void
+ControlAllocationSequentialDesaturation::allocate()
+{
+	switch (_airmode) {
+	case Airmode::roll_pitch:
+		mixAirmodeRP();
+		break;
+
+	case Airmode::roll_pitch_yaw:
+		mixAirmodeRPY();
+		break;
+
+	case Airmode::disabled:
+	default: // just in case: default to disabled
+		mixAirmodeDisabled();
+		break;
+	}
+}
+
+void
+ControlAllocationSequentialDesaturation::mixAxes(bool roll_pitch, bool yaw, bool thrust)
+{
+	const matrix::Vector<float, NUM_AXES> control = _control_sp - _control_trim;
+
+	for (int i = 0; i < _num_actuators; i++) {
+		float actuator_sp = _actuator_trim(i);
+
+		if (roll_pitch) {
+			actuator_sp += _mix(i, ROLL) * control(ROLL) + _mix(i, PITCH) * control(PITCH);
+		}
+
+		if (yaw) {
+			actuator_sp += _mix(i, YAW) * control(YAW);
+		}
+
+		if (thrust) {
+			actuator_sp += _mix(i, THRUST_X) * control(THRUST_X)
+				       + _mix(i, THRUST_Y) * control(THRUST_Y)
+				       + _mix(i, THRUST_Z) * control(THRUST_Z);
+		}
+
+		_actuator_sp(i) = actuator_sp;
+	}
+
+	for (int i = _num_actuators; i < NUM_ACTUATORS; i++) {
+		_actuator_sp(i) = 0.f;
+	}
+}
+
+void
+ControlAllocationSequentialDesaturation::desaturateActuators(ActuatorVector &actuator_sp, ControlAxis axis,
+		bool increase_only, float max_output_extension)
+{
+	float gain = computeDesaturationGain(actuator_sp, axis, max_output_extension);
+
+	if (increase_only && gain < 0.f) {
+		return;
+	}
+
+	for (int i = 0; i < _num_actuators; i++) {
+		actuator_sp(i) += gain * _mix(i, axis);
+	}
+
+	// Compute the desaturation gain again based on the updated outputs.
+	// In most cases it will be zero. It won't be if max(outputs) - min(outputs) > max_output - min_output.
+	// In that case adding 0.5 of the gain will equilibrate saturations.
+	gain = 0.5f * computeDesaturationGain(actuator_sp, axis, max_output_extension);
+
+	for (int i = 0; i < _num_actuators; i++) {
+		actuator_sp(i) += gain * _mix(i, axis);
+	}
+}
+
+float
+ControlAllocationSequentialDesaturation::computeDesaturationGain(const ActuatorVector &actuator_sp, ControlAxis axis,
+		float max_output_extension) const
+{
+	float k_min = 0.f;
+	float k_max = 0.f;
+
+	for (int i = 0; i < _num_actuators; i++) {
+		const float desaturation = _mix(i, axis);
+
+		// Avoid division by zero. If desaturation_vector(i) is zero, there's nothing we can do to unsaturate anyway
+		if (fabsf(desaturation) < FLT_EPSILON) {
+			continue;
+		}
+
+		const float actuator_max = _actuator_max(i) + max_output_extension * (_actuator_max(i) - _actuator_min(i));
+
+		if (actuator_sp(i) < _actuator_min(i)) {
+			float k = (_actuator_min(i) - actuator_sp(i)) / desaturation;
+
+			if (k < k_min) { k_min = k; }
+
+			if (k > k_max) { k_max = k; }
+		}
+
+		if (actuator_sp(i) > actuator_max) {
+			float k = (actuator_max - actuator_sp(i)) / desaturation;
+
+			if (k < k_min) { k_min = k; }
+
+			if (k > k_max) { k_max = k; }
+		}
+	}
+
+	// Reduce the saturation as much as possible
+	return k_min + k_max;
+}
+
+void
+ControlAllocationSequentialDesaturation::mixAirmodeRP()
+{
+	// Airmode for roll and pitch, but not yaw
+
+	// Mix without yaw
+	mixAxes(true, false, true);
+
+	// Thrust will be used to unsaturate if needed
+	desaturateActuators(_actuator_sp, THRUST_Z);
+
+	// Mix yaw independently
+	mixYaw();
+}
+
+void
+ControlAllocationSequentialDesaturation::mixAirmodeRPY()
+{
+	// Airmode for roll, pitch and yaw
+
+	// Do full mixing
+	mixAxes(true, true, true);
+
+	// Thrust will be used to unsaturate if needed
+	desaturateActuators(_actuator_sp, THRUST_Z);
+
+	// Unsaturate yaw (in case upper and lower bounds are exceeded)
+	// to prioritize roll/pitch over yaw.
+	desaturateActuators(_actuator_sp, YAW);
+}
+
+void
+ControlAllocationSequentialDesaturation::mixAirmodeDisabled()
+{
+	// Airmode disabled: never allow to increase the thrust to unsaturate a motor
+
+	// Mix without yaw
+	mixAxes(true, false, true);
+
+	// only reduce thrust (the thrust column points along -z)
+	desaturateActuators(_actuator_sp, THRUST_Z, true);
+
+	// Reduce roll/pitch acceleration if needed to unsaturate
+	desaturateActuators(_actuator_sp, ROLL);
+	desaturateActuators(_actuator_sp, PITCH);
+
+	// Mix yaw independently
+	mixYaw();
+}
+
+void
+ControlAllocationSequentialDesaturation::mixYaw()
+{
+	// Add yaw to outputs
+	const float yaw = _control_sp(YAW) - _control_trim(YAW);
+
+	for (int i = 0; i < _num_actuators; i++) {
+		_actuator_sp(i) += _mix(i, YAW) * yaw;
+	}
+
+	// Change yaw acceleration to unsaturate the outputs if needed (do not change roll/pitch),
+	// and allow some yaw response at maximum thrust
+	desaturateActuators(_actuator_sp, YAW, false, 0.15f);
+
+	// reduce thrust only (the thrust column points along -z)
+	desaturateActuators(_actuator_sp, THRUST_Z, true);
+}
@@ -0,0 +1,233 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file ControlAllocationTest.cpp
+ *
+ * Tests for Control Allocation Algorithms
+ */
+
+#include <gtest/gtest.h>
+#include <ControlAllocationPseudoInverse.hpp>
+#include <ControlAllocationSequentialDesaturation.hpp>
+
+using namespace matrix;
+
+namespace
+{
+
+typedef Matrix<float, ControlAllocation::NUM_AXES, ControlAllocation::NUM_ACTUATORS> EffectivenessMatrix;
+
+// Quadrotor in X configuration, rotors ordered front right, rear left, front left, rear right
+EffectivenessMatrix quadXEffectiveness()
+{
+	static constexpr float arm = 0.707107f;
+	static constexpr float km = 0.05f;
+	static constexpr float rotor[4][3] = {
+		{ arm,  arm,  1.f},
+		{-arm, -arm,  1.f},
+		{ arm, -arm, -1.f},
+		{-arm,  arm, -1.f},
+	};
+
+	EffectivenessMatrix effectiveness;
+
+	for (int i = 0; i < 4; i++) {
+		effectiveness(ControlAllocation::ROLL, i) = -rotor[i][1];
+		effectiveness(ControlAllocation::PITCH, i) = rotor[i][0];
+		effectiveness(ControlAllocation::YAW, i) = km * rotor[i][2];
+		effectiveness(ControlAllocation::THRUST_Z, i) = -1.f;
+	}
+
+	return effectiveness;
+}
+
+void setupMotors(ControlAllocation &allocation)
+{
+	ControlAllocation::ActuatorVector actuator_max;
+
+	for (int i = 0; i < 4; i++) {
+		actuator_max(i) = 1.f;
+	}
+
+	allocation.setEffectivenessMatrix(quadXEffectiveness(), ControlAllocation::ActuatorVector(), 4);
+	allocation.setActuatorMin(ControlAllocation::ActuatorVector());
+	allocation.setActuatorMax(actuator_max);
+}
+
+} // namespace
+
+TEST(ControlAllocationTest, AllZeroCase)
+{
+	ControlAllocationPseudoInverse method;
+
+	method.allocate();
+
+	const ControlAllocation::ActuatorVector actuator_sp = method.getActuatorSetpoint();
+	const ControlAllocation::ActuatorVector zero;
+	EXPECT_EQ(actuator_sp, zero);
+}
+
+TEST(ControlAllocationTest, PseudoInverseAllocatesAchievableSetpoint)
+{
+	ControlAllocationPseudoInverse method;
+	setupMotors(method);
+	EXPECT_EQ(method.mixUpdates(), 1u);
+
+	Vector<float, ControlAllocation::NUM_AXES> control_sp;
+	control_sp(ControlAllocation::ROLL) = 0.1f;
+	control_sp(ControlAllocation::PITCH) = -0.05f;
+	control_sp(ControlAllocation::YAW) = 0.01f;
+	control_sp(ControlAllocation::THRUST_Z) = -2.f;
+
+	method.setControlSetpoint(control_sp);
+	method.allocate();
+
+	const Vector<float, ControlAllocation::NUM_AXES> allocated = method.getAllocatedControl();
+
+	for (int i = 0; i < ControlAllocation::NUM_AXES; i++) {
+		EXPECT_NEAR(allocated(i), control_sp(i), 1e-5f) << "axis " << i;
+	}
+
+	// unused actuators are left at zero
+	for (int i = 4; i < ControlAllocation::NUM_ACTUATORS; i++) {
+		EXPECT_FLOAT_EQ(method.getActuatorSetpoint()(i), 0.f);
+	}
+}
+
+TEST(ControlAllocationTest, PseudoInverseNormalizedHover)
+{
+	ControlAllocationPseudoInverse method;
+	method.setNormalizeRPY(true);
+	setupMotors(method);
+
+	// with a normalized mix, full collective thrust maps to full throttle on each rotor
+	Vector<float, ControlAllocation::NUM_AXES> control_sp;
+	control_sp(ControlAllocation::THRUST_Z) = -1.f;
+	method.setControlSetpoint(control_sp);
+	method.allocate();
+
+	for (int i = 0; i < 4; i++) {
+		EXPECT_NEAR(method.getActuatorSetpoint()(i), 1.f, 1e-5f);
+	}
+}
+
+TEST(ControlAllocationTest, SequentialDesaturationStaysInRange)
+{
+	ControlAllocationSequentialDesaturation method;
+	method.setNormalizeRPY(true);
+	setupMotors(method);
+
+	const ControlAllocationSequentialDesaturation::Airmode modes[] = {
+		ControlAllocationSequentialDesaturation::Airmode::disabled,
+		ControlAllocationSequentialDesaturation::Airmode::roll_pitch,
+		ControlAllocationSequentialDesaturation::Airmode::roll_pitch_yaw,
+	};
+
+	for (const auto mode : modes) {
+		method.setAirmode(mode);
+
+		for (float thrust = 0.f; thrust <= 1.f; thrust += 0.25f) {
+			Vector<float, ControlAllocation::NUM_AXES> control_sp;
+			control_sp(ControlAllocation::ROLL) = 0.2f;
+			control_sp(ControlAllocation::PITCH) = -0.1f;
+			control_sp(ControlAllocation::YAW) = 0.3f;
+			control_sp(ControlAllocation::THRUST_Z) = -thrust;
+
+			method.setControlSetpoint(control_sp);
+			method.allocate();
+
+			for (int i = 0; i < 4; i++) {
+				const float actuator_sp = method.getActuatorSetpoint()(i);
+				EXPECT_GE(actuator_sp, -1e-4f) << "thrust " << thrust;
+				// yaw is allowed to extend the upper bound by 15% (clipped afterwards)
+				EXPECT_LE(actuator_sp, 1.15f + 1e-4f) << "thrust " << thrust;
+			}
+
+			if (mode != ControlAllocationSequentialDesaturation::Airmode::disabled) {
+				// airmode keeps the demanded roll and pitch by shifting the collective thrust
+				const Vector<float, ControlAllocation::NUM_AXES> allocated = method.getAllocatedControl();
+				EXPECT_NEAR(allocated(ControlAllocation::ROLL), control_sp(ControlAllocation::ROLL), 1e-4f);
+				EXPECT_NEAR(allocated(ControlAllocation::PITCH), control_sp(ControlAllocation::PITCH), 1e-4f);
+			}
+		}
+	}
+}
+
+TEST(ControlAllocationTest, MotorGating)
+{
+	// 4 motors followed by 2 control surfaces, as normalized setpoints
+	ControlAllocation::ActuatorVector actuator_sp;
+
+	for (int i = 0; i < 6; i++) {
+		actuator_sp(i) = 0.1f * i;
+	}
+
+	ControlAllocation::ActuatorVector gated = actuator_sp;
+	ControlAllocation::gateMotors(gated, 4, ControlAllocation::MotorGate::NONE);
+
+	for (int i = 0; i < 6; i++) {
+		EXPECT_FLOAT_EQ(gated(i), actuator_sp(i));
+	}
+
+	// spin-up: motors held at idle, surfaces still follow the allocation
+	gated = actuator_sp;
+	ControlAllocation::gateMotors(gated, 4, ControlAllocation::MotorGate::IDLE);
+
+	for (int i = 0; i < 4; i++) {
+		EXPECT_FLOAT_EQ(gated(i), -1.f);
+	}
+
+	EXPECT_FLOAT_EQ(gated(4), actuator_sp(4));
+	EXPECT_FLOAT_EQ(gated(5), actuator_sp(5));
+
+	// disarmed/prearmed: motors invalid so the outputs use their disarmed value, surfaces still move
+	gated = actuator_sp;
+	ControlAllocation::gateMotors(gated, 4, ControlAllocation::MotorGate::DISARMED);
+
+	for (int i = 0; i < 4; i++) {
+		EXPECT_TRUE(std::isnan(gated(i)));
+	}
+
+	EXPECT_FLOAT_EQ(gated(4), actuator_sp(4));
+	EXPECT_FLOAT_EQ(gated(5), actuator_sp(5));
+
+	// the motor count is bounded by the vector size
+	gated = actuator_sp;
+	ControlAllocation::gateMotors(gated, 100, ControlAllocation::MotorGate::IDLE);
+
+	for (int i = 0; i < ControlAllocation::NUM_ACTUATORS; i++) {
+		EXPECT_FLOAT_EQ(gated(i), -1.f);
+	}
+}
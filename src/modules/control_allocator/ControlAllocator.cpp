@@ -0,0 +1,561 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file ControlAllocator.cpp
+ *
+ * Control allocator.
+ */
+
+#include "ControlAllocator.hpp"
+
+#include <drivers/drv_hrt.h>
+
+#include <float.h>
+
+using namespace matrix;
+using namespace time_literals;
+
+ControlAllocator::ControlAllocator() :
+	ModuleParams(nullptr),
+	WorkItem(MODULE_NAME, px4::wq_configurations::rate_ctrl),
+	_loop_perf(perf_alloc(PC_ELAPSED, MODULE_NAME": cycle")),
+	_effectiveness_update_perf(perf_alloc(PC_ELAPSED, MODULE_NAME": effectiveness update"))
+{
+	parameters_updated();
+}
+
+ControlAllocator::~ControlAllocator()
+{
+	delete _control_allocation;
+	delete _actuator_effectiveness;
+
+	perf_free(_loop_perf);
+	perf_free(_effectiveness_update_perf);
+}
+
+bool
+ControlAllocator::init()
+{
+	if (!_vehicle_torque_setpoint_sub.registerCallback()) {
+		PX4_ERR("vehicle_torque_setpoint callback registration failed!");
+		return false;
+	}
+
+	return true;
+}
+
+void
+ControlAllocator::parameters_updated()
+{
+	// Allocation method & effectiveness source
+	// Do this first: in case a new method is loaded, it will be configured below
+	update_effectiveness_source();
+	update_allocation_method();
+
+	if (_control_allocation == nullptr) {
+		return;
+	}
+
+	if (_allocation_method_id == AllocationMethod::SEQUENTIAL_DESATURATION) {
+		static_cast<ControlAllocationSequentialDesaturation *>(_control_allocation)->setAirmode(
+			static_cast<ControlAllocationSequentialDesaturation::Airmode>(_param_mc_airmode.get()));
+	}
+
+	// the effectiveness source parameters might have changed
+	update_effectiveness_matrix_if_needed();
+}
+
+void
+ControlAllocator::update_allocation_method()
+{
+	const AllocationMethod method = static_cast<AllocationMethod>(_param_ca_method.get());
+
+	if (_allocation_method_id != method || _control_allocation == nullptr) {
+
+		// Save current state
+		ControlAllocation::ActuatorVector actuator_sp;
+
+		if (_control_allocation != nullptr) {
+			actuator_sp = _control_allocation->getActuatorSetpoint();
+		}
+
+		// try to instanciate new allocation method
+		ControlAllocationPseudoInverse *tmp = nullptr;
+
+		switch (method) {
+		case AllocationMethod::PSEUDO_INVERSE:
+			tmp = new ControlAllocationPseudoInverse();
+			break;
+
+		case AllocationMethod::SEQUENTIAL_DESATURATION:
+			tmp = new ControlAllocationSequentialDesaturation();
+			break;
+
+		default:
+			PX4_ERR("Unknown allocation method");
+			break;
+		}
+
+		// Replace previous method with new one
+		if (tmp == nullptr) {
+			// It did not work, forget about it
+			PX4_ERR("Control allocation init failed");
+			_param_ca_method.set(static_cast<int>(_allocation_method_id));
+
+		} else {
+			// Swap allocation methods
+			delete _control_allocation;
+			_control_allocation = tmp;
+
+			// Save method id
+			_allocation_method_id = method;
+
+			// the control allocation matrix is normalized like the geometry based mixers,
+			// so the rate controller tuning remains valid
+			tmp->setNormalizeRPY(true);
+
+			// Configure new allocation method, this computes the pseudo-inverse
+			update_effectiveness_matrix_if_needed(true);
+
+			// Restore state
+			_control_allocation->setActuatorSetpoint(actuator_sp);
+		}
+	}
+}
+
+void
+ControlAllocator::update_effectiveness_source()
+{
+	const EffectivenessSource source = static_cast<EffectivenessSource>(_param_ca_airframe.get());
+
+	if (_actuator_effectiveness != nullptr) {
+		// the effectiveness source registers its parameters with this module, it can't be swapped at runtime
+		if (_effectiveness_source_id != source) {
+			PX4_WARN("CA_AIRFRAME change requires a reboot");
+		}
+
+		return;
+	}
+
+	switch (source) {
+	case EffectivenessSource::MULTIROTOR:
+		_actuator_effectiveness = new ActuatorEffectivenessMultirotor(this);
+		break;
+
+	case EffectivenessSource::STANDARD_VTOL:
+		_actuator_effectiveness = new ActuatorEffectivenessStandardVTOL(this);
+		break;
+
+	default:
+		PX4_ERR("Unknown airframe");
+		break;
+	}
+
+	if (_actuator_effectiveness == nullptr) {
+		PX4_ERR("Actuator effectiveness init failed");
+		return;
+	}
+
+	_effectiveness_source_id = source;
+
+	update_effectiveness_matrix_if_needed(true);
+}
+
+void
+ControlAllocator::update_effectiveness_matrix_if_needed(bool force)
+{
+	if (_control_allocation == nullptr || _actuator_effectiveness == nullptr) {
+		return;
+	}
+
+	matrix::Matrix<float, NUM_AXES, NUM_ACTUATORS> effectiveness;
+
+	if (_actuator_effectiveness->getEffectivenessMatrix(effectiveness, force)) {
+		perf_begin(_effectiveness_update_perf);
+
+		const int num_actuators = _actuator_effectiveness->numActuators();
+		const int num_motors = _actuator_effectiveness->numMotors();
+
+		// Motors have the range [0, 1], servos [-1, 1]
+		ControlAllocation::ActuatorVector actuator_min;
+		ControlAllocation::ActuatorVector actuator_max;
+
+		for (int i = 0; i < num_actuators && i < NUM_ACTUATORS; i++) {
+			actuator_min(i) = (i < num_motors) ? 0.f : -1.f;
+			actuator_max(i) = 1.f;
+		}
+
+		_control_allocation->setActuatorMin(actuator_min);
+		_control_allocation->setActuatorMax(actuator_max);
+
+		// Assume actuator trim is zero (motors stopped, surfaces centered)
+		_control_allocation->setEffectivenessMatrix(effectiveness, ControlAllocation::ActuatorVector(), num_actuators);
+
+		_effectiveness_updates++;
+
+		perf_end(_effectiveness_update_perf);
+	}
+}
+
+void
+ControlAllocator::Run()
+{
+	if (should_exit()) {
+		_vehicle_torque_setpoint_sub.unregisterCallback();
+		exit_and_cleanup();
+		return;
+	}
+
+	perf_begin(_loop_perf);
+
+	// Check if parameters have changed
+	if (_parameter_update_sub.updated()) {
+		// clear update
+		parameter_update_s param_update;
+		_parameter_update_sub.copy(&param_update);
+
+		updateParams();
+		parameters_updated();
+	}
+
+	if (_control_allocation == nullptr || _actuator_effectiveness == nullptr) {
+		perf_end(_loop_perf);
+		return;
+	}
+
+	actuator_armed_s armed;
+
+	if (_actuator_armed_sub.update(&armed)) {
+		const bool armed_changed = (armed.armed != _armed.armed) || (armed.prearmed != _armed.prearmed)
+					   || (armed.in_esc_calibration_mode != _armed.in_esc_calibration_mode);
+
+		if (armed.armed && !_armed.armed) {
+			_time_armed = hrt_absolute_time();
+		}
+
+		_armed = armed;
+
+		// republish with the new gating, the torque setpoint is not guaranteed to update
+		if (armed_changed) {
+			publish_actuator_controls();
+		}
+	}
+
+	vehicle_status_s vehicle_status;
+
+	if (_vehicle_status_sub.update(&vehicle_status)) {
+
+		ActuatorEffectiveness::FlightPhase flight_phase{ActuatorEffectiveness::FlightPhase::HOVER_FLIGHT};
+
+		// Check if the current flight phase is HOVER or FIXED_WING
+		if (vehicle_status.vehicle_type == vehicle_status_s::VEHICLE_TYPE_ROTARY_WING) {
+			flight_phase = ActuatorEffectiveness::FlightPhase::HOVER_FLIGHT;
+
+		} else {
+			flight_phase = ActuatorEffectiveness::FlightPhase::FORWARD_FLIGHT;
+		}
+
+		// Special cases for VTOL in transition
+		if (vehicle_status.is_vtol && vehicle_status.in_transition_mode) {
+			if (vehicle_status.in_transition_to_fw) {
+				flight_phase = ActuatorEffectiveness::FlightPhase::TRANSITION_HF_TO_FF;
+
+			} else {
+				flight_phase = ActuatorEffectiveness::FlightPhase::TRANSITION_FF_TO_HF;
+			}
+		}
+
+		// Forward to effectiveness source, the matrix is only recomputed on a phase change
+		_actuator_effectiveness->setFlightPhase(flight_phase);
+		update_effectiveness_matrix_if_needed();
+	}
+
+	vehicle_torque_setpoint_s vehicle_torque_setpoint;
+
+	if (_vehicle_torque_setpoint_sub.update(&vehicle_torque_setpoint)) {
+		_torque_sp = matrix::Vector3f(vehicle_torque_setpoint.xyz);
+		_timestamp_sample = vehicle_torque_setpoint.timestamp_sample;
+
+		vehicle_thrust_setpoint_s vehicle_thrust_setpoint;
+
+		if (_vehicle_thrust_setpoint_sub.update(&vehicle_thrust_setpoint)) {
+			_thrust_sp = matrix::Vector3f(vehicle_thrust_setpoint.xyz);
+		}
+
+		// Set control setpoint vector
+		matrix::Vector<float, NUM_AXES> c;
+		c(0) = _torque_sp(0);
+		c(1) = _torque_sp(1);
+		c(2) = _torque_sp(2);
+		c(3) = _thrust_sp(0);
+		c(4) = _thrust_sp(1);
+		c(5) = _thrust_sp(2);
+		_control_allocation->setControlSetpoint(c);
+
+		// Do allocation: a single matrix-vector product with the precomputed pseudo-inverse,
+		// followed by the (bounded) desaturation of the selected method
+		_control_allocation->allocate();
+		_control_allocation->clipActuatorSetpoint();
+
+		// Publish actuator setpoint and allocator status
+		publish_actuator_controls();
+
+		const hrt_abstime now = hrt_absolute_time();
+
+		if (now - _last_status_pub >= 20_ms) {
+			publish_control_allocator_status();
+			_last_status_pub = now;
+		}
+	}
+
+	perf_end(_loop_perf);
+}
+
+void
+ControlAllocator::publish_control_allocator_status()
+{
+	control_allocator_status_s control_allocator_status{};
+
+	// Allocated control
+	const matrix::Vector<float, NUM_AXES> allocated_control = _control_allocation->getAllocatedControl();
+	control_allocator_status.allocated_torque[0] = allocated_control(0);
+	control_allocator_status.allocated_torque[1] = allocated_control(1);
+	control_allocator_status.allocated_torque[2] = allocated_control(2);
+	control_allocator_status.allocated_thrust[0] = allocated_control(3);
+	control_allocator_status.allocated_thrust[1] = allocated_control(4);
+	control_allocator_status.allocated_thrust[2] = allocated_control(5);
+
+	// Unallocated control
+	const matrix::Vector<float, NUM_AXES> unallocated_control = _control_allocation->getControlSetpoint() - allocated_control;
+	control_allocator_status.unallocated_torque[0] = unallocated_control(0);
+	control_allocator_status.unallocated_torque[1] = unallocated_control(1);
+	control_allocator_status.unallocated_torque[2] = unallocated_control(2);
+	control_allocator_status.unallocated_thrust[0] = unallocated_control(3);
+	control_allocator_status.unallocated_thrust[1] = unallocated_control(4);
+	control_allocator_status.unallocated_thrust[2] = unallocated_control(5);
+
+	// Allocation success flags
+	control_allocator_status.torque_setpoint_achieved = (Vector3f(unallocated_control(0), unallocated_control(1),
+			unallocated_control(2)).norm_squared() < 1e-6f);
+	control_allocator_status.thrust_setpoint_achieved = (Vector3f(unallocated_control(3), unallocated_control(4),
+			unallocated_control(5)).norm_squared() < 1e-6f);
+
+	// Actuator saturation
+	const ControlAllocation::ActuatorVector &actuator_sp = _control_allocation->getActuatorSetpoint();
+	const ControlAllocation::ActuatorVector &actuator_min = _control_allocation->getActuatorMin();
+	const ControlAllocation::ActuatorVector &actuator_max = _control_allocation->getActuatorMax();
+
+	for (int i = 0; i < _control_allocation->numActuators(); i++) {
+		if (actuator_sp(i) > (actuator_max(i) - FLT_EPSILON)) {
+			control_allocator_status.actuator_saturation[i] = control_allocator_status_s::ACTUATOR_SATURATION_UPPER;
+
+		} else if (actuator_sp(i) < (actuator_min(i) + FLT_EPSILON)) {
+			control_allocator_status.actuator_saturation[i] = control_allocator_status_s::ACTUATOR_SATURATION_LOWER;
+		}
+	}
+
+	control_allocator_status.allocation_method = static_cast<uint8_t>(_allocation_method_id);
+	control_allocator_status.effectiveness_updates = _effectiveness_updates;
+
+	control_allocator_status.timestamp = hrt_absolute_time();
+	_control_allocator_status_pub.publish(control_allocator_status);
+}
+
+void
+ControlAllocator::publish_actuator_controls()
+{
+	actuator_controls_s actuator_controls_4{};
+	actuator_controls_s actuator_controls_5{};
+	actuator_controls_4.timestamp_sample = _timestamp_sample;
+	actuator_controls_5.timestamp_sample = _timestamp_sample;
+
+	// Actuator setpoints are mapped from [min, max] to [-1, 1] for the mixers
+	ControlAllocation::ActuatorVector actuator_sp_normalized = _control_allocation->normalizeActuatorSetpoint(
+				_control_allocation->getActuatorSetpoint());
+
+	for (int i = 0; i < ControlAllocation::NUM_ACTUATORS; i++) {
+		if (!PX4_ISFINITE(actuator_sp_normalized(i))) {
+			actuator_sp_normalized(i) = 0.f;
+		}
+	}
+
+	// The allocated groups are passed through to the outputs, so the mixer module cannot tell the motors
+	// apart and its throttle handling does not apply: keep the motors off while not armed (prearmed included,
+	// the outputs are already enabled then) and at idle during the spin-up ramp after arming.
+	ControlAllocation::MotorGate motor_gate = ControlAllocation::MotorGate::NONE;
+
+	if (!_armed.in_esc_calibration_mode) {
+		if (!_armed.armed) {
+			motor_gate = ControlAllocation::MotorGate::DISARMED;
+
+		} else if (hrt_elapsed_time(&_time_armed) < RAMP_TIME_US) {
+			motor_gate = ControlAllocation::MotorGate::IDLE;
+		}
+	}
+
+	ControlAllocation::gateMotors(actuator_sp_normalized, _actuator_effectiveness->numMotors(), motor_gate);
+
+	for (int i = 0; i < 8; i++) {
+		actuator_controls_4.control[i] = actuator_sp_normalized(i);
+		actuator_controls_5.control[i] = actuator_sp_normalized(i + 8);
+	}
+
+	actuator_controls_4.timestamp = hrt_absolute_time();
+	_actuator_controls_4_pub.publish(actuator_controls_4);
+
+	if (_control_allocation->numActuators() > 8) {
+		actuator_controls_5.timestamp = hrt_absolute_time();
+		_actuator_controls_5_pub.publish(actuator_controls_5);
+	}
+}
+
+int ControlAllocator::task_spawn(int argc, char *argv[])
+{
+	ControlAllocator *instance = new ControlAllocator();
+
+	if (instance) {
+		_object.store(instance);
+		_task_id = task_id_is_work_queue;
+
+		if (instance->init()) {
+			return PX4_OK;
+		}
+
+	} else {
+		PX4_ERR("alloc failed");
+	}
+
+	delete instance;
+	_object.store(nullptr);
+	_task_id = -1;
+
+	return PX4_ERROR;
+}
+
+int ControlAllocator::print_status()
+{
+	PX4_INFO("Running");
+
+	// Print current allocation method
+	switch (_allocation_method_id) {
+	case AllocationMethod::NONE:
+		PX4_INFO("Method: None");
+		break;
+
+	case AllocationMethod::PSEUDO_INVERSE:
+		PX4_INFO("Method: Pseudo-inverse");
+		break;
+
+	case AllocationMethod::SEQUENTIAL_DESATURATION:
+		PX4_INFO("Method: Sequential desaturation");
+		break;
+	}
+
+	// Print current airframe
+	switch (_effectiveness_source_id) {
+	case EffectivenessSource::NONE:
+		PX4_INFO("EffectivenessSource: None");
+		break;
+
+	case EffectivenessSource::MULTIROTOR:
+		PX4_INFO("EffectivenessSource: MC parameters");
+		break;
+
+	case EffectivenessSource::STANDARD_VTOL:
+		PX4_INFO("EffectivenessSource: Standard VTOL");
+		break;
+	}
+
+	// Print current effectiveness matrix
+	if (_control_allocation != nullptr) {
+		PX4_INFO("Actuators: %d, effectiveness updates: %u", _control_allocation->numActuators(),
+			 (unsigned)_effectiveness_updates);
+		PX4_INFO("Effectiveness.T =");
+		_control_allocation->getEffectivenessMatrix().T().print();
+		PX4_INFO("Actuator min =");
+		_control_allocation->getActuatorMin().print();
+		PX4_INFO("Actuator max =");
+		_control_allocation->getActuatorMax().print();
+	}
+
+	// Print perf
+	perf_print_counter(_loop_perf);
+	perf_print_counter(_effectiveness_update_perf);
+
+	return 0;
+}
+
+int ControlAllocator::custom_command(int argc, char *argv[])
+{
+	return print_usage("unknown command");
+}
+
+int ControlAllocator::print_usage(const char *reason)
+{
+	if (reason) {
+		PX4_WARN("%s\n", reason);
+	}
+
+	PRINT_MODULE_DESCRIPTION(
+		R"DESCR_STR(
+### Description
+This implements control allocation. It takes torque and thrust setpoints
+as inputs and outputs actuator setpoint messages.
+
+The control effectiveness matrix is built from the vehicle geometry (`CA_AIRFRAME`,
+`CA_MC_R*` parameters) and its pseudo-inverse is only recomputed when the parameters
+or the VTOL flight phase change. Each cycle is then a single matrix-vector product,
+optionally followed by a bounded number of desaturation passes (`CA_METHOD`).
+
+The actuator setpoints are published on `actuator_controls_4` and `actuator_controls_5`,
+use the `control_allocation` mixer to pass them through to the outputs.
+)DESCR_STR");
+
+	PRINT_MODULE_USAGE_NAME("control_allocator", "controller");
+	PRINT_MODULE_USAGE_COMMAND("start");
+	PRINT_MODULE_USAGE_DEFAULT_COMMANDS();
+
+	return 0;
+}
+
+/**
+ * Control Allocator app start / stop handling function
+ */
+extern "C" __EXPORT int control_allocator_main(int argc, char *argv[]);
+
+int control_allocator_main(int argc, char *argv[])
+{
+	return ControlAllocator::main(argc, argv);
+}
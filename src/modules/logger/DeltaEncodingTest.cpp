@@ -0,0 +1,152 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file DeltaEncodingTest.cpp
+ * Tests for the ULog DATA_DELTA encoding.
+ */
+
+#include <gtest/gtest.h>
+
+#include "delta_encoding.h"
+
+using namespace px4::logger;
+
+static constexpr size_t SAMPLE_SIZE = 64;
+
+class DeltaEncodingTest : public ::testing::Test
+{
+public:
+	void SetUp() override
+	{
+		for (size_t i = 0; i < SAMPLE_SIZE; ++i) {
+			_prev[i] = (uint8_t)(i * 7);
+			_cur[i] = _prev[i];
+		}
+	}
+
+	void roundtrip(int expected_len)
+	{
+		const int len = delta::encode(_prev, _cur, SAMPLE_SIZE, _encoded, SAMPLE_SIZE);
+		EXPECT_EQ(len, expected_len);
+
+		if (len >= 0) {
+			uint8_t decoded[SAMPLE_SIZE];
+			memcpy(decoded, _prev, SAMPLE_SIZE);
+			EXPECT_TRUE(delta::apply(decoded, SAMPLE_SIZE, _encoded, len));
+			EXPECT_EQ(memcmp(decoded, _cur, SAMPLE_SIZE), 0);
+		}
+	}
+
+	uint8_t _prev[SAMPLE_SIZE];
+	uint8_t _cur[SAMPLE_SIZE];
+	uint8_t _encoded[SAMPLE_SIZE];
+};
+
+TEST_F(DeltaEncodingTest, Unchanged)
+{
+	roundtrip(0);
+}
+
+TEST_F(DeltaEncodingTest, SingleByte)
+{
+	_cur[10] ^= 0xff;
+	roundtrip(delta::RUN_HEADER_LEN + 1);
+}
+
+TEST_F(DeltaEncodingTest, TimestampChange)
+{
+	// typical case: only the lower bytes of the timestamp change
+	_cur[0] += 1;
+	_cur[1] += 1;
+	_cur[SAMPLE_SIZE - 1] += 1;
+	roundtrip(2 * delta::RUN_HEADER_LEN + 3);
+}
+
+TEST_F(DeltaEncodingTest, ShortGapsAreMerged)
+{
+	_cur[20] += 1;
+	_cur[23] += 1; // 2 unchanged bytes in between: cheaper to send them than a new run header
+	roundtrip(delta::RUN_HEADER_LEN + 4);
+}
+
+TEST_F(DeltaEncodingTest, LongGapsAreSplit)
+{
+	_cur[20] += 1;
+	_cur[30] += 1;
+	roundtrip(2 * (delta::RUN_HEADER_LEN + 1));
+}
+
+TEST_F(DeltaEncodingTest, NotSmallerThanKeyframe)
+{
+	for (size_t i = 0; i < SAMPLE_SIZE; ++i) {
+		_cur[i] = ~_prev[i];
+	}
+
+	roundtrip(-1);
+}
+
+TEST_F(DeltaEncodingTest, LongRun)
+{
+	static constexpr size_t LARGE_SIZE = 1000;
+	uint8_t prev[LARGE_SIZE] {};
+	uint8_t cur[LARGE_SIZE] {};
+	uint8_t encoded[LARGE_SIZE];
+
+	// 300 changed bytes need two runs
+	for (size_t i = 100; i < 400; ++i) {
+		cur[i] = 1;
+	}
+
+	const int len = delta::encode(prev, cur, LARGE_SIZE, encoded, LARGE_SIZE);
+	EXPECT_EQ(len, (int)(2 * delta::RUN_HEADER_LEN + 300));
+	EXPECT_TRUE(delta::apply(prev, LARGE_SIZE, encoded, len));
+	EXPECT_EQ(memcmp(prev, cur, LARGE_SIZE), 0);
+}
+
+TEST_F(DeltaEncodingTest, MalformedInput)
+{
+	uint8_t sample[SAMPLE_SIZE] {};
+
+	// truncated run header
+	const uint8_t truncated[] = {0, 0};
+	EXPECT_FALSE(delta::apply(sample, SAMPLE_SIZE, truncated, sizeof(truncated)));
+
+	// run exceeding the sample
+	const uint8_t out_of_bounds[] = {SAMPLE_SIZE - 1, 0, 2, 1, 1};
+	EXPECT_FALSE(delta::apply(sample, SAMPLE_SIZE, out_of_bounds, sizeof(out_of_bounds)));
+
+	// run exceeding the message
+	const uint8_t too_short[] = {0, 0, 3, 1};
+	EXPECT_FALSE(delta::apply(sample, SAMPLE_SIZE, too_short, sizeof(too_short)));
+}
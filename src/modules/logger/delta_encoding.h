@@ -0,0 +1,137 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file delta_encoding.h
+ * Sparse byte-delta encoding of consecutive samples of the same logged topic
+ * (ULogMessageType::DATA_DELTA). Shared between the logger and the replay module.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+namespace px4
+{
+namespace logger
+{
+namespace delta
+{
+
+static constexpr size_t RUN_HEADER_LEN = 3; ///< uint16_t offset + uint8_t length
+static constexpr size_t MAX_RUN_LEN = UINT8_MAX;
+
+/**
+ * Encode the difference between two samples of the same size as a sequence of runs:
+ * [uint16_t offset][uint8_t length][length bytes of the new sample], little-endian.
+ * Changed bytes separated by less than a run header of unchanged bytes are merged into one run.
+ * @param prev previous sample (as known by the decoder)
+ * @param cur current sample
+ * @param size sample size in bytes (at most UINT16_MAX)
+ * @param out output buffer
+ * @param max_len encoding is aborted if it does not fit strictly below this length
+ * @return encoded length, -1 if the encoding is not smaller than max_len
+ */
+static inline int encode(const uint8_t *prev, const uint8_t *cur, size_t size, uint8_t *out, size_t max_len)
+{
+	size_t out_len = 0;
+	size_t i = 0;
+
+	while (i < size) {
+		if (prev[i] == cur[i]) {
+			++i;
+			continue;
+		}
+
+		size_t run_end = i + 1;
+
+		for (size_t j = i + 1; j < size && j - i < MAX_RUN_LEN && j - run_end < RUN_HEADER_LEN; ++j) {
+			if (prev[j] != cur[j]) {
+				run_end = j + 1;
+			}
+		}
+
+		const size_t run_len = run_end - i;
+
+		if (out_len + RUN_HEADER_LEN + run_len >= max_len) {
+			return -1;
+		}
+
+		out[out_len++] = (uint8_t)i;
+		out[out_len++] = (uint8_t)(i >> 8);
+		out[out_len++] = (uint8_t)run_len;
+		memcpy(out + out_len, cur + i, run_len);
+		out_len += run_len;
+		i = run_end;
+	}
+
+	return (int)out_len;
+}
+
+/**
+ * Apply an encoded delta (@see encode()) in place to the previous sample.
+ * @param sample previous sample, updated to the new sample
+ * @param size sample size in bytes
+ * @param delta encoded runs
+ * @param len length of the encoded runs
+ * @return false if the encoding is malformed (sample content is undefined in that case)
+ */
+static inline bool apply(uint8_t *sample, size_t size, const uint8_t *delta, size_t len)
+{
+	size_t pos = 0;
+
+	while (pos < len) {
+		if (pos + RUN_HEADER_LEN > len) {
+			return false;
+		}
+
+		const size_t offset = delta[pos] | (delta[pos + 1] << 8);
+		const size_t run_len = delta[pos + 2];
+		pos += RUN_HEADER_LEN;
+
+		if (run_len == 0 || pos + run_len > len || offset + run_len > size) {
+			return false;
+		}
+
+		memcpy(sample + offset, delta + pos, run_len);
+		pos += run_len;
+	}
+
+	return true;
+}
+
+} //namespace delta
+} //namespace logger
+} //namespace px4
@@ -65,7 +65,7 @@ public:
 	/** stop all running threads and wait for them to exit */
 	void thread_stop();
 
-	void start_log_file(LogType type, const char *filename);
+	void start_log_file(LogType type, const char *filename, size_t prealloc_extent = 0);
 
 	void stop_log_file(LogType type);
 
@@ -138,6 +138,20 @@ public:
 		return 0;
 	}
 
+	uint32_t get_write_latency_percentile_file(LogType type, float fraction) const
+	{
+		if (_log_writer_file) { return _log_writer_file->get_write_latency_percentile(type, fraction); }
+
+		return 0;
+	}
+
+	uint32_t get_write_latency_max_file(LogType type) const
+	{
+		if (_log_writer_file) { return _log_writer_file->get_write_latency_max(type); }
+
+		return 0;
+	}
+
 	pthread_t thread_id_file() const
 	{
 		if (_log_writer_file) { return _log_writer_file->thread_id(); }
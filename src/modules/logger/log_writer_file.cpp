@@ -35,6 +35,7 @@
 #include "messages.h"
 
 #include <fcntl.h>
+#include <unistd.h>
 #include <string.h>
 #include <errno.h>
 
@@ -56,9 +57,10 @@ constexpr size_t LogWriterFile::_min_write_chunk;
 LogWriterFile::LogWriterFile(size_t buffer_size)
 	: _buffers{
 	//We always write larger chunks (orb messages) to the buffer, so the buffer
-	//needs to be larger than the minimum write chunk (300 is somewhat arbitrary)
+	//needs to be larger than the minimum write chunk (300 is somewhat arbitrary).
+	//It is rounded up to whole chunks, so that aligned writes stay aligned when the buffer wraps around.
 	{
-		math::max(buffer_size, _min_write_chunk + 300),
+		(math::max(buffer_size, _min_write_chunk + 300) + _min_write_chunk - 1) / _min_write_chunk * _min_write_chunk,
 		perf_alloc(PC_ELAPSED, "logger_sd_write"), perf_alloc(PC_ELAPSED, "logger_sd_fsync")},
 
 	{
@@ -81,7 +83,7 @@ LogWriterFile::~LogWriterFile()
 	pthread_cond_destroy(&_cv);
 }
 
-void LogWriterFile::start_log(LogType type, const char *filename)
+void LogWriterFile::start_log(LogType type, const char *filename, size_t prealloc_extent)
 {
 	// At this point we don't expect the file to be open, but it can happen for very fast consecutive stop & start
 	// calls. In that case we wait for the thread to close the file first.
@@ -107,7 +109,7 @@ void LogWriterFile::start_log(LogType type, const char *filename)
 		}
 	}
 
-	if (_buffers[(int)type].start_log(filename)) {
+	if (_buffers[(int)type].start_log(filename, prealloc_extent)) {
 		PX4_INFO("Opened %s log file: %s", log_type_str(type), filename);
 		notify();
 	}
@@ -247,15 +249,24 @@ void LogWriterFile::run()
 				LogFileBuffer &buffer = _buffers[i];
 				size_t available = buffer.get_read_ptr(&read_ptr, &is_part);
 
+				if (buffer.aligned() && buffer._should_run) {
+					/* write whole chunks only. A part always ends at the buffer end, which is aligned too */
+					available -= available % _min_write_chunk;
+				}
+
 				/* if sufficient data available or partial read or terminating, write data */
 				if (available >= min_available[i] || is_part || (!buffer._should_run && available > 0)) {
 					pthread_mutex_unlock(&_mtx);
 
+					const hrt_abstime write_start = hrt_absolute_time();
 					written = buffer.write_to_file(read_ptr, available, call_fsync);
+					const hrt_abstime write_latency = hrt_elapsed_time(&write_start);
 
 					/* buffer.mark_read() requires _mtx to be locked */
 					pthread_mutex_lock(&_mtx);
 
+					buffer.add_write_latency(write_latency);
+
 					if (written >= 0) {
 						/* subtract bytes written from number in buffer (count -= written) */
 						buffer.mark_read(written);
@@ -447,7 +458,7 @@ size_t LogWriterFile::LogFileBuffer::get_read_ptr(void **ptr, bool *is_part)
 	}
 }
 
-bool LogWriterFile::LogFileBuffer::start_log(const char *filename)
+bool LogWriterFile::LogFileBuffer::start_log(const char *filename, size_t prealloc_extent)
 {
 	_fd = ::open(filename, O_CREAT | O_WRONLY, PX4_O_MODE_666);
 
@@ -472,20 +483,69 @@ bool LogWriterFile::LogFileBuffer::start_log(const char *filename)
 	_count = 0;
 	_total_written = 0;
 
+	memset(_write_latency_hist, 0, sizeof(_write_latency_hist));
+	_write_latency_count = 0;
+	_write_latency_max = 0;
+
+	// the first extent is reserved by the writer thread on the first write, not here on the logger thread
+	_prealloc_extent = prealloc_extent;
+	_allocated = 0;
+	_synced = 0;
+
 	_should_run = true;
 
 	return true;
 }
 
-void LogWriterFile::LogFileBuffer::fsync() const
+bool LogWriterFile::LogFileBuffer::preallocate()
+{
+#if defined(__PX4_LINUX)
+	// reserve the blocks without changing the file size, so the file never contains a zero tail
+	if (fallocate(_fd, FALLOC_FL_KEEP_SIZE, _allocated, _prealloc_extent) != 0) {
+		return false;
+	}
+
+	_allocated += _prealloc_extent;
+#else
+	// There is no allocation without extending the file: growing it with ftruncate() would leave a
+	// zero tail after a crash (and zero-fill synchronously on FAT). Only the aligned writes are kept.
+	_allocated = SIZE_MAX;
+#endif
+
+	return true;
+}
+
+void LogWriterFile::LogFileBuffer::fsync()
 {
 	perf_begin(_perf_fsync);
+
+#if defined(__PX4_LINUX)
+
+	if (_prealloc_extent > 0) {
+		// start write-back of the range written since the last call, without waiting for metadata
+		sync_file_range(_fd, _synced, _total_written - _synced, SYNC_FILE_RANGE_WRITE);
+		_synced = _total_written;
+
+	} else {
+		::fsync(_fd);
+	}
+
+#else
+	// no range sync available
 	::fsync(_fd);
+#endif
+
 	perf_end(_perf_fsync);
 }
 
-ssize_t LogWriterFile::LogFileBuffer::write_to_file(const void *buffer, size_t size, bool call_fsync) const
+ssize_t LogWriterFile::LogFileBuffer::write_to_file(const void *buffer, size_t size, bool call_fsync)
 {
+	if (_prealloc_extent > 0 && _total_written + size > _allocated && !preallocate()) {
+		PX4_WARN("log file preallocation failed (%i)", errno);
+		// keep writing, the file grows as usual
+		_allocated = SIZE_MAX;
+	}
+
 	perf_begin(_perf_write);
 	ssize_t ret = ::write(_fd, buffer, size);
 	perf_end(_perf_write);
@@ -497,12 +557,65 @@ ssize_t LogWriterFile::LogFileBuffer::write_to_file(const void *buffer, size_t s
 	return ret;
 }
 
+void LogWriterFile::LogFileBuffer::add_write_latency(hrt_abstime latency)
+{
+	int bucket = 0;
+
+	while (bucket < WRITE_LATENCY_BUCKETS - 1 && latency >= (2ull << bucket)) {
+		++bucket;
+	}
+
+	++_write_latency_hist[bucket];
+	++_write_latency_count;
+
+	if (latency > _write_latency_max) {
+		_write_latency_max = latency > UINT32_MAX ? UINT32_MAX : latency;
+	}
+}
+
+uint32_t LogWriterFile::LogFileBuffer::write_latency_percentile(float fraction) const
+{
+	if (_write_latency_count == 0) {
+		return 0;
+	}
+
+	const float target = fraction * _write_latency_count;
+	uint32_t cumulative = 0;
+
+	for (int bucket = 0; bucket < WRITE_LATENCY_BUCKETS; ++bucket) {
+		if (cumulative + _write_latency_hist[bucket] >= target) {
+			// interpolate linearly within the bucket
+			const float lower = (bucket == 0) ? 0.f : (float)(1u << bucket);
+			const float upper = (float)(2u << bucket);
+			const float ratio = (target - cumulative) / _write_latency_hist[bucket];
+			const float percentile = lower + (upper - lower) * ratio;
+
+			return math::min((uint32_t)percentile, _write_latency_max);
+		}
+
+		cumulative += _write_latency_hist[bucket];
+	}
+
+	return _write_latency_max;
+}
+
 void LogWriterFile::LogFileBuffer::close_file()
 {
 	_head = 0;
 	_count = 0;
 
 	if (_fd >= 0) {
+#if defined(__PX4_LINUX)
+
+		if (_prealloc_extent > 0) {
+			// release the preallocated but unused blocks beyond the end of the file
+			if (ftruncate(_fd, _total_written) != 0) {
+				PX4_WARN("truncating log file failed (%i)", errno);
+			}
+		}
+
+#endif
+
 		int res = close(_fd);
 		_fd = -1;
 
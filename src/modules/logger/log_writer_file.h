@@ -77,7 +77,10 @@ public:
 
 	void thread_stop();
 
-	void start_log(LogType type, const char *filename);
+	/**
+	 * @param prealloc_extent preallocate the file in extents of this size and write aligned chunks (0 to disable)
+	 */
+	void start_log(LogType type, const char *filename, size_t prealloc_extent = 0);
 
 	void stop_log(LogType type);
 
@@ -116,6 +119,20 @@ public:
 		return _buffers[(int)type].count();
 	}
 
+	/**
+	 * Write latency percentile since the log start, requires the lock to be held.
+	 * @param fraction percentile as fraction, e.g. 0.99
+	 */
+	uint32_t get_write_latency_percentile(LogType type, float fraction) const
+	{
+		return _buffers[(int)type].write_latency_percentile(fraction);
+	}
+
+	uint32_t get_write_latency_max(LogType type) const
+	{
+		return _buffers[(int)type].write_latency_max();
+	}
+
 	void set_need_reliable_transfer(bool need_reliable)
 	{
 		_need_reliable_transfer = need_reliable;
@@ -156,7 +173,7 @@ private:
 
 		~LogFileBuffer();
 
-		bool start_log(const char *filename);
+		bool start_log(const char *filename, size_t prealloc_extent);
 
 		void close_file();
 
@@ -171,9 +188,13 @@ private:
 
 		int fd() const { return _fd; }
 
-		inline ssize_t write_to_file(const void *buffer, size_t size, bool call_fsync) const;
+		inline ssize_t write_to_file(const void *buffer, size_t size, bool call_fsync);
 
-		inline void fsync() const;
+		/**
+		 * flush written data to the card: on Linux the range written since the last call for preallocated
+		 * files, the whole file otherwise
+		 */
+		inline void fsync();
 
 		void mark_read(size_t n) { _count -= n; _total_written += n; }
 
@@ -181,6 +202,13 @@ private:
 		size_t buffer_size() const { return _buffer_size; }
 		size_t count() const { return _count; }
 
+		/** whether writes are kept aligned to _min_write_chunk */
+		bool aligned() const { return _prealloc_extent > 0; }
+
+		void add_write_latency(hrt_abstime latency);
+		uint32_t write_latency_percentile(float fraction) const;
+		uint32_t write_latency_max() const { return _write_latency_max; }
+
 		bool _should_run = false;
 
 	private:
@@ -192,6 +220,22 @@ private:
 		size_t _total_written = 0;
 		perf_counter_t _perf_write;
 		perf_counter_t _perf_fsync;
+
+		/**
+		 * reserve the next extent of the file (Linux only, without changing the file size)
+		 * @return false on error
+		 */
+		bool preallocate();
+
+		size_t _prealloc_extent = 0; ///< preallocation extent size, 0 if disabled
+		size_t _allocated = 0; ///< file size preallocated so far
+		size_t _synced = 0; ///< file offset up to which data was flushed
+
+		/* write latency histogram, bucket i holds latencies in [2^i, 2^(i+1)) us (bucket 0 from 0) */
+		static constexpr int WRITE_LATENCY_BUCKETS = 24;
+		uint32_t _write_latency_hist[WRITE_LATENCY_BUCKETS] {};
+		uint32_t _write_latency_count = 0;
+		uint32_t _write_latency_max = 0;
 	};
 
 	LogFileBuffer _buffers[(int)LogType::Count];
@@ -48,6 +48,8 @@ void LoggedTopics::add_default_topics()
 	add_topic("actuator_armed");
 	add_topic("actuator_controls_0", 50);
 	add_topic("actuator_controls_1", 100);
+	add_topic("actuator_controls_4", 50);
+	add_topic("actuator_controls_5", 50);
 	add_topic("airspeed", 1000);
 	add_topic("airspeed_validated", 200);
 	add_topic("camera_capture");
@@ -55,6 +57,7 @@ void LoggedTopics::add_default_topics()
 	add_topic("camera_trigger_secondary");
 	add_topic("cellular_status", 200);
 	add_topic("commander_state");
+	add_topic("control_allocator_status", 200);
 	add_topic("cpuload");
 	add_topic("esc_status", 250);
 	add_topic("generator_status");
@@ -103,6 +106,8 @@ void LoggedTopics::add_default_topics()
 	add_topic("vehicle_roi", 1000);
 	add_topic("vehicle_status");
 	add_topic("vehicle_status_flags");
+	add_topic("vehicle_thrust_setpoint", 20);
+	add_topic("vehicle_torque_setpoint", 20);
 	add_topic("vtol_vehicle_status", 200);
 
 	// multi topics
@@ -324,6 +329,61 @@ void LoggedTopics::add_mission_topic(const char *name, uint16_t interval_ms)
 	}
 }
 
+LogPriority LoggedTopics::topic_priority(const char *name)
+{
+	struct PriorityPrefix {
+		const char *prefix;
+		LogPriority priority;
+	};
+
+	// the first matching prefix is used, so more specific prefixes go first
+	static constexpr PriorityPrefix priorities[] = {
+		{"actuator_armed", LogPriority::Critical},
+		{"battery_status", LogPriority::Critical},
+		{"commander_state", LogPriority::Critical},
+		{"cpuload", LogPriority::Critical},
+		{"failure_detector_status", LogPriority::Critical},
+		{"home_position", LogPriority::Critical},
+		{"logger_status", LogPriority::Critical},
+		{"mission_result", LogPriority::Critical},
+		{"safety", LogPriority::Critical},
+		{"system_power", LogPriority::Critical},
+		{"vehicle_command", LogPriority::Critical},
+		{"vehicle_control_mode", LogPriority::Critical},
+		{"vehicle_land_detected", LogPriority::Critical},
+		{"vehicle_status", LogPriority::Critical},
+
+		{"ekf", LogPriority::Estimator},
+		{"estimator_", LogPriority::Estimator},
+		{"vehicle_attitude_setpoint", LogPriority::Default},
+		{"vehicle_attitude", LogPriority::Estimator},
+		{"vehicle_global_position", LogPriority::Estimator},
+		{"vehicle_local_position_setpoint", LogPriority::Default},
+		{"vehicle_local_position", LogPriority::Estimator},
+		{"wind_estimate", LogPriority::Estimator},
+		{"yaw_estimator_status", LogPriority::Estimator},
+
+		{"sensor_selection", LogPriority::Default},
+		{"sensor_", LogPriority::Sensor},
+		{"vehicle_acceleration", LogPriority::Sensor},
+		{"vehicle_air_data", LogPriority::Sensor},
+		{"vehicle_angular_", LogPriority::Sensor},
+		{"vehicle_imu", LogPriority::Sensor},
+		{"vehicle_magnetometer", LogPriority::Sensor},
+
+		{"debug_", LogPriority::Debug},
+		{"satellite_info", LogPriority::Debug},
+	};
+
+	for (const PriorityPrefix &p : priorities) {
+		if (strncmp(name, p.prefix, strlen(p.prefix)) == 0) {
+			return p.priority;
+		}
+	}
+
+	return LogPriority::Default;
+}
+
 bool LoggedTopics::add_topic(const orb_metadata *topic, uint16_t interval_ms, uint8_t instance)
 {
 	size_t fields_len = strlen(topic->o_fields) + strlen(topic->o_name) + 1; //1 for ':'
@@ -343,6 +403,7 @@ bool LoggedTopics::add_topic(const orb_metadata *topic, uint16_t interval_ms, ui
 	RequestedSubscription &sub = _subscriptions.sub[_subscriptions.count++];
 	sub.interval_ms = interval_ms;
 	sub.instance = instance;
+	sub.priority = topic_priority(topic->o_name);
 	sub.id = static_cast<ORB_ID>(topic->o_id);
 	return true;
 }
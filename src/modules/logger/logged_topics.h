@@ -62,6 +62,20 @@ enum class MissionLogType : int32_t {
 	Geotagging =             2
 };
 
+/**
+ * Admission priority of a logged topic, highest first. Under buffer pressure the lower
+ * priorities are thinned first (the values match logger_status_s::PRIORITY_*).
+ */
+enum class LogPriority : uint8_t {
+	Critical =  0, ///< vehicle state, commands and failures: only dropped when the buffer is full
+	Estimator = 1, ///< estimator outputs and status
+	Default =   2, ///< control setpoints and everything not classified otherwise
+	Sensor =    3, ///< high-rate sensor data
+	Debug =     4, ///< debug topics
+
+	Count
+};
+
 inline bool operator&(SDLogProfileMask a, SDLogProfileMask b)
 {
 	return static_cast<int32_t>(a) & static_cast<int32_t>(b);
@@ -79,6 +93,7 @@ public:
 	struct RequestedSubscription {
 		uint16_t interval_ms;
 		uint8_t instance;
+		LogPriority priority;
 		ORB_ID id{ORB_ID::INVALID};
 	};
 	struct RequestedSubscriptionArray {
@@ -153,6 +168,11 @@ private:
 	void add_raw_imu_gyro_fifo();
 	void add_raw_imu_accel_fifo();
 
+	/**
+	 * Get the admission priority of a topic, based on its name
+	 */
+	static LogPriority topic_priority(const char *name);
+
 	/**
 	 * add a logged topic (called by add_topic() above).
 	 * @return true on success
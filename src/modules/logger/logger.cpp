@@ -32,7 +32,9 @@
  ****************************************************************************/
 
 #include <px4_platform_common/px4_config.h>
+#include <px4_platform_common/boot_profile.h>
 #include <px4_platform_common/console_buffer.h>
+#include "delta_encoding.h"
 #include "logged_topics.h"
 #include "logger.h"
 #include "messages.h"
@@ -136,6 +138,8 @@ namespace logger
 {
 
 constexpr const char *Logger::LOG_ROOT[(int)LogType::Count];
+constexpr uint8_t Logger::THIN_START_PERCENT[(int)LogPriority::Count];
+constexpr uint8_t Logger::THIN_DROP_PERCENT[(int)LogPriority::Count];
 
 int Logger::custom_command(int argc, char *argv[])
 {
@@ -180,6 +184,10 @@ int Logger::print_status()
 	PX4_INFO("Number of subscriptions: %i (%i bytes)", _num_subscriptions,
 		 (int)(_num_subscriptions * sizeof(LoggerSubscription)));
 
+	if (_delta_states) {
+		PX4_INFO("Delta encoding enabled (keyframe interval: %i)", _delta_keyframe_interval);
+	}
+
 	bool is_logging = false;
 
 	if (_writer.is_started(LogType::Full, LogWriter::BackendFile)) {
@@ -230,9 +238,19 @@ void Logger::print_statistics(LogType type)
 
 	PX4_INFO("Since last status: dropouts: %zu (max len: %.3f s), max used buffer: %zu / %zu B",
 		 stats.write_dropouts, (double)stats.max_dropout_duration, stats.high_water, _writer.get_buffer_size_file(type));
+
+	if (type == LogType::Full) {
+		PX4_INFO("Dropped samples: critical: %" PRIu32 ", estimator: %" PRIu32 ", default: %" PRIu32 ", sensor: %" PRIu32
+			 ", debug: %" PRIu32,
+			 stats.priority_drops[(int)LogPriority::Critical], stats.priority_drops[(int)LogPriority::Estimator],
+			 stats.priority_drops[(int)LogPriority::Default], stats.priority_drops[(int)LogPriority::Sensor],
+			 stats.priority_drops[(int)LogPriority::Debug]);
+	}
+
 	stats.high_water = 0;
 	stats.write_dropouts = 0;
 	stats.max_dropout_duration = 0.f;
+	memset(stats.priority_drops, 0, sizeof(stats.priority_drops));
 }
 
 Logger *Logger::instantiate(int argc, char *argv[])
@@ -390,6 +408,9 @@ Logger::~Logger()
 
 	delete[](_msg_buffer);
 	delete[](_subscriptions);
+	delete[](_delta_states);
+	delete[](_delta_sample_buffer);
+	delete[](_delta_msg_buffer);
 }
 
 void Logger::update_params()
@@ -529,7 +550,7 @@ bool Logger::initialize_topics()
 
 		for (int i = 0; i < logged_topics.subscriptions().count; ++i) {
 			const LoggedTopics::RequestedSubscription &sub = logged_topics.subscriptions().sub[i];
-			_subscriptions[i] = LoggerSubscription(sub.id, sub.interval_ms, sub.instance);
+			_subscriptions[i] = LoggerSubscription(sub.id, sub.interval_ms, sub.instance, sub.priority);
 			_subscriptions[i].subscribe();
 		}
 	}
@@ -603,6 +624,11 @@ void Logger::run()
 	}
 
 
+	if (!initialize_delta_encoding()) {
+		PX4_ERR("failed to alloc delta encoding buffers");
+		return;
+	}
+
 	if (!_writer.init()) {
 		PX4_ERR("writer init failed");
 		return;
@@ -709,6 +735,9 @@ void Logger::run()
 			/* wait for lock on log buffer */
 			_writer.lock();
 
+			// size of the full log buffer, used for the priority based admission (0 for the mavlink backend)
+			const size_t full_buffer_size = _writer.get_buffer_size_file(LogType::Full);
+
 			for (int sub_idx = 0; sub_idx < _num_subscriptions; ++sub_idx) {
 				LoggerSubscription &sub = _subscriptions[sub_idx];
 				/* if this topic has been updated, copy the new data into the message buffer
@@ -731,12 +760,36 @@ void Logger::run()
 
 					// PX4_INFO("topic: %s, size = %zu, out_size = %zu", sub.get_topic()->o_name, sub.get_topic()->o_size, msg_size);
 
-					// full log
-					if (write_message(LogType::Full, _msg_buffer, msg_size)) {
+					// full log: sample the buffer fill for each message, as the ones written before it in this
+					// cycle count towards it
+					const unsigned buffer_fill_percent = full_buffer_size > 0 ?
+									     _writer.get_buffer_fill_count_file(LogType::Full) * 100 / full_buffer_size : 0;
+
+					if (admit_sample(sub, buffer_fill_percent)) {
+						size_t full_msg_size = msg_size;
+						uint8_t *full_msg = delta_encode_data_message(sub_idx, full_msg_size);
+
+						if (write_message(LogType::Full, full_msg, full_msg_size)) {
 
 #ifdef DBGPRINT
-						total_bytes += msg_size;
+							total_bytes += full_msg_size;
 #endif /* DBGPRINT */
+
+						} else {
+							++_statistics[(int)LogType::Full].priority_drops[(int)sub.priority];
+
+							if (_delta_states) {
+								// the decoder did not see this sample
+								_delta_states[sub_idx].valid = false;
+							}
+						}
+
+					} else {
+						++_statistics[(int)LogType::Full].priority_drops[(int)sub.priority];
+
+						if (_delta_states) {
+							_delta_states[sub_idx].valid = false;
+						}
 					}
 
 					// mission log
@@ -943,9 +996,18 @@ void Logger::publish_logger_status()
 				status.total_written_kb = kb_written;
 				status.write_rate_kb_s = kb_written / seconds;
 				status.dropouts = _statistics[i].write_dropouts;
+
+				for (int priority = 0; priority < (int)LogPriority::Count; ++priority) {
+					status.priority_drops[priority] = _statistics[i].priority_drops[priority];
+				}
+
 				status.message_gaps = _message_gaps;
 				status.buffer_used_bytes = buffer_fill_count_file;
 				status.buffer_size_bytes = _writer.get_buffer_size_file(log_type);
+				status.write_latency_p50_us = _writer.get_write_latency_percentile_file(log_type, 0.50f);
+				status.write_latency_p95_us = _writer.get_write_latency_percentile_file(log_type, 0.95f);
+				status.write_latency_p99_us = _writer.get_write_latency_percentile_file(log_type, 0.99f);
+				status.write_latency_max_us = _writer.get_write_latency_max_file(log_type);
 				status.num_messages = _num_subscriptions;
 				status.timestamp = hrt_absolute_time();
 				_logger_status_pub[i].publish(status);
@@ -1061,6 +1123,116 @@ void Logger::handle_vehicle_command_update()
 	}
 }
 
+bool Logger::initialize_delta_encoding()
+{
+	if (_param_sdlog_delta_kf.get() <= 0 || _num_subscriptions == 0) {
+		return true;
+	}
+
+	size_t sample_buffer_size = 0;
+
+	for (int sub_idx = 0; sub_idx < _num_subscriptions; ++sub_idx) {
+		sample_buffer_size += _subscriptions[sub_idx].get_topic()->o_size_no_padding;
+	}
+
+	_delta_states = new DeltaState[_num_subscriptions];
+	_delta_sample_buffer = new uint8_t[sample_buffer_size];
+	// the encoded message is always smaller than the DATA message
+	_delta_msg_buffer = new uint8_t[_msg_buffer_len];
+
+	if (!_delta_states || !_delta_sample_buffer || !_delta_msg_buffer) {
+		delete[](_delta_states);
+		delete[](_delta_sample_buffer);
+		delete[](_delta_msg_buffer);
+		_delta_states = nullptr;
+		_delta_sample_buffer = nullptr;
+		_delta_msg_buffer = nullptr;
+		return false;
+	}
+
+	uint8_t *prev_sample = _delta_sample_buffer;
+
+	for (int sub_idx = 0; sub_idx < _num_subscriptions; ++sub_idx) {
+		_delta_states[sub_idx].prev_sample = prev_sample;
+		prev_sample += _subscriptions[sub_idx].get_topic()->o_size_no_padding;
+	}
+
+	_delta_keyframe_interval = _param_sdlog_delta_kf.get();
+	PX4_DEBUG("delta encoding enabled (keyframe interval: %i, %zu bytes)", _delta_keyframe_interval, sample_buffer_size);
+	return true;
+}
+
+void Logger::reset_delta_states()
+{
+	if (!_delta_states) {
+		return;
+	}
+
+	for (int sub_idx = 0; sub_idx < _num_subscriptions; ++sub_idx) {
+		_delta_states[sub_idx].valid = false;
+	}
+}
+
+uint8_t *Logger::delta_encode_data_message(int sub_idx, size_t &msg_size)
+{
+	// a mavlink log stream is lossy, so a missed keyframe would corrupt the following samples
+	if (!_delta_states || _writer.is_started(LogType::Full, LogWriter::BackendMavlink)) {
+		return _msg_buffer;
+	}
+
+	DeltaState &state = _delta_states[sub_idx];
+	const uint8_t *sample = _msg_buffer + sizeof(ulog_message_data_header_s);
+	const size_t sample_size = msg_size - sizeof(ulog_message_data_header_s);
+	uint8_t *msg = _msg_buffer;
+
+	if (state.valid && state.samples_since_keyframe < _delta_keyframe_interval) {
+		const size_t header_size = sizeof(ulog_message_data_delta_header_s);
+		const int delta_size = delta::encode(state.prev_sample, sample, sample_size, _delta_msg_buffer + header_size,
+						     msg_size - header_size);
+
+		if (delta_size >= 0) {
+			const uint16_t write_msg_size = static_cast<uint16_t>(header_size + delta_size - ULOG_MSG_HEADER_LEN);
+			_delta_msg_buffer[0] = (uint8_t)write_msg_size;
+			_delta_msg_buffer[1] = (uint8_t)(write_msg_size >> 8);
+			_delta_msg_buffer[2] = static_cast<uint8_t>(ULogMessageType::DATA_DELTA);
+			_delta_msg_buffer[3] = _msg_buffer[3]; // msg_id
+			_delta_msg_buffer[4] = _msg_buffer[4];
+
+			msg = _delta_msg_buffer;
+			msg_size = header_size + delta_size;
+			++state.samples_since_keyframe;
+		}
+	}
+
+	if (msg == _msg_buffer) {
+		state.samples_since_keyframe = 0;
+	}
+
+	memcpy(state.prev_sample, sample, sample_size);
+	state.valid = true;
+	return msg;
+}
+
+bool Logger::admit_sample(LoggerSubscription &sub, unsigned buffer_fill_percent)
+{
+	const int priority = (int)sub.priority;
+
+	if (buffer_fill_percent < THIN_START_PERCENT[priority]) {
+		sub.thin_counter = 0;
+		return true;
+	}
+
+	if (buffer_fill_percent >= THIN_DROP_PERCENT[priority]) {
+		// critical topics end up here only if the buffer is full, and the write would fail anyway
+		return priority == (int)LogPriority::Critical;
+	}
+
+	// thinned: write every THIN_RATIO-th sample, starting with the first one
+	const bool admit = (sub.thin_counter == 0);
+	sub.thin_counter = (sub.thin_counter + 1) % THIN_RATIO;
+	return admit;
+}
+
 bool Logger::write_message(LogType type, void *ptr, size_t size)
 {
 	Statistics &stats = _statistics[(int)type];
@@ -1245,10 +1417,22 @@ void Logger::start_log_file(LogType type)
 		mavlink_log_info(&_mavlink_log_pub, "[logger] %s", file_name);
 	}
 
-	_writer.start_log_file(type, file_name);
+	const size_t prealloc_extent = (type == LogType::Full) ? (size_t)_param_sdlog_prealloc.get() * 1024 * 1024 : 0;
+	_writer.start_log_file(type, file_name, prealloc_extent);
 	_writer.select_write_backend(LogWriter::BackendFile);
 	_writer.set_need_reliable_transfer(true);
-	write_header(type);
+
+	if (type == LogType::Full) {
+		reset_delta_states();
+	}
+
+	write_header(type, type == LogType::Full && _delta_states);
+
+	if (type == LogType::Full) {
+		write_boot_profile();
+		px4_boot_profile_complete();
+	}
+
 	write_version(type);
 	write_formats(type);
 
@@ -1301,6 +1485,8 @@ void Logger::start_log_mavlink()
 	_writer.start_log_mavlink();
 	_writer.select_write_backend(LogWriter::BackendMavlink);
 	_writer.set_need_reliable_transfer(true);
+	// the file log (if running) continues with full samples from here on, see delta_encode_data_message()
+	reset_delta_states();
 	write_header(LogType::Full);
 	write_version(LogType::Full);
 	write_formats(LogType::Full);
@@ -1439,6 +1625,15 @@ void Logger::write_console_output()
 
 }
 
+void Logger::write_boot_profile()
+{
+	char buffer[200];
+
+	for (int i = 0; px4_boot_profile_line(i, buffer, sizeof(buffer)) >= 0; i++) {
+		write_info_multiple(LogType::Full, "boot_profile", buffer, i != 0);
+	}
+}
+
 void Logger::write_format(LogType type, const orb_metadata &meta, WrittenFormats &written_formats,
 			  ulog_message_format_s &msg, int subscription_index, int level)
 {
@@ -1720,7 +1915,7 @@ void Logger::write_info_template(LogType type, const char *name, T value, const
 	_writer.unlock();
 }
 
-void Logger::write_header(LogType type)
+void Logger::write_header(LogType type, bool delta_encoded)
 {
 	ulog_file_header_s header = {};
 	header.magic[0] = 'U';
@@ -1741,6 +1936,10 @@ void Logger::write_header(LogType type)
 	flag_bits.msg_size = sizeof(flag_bits) - ULOG_MSG_HEADER_LEN;
 	flag_bits.msg_type = static_cast<uint8_t>(ULogMessageType::FLAG_BITS);
 
+	if (delta_encoded) {
+		flag_bits.incompat_flags[0] |= ULOG_INCOMPAT_FLAG0_DATA_DELTA_MASK;
+	}
+
 	write_message(type, &flag_bits, sizeof(flag_bits));
 
 	_writer.unlock();
@@ -36,6 +36,7 @@
 #include "log_writer.h"
 #include "messages.h"
 #include <containers/Array.hpp>
+#include "logged_topics.h"
 #include "util.h"
 #include <px4_platform_common/defines.h>
 #include <drivers/drv_hrt.h>
@@ -72,11 +73,15 @@ static constexpr uint8_t MSG_ID_INVALID = UINT8_MAX;
 struct LoggerSubscription : public uORB::SubscriptionInterval {
 	LoggerSubscription() = default;
 
-	LoggerSubscription(ORB_ID id, uint32_t interval_ms = 0, uint8_t instance = 0) :
-		uORB::SubscriptionInterval(id, interval_ms * 1000, instance)
+	LoggerSubscription(ORB_ID id, uint32_t interval_ms = 0, uint8_t instance = 0,
+			   LogPriority log_priority = LogPriority::Default) :
+		uORB::SubscriptionInterval(id, interval_ms * 1000, instance),
+		priority(log_priority)
 	{}
 
 	uint8_t msg_id{MSG_ID_INVALID};
+	LogPriority priority{LogPriority::Default};
+	uint8_t thin_counter{0}; ///< counts updates while the priority is thinned
 };
 
 class Logger : public ModuleBase<Logger>, public ModuleParams
@@ -157,6 +162,13 @@ private:
 		float max_dropout_duration{0.0f};			///< max duration of dropout [s]
 		size_t write_dropouts{0};				///< failed buffer writes due to buffer overflow
 		size_t high_water{0};					///< maximum used write buffer
+		uint32_t priority_drops[(int)LogPriority::Count] {};	///< dropped topic samples per priority (thinned or buffer full)
+	};
+
+	struct DeltaState {
+		uint8_t *prev_sample{nullptr};   ///< last sample written to the full log (points into _delta_sample_buffer)
+		uint16_t samples_since_keyframe{0};
+		bool valid{false};               ///< false if the next sample must be written as keyframe
 	};
 
 	struct MissionSubscription {
@@ -164,6 +176,21 @@ private:
 		unsigned next_write_time{0};     ///< next time to write in 0.1 seconds
 	};
 
+	/**
+	 * Buffer fill level (in percent) above which a priority is thinned, and above which it is
+	 * dropped entirely. Critical topics are never thinned.
+	 */
+	static constexpr uint8_t THIN_START_PERCENT[(int)LogPriority::Count] = {100, 90, 80, 65, 50};
+	static constexpr uint8_t THIN_DROP_PERCENT[(int)LogPriority::Count] = {100, 98, 92, 80, 65};
+	static constexpr uint8_t THIN_RATIO = 4; ///< while thinned, 1 out of THIN_RATIO samples is written
+
+	/**
+	 * Admission check of a topic sample for the full log, depending on its priority and the buffer fill.
+	 * _writer.lock() must be held when calling this.
+	 * @return true if the sample should be written
+	 */
+	bool admit_sample(LoggerSubscription &sub, unsigned buffer_fill_percent);
+
 	/**
 	 * @brief Updates and checks for updated uORB parameters.
 	 */
@@ -215,8 +242,9 @@ private:
 
 	/**
 	 * write the file header with file magic and timestamp.
+	 * @param delta_encoded set the incompat flag for DATA_DELTA messages
 	 */
-	void write_header(LogType type);
+	void write_header(LogType type, bool delta_encoded = false);
 
 	/// Array to store written formats for nested definitions (only)
 	using WrittenFormats = Array < const orb_metadata *, 20 >;
@@ -236,6 +264,11 @@ private:
 	 */
 	void write_console_output();
 
+	/**
+	 * write the module startup trace
+	 */
+	void write_boot_profile();
+
 	/**
 	 * callback to write the performance counters
 	 */
@@ -270,6 +303,26 @@ private:
 	 */
 	bool write_message(LogType type, void *ptr, size_t size);
 
+	/**
+	 * Allocate the per-subscription state for delta encoding (if enabled via SDLOG_DELTA_KF).
+	 * Must be called after initialize_topics().
+	 * @return false on allocation failure
+	 */
+	bool initialize_delta_encoding();
+
+	/**
+	 * force a keyframe for every subscription on the next update
+	 */
+	void reset_delta_states();
+
+	/**
+	 * Delta-encode the DATA message in _msg_buffer against the previous sample of the same subscription.
+	 * @param sub_idx subscription index
+	 * @param msg_size size of the DATA message, updated to the size of the returned message
+	 * @return message to write to the full log: either _msg_buffer (keyframe) or _delta_msg_buffer
+	 */
+	uint8_t *delta_encode_data_message(int sub_idx, size_t &msg_size);
+
 	/**
 	 * Add topic subscriptions from SD file if it exists, otherwise add topics based on the configured profile.
 	 * This must be called before start_log() (because it does not write an ADD_LOGGED_MSG message).
@@ -331,6 +384,11 @@ private:
 	MissionSubscription 				_mission_subscriptions[MAX_MISSION_TOPICS_NUM] {}; ///< additional data for mission subscriptions
 	int						_num_mission_subs{0};
 
+	DeltaState					*_delta_states{nullptr}; ///< per subscription, nullptr if delta encoding is disabled
+	uint8_t						*_delta_sample_buffer{nullptr}; ///< previous samples of all subscriptions
+	uint8_t						*_delta_msg_buffer{nullptr}; ///< encoded DATA_DELTA message
+	uint16_t					_delta_keyframe_interval{0};
+
 	LogWriter					_writer;
 	uint32_t					_log_interval{0};
 	const orb_metadata				*_polling_topic_meta{nullptr}; ///< if non-null, poll on this topic instead of sleeping
@@ -362,7 +420,9 @@ private:
 		(ParamInt<px4::params::SDLOG_PROFILE>) _param_sdlog_profile,
 		(ParamInt<px4::params::SDLOG_MISSION>) _param_sdlog_mission,
 		(ParamBool<px4::params::SDLOG_BOOT_BAT>) _param_sdlog_boot_bat,
-		(ParamBool<px4::params::SDLOG_UUID>) _param_sdlog_uuid
+		(ParamBool<px4::params::SDLOG_UUID>) _param_sdlog_uuid,
+		(ParamInt<px4::params::SDLOG_DELTA_KF>) _param_sdlog_delta_kf,
+		(ParamInt<px4::params::SDLOG_PREALLOC>) _param_sdlog_prealloc
 	)
 };
 
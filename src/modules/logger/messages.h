@@ -46,6 +46,7 @@ enum class ULogMessageType : uint8_t {
 	LOGGING = 'L',
 	LOGGING_TAGGED = 'C',
 	FLAG_BITS = 'B',
+	DATA_DELTA = 'X',
 };
 
 
@@ -108,6 +109,14 @@ struct ulog_message_data_header_s {
 	uint16_t msg_id;
 };
 
+/** followed by sparse runs against the previous sample of msg_id, @see delta_encoding.h */
+struct ulog_message_data_delta_header_s {
+	uint16_t msg_size; //size of message - ULOG_MSG_HEADER_LEN
+	uint8_t msg_type = static_cast<uint8_t>(ULogMessageType::DATA_DELTA);
+
+	uint16_t msg_id;
+};
+
 struct ulog_message_info_header_s {
 	uint16_t msg_size; //size of message - ULOG_MSG_HEADER_LEN
 	uint8_t msg_type = static_cast<uint8_t>(ULogMessageType::INFO);
@@ -154,6 +163,7 @@ struct ulog_message_parameter_header_s {
 
 
 #define ULOG_INCOMPAT_FLAG0_DATA_APPENDED_MASK (1<<0)
+#define ULOG_INCOMPAT_FLAG0_DATA_DELTA_MASK (1<<1) ///< log may contain DATA_DELTA messages
 
 struct ulog_message_flag_bits_s {
 	uint16_t msg_size;
@@ -173,3 +173,47 @@ PARAM_DEFINE_INT32(SDLOG_DIRS_MAX, 0);
  * @group SD Logging
  */
 PARAM_DEFINE_INT32(SDLOG_UUID, 1);
+
+/**
+ * Delta encoding keyframe interval
+ *
+ * If set to a value > 0, consecutive samples of a logged topic are written as sparse
+ * byte-deltas against the previous sample (DATA_DELTA messages), with a full sample
+ * (keyframe) every SDLOG_DELTA_KF samples. This reduces the log size and SD card
+ * write load for slowly changing topics.
+ *
+ * Logs written with this enabled require a ULog parser that supports DATA_DELTA messages.
+ * Delta encoding is not used while streaming the log via MAVLink.
+ *
+ * Set to 0 to disable.
+ *
+ * @min 0
+ * @max 1000
+ * @reboot_required true
+ * @group SD Logging
+ */
+PARAM_DEFINE_INT32(SDLOG_DELTA_KF, 0);
+
+/**
+ * Log file preallocation
+ *
+ * If set to a value > 0, the full log is written in aligned multiples of the 4 KiB
+ * write chunk.
+ *
+ * On Linux, the file blocks are in addition reserved in extents of this size (without
+ * changing the file size), and instead of a whole-file fsync only the range written
+ * since the last sync is flushed. This avoids block allocation and metadata updates
+ * during the flight. The unused reserved blocks are released when the log is stopped.
+ * Choose the extent large enough to cover a typical flight, as reserving another
+ * extent can block the writer.
+ *
+ * On NuttX, no blocks are reserved and the periodic fsync is unchanged.
+ *
+ * Set to 0 to disable.
+ *
+ * @unit MB
+ * @min 0
+ * @max 1024
+ * @group SD Logging
+ */
+PARAM_DEFINE_INT32(SDLOG_PREALLOC, 0);
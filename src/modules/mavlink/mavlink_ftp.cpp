@@ -42,6 +42,8 @@
 #include <errno.h>
 #include <cstring>
 
+#include <lib/mathlib/mathlib.h>
+
 #include "mavlink_ftp.h"
 #include "mavlink_tests/mavlink_ftp_test.h"
 
@@ -58,12 +60,19 @@ constexpr const char MavlinkFTP::_root_dir[];
 MavlinkFTP::MavlinkFTP(Mavlink *mavlink) :
 	_mavlink(mavlink)
 {
-	// initialize session
-	_session_info.fd = -1;
+	// initialize sessions
+	for (auto &session_info : _session_info) {
+		session_info.fd = -1;
+		session_info.read_ahead = nullptr;
+	}
 }
 
 MavlinkFTP::~MavlinkFTP()
 {
+	for (uint8_t session = 0; session < kMaxSessions; session++) {
+		_close_session(session);
+	}
+
 	delete[] _work_buffer1;
 	delete[] _work_buffer2;
 }
@@ -71,12 +80,187 @@ MavlinkFTP::~MavlinkFTP()
 unsigned
 MavlinkFTP::get_size()
 {
-	if (_session_info.stream_download) {
-		return MAVLINK_MSG_ID_FILE_TRANSFER_PROTOCOL_LEN + MAVLINK_NUM_NON_PAYLOAD_BYTES;
+	for (const auto &session_info : _session_info) {
+		if (session_info.stream_download) {
+			return MAVLINK_MSG_ID_FILE_TRANSFER_PROTOCOL_LEN + MAVLINK_NUM_NON_PAYLOAD_BYTES;
+		}
+	}
 
-	} else {
+	return 0;
+}
+
+MavlinkFTP::ReadAhead::ReadAhead() :
+	WorkItem(MODULE_NAME "_ftp", px4::wq_configurations::mavlink_ftp)
+{
+	pthread_mutex_init(&_mutex, nullptr);
+	_buffer = new uint8_t[BUFFER_SIZE];
+}
+
+MavlinkFTP::ReadAhead::~ReadAhead()
+{
+	stop();
+
+	perf_free(_read_perf);
+	delete[] _buffer;
+	pthread_mutex_destroy(&_mutex);
+}
+
+void
+MavlinkFTP::ReadAhead::start(int fd, uint32_t file_size, uint32_t offset)
+{
+	pthread_mutex_lock(&_mutex);
+
+	if ((fd != _fd) || (offset < _consume_pos.load()) || (offset > _fill_pos.load())) {
+		// not buffered, restart at the beginning of the block containing offset
+		const uint32_t block_start = offset - (offset % BLOCK_SIZE);
+		_fill_pos.store(block_start);
+		_consume_pos.store(block_start);
+		_generation++;
+	}
+
+	_fd = fd;
+	_file_size = file_size;
+	_errno.store(0);
+
+	pthread_mutex_unlock(&_mutex);
+
+	ScheduleNow();
+}
+
+void
+MavlinkFTP::ReadAhead::stop()
+{
+	ScheduleClear();
+
+	// a read in progress is not waited for, its result is dropped by fill()
+	pthread_mutex_lock(&_mutex);
+	_fd = -1;
+	_generation++;
+	pthread_mutex_unlock(&_mutex);
+}
+
+void
+MavlinkFTP::ReadAhead::release()
+{
+	stop();
+
+	// deleted on the work queue, where it cannot be in the middle of fill()
+	_released.store(true);
+	ScheduleNow();
+}
+
+void
+MavlinkFTP::ReadAhead::Run()
+{
+	if (_released.load()) {
+		delete this;
+		return;
+	}
+
+	fill();
+}
+
+int
+MavlinkFTP::ReadAhead::read(uint32_t offset, uint8_t *dst, unsigned len)
+{
+	if (offset >= _file_size) {
 		return 0;
 	}
+
+	if (len > _file_size - offset) {
+		len = _file_size - offset;
+	}
+
+	const uint32_t fill_pos = _fill_pos.load();
+
+	if (offset + len > fill_pos) {
+		const int read_errno = _errno.load();
+
+		if (read_errno != 0) {
+			errno = read_errno;
+			return -1;
+		}
+
+		_stalls++;
+		ScheduleNow();
+		return 0;
+	}
+
+	const uint32_t index = offset % BUFFER_SIZE;
+	const uint32_t first = math::min((uint32_t)len, BUFFER_SIZE - index);
+	memcpy(dst, &_buffer[index], first);
+	memcpy(dst + first, &_buffer[0], len - first);
+
+	_consume_pos.store(offset + len);
+
+	// read the next block as soon as there is room for it
+	if ((fill_pos < _file_size) && (fill_pos - (offset + len) <= BUFFER_SIZE - BLOCK_SIZE)) {
+		ScheduleNow();
+	}
+
+	return len;
+}
+
+void
+MavlinkFTP::ReadAhead::fill()
+{
+	while (true) {
+		// take a snapshot of the read state, the storage access is done without the lock
+		pthread_mutex_lock(&_mutex);
+
+		const int fd = _fd;
+		const uint32_t generation = _generation;
+		const uint32_t file_size = _file_size;
+		const uint32_t fill_pos = _fill_pos.load();
+		const uint32_t free_space = BUFFER_SIZE - (fill_pos - _consume_pos.load());
+
+		pthread_mutex_unlock(&_mutex);
+
+		if ((fd < 0) || (_errno.load() != 0)) {
+			break;
+		}
+
+		// read up to the next block boundary (which never wraps the ring), but not past the end of the file
+		uint32_t len = BLOCK_SIZE - (fill_pos % BLOCK_SIZE);
+
+		if ((fill_pos >= file_size) || (free_space < len)) {
+			break;
+		}
+
+		len = math::min(len, file_size - fill_pos);
+
+		// Only free space of the ring is written. If the read is restarted or stopped meanwhile, the
+		// range is no longer valid data either. pread() leaves the file offset untouched, so a read on
+		// an fd that was closed and reused in the meantime does not affect its new owner.
+		perf_begin(_read_perf);
+		const ssize_t bytes_read = ::pread(fd, &_buffer[fill_pos % BUFFER_SIZE], len, fill_pos);
+		const int read_errno = errno;
+		perf_end(_read_perf);
+
+		// publish the result, unless the read was restarted or stopped
+		pthread_mutex_lock(&_mutex);
+
+		const bool current = (generation == _generation);
+
+		if (current) {
+			if (bytes_read < 0) {
+				_errno.store(read_errno);
+
+			} else if (bytes_read == 0) {
+				// file got shorter since it was opened
+				_errno.store(EIO);
+
+			} else {
+				_fill_pos.store(fill_pos + bytes_read);
+			}
+		}
+
+		pthread_mutex_unlock(&_mutex);
+
+		if (!current || (bytes_read <= 0)) {
+			break;
+		}
+	}
 }
 
 #ifdef MAVLINK_FTP_UNIT_TEST
@@ -264,6 +448,11 @@ MavlinkFTP::_process_request(
 		break;
 	}
 
+	// keep the session of the request alive, see send()
+	if (SessionInfo *session_info = _get_session(payload->session)) {
+		session_info->last_access = hrt_absolute_time();
+	}
+
 out:
 	payload->seq_number++;
 
@@ -500,7 +689,13 @@ MavlinkFTP::_workList(PayloadHeader *payload)
 MavlinkFTP::ErrorCode
 MavlinkFTP::_workOpen(PayloadHeader *payload, int oflag)
 {
-	if (_session_info.fd >= 0) {
+	uint8_t session = 0;
+
+	while ((session < kMaxSessions) && (_session_info[session].fd >= 0)) {
+		session++;
+	}
+
+	if (session >= kMaxSessions) {
 		PX4_ERR("FTP: Open failed - out of sessions\n");
 		return kErrNoSessionsAvailable;
 	}
@@ -534,11 +729,14 @@ MavlinkFTP::_workOpen(PayloadHeader *payload, int oflag)
 		return kErrFailErrno;
 	}
 
-	_session_info.fd = fd;
-	_session_info.file_size = fileSize;
-	_session_info.stream_download = false;
+	SessionInfo &session_info = _session_info[session];
+	session_info.fd = fd;
+	session_info.file_size = fileSize;
+	session_info.stream_download = false;
+	session_info.stream_start = 0;
+	session_info.stream_bytes = 0;
 
-	payload->session = 0;
+	payload->session = session;
 	payload->size = sizeof(uint32_t);
 	std::memcpy(payload->data, &fileSize, payload->size);
 
@@ -549,7 +747,9 @@ MavlinkFTP::_workOpen(PayloadHeader *payload, int oflag)
 MavlinkFTP::ErrorCode
 MavlinkFTP::_workRead(PayloadHeader *payload)
 {
-	if (payload->session != 0 || _session_info.fd < 0) {
+	SessionInfo *session_info = _get_session(payload->session);
+
+	if (session_info == nullptr) {
 		return kErrInvalidSession;
 	}
 
@@ -558,17 +758,22 @@ MavlinkFTP::_workRead(PayloadHeader *payload)
 #endif
 
 	// We have to test seek past EOF ourselves, lseek will allow seek past EOF
-	if (payload->offset >= _session_info.file_size) {
+	if (payload->offset >= session_info->file_size) {
 		PX4_ERR("request past EOF");
 		return kErrEOF;
 	}
 
-	if (lseek(_session_info.fd, payload->offset, SEEK_SET) < 0) {
+	// a following burst restarts the read-ahead at its offset
+	if (session_info->read_ahead) {
+		session_info->read_ahead->stop();
+	}
+
+	if (lseek(session_info->fd, payload->offset, SEEK_SET) < 0) {
 		PX4_ERR("seek fail");
 		return kErrFailErrno;
 	}
 
-	int bytes_read = ::read(_session_info.fd, &payload->data[0], kMaxDataLength);
+	int bytes_read = ::read(session_info->fd, &payload->data[0], kMaxDataLength);
 
 	if (bytes_read < 0) {
 		// Negative return indicates error other than eof
@@ -585,20 +790,41 @@ MavlinkFTP::_workRead(PayloadHeader *payload)
 MavlinkFTP::ErrorCode
 MavlinkFTP::_workBurst(PayloadHeader *payload, uint8_t target_system_id, uint8_t target_component_id)
 {
-	if (payload->session != 0 && _session_info.fd < 0) {
+	SessionInfo *session_info = _get_session(payload->session);
+
+	if (session_info == nullptr) {
 		return kErrInvalidSession;
 	}
 
 #ifdef MAVLINK_FTP_DEBUG
 	PX4_INFO("FTP: burst offset:%d", payload->offset);
 #endif
+
+	// Read ahead from storage on the FTP work queue, fall back to direct reads if there is no memory
+	if (session_info->read_ahead == nullptr) {
+		session_info->read_ahead = new ReadAhead();
+
+		if (session_info->read_ahead && !session_info->read_ahead->valid()) {
+			delete session_info->read_ahead;
+			session_info->read_ahead = nullptr;
+		}
+	}
+
+	if (session_info->read_ahead) {
+		session_info->read_ahead->start(session_info->fd, session_info->file_size, payload->offset);
+	}
+
 	// Setup for streaming sends
-	_session_info.stream_download = true;
-	_session_info.stream_offset = payload->offset;
-	_session_info.stream_chunk_transmitted = 0;
-	_session_info.stream_seq_number = payload->seq_number + 1;
-	_session_info.stream_target_system_id = target_system_id;
-	_session_info.stream_target_component_id = target_component_id;
+	session_info->stream_download = true;
+	session_info->stream_offset = payload->offset;
+	session_info->stream_chunk_transmitted = 0;
+	session_info->stream_seq_number = payload->seq_number + 1;
+	session_info->stream_target_system_id = target_system_id;
+	session_info->stream_target_component_id = target_component_id;
+
+	if (session_info->stream_start == 0) {
+		session_info->stream_start = hrt_absolute_time();
+	}
 
 	return kErrNone;
 }
@@ -607,17 +833,23 @@ MavlinkFTP::_workBurst(PayloadHeader *payload, uint8_t target_system_id, uint8_t
 MavlinkFTP::ErrorCode
 MavlinkFTP::_workWrite(PayloadHeader *payload)
 {
-	if (payload->session != 0 && _session_info.fd < 0) {
+	SessionInfo *session_info = _get_session(payload->session);
+
+	if (session_info == nullptr) {
 		return kErrInvalidSession;
 	}
 
-	if (lseek(_session_info.fd, payload->offset, SEEK_SET) < 0) {
+	if (session_info->read_ahead) {
+		session_info->read_ahead->stop();
+	}
+
+	if (lseek(session_info->fd, payload->offset, SEEK_SET) < 0) {
 		// Unable to see to the specified location
 		PX4_ERR("seek fail");
 		return kErrFailErrno;
 	}
 
-	int bytes_written = ::write(_session_info.fd, &payload->data[0], payload->size);
+	int bytes_written = ::write(session_info->fd, &payload->data[0], payload->size);
 
 	if (bytes_written < 0) {
 		// Negative return indicates error other than eof
@@ -747,13 +979,11 @@ MavlinkFTP::_workTruncateFile(PayloadHeader *payload)
 MavlinkFTP::ErrorCode
 MavlinkFTP::_workTerminate(PayloadHeader *payload)
 {
-	if (payload->session != 0 || _session_info.fd < 0) {
+	if (_get_session(payload->session) == nullptr) {
 		return kErrInvalidSession;
 	}
 
-	::close(_session_info.fd);
-	_session_info.fd = -1;
-	_session_info.stream_download = false;
+	_close_session(payload->session);
 
 	payload->size = 0;
 
@@ -764,10 +994,8 @@ MavlinkFTP::_workTerminate(PayloadHeader *payload)
 MavlinkFTP::ErrorCode
 MavlinkFTP::_workReset(PayloadHeader *payload)
 {
-	if (_session_info.fd != -1) {
-		::close(_session_info.fd);
-		_session_info.fd = -1;
-		_session_info.stream_download = false;
+	for (uint8_t session = 0; session < kMaxSessions; session++) {
+		_close_session(session);
 	}
 
 	payload->size = 0;
@@ -956,6 +1184,33 @@ MavlinkFTP::_copy_file(const char *src_path, const char *dst_path, size_t length
 	return (length > 0) ? -1 : 0;
 }
 
+void
+MavlinkFTP::_close_session(uint8_t session)
+{
+	SessionInfo &session_info = _session_info[session];
+
+	if (session_info.read_ahead) {
+		const unsigned stalls = session_info.read_ahead->stalls();
+		session_info.read_ahead->release();
+		session_info.read_ahead = nullptr;
+
+		if (session_info.stream_start != 0) {
+			const float elapsed = hrt_elapsed_time(&session_info.stream_start) * 1e-6f;
+			PX4_DEBUG("FTP: session %u sent %u bytes in %.1f s (%.1f kB/s, %u stalls)", session, session_info.stream_bytes,
+				  (double)elapsed, (double)(session_info.stream_bytes / 1024.f / math::max(elapsed, 0.001f)), stalls);
+		}
+	}
+
+	if (session_info.fd >= 0) {
+		::close(session_info.fd);
+		session_info.fd = -1;
+	}
+
+	session_info.stream_download = false;
+	session_info.stream_start = 0;
+	session_info.stream_bytes = 0;
+}
+
 void MavlinkFTP::send()
 {
 
@@ -973,25 +1228,27 @@ void MavlinkFTP::send()
 			}
 		}
 
-	} else if (_session_info.fd != -1) {
-		// close session without activity
-		if (hrt_elapsed_time(&_last_work_buffer_access) > 10_s) {
-			::close(_session_info.fd);
-			_session_info.fd = -1;
-			_session_info.stream_download = false;
+	}
+
+	// close sessions without activity, each on its own timeout
+	for (uint8_t session = 0; session < kMaxSessions; session++) {
+		if ((_session_info[session].fd != -1) && (hrt_elapsed_time(&_session_info[session].last_access) > 10_s)) {
+			_close_session(session);
 			_last_reply_valid = false;
-			PX4_WARN("Session was closed without activity");
+			PX4_WARN("Session %i was closed without activity", session);
 		}
 	}
 
 	// Anything to stream?
-	if (!_session_info.stream_download) {
+	if (get_size() == 0) {
 		return;
 	}
 
+	unsigned max_bytes_to_send = 0;
+
 #ifndef MAVLINK_FTP_UNIT_TEST
 	// Skip send if not enough room
-	unsigned max_bytes_to_send = _mavlink->get_free_tx_buf();
+	max_bytes_to_send = _mavlink->get_free_tx_buf();
 #ifdef MAVLINK_FTP_DEBUG
 	PX4_INFO("MavlinkFTP::send max_bytes_to_send(%d) get_free_tx_buf(%d)", max_bytes_to_send, _mavlink->get_free_tx_buf());
 #endif
@@ -1002,104 +1259,147 @@ void MavlinkFTP::send()
 
 #endif
 
-	// Send stream packets until buffer is full
-
-	bool more_data;
+	// Send stream packets until buffer is full, one packet per streaming session in turn. Sessions waiting
+	// for their read-ahead are skipped, so that they do not hold back the others.
+	bool sent;
 
 	do {
-		more_data = false;
+		sent = false;
 
-		ErrorCode error_code = kErrNone;
+		for (uint8_t n = 0; n < kMaxSessions; n++) {
+			const uint8_t session = (_stream_next_session + n) % kMaxSessions;
 
-		mavlink_file_transfer_protocol_t ftp_msg;
-		PayloadHeader *payload = reinterpret_cast<PayloadHeader *>(&ftp_msg.payload[0]);
+			if (!_session_info[session].stream_download) {
+				continue;
+			}
 
-		payload->seq_number = _session_info.stream_seq_number;
-		payload->session = 0;
-		payload->opcode = kRspAck;
-		payload->req_opcode = kCmdBurstReadFile;
-		payload->offset = _session_info.stream_offset;
-		_session_info.stream_seq_number++;
+			const StreamResult result = _stream_send(session, max_bytes_to_send);
+
+			if (result == StreamResult::BufferFull) {
+				// continue after this session on the next call
+				_stream_next_session = (session + 1) % kMaxSessions;
+				return;
+			}
+
+			sent |= (result == StreamResult::Sent);
+		}
+
+		// rotate the session served first
+		_stream_next_session = (_stream_next_session + 1) % kMaxSessions;
+
+	} while (sent);
+}
+
+MavlinkFTP::StreamResult
+MavlinkFTP::_stream_send(uint8_t session, unsigned &max_bytes_to_send)
+{
+	SessionInfo &session_info = _session_info[session];
+	session_info.last_access = hrt_absolute_time();
+	StreamResult result = StreamResult::Sent;
+
+	ErrorCode error_code = kErrNone;
+
+	mavlink_file_transfer_protocol_t ftp_msg;
+	PayloadHeader *payload = reinterpret_cast<PayloadHeader *>(&ftp_msg.payload[0]);
+
+	payload->seq_number = session_info.stream_seq_number;
+	payload->session = session;
+	payload->opcode = kRspAck;
+	payload->req_opcode = kCmdBurstReadFile;
+	payload->burst_complete = false;
+	payload->offset = session_info.stream_offset;
 
 #ifdef MAVLINK_FTP_DEBUG
-		PX4_INFO("stream send: offset %d", _session_info.stream_offset);
+	PX4_INFO("stream send: session %d offset %d", session, session_info.stream_offset);
 #endif
 
-		// We have to test seek past EOF ourselves, lseek will allow seek past EOF
-		if (_session_info.stream_offset >= _session_info.file_size) {
-			error_code = kErrEOF;
+	// We have to test seek past EOF ourselves, lseek will allow seek past EOF
+	if (session_info.stream_offset >= session_info.file_size) {
+		error_code = kErrEOF;
 #ifdef MAVLINK_FTP_DEBUG
-			PX4_INFO("stream download: sending Nak EOF");
+		PX4_INFO("stream download: sending Nak EOF");
 #endif
-		}
+	}
+
+	if (error_code == kErrNone) {
+		int bytes_read = -1;
+
+		if (session_info.read_ahead) {
+			bytes_read = session_info.read_ahead->read(session_info.stream_offset, &payload->data[0], kMaxDataLength);
+
+#ifdef MAVLINK_FTP_UNIT_TEST
+
+			// no concurrency in the unit test, read synchronously
+			if (bytes_read == 0) {
+				session_info.read_ahead->fill();
+				bytes_read = session_info.read_ahead->read(session_info.stream_offset, &payload->data[0], kMaxDataLength);
+			}
 
-		if (error_code == kErrNone) {
-			if (lseek(_session_info.fd, payload->offset, SEEK_SET) < 0) {
-				error_code = kErrFailErrno;
-#ifdef MAVLINK_FTP_DEBUG
-				PX4_WARN("stream download: seek fail");
 #endif
+
+			if (bytes_read == 0) {
+				// not read from storage yet, don't wait for it and continue on the next call
+				return StreamResult::Stalled;
 			}
-		}
 
-		if (error_code == kErrNone) {
-			int bytes_read = ::read(_session_info.fd, &payload->data[0], kMaxDataLength);
+		} else if (lseek(session_info.fd, payload->offset, SEEK_SET) >= 0) {
+			bytes_read = ::read(session_info.fd, &payload->data[0], kMaxDataLength);
+		}
 
-			if (bytes_read < 0) {
-				// Negative return indicates error other than eof
-				error_code = kErrFailErrno;
+		if (bytes_read < 0) {
+			// Negative return indicates error other than eof
+			error_code = kErrFailErrno;
 #ifdef MAVLINK_FTP_DEBUG
-				PX4_WARN("stream download: read fail");
+			PX4_WARN("stream download: read fail");
 #endif
 
-			} else {
-				payload->size = bytes_read;
-				_session_info.stream_offset += bytes_read;
-				_session_info.stream_chunk_transmitted += bytes_read;
-			}
+		} else {
+			payload->size = bytes_read;
+			session_info.stream_offset += bytes_read;
+			session_info.stream_chunk_transmitted += bytes_read;
+			session_info.stream_bytes += bytes_read;
 		}
+	}
 
-		if (error_code != kErrNone) {
-			payload->opcode = kRspNak;
-			payload->size = 1;
-			uint8_t *pData = &payload->data[0];
-			*pData = error_code; // Straight reference to data[0] is causing bogus gcc array subscript error
+	session_info.stream_seq_number++;
 
-			if (error_code == kErrFailErrno) {
-				int r_errno = errno;
-				payload->size = 2;
-				payload->data[1] = r_errno;
-			}
+	if (error_code != kErrNone) {
+		payload->opcode = kRspNak;
+		payload->size = 1;
+		uint8_t *pData = &payload->data[0];
+		*pData = error_code; // Straight reference to data[0] is causing bogus gcc array subscript error
 
-			_session_info.stream_download = false;
+		if (error_code == kErrFailErrno) {
+			int r_errno = errno;
+			payload->size = 2;
+			payload->data[1] = r_errno;
+		}
+
+		session_info.stream_download = false;
+	}
 
-		} else {
 #ifndef MAVLINK_FTP_UNIT_TEST
 
-			if (max_bytes_to_send < (get_size() * 2)) {
-				more_data = false;
+	if (max_bytes_to_send < (get_size() * 2)) {
+		result = StreamResult::BufferFull;
 
-				/* perform transfers in 35K chunks - this is determined empirical */
-				if (_session_info.stream_chunk_transmitted > 35000) {
-					payload->burst_complete = true;
-					_session_info.stream_download = false;
-					_session_info.stream_chunk_transmitted = 0;
-				}
+		/* perform transfers in 35K chunks - this is determined empirical */
+		if ((error_code == kErrNone) && (session_info.stream_chunk_transmitted > 35000)) {
+			payload->burst_complete = true;
+			session_info.stream_download = false;
+			session_info.stream_chunk_transmitted = 0;
+		}
 
-			} else {
-#endif
-				more_data = true;
-				payload->burst_complete = false;
-#ifndef MAVLINK_FTP_UNIT_TEST
-				max_bytes_to_send -= get_size();
-			}
+	} else {
+		max_bytes_to_send -= get_size();
+	}
 
 #endif
-		}
 
-		ftp_msg.target_system = _session_info.stream_target_system_id;
-		ftp_msg.target_network = 0;
-		ftp_msg.target_component = _session_info.stream_target_component_id;
-		_reply(&ftp_msg);
-	} while (more_data);
+	ftp_msg.target_system = session_info.stream_target_system_id;
+	ftp_msg.target_network = 0;
+	ftp_msg.target_component = session_info.stream_target_component_id;
+	_reply(&ftp_msg);
+
+	return result;
 }
@@ -39,9 +39,14 @@
 #include <dirent.h>
 #include <queue.h>
 
+#include <pthread.h>
+
+#include <px4_platform_common/atomic.h>
 #include <px4_platform_common/defines.h>
+#include <px4_platform_common/px4_work_queue/WorkItem.hpp>
 #include <systemlib/err.h>
 #include <drivers/drv_hrt.h>
+#include <lib/perf/perf_counter.h>
 
 #ifndef MAVLINK_FTP_UNIT_TEST
 #include "mavlink_bridge_header.h"
@@ -151,6 +156,22 @@ private:
 	ErrorCode	_workRename(PayloadHeader *payload);
 	ErrorCode	_workCalcFileCRC32(PayloadHeader *payload);
 
+	enum class StreamResult : uint8_t {
+		Sent,		///< a packet was sent, the budget allows more
+		Stalled,	///< the read-ahead has no data yet, nothing was sent
+		BufferFull	///< a packet was sent, the budget is used up
+	};
+
+	/**
+	 * Send the next burst packet of one session
+	 * @param session session index
+	 * @param max_bytes_to_send remaining TX budget, reduced by the bytes sent
+	 */
+	StreamResult _stream_send(uint8_t session, unsigned &max_bytes_to_send);
+
+	/// Close a session and report its transfer statistics
+	void _close_session(uint8_t session);
+
 	uint8_t _getServerSystemId(void);
 	uint8_t _getServerComponentId(void);
 	uint8_t _getServerChannel(void);
@@ -168,6 +189,74 @@ private:
 	/// @brief Maximum data size in RequestHeader::data
 	static const uint8_t	kMaxDataLength = MAVLINK_MSG_FILE_TRANSFER_PROTOCOL_FIELD_PAYLOAD_LEN - sizeof(PayloadHeader);
 
+	/**
+	 * Read-ahead of a burst download. A work item on a dedicated work queue reads large
+	 * aligned blocks of the file into a ring buffer, which the burst packets are drained
+	 * from at link rate, so storage latency never blocks the mavlink thread.
+	 * The ring is indexed by file offset: [_consume_pos, _fill_pos) is valid data.
+	 */
+	class ReadAhead : public px4::WorkItem
+	{
+	public:
+		ReadAhead();
+		~ReadAhead() override;
+
+		/// @return true if the ring buffer could be allocated
+		bool valid() const { return _buffer != nullptr; }
+
+		/// Start (or continue if the data is still buffered) reading fd from offset
+		void start(int fd, uint32_t file_size, uint32_t offset);
+
+		/// Stop reading, must be called before the file is closed. Does not wait for a read in progress, its result is discarded.
+		void stop();
+
+		/// Stop reading and free the object on the work queue, once a read in progress completed. Does not block.
+		void release();
+
+		/**
+		 * Copy buffered file data
+		 * @param offset file offset, must not be before the previously read one
+		 * @param dst destination
+		 * @param len number of bytes, truncated at the end of the file
+		 * @return number of bytes copied, 0 if the data is not available yet, -1 on read error (errno set)
+		 */
+		int read(uint32_t offset, uint8_t *dst, unsigned len);
+
+		/// Fill the ring buffer as far as possible (blocking storage reads, done without holding the lock)
+		void fill();
+
+		unsigned stalls() const { return _stalls; }
+
+	private:
+		void Run() override;
+
+#if defined(__PX4_NUTTX)
+		static constexpr uint32_t BLOCK_SIZE = 1024;
+		static constexpr uint32_t BUFFER_SIZE = 4 * BLOCK_SIZE;
+#else
+		static constexpr uint32_t BLOCK_SIZE = 4096;
+		static constexpr uint32_t BUFFER_SIZE = 8 * BLOCK_SIZE;
+#endif
+
+		uint8_t *_buffer{nullptr};
+		pthread_mutex_t _mutex{};	///< protects _fd, _file_size and _generation, never held during storage I/O
+
+		int _fd{-1};
+		uint32_t _file_size{0};
+		uint32_t _generation{0};		///< incremented on stop and restart, a read of an older generation is discarded
+
+		px4::atomic<uint32_t> _fill_pos{0};	///< file offset up to which data is buffered (written by the worker)
+		px4::atomic<uint32_t> _consume_pos{0};	///< file offset from which data is still needed (written by the reader)
+		px4::atomic_int _errno{0};		///< errno of a failed read, 0 if ok
+		px4::atomic_bool _released{false};	///< set by release(), the object is deleted by the next Run()
+
+		unsigned _stalls{0};			///< number of packets delayed because the data was not read yet
+
+		perf_counter_t _read_perf{perf_alloc(PC_ELAPSED, MODULE_NAME": ftp read")};
+	};
+
+	static constexpr uint8_t kMaxSessions = 4;	///< Number of concurrently open sessions
+
 	struct SessionInfo {
 		int		fd;
 		uint32_t	file_size;
@@ -177,8 +266,19 @@ private:
 		uint8_t		stream_target_system_id;
 		uint8_t         stream_target_component_id;
 		unsigned	stream_chunk_transmitted;
+		ReadAhead	*read_ahead;		///< allocated with the first burst of the session
+		hrt_abstime	last_access;		///< timestamp of the last request or burst packet
+		hrt_abstime	stream_start;		///< timestamp of the first burst packet
+		uint32_t	stream_bytes;		///< total bytes sent in bursts
 	};
-	struct SessionInfo _session_info {};	///< Session info, fd=-1 for no active session
+	struct SessionInfo _session_info[kMaxSessions] {};	///< Session info, fd=-1 for no active session
+	uint8_t _stream_next_session{0};	///< session the next burst packet is sent from (round robin)
+
+	/// @return session info of an open session, nullptr if session is invalid or not open
+	SessionInfo *_get_session(uint8_t session)
+	{
+		return (session < kMaxSessions && _session_info[session].fd >= 0) ? &_session_info[session] : nullptr;
+	}
 
 	ReceiveMessageFunc_t	_utRcvMsgFunc{};	///< Unit test override for mavlink message sending
 	void			*_worker_data{nullptr};	///< Additional parameter to _utRcvMsgFunc;
@@ -36,6 +36,8 @@
 
 #include "mavlink_log_handler.h"
 #include "mavlink_main.h"
+#include <stdlib.h>
+#include <string.h>
 #include <sys/stat.h>
 #include <time.h>
 #include <systemlib/err.h>
@@ -88,6 +90,7 @@ MavlinkLogHandler::MavlinkLogHandler(Mavlink *mavlink)
 MavlinkLogHandler::~MavlinkLogHandler()
 {
 	_close_and_unlink_files();
+	_free_entries();
 }
 
 //-------------------------------------------------------------------
@@ -327,6 +330,10 @@ void MavlinkLogHandler::_close_and_unlink_files()
 		_reset_list_helper();
 	}
 
+	delete[] _read_ahead;
+	_read_ahead = nullptr;
+	_read_ahead_len = 0;
+
 	// Remove log data files (if any)
 	unlink(kLogData);
 	unlink(kTmpData);
@@ -336,33 +343,30 @@ void MavlinkLogHandler::_close_and_unlink_files()
 bool
 MavlinkLogHandler::_get_entry(int idx, uint32_t &size, uint32_t &date, char *filename, int filename_len)
 {
-	//-- Find log file in log list file created during init()
+	//-- Look up the log in the catalog created during init()
 	size = 0;
 	date = 0;
+
+	if (idx < 0 || idx >= _log_count || _log_entries == nullptr) {
+		return false;
+	}
+
+	const LogEntry &entry = _log_entries[idx];
+	size = entry.size;
+	date = entry.date;
+
+	if (!filename || filename_len <= 0) {
+		return true;
+	}
+
+	//-- The path is only needed to start a download, fetch it directly from its offset in the list file
 	bool result = false;
-	//-- Open list of log files
 	FILE *f = ::fopen(kLogData, "r");
 
 	if (f) {
-		//--- Find requested entry
-		char line[160];
-		int count = 0;
-
-		while (fgets(line, sizeof(line), f)) {
-			//-- Found our "index"
-			if (count++ == idx) {
-				char file[160];
-
-				if (sscanf(line, "%u %u %s", &date, &size, file) == 3) {
-					if (filename && filename_len > 0) {
-						strncpy(filename, file, filename_len);
-						filename[filename_len - 1] = 0; // ensure null-termination
-					}
-
-					result = true;
-					break;
-				}
-			}
+		if (fseek(f, entry.path_offset, SEEK_SET) == 0 && fgets(filename, filename_len, f)) {
+			filename[strcspn(filename, "\n")] = 0;
+			result = filename[0] != 0;
 		}
 
 		fclose(f);
@@ -371,6 +375,59 @@ MavlinkLogHandler::_get_entry(int idx, uint32_t &size, uint32_t &date, char *fil
 	return result;
 }
 
+//-------------------------------------------------------------------
+bool
+MavlinkLogHandler::_add_entry(uint32_t date, uint32_t size, uint32_t path_offset)
+{
+	if (_log_count >= _log_entries_capacity) {
+		const int capacity = (_log_entries_capacity > 0) ? _log_entries_capacity * 2 : 64;
+		LogEntry *entries = (LogEntry *)realloc(_log_entries, capacity * sizeof(LogEntry));
+
+		if (entries == nullptr) {
+			PX4LOG_WARN("MavlinkLogHandler::add_entry out of memory for %d logs", capacity);
+			return false;
+		}
+
+		_log_entries = entries;
+		_log_entries_capacity = capacity;
+	}
+
+	LogEntry &entry = _log_entries[_log_count++];
+	entry.date = date;
+	entry.size = size;
+	entry.path_offset = path_offset;
+	return true;
+}
+
+//-------------------------------------------------------------------
+void
+MavlinkLogHandler::_sort_entries()
+{
+	if (_log_count > 1) {
+		qsort(_log_entries, _log_count, sizeof(LogEntry), [](const void *a, const void *b) {
+			const LogEntry *ea = (const LogEntry *)a;
+			const LogEntry *eb = (const LogEntry *)b;
+
+			//-- Oldest first, logs of the same time keep the order they were found in
+			if (ea->date != eb->date) {
+				return (ea->date < eb->date) ? -1 : 1;
+			}
+
+			return (ea->path_offset < eb->path_offset) ? -1 : ((ea->path_offset > eb->path_offset) ? 1 : 0);
+		});
+	}
+}
+
+//-------------------------------------------------------------------
+void
+MavlinkLogHandler::_free_entries()
+{
+	free(_log_entries);
+	_log_entries = nullptr;
+	_log_entries_capacity = 0;
+	_log_count = 0;
+}
+
 //-------------------------------------------------------------------
 bool
 MavlinkLogHandler::_open_for_transmit()
@@ -380,6 +437,7 @@ MavlinkLogHandler::_open_for_transmit()
 		_current_log_filep = nullptr;
 	}
 
+	_read_ahead_len = 0;
 	_current_log_filep = ::fopen(_current_log_filename, "rb");
 
 	if (!_current_log_filep) {
@@ -403,16 +461,40 @@ MavlinkLogHandler::_get_log_data(uint8_t len, uint8_t *buffer)
 		return 0;
 	}
 
+	if (_read_ahead == nullptr) {
+		_read_ahead = new uint8_t[READ_AHEAD_SIZE];
+		_read_ahead_len = 0;
+	}
+
+	//-- Serve sequential requests from the read-ahead buffer
+	if (_read_ahead && _read_ahead_len > 0
+	    && _current_log_data_offset >= _read_ahead_offset
+	    && _current_log_data_offset + len <= _read_ahead_offset + _read_ahead_len) {
+
+		memcpy(buffer, &_read_ahead[_current_log_data_offset - _read_ahead_offset], len);
+		return len;
+	}
+
 	long int offset = _current_log_data_offset - ftell(_current_log_filep);
 
 	if (offset && fseek(_current_log_filep, offset, SEEK_CUR)) {
 		fclose(_current_log_filep);
 		_current_log_filep = nullptr;
+		_read_ahead_len = 0;
 		PX4LOG_WARN("MavlinkLogHandler::get_log_data Seek error in %s", _current_log_filename);
 		return 0;
 	}
 
-	size_t result = fread(buffer, 1, len, _current_log_filep);
+	if (_read_ahead == nullptr) {
+		return fread(buffer, 1, len, _current_log_filep);
+	}
+
+	//-- Refill the buffer with one read for the following packets
+	_read_ahead_offset = _current_log_data_offset;
+	_read_ahead_len = fread(_read_ahead, 1, READ_AHEAD_SIZE, _current_log_filep);
+
+	size_t result = (len < _read_ahead_len) ? len : _read_ahead_len;
+	memcpy(buffer, _read_ahead, result);
 	return result;
 }
 
@@ -428,6 +510,7 @@ MavlinkLogHandler::_reset_list_helper()
 	_current_log_data_offset = 0;
 	_current_log_data_remaining = 0;
 	_current_log_filep = nullptr;
+	_read_ahead_len = 0;
 }
 
 void
@@ -436,8 +519,9 @@ MavlinkLogHandler::_init_list_helper()
 	/*
 
 		When this helper is created, it scans the log directory
-		and collects all log files found into one file for easy,
-		subsequent access.
+		and collects all log files found into an in-memory catalog
+		(date, size) sorted by date. The file paths go into one
+		file, the catalog keeps their offset for direct access.
 	*/
 
 	_current_log_filename[0] = 0;
@@ -487,6 +571,8 @@ MavlinkLogHandler::_init_list_helper()
 		PX4LOG_WARN("MavlinkLogHandler::init Error renaming %s", kTmpData);
 		_log_count = 0;
 	}
+
+	_sort_entries();
 }
 
 //-------------------------------------------------------------------
@@ -535,9 +621,12 @@ MavlinkLogHandler::_scan_logs(FILE *f, const char *dir, time_t &date)
 
 				if (path_is_ok) {
 					if (_get_log_time_size(log_file_path, result->d_name, ldate, size)) {
-						//-- Write result->out to list file
-						fprintf(f, "%u %u %s\n", (unsigned)ldate, (unsigned)size, log_file_path);
-						_log_count++;
+						//-- Write path to list file and add the log to the catalog
+						const long path_offset = ftell(f);
+
+						if (path_offset >= 0 && _add_entry(ldate, size, path_offset)) {
+							fprintf(f, "%s\n", log_file_path);
+						}
 					}
 				}
 			}
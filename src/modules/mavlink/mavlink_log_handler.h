@@ -82,6 +82,9 @@ private:
 	bool _get_session_date(const char *path, const char *dir, time_t &date);
 	void _scan_logs(FILE *f, const char *dir, time_t &date);
 	bool _get_log_time_size(const char *path, const char *file, time_t &date, uint32_t &size);
+	bool _add_entry(uint32_t date, uint32_t size, uint32_t path_offset);
+	void _sort_entries();
+	void _free_entries();
 	static void _delete_all(const char *dir);
 	bool _get_entry(int idx, uint32_t &size, uint32_t &date, char *filename = 0, int filename_len = 0);
 	bool _open_for_transmit();
@@ -94,6 +97,22 @@ private:
 	LogHandlerState _current_status{LogHandlerState::Inactive};
 	Mavlink *_mavlink;
 
+	// Catalog entry of one log file, the path is kept in the list file to save RAM
+	struct LogEntry {
+		uint32_t date;
+		uint32_t size;
+		uint32_t path_offset;	///< offset of the file path in the list file
+	};
+
+	LogEntry   *_log_entries{nullptr};	///< catalog sorted by date, built once per listing session
+	int         _log_entries_capacity{0};
+
+	// Read-ahead buffer for sequential LOG_DATA transfer, filled with one read for many packets
+	static constexpr uint32_t READ_AHEAD_SIZE{4096};
+	uint8_t    *_read_ahead{nullptr};
+	uint32_t    _read_ahead_offset{0};	///< log file offset of the buffer start
+	uint32_t    _read_ahead_len{0};	///< number of valid bytes in the buffer
+
 	int         _next_entry{0};
 	int         _last_entry{0};
 	int         _log_count{0};
@@ -48,6 +48,8 @@
 #include <netutils/netlib.h>
 #endif
 
+#include <px4_platform_common/boot_profile.h>
+
 #include <lib/ecl/geo/geo.h>
 #include <lib/mathlib/mathlib.h>
 #include <lib/systemlib/mavlink_log.h>
@@ -1248,6 +1250,8 @@ Mavlink::configure_stream(const char *stream_name, const float rate)
 
 	for (const auto &stream : _streams) {
 		if (strcmp(stream_name, stream->get_name()) == 0) {
+			_stream_scheduler.invalidate();
+
 			if (interval != 0) {
 				/* set new interval */
 				stream->set_interval(interval);
@@ -1269,6 +1273,7 @@ Mavlink::configure_stream(const char *stream_name, const float rate)
 	if (stream != nullptr) {
 		stream->set_interval(interval);
 		_streams.add(stream);
+		_stream_scheduler.invalidate();
 
 		return OK;
 	}
@@ -1456,6 +1461,69 @@ Mavlink::close_shell()
 	}
 }
 
+void
+Mavlink::update_streams(const hrt_abstime &t)
+{
+	/* the intervals depend on the rate mult, reorder if it changed noticeably */
+	if (fabsf(_rate_mult - _stream_scheduler_rate_mult) > 0.05f * _stream_scheduler_rate_mult) {
+		_stream_scheduler.invalidate();
+	}
+
+	if (!_stream_scheduler.valid()) {
+		if (!_stream_scheduler.rebuild(_streams, t)) {
+			PX4_ERR("stream scheduler alloc failed");
+			return;
+		}
+
+		_stream_scheduler_rate_mult = _rate_mult;
+	}
+
+	/* refill the byte budget at the link data rate, but never beyond what the link can buffer */
+	if (_stream_tx_budget_last != 0 && t > _stream_tx_budget_last) {
+		_stream_tx_budget += _datarate * ((t - _stream_tx_budget_last) * 1e-6f);
+	}
+
+	_stream_tx_budget_last = t;
+	_stream_tx_budget = math::min(_stream_tx_budget, (float)math::max(get_free_tx_buf(), (unsigned)MAVLINK_MAX_PACKET_LEN));
+
+	/* only visit the streams which are due, earliest deadline first */
+	bool sent_any = false;
+	MavlinkStream *stream = nullptr;
+
+	while ((stream = _stream_scheduler.pop_due(t)) != nullptr) {
+
+		/* spread sends over the loop iterations instead of bursting them, defer the rest (at least one goes out) */
+		if (sent_any && (stream->get_size() > _stream_tx_budget)) {
+			continue;
+		}
+
+		const unsigned bytes_tx_before = _bytes_tx;
+
+		stream->update(t);
+
+		if (_bytes_tx != bytes_tx_before) {
+			_stream_tx_budget -= _bytes_tx - bytes_tx_before;
+			sent_any = true;
+		}
+
+		if (!_first_heartbeat_sent) {
+			if (_mode == MAVLINK_MODE_IRIDIUM) {
+				if (stream->get_id() == MAVLINK_MSG_ID_HIGH_LATENCY2) {
+					_first_heartbeat_sent = stream->first_message_sent();
+				}
+
+			} else {
+				if (stream->get_id() == MAVLINK_MSG_ID_HEARTBEAT) {
+					_first_heartbeat_sent = stream->first_message_sent();
+				}
+			}
+		}
+	}
+
+	/* streams still due (polled or deferred) are visited again on the next regular iteration */
+	_stream_scheduler.reschedule_popped(t, _main_loop_delay);
+}
+
 void
 Mavlink::update_rate_mult()
 {
@@ -2231,8 +2299,20 @@ Mavlink::task_main(int argc, char *argv[])
 	_mavlink_start_time = hrt_absolute_time();
 
 	while (!_task_should_exit) {
-		/* main loop */
-		px4_usleep(_main_loop_delay);
+		/* main loop, wake up early if a stream deadline comes before the regular loop delay */
+		unsigned sleep_interval = _main_loop_delay;
+
+		if (_stream_scheduler.valid()) {
+			const hrt_abstime now = hrt_absolute_time();
+			const hrt_abstime next_deadline = _stream_scheduler.next_deadline();
+
+			if (next_deadline < now + sleep_interval) {
+				sleep_interval = (next_deadline > now) ? (next_deadline - now) : 0;
+				sleep_interval = math::max(sleep_interval, (unsigned)MAVLINK_MIN_INTERVAL);
+			}
+		}
+
+		px4_usleep(sleep_interval);
 
 		if (!should_transmit()) {
 			check_requested_subscriptions();
@@ -2376,22 +2456,7 @@ Mavlink::task_main(int argc, char *argv[])
 		check_requested_subscriptions();
 
 		/* update streams */
-		for (const auto &stream : _streams) {
-			stream->update(t);
-
-			if (!_first_heartbeat_sent) {
-				if (_mode == MAVLINK_MODE_IRIDIUM) {
-					if (stream->get_id() == MAVLINK_MSG_ID_HIGH_LATENCY2) {
-						_first_heartbeat_sent = stream->first_message_sent();
-					}
-
-				} else {
-					if (stream->get_id() == MAVLINK_MSG_ID_HEARTBEAT) {
-						_first_heartbeat_sent = stream->first_message_sent();
-					}
-				}
-			}
-		}
+		update_streams(t);
 
 		/* check for ulog streaming messages */
 		if (_mavlink_ulog) {
@@ -2498,6 +2563,7 @@ Mavlink::task_main(int argc, char *argv[])
 	_subscribe_to_stream = nullptr;
 
 	/* delete streams */
+	_stream_scheduler.invalidate();
 	_streams.clear();
 
 	if (_uart_fd >= 0 && !_is_usb_uart) {
@@ -3001,6 +3067,9 @@ Mavlink::set_boot_complete()
 {
 	_boot_complete = true;
 
+	/* called at the end of rcS */
+	px4_boot_profile_complete();
+
 #if defined(MAVLINK_UDP)
 	Mavlink *inst;
 	LL_FOREACH(::_mavlink_instances, inst) {
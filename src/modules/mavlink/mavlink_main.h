@@ -77,6 +77,7 @@
 #include "mavlink_command_sender.h"
 #include "mavlink_messages.h"
 #include "mavlink_shell.h"
+#include "mavlink_stream_scheduler.h"
 #include "mavlink_ulog.h"
 
 #define DEFAULT_BAUD_RATE       57600
@@ -550,6 +551,10 @@ private:
 	unsigned		_main_loop_delay{1000};	/**< mainloop delay, depends on data rate */
 
 	List<MavlinkStream *>		_streams;
+	MavlinkStreamScheduler		_stream_scheduler;	/**< streams ordered by next deadline */
+	float			_stream_scheduler_rate_mult{1.0f};	/**< rate mult the schedule was built with */
+	float			_stream_tx_budget{0.0f};	/**< bytes the streams may still send, refilled at _datarate */
+	hrt_abstime		_stream_tx_budget_last{0};
 
 	MavlinkShell		*_mavlink_shell{nullptr};
 	MavlinkULog		*_mavlink_ulog{nullptr};
@@ -727,6 +732,11 @@ private:
 	 */
 	void update_rate_mult();
 
+	/**
+	 * Update the streams that are due at t, in order of their deadline and within the link byte budget.
+	 */
+	void update_streams(const hrt_abstime &t);
+
 #if defined(MAVLINK_UDP)
 	void find_broadcast_address();
 
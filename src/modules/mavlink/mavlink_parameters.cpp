@@ -44,6 +44,7 @@
 
 #include "mavlink_parameters.h"
 #include "mavlink_main.h"
+#include <lib/mathlib/mathlib.h>
 #include <lib/systemlib/mavlink_log.h>
 
 MavlinkParametersManager::MavlinkParametersManager(Mavlink *mavlink) :
@@ -68,13 +69,8 @@ MavlinkParametersManager::handle_message(const mavlink_message_t *msg)
 
 			if (req_list.target_system == mavlink_system.sysid &&
 			    (req_list.target_component == mavlink_system.compid || req_list.target_component == MAV_COMP_ID_ALL)) {
-				if (_send_all_index < 0) {
-					_send_all_index = PARAM_HASH;
-
-				} else {
-					/* a restart should skip the hash check on the ground */
-					_send_all_index = 0;
-				}
+				/* a restart should skip the hash check on the ground */
+				start_send_all(_send_all_index < 0);
 			}
 
 			if (req_list.target_system == mavlink_system.sysid && req_list.target_component < 127 &&
@@ -316,37 +312,51 @@ MavlinkParametersManager::send()
 		_first_send = true;
 	}
 
-	int max_num_to_send;
+	// refill the byte budget at the link data rate, but never beyond what the link can buffer
+	const hrt_abstime now = hrt_absolute_time();
 
-	if (_mavlink->get_protocol() == Protocol::SERIAL && !_mavlink->is_usb_uart()) {
-		max_num_to_send = 3;
-
-	} else {
-		// speed up parameter loading via UDP or USB: try to send 20 at once
-		max_num_to_send = 20;
+	if (_send_budget_last != 0) {
+		_send_budget += _mavlink->get_data_rate() * ((now - _send_budget_last) * 1e-6f);
 	}
 
-	int i = 0;
+	_send_budget_last = now;
+	_send_budget = math::min(_send_budget, (float)math::max(_mavlink->get_free_tx_buf(), get_size()));
+
+	// always allow at least one message so slow links still make progress
+	const unsigned max_num_to_send = math::max((unsigned)(_send_budget / get_size()), 1u);
+	unsigned num_sent = 0;
+
+	// Send while the budget is not exceeded, we still have buffer space and still something to send
+	while ((num_sent < max_num_to_send) && (_mavlink->get_free_tx_buf() >= get_size())) {
+		const unsigned sent = send_params(max_num_to_send - num_sent);
+
+		if (sent == 0) {
+			break;
+		}
+
+		num_sent += sent;
+	}
 
-	// Send while burst is not exceeded, we still have buffer space and still something to send
-	while ((i++ < max_num_to_send) && (_mavlink->get_free_tx_buf() >= get_size()) && send_params()) {}
+	_send_budget = math::max(_send_budget - num_sent * get_size(), 0.f);
 }
 
-bool
-MavlinkParametersManager::send_params()
+unsigned
+MavlinkParametersManager::send_params(unsigned max_num)
 {
 	if (send_uavcan()) {
-		return true;
+		return 1;
+	}
 
-	} else if (send_one()) {
-		return true;
+	const unsigned sent = send_all(max_num);
 
-	} else if (send_untransmitted()) {
-		return true;
+	if (sent > 0) {
+		return sent;
 
-	} else {
-		return false;
+	} else if (send_untransmitted()) {
+		return 1;
 	}
+
+	return 0;
 }
 
 bool
@@ -458,58 +468,108 @@ MavlinkParametersManager::send_uavcan()
 	return false;
 }
 
-bool
-MavlinkParametersManager::send_one()
+void
+MavlinkParametersManager::start_send_all(bool send_hash)
 {
-	if (_send_all_index >= 0) {
-		/* send all parameters if requested, but only after the system has booted */
+	const unsigned count = param_count_used();
 
-		/* The first thing we send is a hash of all values for the ground
-		 * station to try and quickly load a cached copy of our params
-		 */
-		if (_send_all_index == PARAM_HASH) {
-			/* return hash check for cached params */
-			uint32_t hash = param_hash_check();
-
-			/* build the one-off response message */
-			mavlink_param_value_t msg;
-			msg.param_count = param_count_used();
-			msg.param_index = -1;
-			strncpy(msg.param_id, HASH_PARAM, MAVLINK_MSG_PARAM_VALUE_FIELD_PARAM_ID_LEN);
-			msg.param_type = MAV_PARAM_TYPE_UINT32;
-			memcpy(&msg.param_value, &hash, sizeof(hash));
-			mavlink_msg_param_value_send_struct(_mavlink->get_channel(), &msg);
-
-			/* after this we should start sending all params */
-			_send_all_index = 0;
-
-			/* No further action, return now */
-			return true;
+	if (count > _send_all_list_capacity) {
+		delete[] _send_all_list;
+		_send_all_list = new param_t[count];
+		_send_all_list_capacity = (_send_all_list != nullptr) ? count : 0;
+	}
+
+	// walk the table once instead of skipping unused parameters on every send
+	_send_all_list_size = 0;
+
+	for (param_t p = param_for_index(0); (p != PARAM_INVALID) && (_send_all_list_size < _send_all_list_capacity);
+	     p = param_for_index(p + 1)) {
+		if (param_used(p)) {
+			_send_all_list[_send_all_list_size++] = p;
 		}
+	}
 
-		/* look for the first parameter which is used */
-		param_t p;
+	_send_all_index = send_hash ? PARAM_HASH : 0;
+}
 
-		do {
-			/* walk through all parameters, including unused ones */
-			p = param_for_index(_send_all_index);
-			_send_all_index++;
-		} while (p != PARAM_INVALID && !param_used(p));
+unsigned
+MavlinkParametersManager::send_all(unsigned max_num)
+{
+	if (_send_all_index < 0 || max_num == 0) {
+		return 0;
+	}
 
-		if (p != PARAM_INVALID) {
-			send_param(p);
-		}
+	/* send all parameters if requested, but only after the system has booted */
 
-		if ((p == PARAM_INVALID) || (_send_all_index >= (int) param_count())) {
-			_send_all_index = -1;
-			return false;
+	/* The first thing we send is a hash of all values for the ground
+	 * station to try and quickly load a cached copy of our params
+	 */
+	if (_send_all_index == PARAM_HASH) {
+		/* return hash check for cached params */
+		uint32_t hash = param_hash_check();
+
+		/* build the one-off response message */
+		mavlink_param_value_t msg;
+		msg.param_count = _send_all_list_size;
+		msg.param_index = -1;
+		strncpy(msg.param_id, HASH_PARAM, MAVLINK_MSG_PARAM_VALUE_FIELD_PARAM_ID_LEN);
+		msg.param_type = MAV_PARAM_TYPE_UINT32;
+		memcpy(&msg.param_value, &hash, sizeof(hash));
+		mavlink_msg_param_value_send_struct(_mavlink->get_channel(), &msg);
 
-		} else {
-			return true;
-		}
+		/* after this we should start sending all params */
+		_send_all_index = 0;
+
+		/* No further action, return now */
+		return 1;
 	}
 
-	return false;
+	// fetch the values of the whole batch with a single lock of the parameter store
+	static constexpr unsigned BATCH_SIZE = 16;
+	union param_value_u values[BATCH_SIZE];
+
+	const unsigned index = _send_all_index;
+	const unsigned remaining = (index < _send_all_list_size) ? (_send_all_list_size - index) : 0;
+	const unsigned num = math::min(math::min(max_num, remaining), BATCH_SIZE);
+	const unsigned num_values = param_get_multiple(&_send_all_list[index], values, num);
+
+	for (unsigned i = 0; i < num_values; i++) {
+		const param_t param = _send_all_list[index + i];
+
+		mavlink_param_value_t msg;
+		memcpy(&msg.param_value, &values[i], sizeof(msg.param_value));
+		msg.param_count = _send_all_list_size;
+		msg.param_index = index + i;
+
+#if defined(__GNUC__) && __GNUC__ >= 8
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wstringop-truncation"
+#endif
+		/*
+		 * coverity[buffer_size_warning : FALSE]
+		 *
+		 * The MAVLink spec does not require the string to be NUL-terminated if it
+		 * has length 16. In this case the receiving end needs to terminate it
+		 * when copying it.
+		 */
+		strncpy(msg.param_id, param_name(param), MAVLINK_MSG_PARAM_VALUE_FIELD_PARAM_ID_LEN);
+#if defined(__GNUC__) && __GNUC__ >= 8
+#pragma GCC diagnostic pop
+#endif
+
+		msg.param_type = (param_type(param) == PARAM_TYPE_INT32) ? MAVLINK_TYPE_INT32_T : MAVLINK_TYPE_FLOAT;
+
+		mavlink_msg_param_value_send_struct(_mavlink->get_channel(), &msg);
+	}
+
+	// step over a handle that could not be read instead of retrying it forever
+	_send_all_index = index + math::max(num_values, (num > 0) ? 1u : 0u);
+
+	if ((unsigned)_send_all_index >= _send_all_list_size) {
+		_send_all_index = -1;
+	}
+
+	return num_values;
 }
 
 int
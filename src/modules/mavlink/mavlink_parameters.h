@@ -59,7 +59,7 @@ class MavlinkParametersManager
 {
 public:
 	explicit MavlinkParametersManager(Mavlink *mavlink);
-	~MavlinkParametersManager() = default;
+	~MavlinkParametersManager() { delete[] _send_all_list; }
 
 	/**
 	 * Handle sending of messages. Call this regularly at a fixed frequency.
@@ -79,14 +79,23 @@ private:
 	MavlinkParametersManager &operator = (const MavlinkParametersManager &);
 
 protected:
-	/// send a single param if a PARAM_REQUEST_LIST is in progress
-	/// @return true if a parameter was sent
-	bool send_one();
+	/**
+	 * Start a PARAM_REQUEST_LIST transfer: snapshot the handles of all used parameters
+	 * @param send_hash true to send the parameter hash first
+	 */
+	void start_send_all(bool send_hash);
+
+	/// send a batch of params if a PARAM_REQUEST_LIST is in progress
+	/// @param max_num maximum number of messages to send
+	/// @return number of messages sent
+	unsigned send_all(unsigned max_num);
 
 	/**
 	 * Handle any open param send transfer
+	 * @param max_num maximum number of messages to send
+	 * @return number of messages sent
 	 */
-	bool send_params();
+	unsigned send_params(unsigned max_num);
 
 	/**
 	 * Send UAVCAN params
@@ -151,6 +160,13 @@ protected:
 	hrt_abstime _param_update_time{0};
 	int _param_update_index{0};
 
+	param_t *_send_all_list{nullptr};		///< used parameters of the PARAM_REQUEST_LIST transfer in progress
+	unsigned _send_all_list_size{0};
+	unsigned _send_all_list_capacity{0};
+
+	float _send_budget{0.f};			///< bytes the parameter transfer may still send, refilled at the link data rate
+	hrt_abstime _send_budget_last{0};
+
 	Mavlink *_mavlink;
 
 	bool _first_send{false};
@@ -128,3 +128,30 @@ MavlinkStream::update(const hrt_abstime &t)
 
 	return -1;
 }
+
+hrt_abstime
+MavlinkStream::get_next_due(const hrt_abstime &t)
+{
+	if (_last_sent == 0 || update_data_every_iteration()) {
+		return t;
+	}
+
+	int interval = _interval;
+
+	if (!const_rate()) {
+		interval /= _mavlink->get_rate_mult();
+	}
+
+	if (interval == 0) {
+		return UINT64_MAX;
+
+	} else if (interval < 0) {
+		return t;
+	}
+
+	// same early send margin as in update()
+	const int64_t margin = (_mavlink->get_main_loop_delay() / 10) * 3;
+	const int64_t due = (int64_t)_last_sent + interval - margin + 1;
+
+	return (due > (int64_t)t) ? (hrt_abstime)due : t;
+}
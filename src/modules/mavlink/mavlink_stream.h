@@ -79,6 +79,19 @@ public:
 	 * @return 0 if updated / sent, -1 if unchanged
 	 */
 	int update(const hrt_abstime &t);
+
+	/**
+	 * Get the earliest time at which update() can send the next message
+	 *
+	 * Mirrors the send condition of update(). Streams that have to be polled
+	 * (unlimited rate, never sent, or with per iteration update_data()) are
+	 * due immediately, disabled streams (interval 0) are never due.
+	 *
+	 * @param t current time
+	 * @return absolute time in microseconds (us), t if due now
+	 */
+	hrt_abstime get_next_due(const hrt_abstime &t);
+
 	virtual const char *get_name() const = 0;
 	virtual uint16_t get_id() = 0;
 
@@ -87,6 +100,11 @@ public:
 	 */
 	virtual bool const_rate() { return false; }
 
+	/**
+	 * @return true if update_data() has to be called on every iteration of the main loop
+	 */
+	virtual bool update_data_every_iteration() const { return false; }
+
 	/**
 	 * Get maximal total messages size on update
 	 */
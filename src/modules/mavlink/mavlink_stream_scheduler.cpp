@@ -0,0 +1,161 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file mavlink_stream_scheduler.cpp
+ * Deadline ordered scheduling of the streams of a mavlink instance.
+ */
+
+#include "mavlink_stream_scheduler.h"
+
+bool
+MavlinkStreamScheduler::rebuild(List<MavlinkStream *> &streams, const hrt_abstime &t)
+{
+	const unsigned n = streams.size();
+
+	if (n > _capacity) {
+		delete[] _heap;
+		_heap = new Entry[n];
+
+		if (_heap == nullptr) {
+			_capacity = 0;
+			_count = 0;
+			_popped = 0;
+			_valid = false;
+			return false;
+		}
+
+		_capacity = n;
+	}
+
+	_count = 0;
+	_popped = 0;
+
+	for (const auto &stream : streams) {
+		_heap[_count].due = stream->get_next_due(t);
+		_heap[_count].stream = stream;
+		_count++;
+	}
+
+	// heapify
+	for (unsigned i = _count / 2; i > 0; i--) {
+		sift_down(i - 1);
+	}
+
+	_valid = true;
+	return true;
+}
+
+MavlinkStream *
+MavlinkStreamScheduler::pop_due(const hrt_abstime &t)
+{
+	if (_count == 0 || _heap[0].due > t) {
+		return nullptr;
+	}
+
+	// move the root behind the heap into the popped area
+	_count--;
+	const Entry root = _heap[0];
+	_heap[0] = _heap[_count];
+	_heap[_count] = root;
+	_popped++;
+
+	if (_count > 1) {
+		sift_down(0);
+	}
+
+	return root.stream;
+}
+
+void
+MavlinkStreamScheduler::reschedule_popped(const hrt_abstime &t, const hrt_abstime &poll_interval)
+{
+	while (_popped > 0) {
+		Entry &entry = _heap[_count];
+		entry.due = entry.stream->get_next_due(t);
+
+		if (entry.due <= t) {
+			entry.due = t + poll_interval;
+		}
+
+		_popped--;
+		_count++;
+		sift_up(_count - 1);
+	}
+}
+
+void
+MavlinkStreamScheduler::sift_up(unsigned index)
+{
+	const Entry entry = _heap[index];
+
+	while (index > 0) {
+		const unsigned parent = (index - 1) / 2;
+
+		if (_heap[parent].due <= entry.due) {
+			break;
+		}
+
+		_heap[index] = _heap[parent];
+		index = parent;
+	}
+
+	_heap[index] = entry;
+}
+
+void
+MavlinkStreamScheduler::sift_down(unsigned index)
+{
+	const Entry entry = _heap[index];
+
+	for (;;) {
+		unsigned child = 2 * index + 1;
+
+		if (child >= _count) {
+			break;
+		}
+
+		if ((child + 1 < _count) && (_heap[child + 1].due < _heap[child].due)) {
+			child++;
+		}
+
+		if (entry.due <= _heap[child].due) {
+			break;
+		}
+
+		_heap[index] = _heap[child];
+		index = child;
+	}
+
+	_heap[index] = entry;
+}
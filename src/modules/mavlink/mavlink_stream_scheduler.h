@@ -0,0 +1,124 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file mavlink_stream_scheduler.h
+ * Deadline ordered scheduling of the streams of a mavlink instance.
+ *
+ * The streams are kept in a binary min-heap keyed by the time at which they
+ * can send next, so that the main loop only touches streams that are due and
+ * knows how long it can sleep until the next one is.
+ */
+
+#pragma once
+
+#include <drivers/drv_hrt.h>
+#include <containers/List.hpp>
+
+#include "mavlink_stream.h"
+
+class MavlinkStreamScheduler
+{
+public:
+	MavlinkStreamScheduler() = default;
+	~MavlinkStreamScheduler() { delete[] _heap; }
+
+	// no copy, assignment, move, move assignment
+	MavlinkStreamScheduler(const MavlinkStreamScheduler &) = delete;
+	MavlinkStreamScheduler &operator=(const MavlinkStreamScheduler &) = delete;
+	MavlinkStreamScheduler(MavlinkStreamScheduler &&) = delete;
+	MavlinkStreamScheduler &operator=(MavlinkStreamScheduler &&) = delete;
+
+	/**
+	 * Mark the schedule as stale, it has to be rebuilt before the next use.
+	 * Needs to be called whenever streams are added, removed or reconfigured.
+	 */
+	void invalidate() { _valid = false; }
+
+	bool valid() const { return _valid; }
+
+	/**
+	 * Rebuild the heap from the stream list
+	 *
+	 * @param streams streams of the mavlink instance
+	 * @param t current time
+	 * @return false if the heap could not be allocated
+	 */
+	bool rebuild(List<MavlinkStream *> &streams, const hrt_abstime &t);
+
+	/**
+	 * @return time of the earliest deadline, UINT64_MAX if no stream is scheduled
+	 */
+	hrt_abstime next_deadline() const { return (_count > 0) ? _heap[0].due : UINT64_MAX; }
+
+	/**
+	 * Take the earliest stream out of the schedule if it is due
+	 *
+	 * Popped streams are held back until reschedule_popped() so that a stream
+	 * which is still due after its update is not returned twice in one iteration.
+	 *
+	 * @param t current time
+	 * @return stream or nullptr if no stream is due at t
+	 */
+	MavlinkStream *pop_due(const hrt_abstime &t);
+
+	/**
+	 * Put all popped streams back into the schedule
+	 *
+	 * Streams that are still due (polled streams waiting for new data, or
+	 * streams deferred because of the link budget) are checked again after
+	 * poll_interval.
+	 *
+	 * @param t current time
+	 * @param poll_interval interval in microseconds (us) for polled streams
+	 */
+	void reschedule_popped(const hrt_abstime &t, const hrt_abstime &poll_interval);
+
+	unsigned size() const { return _count; }
+
+private:
+	struct Entry {
+		hrt_abstime due;
+		MavlinkStream *stream;
+	};
+
+	void sift_up(unsigned index);
+	void sift_down(unsigned index);
+
+	Entry *_heap{nullptr};
+	unsigned _capacity{0};
+	unsigned _count{0};	///< number of scheduled streams, _heap[0, _count)
+	unsigned _popped{0};	///< number of popped streams, _heap[_count, _count + _popped)
+
+	bool _valid{false};
+};
@@ -54,6 +54,15 @@ static const char *_test_files[] = {
 	PX4_MAVLINK_TEST_DATA_DIR  "/" "test_240.data"
 };
 
+// spans several read-ahead buffers
+static const char *_large_test_file = PX4_MAVLINK_TEST_DATA_DIR "/" "test_large.data";
+static constexpr uint32_t _large_test_file_size = 100000;
+
+static uint8_t large_test_file_byte(uint32_t offset)
+{
+	return (uint8_t)(offset * 7 + (offset >> 8));
+}
+
 const MavlinkFtpTest::DownloadTestCase MavlinkFtpTest::_rgDownloadTestCases[] = {
 	{ _test_files[0], MAVLINK_MSG_FILE_TRANSFER_PROTOCOL_FIELD_PAYLOAD_LEN - sizeof(MavlinkFTP::PayloadHeader) - 1,	true, false },	// Read takes less than single packet
 	{ _test_files[1], MAVLINK_MSG_FILE_TRANSFER_PROTOCOL_FIELD_PAYLOAD_LEN - sizeof(MavlinkFTP::PayloadHeader),	true, true },	// Read completely fills single packet
@@ -119,6 +128,35 @@ bool MavlinkFtpTest::_create_test_files()
 	return !failed;
 }
 
+/// @brief Creates the test file for the read-ahead tests. Not part of the test data directory listed by the
+/// other tests, it is removed with the other test files.
+bool MavlinkFtpTest::_create_large_test_file()
+{
+	static_assert(_large_test_file_size % 1000 == 0, "written in chunks");
+
+	int fd = ::open(_large_test_file, O_CREAT | O_EXCL | O_WRONLY, S_IRWXU | S_IRWXG | S_IRWXO);
+	ut_assert("Open failed", fd != -1);
+
+	bool failed = false;
+	uint8_t chunk[1000];
+
+	for (uint32_t offset = 0; offset < _large_test_file_size; offset += sizeof(chunk)) {
+		for (uint32_t i = 0; i < sizeof(chunk); ++i) {
+			chunk[i] = large_test_file_byte(offset + i);
+		}
+
+		if (::write(fd, chunk, sizeof(chunk)) != sizeof(chunk)) {
+			failed = true;
+		}
+	}
+
+	close(fd);
+
+	ut_assert("Could not write test file", !failed);
+
+	return !failed;
+}
+
 /// @brief Called after every test to take down the FTP Server.
 void MavlinkFtpTest::_cleanup()
 {
@@ -134,6 +172,8 @@ bool MavlinkFtpTest::_remove_test_files()
 		::unlink(_test_files[i]);
 	}
 
+	::unlink(_large_test_file);
+
 	::rmdir(PX4_MAVLINK_TEST_DATA_DIR "/empty_dir");
 	::rmdir(PX4_MAVLINK_TEST_DATA_DIR);
 
@@ -651,6 +691,104 @@ bool MavlinkFtpTest::_burst_test()
 	return true;
 }
 
+/// @brief Tests two burst downloads of the same file that are sent interleaved.
+bool MavlinkFtpTest::_burst_interleaved_test()
+{
+	if (!_create_large_test_file()) {
+		return false;
+	}
+
+	uint8_t *bytes = new uint8_t[_large_test_file_size];
+	ut_assert("new failed", bytes != nullptr);
+
+	for (uint32_t i = 0; i < _large_test_file_size; i++) {
+		bytes[i] = large_test_file_byte(i);
+	}
+
+	StreamInfo stream_info{};
+	stream_info.file_bytes = bytes;
+	stream_info.file_size = _large_test_file_size;
+
+	bool success = _open_session(_large_test_file, stream_info.sessions[0])
+		       && _open_session(_large_test_file, stream_info.sessions[1]);
+
+	if (!success) {
+		delete[] bytes;
+		return false;
+	}
+
+	ut_assert("Sessions not distinct", stream_info.sessions[0] != stream_info.sessions[1]);
+
+	// both bursts are pending before the first packet is sent
+	_ftp_server->set_unittest_worker(MavlinkFtpTest::receive_message_handler_stream, &stream_info);
+	_start_burst(stream_info.sessions[0], 0);
+	_start_burst(stream_info.sessions[1], 0);
+	_ftp_server->send();
+	_ftp_server->set_unittest_worker(MavlinkFtpTest::receive_message_handler_generic, this);
+
+	delete[] bytes;
+
+	ut_compare("Stream data errors", stream_info.errors, 0);
+	ut_assert("Session 0 incomplete", stream_info.eof[0] && stream_info.next_offset[0] == _large_test_file_size);
+	ut_assert("Session 1 incomplete", stream_info.eof[1] && stream_info.next_offset[1] == _large_test_file_size);
+
+	// with round robin both sessions finish at about the same time
+	ut_assert("Sessions not interleaved", stream_info.other_offset_at_eof > _large_test_file_size / 2);
+
+	return _terminate_session(stream_info.sessions[0]) && _terminate_session(stream_info.sessions[1]);
+}
+
+/// @brief Tests burst downloads that seek outside of the read-ahead buffer of the session.
+bool MavlinkFtpTest::_burst_seek_test()
+{
+	if (!_create_large_test_file()) {
+		return false;
+	}
+
+	uint8_t *bytes = new uint8_t[_large_test_file_size];
+	ut_assert("new failed", bytes != nullptr);
+
+	for (uint32_t i = 0; i < _large_test_file_size; i++) {
+		bytes[i] = large_test_file_byte(i);
+	}
+
+	uint8_t session = 0;
+
+	if (!_open_session(_large_test_file, session)) {
+		delete[] bytes;
+		return false;
+	}
+
+	// forward into the middle of a block, then back to the start, which was never buffered or already consumed
+	const uint32_t offsets[] = {_large_test_file_size / 2 + 17, 0, 1};
+	bool complete = true;
+	unsigned errors = 0;
+
+	for (const uint32_t offset : offsets) {
+		StreamInfo stream_info{};
+		stream_info.file_bytes = bytes;
+		stream_info.file_size = _large_test_file_size;
+		stream_info.sessions[0] = session;
+		stream_info.sessions[1] = UINT8_MAX;
+		stream_info.next_offset[0] = offset;
+
+		_ftp_server->set_unittest_worker(MavlinkFtpTest::receive_message_handler_stream, &stream_info);
+		_start_burst(session, offset);
+		_ftp_server->send();
+		_ftp_server->set_unittest_worker(MavlinkFtpTest::receive_message_handler_generic, this);
+
+		errors += stream_info.errors;
+		complete = complete && stream_info.eof[0] && (stream_info.next_offset[0] == _large_test_file_size);
+	}
+
+	delete[] bytes;
+
+	ut_compare("Stream data errors", errors, 0);
+	ut_assert("Burst incomplete", complete);
+
+	return _terminate_session(session);
+}
+
 /// @brief Tests for correct reponse to a Read command on an invalid session.
 bool MavlinkFtpTest::_read_badsession_test()
 {
@@ -925,6 +1063,49 @@ bool MavlinkFtpTest::_receive_message_handler_burst(const mavlink_file_transfer_
 	return true;
 }
 
+/// Static method used as callback from MavlinkFTP for the read-ahead tests. Checks that each session receives
+/// its file in order and without gaps, followed by a Nak EOF.
+void MavlinkFtpTest::receive_message_handler_stream(const mavlink_file_transfer_protocol_t *ftp_req, void *worker_data)
+{
+	StreamInfo *stream_info = (StreamInfo *)worker_data;
+	const MavlinkFTP::PayloadHeader *reply = reinterpret_cast<const MavlinkFTP::PayloadHeader *>(ftp_req->payload);
+
+	int index = -1;
+
+	if (reply->session == stream_info->sessions[0]) {
+		index = 0;
+
+	} else if (reply->session == stream_info->sessions[1]) {
+		index = 1;
+	}
+
+	if ((index < 0) || stream_info->eof[index] || (reply->req_opcode != MavlinkFTP::kCmdBurstReadFile)) {
+		stream_info->errors++;
+		return;
+	}
+
+	if (reply->opcode == MavlinkFTP::kRspNak) {
+		if ((reply->data[0] != MavlinkFTP::kErrEOF) || (stream_info->next_offset[index] != stream_info->file_size)) {
+			stream_info->errors++;
+		}
+
+		if (!stream_info->eof[1 - index]) {
+			stream_info->other_offset_at_eof = stream_info->next_offset[1 - index];
+		}
+
+		stream_info->eof[index] = true;
+		return;
+	}
+
+	if ((reply->opcode != MavlinkFTP::kRspAck) || (reply->offset != stream_info->next_offset[index])
+	    || (reply->offset + reply->size > stream_info->file_size)
+	    || (memcmp(reply->data, &stream_info->file_bytes[reply->offset], reply->size) != 0)) {
+		stream_info->errors++;
+	}
+
+	stream_info->next_offset[index] += reply->size;
+}
+
 /// @brief Decode and validate the incoming message
 bool MavlinkFtpTest::_decode_message(const mavlink_file_transfer_protocol_t	*ftp_msg,	///< Incoming FTP message
 				     const MavlinkFTP::PayloadHeader		**payload)	///< Payload inside FTP message response
@@ -989,6 +1170,59 @@ bool MavlinkFtpTest::_send_receive_msg(MavlinkFTP::PayloadHeader	*payload_header
 	return _decode_message(&_reply_msg, payload_reply);
 }
 
+/// @brief Opens a file read-only and returns the session
+bool MavlinkFtpTest::_open_session(const char *file, uint8_t &session)
+{
+	MavlinkFTP::PayloadHeader	payload{};
+	const MavlinkFTP::PayloadHeader	*reply;
+
+	payload.opcode = MavlinkFTP::kCmdOpenFileRO;
+	payload.offset = 0;
+
+	bool success = _send_receive_msg(&payload, strlen(file) + 1, (const uint8_t *)file, &reply);
+
+	if (!success) {
+		return false;
+	}
+
+	ut_compare("Didn't get Ack back", reply->opcode, MavlinkFTP::kRspAck);
+	session = reply->session;
+	return true;
+}
+
+/// @brief Terminates a session
+bool MavlinkFtpTest::_terminate_session(uint8_t session)
+{
+	MavlinkFTP::PayloadHeader	payload{};
+	const MavlinkFTP::PayloadHeader	*reply;
+
+	payload.opcode = MavlinkFTP::kCmdTerminateSession;
+	payload.session = session;
+
+	bool success = _send_receive_msg(&payload, 0, nullptr, &reply);
+
+	if (!success) {
+		return false;
+	}
+
+	ut_compare("Didn't get Ack back", reply->opcode, MavlinkFTP::kRspAck);
+	return true;
+}
+
+/// @brief Starts a burst download, its packets are sent by MavlinkFTP::send()
+void MavlinkFtpTest::_start_burst(uint8_t session, uint32_t offset)
+{
+	MavlinkFTP::PayloadHeader	payload{};
+	mavlink_message_t		msg;
+
+	payload.opcode = MavlinkFTP::kCmdBurstReadFile;
+	payload.session = session;
+	payload.offset = offset;
+
+	_setup_ftp_msg(&payload, 0, nullptr, &msg);
+	_ftp_server->handle_message(&msg);
+}
+
 /// @brief Cleans up an files created on microsd during testing
 void MavlinkFtpTest::_cleanup_microsd()
 {
@@ -1010,6 +1244,8 @@ bool MavlinkFtpTest::run_tests()
 	ut_run_test(_read_test);
 	ut_run_test(_read_badsession_test);
 	ut_run_test(_burst_test);
+	ut_run_test(_burst_interleaved_test);
+	ut_run_test(_burst_seek_test);
 	ut_run_test(_removedirectory_test);
 	ut_run_test(_createdirectory_test);
 	ut_run_test(_removefile_test);
@@ -65,6 +65,19 @@ public:
 
 	static void receive_message_handler_burst(const mavlink_file_transfer_protocol_t *ftp_req, void *worker_data);
 
+	/// Worker data for the stream handler of the read-ahead tests, which track up to two sessions
+	struct StreamInfo {
+		const uint8_t	*file_bytes;
+		uint32_t	file_size;
+		uint8_t		sessions[2];
+		uint32_t	next_offset[2];		///< offset of the next expected packet of each session
+		bool		eof[2];
+		uint32_t	other_offset_at_eof;	///< next_offset of the other session when the first one reached EOF
+		unsigned	errors;
+	};
+
+	static void receive_message_handler_stream(const mavlink_file_transfer_protocol_t *ftp_req, void *worker_data);
+
 	static const uint8_t serverSystemId = 50;	///< System ID for server
 	static const uint8_t serverComponentId = 1;	///< Component ID for server
 	static const uint8_t serverChannel = 0;		///< Channel to send to
@@ -81,6 +94,7 @@ private:
 	virtual void _cleanup(void);
 
 	bool _create_test_files(void);
+	bool _create_large_test_file(void);
 	bool _remove_test_files(void);
 	bool _ack_test(void);
 	bool _bad_opcode_test(void);
@@ -93,6 +107,8 @@ private:
 	bool _read_test(void);
 	bool _read_badsession_test(void);
 	bool _burst_test(void);
+	bool _burst_interleaved_test(void);
+	bool _burst_seek_test(void);
 	bool _removedirectory_test(void);
 	bool _createdirectory_test(void);
 	bool _removefile_test(void);
@@ -105,6 +121,9 @@ private:
 			       uint8_t				size,
 			       const uint8_t			*data,
 			       const MavlinkFTP::PayloadHeader	**payload_reply);
+	bool _open_session(const char *file, uint8_t &session);
+	bool _terminate_session(uint8_t session);
+	void _start_burst(uint8_t session, uint32_t offset);
 	void _cleanup_microsd(void);
 
 	/// A single download test case
@@ -74,6 +74,8 @@ public:
 
 	bool const_rate() override { return true; }
 
+	bool update_data_every_iteration() const override { return true; }
+
 private:
 	explicit MavlinkStreamHighLatency2(Mavlink *mavlink) :
 		MavlinkStream(mavlink),
@@ -277,6 +277,24 @@ MulticopterRateControl::Run()
 			actuators.timestamp = hrt_absolute_time();
 			_actuators_0_pub.publish(actuators);
 
+			if (_param_sys_ctrl_alloc.get() && !_vehicle_status.is_vtol) {
+				// publish the torque and thrust setpoints for the control allocator
+				vehicle_torque_setpoint_s v_torque_sp{};
+				v_torque_sp.timestamp_sample = angular_velocity.timestamp_sample;
+				v_torque_sp.xyz[0] = actuators.control[actuator_controls_s::INDEX_ROLL];
+				v_torque_sp.xyz[1] = actuators.control[actuator_controls_s::INDEX_PITCH];
+				v_torque_sp.xyz[2] = actuators.control[actuator_controls_s::INDEX_YAW];
+				v_torque_sp.timestamp = hrt_absolute_time();
+				_vehicle_torque_setpoint_pub.publish(v_torque_sp);
+
+				// thrust is along the body -z axis
+				vehicle_thrust_setpoint_s v_thrust_sp{};
+				v_thrust_sp.timestamp_sample = angular_velocity.timestamp_sample;
+				v_thrust_sp.xyz[2] = -actuators.control[actuator_controls_s::INDEX_THROTTLE];
+				v_thrust_sp.timestamp = hrt_absolute_time();
+				_vehicle_thrust_setpoint_pub.publish(v_thrust_sp);
+			}
+
 		} else if (_v_control_mode.flag_control_termination_enabled) {
 			if (!_vehicle_status.is_vtol) {
 				// publish actuator controls
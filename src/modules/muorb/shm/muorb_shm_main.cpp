@@ -0,0 +1,138 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include <string.h>
+
+#include <px4_platform_common/getopt.h>
+#include <px4_platform_common/log.h>
+#include <px4_platform_common/module.h>
+
+#include "modules/uORB/uORBManager.hpp"
+#include "uORBShmChannel.hpp"
+
+extern "C" { __EXPORT int muorb_shm_main(int argc, char *argv[]); }
+
+static void usage()
+{
+	PRINT_MODULE_DESCRIPTION(
+		R"DESCR_STR(
+### Description
+Bridges uORB topics between PX4 processes (e.g. multiple SITL instances) and companion
+processes on the same host through a POSIX shared-memory segment.
+
+Topics advertised or subscribed before the bridge is started are not announced to the
+other participants, so it should be started right after uORB.
+Topics larger than 1024 bytes are not bridged.
+
+### Example
+$ muorb_shm start -n /px4_uorb_vehicle1
+)DESCR_STR");
+
+	PRINT_MODULE_USAGE_NAME("muorb_shm", "communication");
+	PRINT_MODULE_USAGE_COMMAND("start");
+	PRINT_MODULE_USAGE_PARAM_STRING('n', "/px4_uorb", nullptr, "Shared-memory segment name", true);
+	PRINT_MODULE_USAGE_COMMAND_DESCR("stop", "Stop the bridge");
+	PRINT_MODULE_USAGE_COMMAND_DESCR("status", "Print bridged topics and statistics");
+}
+
+int
+muorb_shm_main(int argc, char *argv[])
+{
+	if (argc < 2) {
+		usage();
+		return -EINVAL;
+	}
+
+	if (!strcmp(argv[1], "start")) {
+		const char *segment_name = "/px4_uorb";
+		int myoptind = 1;
+		int ch;
+		const char *myoptarg = nullptr;
+
+		while ((ch = px4_getopt(argc, argv, "n:", &myoptind, &myoptarg)) != EOF) {
+			switch (ch) {
+			case 'n':
+				segment_name = myoptarg;
+				break;
+
+			default:
+				usage();
+				return -EINVAL;
+			}
+		}
+
+		if (uORB::ShmChannel::isInstance()) {
+			PX4_WARN("muorb_shm already running");
+			return PX4_OK;
+		}
+
+		uORB::ShmChannel *channel = uORB::ShmChannel::GetInstance();
+
+		if (channel->Start(segment_name) != 0) {
+			PX4_ERR("start failed");
+			uORB::ShmChannel::terminate();
+			return PX4_ERROR;
+		}
+
+		// register the shared-memory channel with uORB. The receive thread holds back the topics and
+		// subscriptions of the other participants until the handler is set, then announces all of them.
+		uORB::Manager::get_instance()->set_uorb_communicator(channel);
+		return PX4_OK;
+	}
+
+	if (!strcmp(argv[1], "stop")) {
+		if (uORB::ShmChannel::isInstance()) {
+			uORB::Manager::get_instance()->set_uorb_communicator(nullptr);
+			uORB::ShmChannel::terminate();
+
+		} else {
+			PX4_WARN("muorb_shm not running");
+		}
+
+		return PX4_OK;
+	}
+
+	if (!strcmp(argv[1], "status")) {
+		if (uORB::ShmChannel::isInstance()) {
+			uORB::ShmChannel::GetInstance()->PrintStatus();
+
+		} else {
+			PX4_INFO("muorb_shm not running");
+		}
+
+		return PX4_OK;
+	}
+
+	usage();
+	return -EINVAL;
+}
@@ -0,0 +1,708 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include "uORBShmChannel.hpp"
+
+#include <lib/mathlib/mathlib.h>
+#include <px4_platform_common/log.h>
+#include <px4_platform_common/posix.h>
+#include <px4_platform_common/tasks.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <drivers/drv_orb_dev.h>
+#include <uORB/uORBDeviceMaster.hpp>
+#include <uORB/uORBDeviceNode.hpp>
+#include <uORB/uORBManager.hpp>
+#include <uORB/uORBUtils.hpp>
+
+#if defined(__PX4_LINUX)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+using namespace uORB::shm;
+
+uORB::ShmChannel *uORB::ShmChannel::_InstancePtr = nullptr;
+
+static constexpr int WAKEUP_TIMEOUT_MS = 100; ///< upper bound to notice exit requests
+
+static void futex_wait(std::atomic<uint32_t> &word, uint32_t expected, int timeout_ms)
+{
+#if defined(__PX4_LINUX)
+	struct timespec ts {timeout_ms / 1000, (timeout_ms % 1000) * 1000000};
+	syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAIT, expected, &ts, nullptr, 0);
+#else
+
+	// no futex available: poll
+	for (int i = 0; i < timeout_ms && word.load(std::memory_order_acquire) == expected; ++i) {
+		usleep(1000);
+	}
+
+#endif
+}
+
+static void futex_wake(std::atomic<uint32_t> &word)
+{
+#if defined(__PX4_LINUX)
+	syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAKE, INT32_MAX, nullptr, nullptr, 0);
+#endif
+}
+
+int uORB::ShmChannel::map_segment(const char *segment_name)
+{
+	bool creator = true;
+	int fd = shm_open(segment_name, O_RDWR | O_CREAT | O_EXCL, 0666);
+
+	if (fd < 0 && errno == EEXIST) {
+		creator = false;
+		fd = shm_open(segment_name, O_RDWR, 0666);
+	}
+
+	if (fd < 0) {
+		PX4_ERR("shm_open %s failed (%i)", segment_name, errno);
+		return -errno;
+	}
+
+	if (creator) {
+		// the memory is zero-initialized, which is the initial state of all fields
+		if (ftruncate(fd, sizeof(Segment)) != 0) {
+			PX4_ERR("ftruncate failed (%i)", errno);
+			close(fd);
+			shm_unlink(segment_name);
+			return -errno;
+		}
+
+	} else {
+		// wait for the creator to size the segment
+		struct stat st {};
+
+		for (int i = 0; i < 100 && (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(Segment)); ++i) {
+			usleep(10000);
+		}
+
+		if (st.st_size != (off_t)sizeof(Segment)) {
+			PX4_ERR("segment %s has unexpected size %i (expected %i)", segment_name, (int)st.st_size, (int)sizeof(Segment));
+			close(fd);
+			return -EINVAL;
+		}
+	}
+
+	void *ptr = mmap(nullptr, sizeof(Segment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+
+	if (ptr == MAP_FAILED) {
+		PX4_ERR("mmap failed (%i)", errno);
+		return -errno;
+	}
+
+	Segment *segment = static_cast<Segment *>(ptr);
+
+	if (creator) {
+		segment->version = SEGMENT_VERSION;
+		segment->magic.store(SEGMENT_MAGIC, std::memory_order_release);
+
+	} else {
+		for (int i = 0; i < 100 && segment->magic.load(std::memory_order_acquire) != SEGMENT_MAGIC; ++i) {
+			usleep(10000);
+		}
+
+		if (segment->magic.load(std::memory_order_acquire) != SEGMENT_MAGIC || segment->version != SEGMENT_VERSION) {
+			PX4_ERR("segment %s not initialized or incompatible version", segment_name);
+			munmap(ptr, sizeof(Segment));
+			return -EINVAL;
+		}
+	}
+
+	_segment = segment;
+	return 0;
+}
+
+void uORB::ShmChannel::release_stale_participants()
+{
+	bool changed = false;
+
+	for (int i = 0; i < MAX_PARTICIPANTS; ++i) {
+		int32_t pid = _segment->participants[i].pid.load(std::memory_order_acquire);
+
+		if (pid != 0 && kill(pid, 0) != 0 && errno == ESRCH) {
+			// the process died without calling Stop(): clear its advertisements and subscriptions
+			const uint32_t bit = 1u << i;
+
+			for (int t = 0; t < MAX_TOPICS; ++t) {
+				_segment->topics[t].publishers.fetch_and(~bit, std::memory_order_acq_rel);
+				_segment->topics[t].subscribers.fetch_and(~bit, std::memory_order_acq_rel);
+			}
+
+			_segment->participants[i].pid.compare_exchange_strong(pid, 0);
+			changed = true;
+		}
+	}
+
+	if (changed) {
+		notify_control_change();
+	}
+}
+
+int uORB::ShmChannel::claim_participant()
+{
+	release_stale_participants();
+
+	for (int i = 0; i < MAX_PARTICIPANTS; ++i) {
+		int32_t expected = 0;
+
+		if (_segment->participants[i].pid.compare_exchange_strong(expected, getpid())) {
+			_participant = i;
+			_participant_bit = 1u << i;
+			return 0;
+		}
+	}
+
+	PX4_ERR("no free participant slot (max %i)", MAX_PARTICIPANTS);
+	return -ENOSPC;
+}
+
+unsigned uORB::ShmChannel::index_cache_slot(const char *messageName)
+{
+	// names are static strings, so the address identifies the topic
+	const uintptr_t address = reinterpret_cast<uintptr_t>(messageName);
+	return (unsigned)((address >> 3) * 2654435761u) & (INDEX_CACHE_SIZE - 1);
+}
+
+int uORB::ShmChannel::cached_topic_index(const char *messageName) const
+{
+	for (unsigned n = 0, slot = index_cache_slot(messageName); n < INDEX_CACHE_SIZE;
+	     ++n, slot = (slot + 1) & (INDEX_CACHE_SIZE - 1)) {
+		const char *name = _index_cache[slot].name.load(std::memory_order_acquire);
+
+		if (name == messageName) {
+			return _index_cache[slot].index;
+		}
+
+		if (name == nullptr) {
+			break;
+		}
+	}
+
+	return -1;
+}
+
+int uORB::ShmChannel::topic_index(const char *messageName)
+{
+	// resolved once when the topic is advertised or subscribed, publications only take this path
+	int index = cached_topic_index(messageName);
+
+	if (index >= 0) {
+		return index;
+	}
+
+	pthread_mutex_lock(&_mutex);
+
+	// resolved by another thread in the meantime
+	index = cached_topic_index(messageName);
+
+	if (index >= 0) {
+		pthread_mutex_unlock(&_mutex);
+		return index;
+	}
+
+	if (strlen(messageName) < MAX_TOPIC_NAME_LEN) {
+		spin_lock(_segment->topic_lock);
+		index = find_topic(*_segment, messageName);
+
+		for (int i = 0; i < MAX_TOPICS && index < 0; ++i) {
+			Topic &topic = _segment->topics[i];
+
+			if (topic.state.load(std::memory_order_relaxed) == TOPIC_FREE) {
+				strncpy(topic.name, messageName, MAX_TOPIC_NAME_LEN);
+				topic.state.store(TOPIC_READY, std::memory_order_release);
+				index = i;
+			}
+		}
+
+		spin_unlock(_segment->topic_lock);
+	}
+
+	if (index >= 0) {
+		// there are at most MAX_TOPICS entries, so there is always a free slot
+		unsigned slot = index_cache_slot(messageName);
+
+		while (_index_cache[slot].name.load(std::memory_order_relaxed) != nullptr) {
+			slot = (slot + 1) & (INDEX_CACHE_SIZE - 1);
+		}
+
+		_index_cache[slot].index = index;
+		_index_cache[slot].name.store(messageName, std::memory_order_release);
+
+	} else {
+		PX4_ERR("cannot bridge %s (segment full or name too long)", messageName);
+	}
+
+	pthread_mutex_unlock(&_mutex);
+	return index;
+}
+
+void uORB::ShmChannel::set_mask_bit(std::atomic<uint32_t> &mask, bool set)
+{
+	if (set) {
+		mask.fetch_or(_participant_bit, std::memory_order_acq_rel);
+
+	} else {
+		mask.fetch_and(~_participant_bit, std::memory_order_acq_rel);
+	}
+
+	notify_control_change();
+}
+
+void uORB::ShmChannel::notify_control_change()
+{
+	_segment->control_generation.fetch_add(1, std::memory_order_acq_rel);
+	wakeup_participants(~_participant_bit);
+}
+
+void uORB::ShmChannel::wakeup_participants(uint32_t mask)
+{
+	for (int i = 0; i < MAX_PARTICIPANTS && mask != 0; ++i, mask >>= 1) {
+		if ((mask & 1) && _segment->participants[i].pid.load(std::memory_order_relaxed) != 0) {
+			_segment->participants[i].wakeup.fetch_add(1, std::memory_order_release);
+			futex_wake(_segment->participants[i].wakeup);
+		}
+	}
+}
+
+int16_t uORB::ShmChannel::topic_advertised(const char *messageName)
+{
+	if (!_segment) {
+		return -1;
+	}
+
+	const int index = topic_index(messageName);
+
+	if (index < 0) {
+		return -1;
+	}
+
+	// publish the queue size of the local publisher, so that the readers forward every sample of queued topics
+	std::atomic<uint32_t> &queue_size = _segment->topics[index].queue_size;
+	const uint32_t local_queue = local_queue_size(messageName);
+	uint32_t current = queue_size.load(std::memory_order_relaxed);
+
+	while (local_queue > current && !queue_size.compare_exchange_weak(current, local_queue)) {}
+
+	_local_topics[index].advertised.store(true);
+	set_mask_bit(_segment->topics[index].publishers, true);
+	return 0;
+}
+
+int16_t uORB::ShmChannel::add_subscription(const char *messageName, int32_t msgRateInHz)
+{
+	if (!_segment) {
+		return -1;
+	}
+
+	const int index = topic_index(messageName);
+
+	if (index < 0) {
+		return -1;
+	}
+
+	LocalTopic &local = _local_topics[index];
+
+	if (!local.subscribed.load()) {
+		// like a new uORB subscription, start with the latest sample (applied by the receive thread)
+		local.resubscribed.store(true);
+	}
+
+	local.subscribed.store(true);
+	set_mask_bit(_segment->topics[index].subscribers, true);
+	return 0;
+}
+
+int16_t uORB::ShmChannel::remove_subscription(const char *messageName)
+{
+	if (!_segment) {
+		return -1;
+	}
+
+	const int index = topic_index(messageName);
+
+	if (index < 0) {
+		return -1;
+	}
+
+	_local_topics[index].subscribed.store(false);
+	set_mask_bit(_segment->topics[index].subscribers, false);
+	return 0;
+}
+
+int16_t uORB::ShmChannel::register_handler(uORBCommunicator::IChannelRxHandler *handler)
+{
+	_RxHandler.store(handler, std::memory_order_release);
+
+	// the receive thread holds back control changes until there is a handler: wake it up to announce them
+	if (_segment && _participant >= 0) {
+		_segment->participants[_participant].wakeup.fetch_add(1, std::memory_order_release);
+		futex_wake(_segment->participants[_participant].wakeup);
+	}
+
+	return 0;
+}
+
+int16_t uORB::ShmChannel::send_message(const char *messageName, int32_t length, uint8_t *data)
+{
+	if (!_segment) {
+		return -1;
+	}
+
+	if (length > MAX_PAYLOAD_SIZE) {
+		// not bridged
+		return 0;
+	}
+
+	const int index = topic_index(messageName);
+
+	if (index < 0) {
+		return -1;
+	}
+
+	Topic &topic = _segment->topics[index];
+	const uint32_t remote_subscribers = topic.subscribers.load(std::memory_order_acquire) & ~_participant_bit;
+
+	if (remote_subscribers == 0) {
+		return 0;
+	}
+
+	spin_lock(topic.write_lock);
+	write_sample(topic, _participant, data, length);
+	spin_unlock(topic.write_lock);
+
+	_local_topics[index].sent.fetch_add(1, std::memory_order_relaxed);
+	wakeup_participants(remote_subscribers);
+	return 0;
+}
+
+int uORB::ShmChannel::Start(const char *segment_name)
+{
+	if (_segment) {
+		return 0;
+	}
+
+	int ret = map_segment(segment_name);
+
+	if (ret == 0) {
+		ret = claim_participant();
+	}
+
+	if (ret != 0) {
+		if (_segment) {
+			munmap(_segment, sizeof(Segment));
+			_segment = nullptr;
+		}
+
+		return ret;
+	}
+
+	// announce topics of the other participants on the first iteration
+	_last_control_generation = _segment->control_generation.load(std::memory_order_acquire) - 1;
+	_ThreadShouldExit = false;
+
+	pthread_attr_t attr;
+	pthread_attr_init(&attr);
+	struct sched_param param {};
+	param.sched_priority = SCHED_PRIORITY_MAX - 10; // above the work queues of the publishing process
+	pthread_attr_setschedparam(&attr, &param);
+	ret = pthread_create(&_RecvThread, &attr, &ShmChannel::thread_start, this);
+	pthread_attr_destroy(&attr);
+
+	if (ret != 0) {
+		PX4_ERR("failed to start receive thread (%i)", ret);
+		Stop();
+		return -ret;
+	}
+
+	_ThreadStarted = true;
+	PX4_INFO("participant %i of %s", _participant, segment_name);
+	return 0;
+}
+
+void uORB::ShmChannel::Stop()
+{
+	if (!_segment) {
+		return;
+	}
+
+	_ThreadShouldExit = true;
+
+	if (_ThreadStarted) {
+		_segment->participants[_participant].wakeup.fetch_add(1, std::memory_order_release);
+		futex_wake(_segment->participants[_participant].wakeup);
+		pthread_join(_RecvThread, nullptr);
+		_ThreadStarted = false;
+	}
+
+	if (_participant >= 0) {
+		for (int t = 0; t < MAX_TOPICS; ++t) {
+			_segment->topics[t].publishers.fetch_and(~_participant_bit, std::memory_order_acq_rel);
+			_segment->topics[t].subscribers.fetch_and(~_participant_bit, std::memory_order_acq_rel);
+		}
+
+		notify_control_change();
+		_segment->participants[_participant].pid.store(0, std::memory_order_release);
+		_participant = -1;
+		_participant_bit = 0;
+	}
+
+	munmap(_segment, sizeof(Segment));
+	_segment = nullptr;
+}
+
+void *uORB::ShmChannel::thread_start(void *arg)
+{
+	px4_prctl(PR_SET_NAME, "muorb_shm_rx", px4_getpid());
+	static_cast<ShmChannel *>(arg)->recv_thread();
+	return nullptr;
+}
+
+void uORB::ShmChannel::recv_thread()
+{
+	Participant &self = _segment->participants[_participant];
+
+	while (!_ThreadShouldExit) {
+		// read the wakeup counter first, so that no notification between here and the wait is lost
+		const uint32_t wakeup = self.wakeup.load(std::memory_order_acquire);
+
+		if (_segment->control_generation.load(std::memory_order_acquire) != _last_control_generation) {
+			process_control_changes();
+		}
+
+		receive_topics();
+
+		futex_wait(self.wakeup, wakeup, WAKEUP_TIMEOUT_MS);
+	}
+}
+
+void uORB::ShmChannel::process_control_changes()
+{
+	uORBCommunicator::IChannelRxHandler *handler = _RxHandler.load(std::memory_order_acquire);
+
+	if (!handler) {
+		// keep the changes pending, so that the whole state is announced once a handler is registered
+		return;
+	}
+
+	_last_control_generation = _segment->control_generation.load(std::memory_order_acquire);
+
+	for (int i = 0; i < MAX_TOPICS; ++i) {
+		Topic &topic = _segment->topics[i];
+
+		if (topic.state.load(std::memory_order_acquire) != TOPIC_READY) {
+			continue;
+		}
+
+		const bool remote_publisher = (topic.publishers.load(std::memory_order_acquire) & ~_participant_bit) != 0;
+		const bool remote_subscriber = (topic.subscribers.load(std::memory_order_acquire) & ~_participant_bit) != 0;
+
+		LocalTopic &local = _local_topics[i];
+		const bool publisher_changed = local.remote_publisher != remote_publisher;
+		const bool subscriber_changed = local.remote_subscriber != remote_subscriber;
+		local.remote_publisher = remote_publisher;
+		local.remote_subscriber = remote_subscriber;
+
+		// the handler may call back into send_message(), so no lock must be held here
+		if (publisher_changed) {
+			handler->process_remote_topic(topic.name, remote_publisher);
+		}
+
+		if (subscriber_changed) {
+			if (remote_subscriber) {
+				handler->process_add_subscription(topic.name, 1);
+
+			} else {
+				handler->process_remove_subscription(topic.name);
+			}
+		}
+	}
+}
+
+void uORB::ShmChannel::receive_topics()
+{
+	for (int i = 0; i < MAX_TOPICS; ++i) {
+		LocalTopic &local = _local_topics[i];
+
+		if (!local.subscribed.load(std::memory_order_acquire) || !local.remote_publisher) {
+			continue;
+		}
+
+		Topic &topic = _segment->topics[i];
+		const uint32_t generation = topic.generation.load(std::memory_order_acquire);
+
+		if (local.resubscribed.exchange(false)) {
+			local.last_generation = (generation > 0) ? generation - 1 : 0;
+		}
+
+		if (generation == local.last_generation) {
+			continue;
+		}
+
+		const uint32_t queue_size = topic.queue_size.load(std::memory_order_relaxed);
+
+		if (queue_size > 1) {
+			receive_queued(i, generation, queue_size);
+			continue;
+		}
+
+		Reader reader(topic);
+		const uint32_t length = reader.copy(_rx_buffer, sizeof(_rx_buffer));
+
+		if (length == 0) {
+			// writer too fast, retry on the next wakeup
+			continue;
+		}
+
+		local.last_generation = reader.last_generation();
+
+		if (topic.last_writer.load(std::memory_order_relaxed) == (uint32_t)_participant) {
+			// our own publication
+			continue;
+		}
+
+		uORBCommunicator::IChannelRxHandler *handler = _RxHandler.load(std::memory_order_acquire);
+
+		if (handler) {
+			handler->process_received_message(topic.name, length, _rx_buffer);
+			local.received.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+}
+
+void uORB::ShmChannel::receive_queued(int index, uint32_t generation, uint32_t queue_size)
+{
+	LocalTopic &local = _local_topics[index];
+	Topic &topic = _segment->topics[index];
+	uORBCommunicator::IChannelRxHandler *handler = _RxHandler.load(std::memory_order_acquire);
+
+	if (!local.local_queue_set) {
+		set_local_queue_size(topic.name, queue_size);
+		local.local_queue_set = true;
+	}
+
+	// samples older than the queue (or the ring) would be dropped by the subscribers anyway
+	const uint32_t count = math::min(generation - local.last_generation, math::min(queue_size, (uint32_t)RING_SLOTS));
+	const Reader reader(topic);
+
+	for (uint32_t n = count; n > 0; --n) {
+		uint32_t writer = 0;
+		const uint32_t length = reader.copy(generation - n + 1, _rx_buffer, sizeof(_rx_buffer), writer);
+
+		// skip samples overwritten in the meantime and our own publications
+		if ((length > 0) && (writer != (uint32_t)_participant) && handler) {
+			handler->process_received_message(topic.name, length, _rx_buffer);
+			local.received.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+	local.last_generation = generation;
+}
+
+unsigned uORB::ShmChannel::local_queue_size(const char *messageName)
+{
+	char nodepath[orb_maxpath];
+	uORB::DeviceMaster *device_master = uORB::Manager::get_instance()->get_device_master();
+
+	if ((uORB::Utils::node_mkpath(nodepath, messageName) == OK) && device_master) {
+		uORB::DeviceNode *node = device_master->getDeviceNode(nodepath);
+
+		if (node) {
+			return node->get_queue_size();
+		}
+	}
+
+	return 0;
+}
+
+void uORB::ShmChannel::set_local_queue_size(const char *messageName, unsigned queue_size)
+{
+	char nodepath[orb_maxpath];
+
+	if ((uORB::Utils::node_mkpath(nodepath, messageName) != OK) || (local_queue_size(messageName) >= queue_size)) {
+		return;
+	}
+
+	// as in orb_advertise_queue(): fails once the node holds data, then the local queue size is kept
+	const int fd = px4_open(nodepath, 0);
+
+	if (fd >= 0) {
+		px4_ioctl(fd, ORBIOCSETQUEUESIZE, (unsigned long)queue_size);
+		px4_close(fd);
+	}
+}
+
+void uORB::ShmChannel::PrintStatus()
+{
+	if (!_segment) {
+		PX4_INFO("not running");
+		return;
+	}
+
+	int participants = 0;
+
+	for (int i = 0; i < MAX_PARTICIPANTS; ++i) {
+		if (_segment->participants[i].pid.load(std::memory_order_relaxed) != 0) {
+			++participants;
+		}
+	}
+
+	PX4_INFO("participant %i (%i active)", _participant, participants);
+	PX4_INFO_RAW("%-40s %4s %4s %10s %10s\n", "topic", "pubs", "subs", "sent", "received");
+
+	for (int i = 0; i < MAX_TOPICS; ++i) {
+		const Topic &topic = _segment->topics[i];
+
+		if (topic.state.load(std::memory_order_acquire) != TOPIC_READY) {
+			continue;
+		}
+
+		PX4_INFO_RAW("%-40s %4i %4i %10u %10u\n", topic.name,
+			     __builtin_popcount(topic.publishers.load(std::memory_order_relaxed)),
+			     __builtin_popcount(topic.subscribers.load(std::memory_order_relaxed)),
+			     _local_topics[i].sent.load(std::memory_order_relaxed),
+			     _local_topics[i].received.load(std::memory_order_relaxed));
+	}
+}
@@ -0,0 +1,205 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include <pthread.h>
+
+#include <uORB/uORBCommunicator.hpp>
+
+#include "uORBShmSegment.hpp"
+
+namespace uORB
+{
+class ShmChannel;
+}
+
+/**
+ * uORBCommunicator::IChannel implementation for co-located processes on POSIX.
+ *
+ * All participants map the same shared-memory segment (@see uORBShmSegment.hpp).
+ * Advertisements and subscriptions are announced through the per-topic publisher and
+ * subscriber masks; a receive thread forwards remote changes to the IChannelRxHandler
+ * (process_remote_topic/process_add_subscription/process_remove_subscription) and
+ * publishes new remote samples locally. Samples are only written to the segment if
+ * another participant subscribed to the topic.
+ */
+class uORB::ShmChannel final : public uORBCommunicator::IChannel
+{
+public:
+	/**
+	 * static method to get the IChannel Implementor.
+	 */
+	static uORB::ShmChannel *GetInstance()
+	{
+		if (_InstancePtr == nullptr) {
+			_InstancePtr = new uORB::ShmChannel();
+		}
+
+		return _InstancePtr;
+	}
+
+	/**
+	 * Static method to check if there is an instance.
+	 */
+	static bool isInstance()
+	{
+		return (_InstancePtr != nullptr);
+	}
+
+	/**
+	 * Stop the channel and delete the instance, so that it can be started again.
+	 * Unregister it from uORB first.
+	 */
+	static void terminate()
+	{
+		if (_InstancePtr != nullptr) {
+			_InstancePtr->Stop();
+			delete _InstancePtr;
+			_InstancePtr = nullptr;
+		}
+	}
+
+	/** @see IChannel */
+	int16_t topic_advertised(const char *messageName) override;
+
+	/** @see IChannel */
+	int16_t add_subscription(const char *messageName, int32_t msgRateInHz) override;
+
+	/** @see IChannel */
+	int16_t remove_subscription(const char *messageName) override;
+
+	/** @see IChannel */
+	int16_t register_handler(uORBCommunicator::IChannelRxHandler *handler) override;
+
+	/** @see IChannel */
+	int16_t send_message(const char *messageName, int32_t length, uint8_t *data) override;
+
+	/**
+	 * Map (and create if needed) the shared segment and start the receive thread.
+	 * @param segment_name name of the POSIX shared-memory object, e.g. "/px4_uorb"
+	 * @return 0 on success
+	 */
+	int Start(const char *segment_name);
+
+	void Stop();
+
+	void PrintStatus();
+
+private:
+	ShmChannel() = default;
+	~ShmChannel() = default;
+
+	/**
+	 * Per-topic state of this process. The atomic fields are shared between the publishing/subscribing
+	 * threads and the receive thread, all others are only accessed by the receive thread.
+	 */
+	struct LocalTopic {
+		std::atomic<bool> advertised{false};  ///< advertised by this process
+		std::atomic<bool> subscribed{false};  ///< this process has local subscribers
+		std::atomic<bool> resubscribed{false}; ///< set on a new local subscription, restart at the latest sample
+		bool remote_publisher{false};
+		bool remote_subscriber{false};
+		uint32_t last_generation{0}; ///< last sample forwarded to the local node
+		bool local_queue_set{false}; ///< the queue size of the local node was raised to the one of the publishers
+
+		// statistics
+		std::atomic<uint32_t> sent{0};
+		std::atomic<uint32_t> received{0};
+	};
+
+	/** entry of the topic name to index cache, name is stored last to publish the entry */
+	struct IndexCacheEntry {
+		std::atomic<const char *> name{nullptr};
+		int index{-1};
+	};
+
+	static constexpr int INDEX_CACHE_SIZE = 2 * shm::MAX_TOPICS; ///< power of 2, at most half full
+
+	int map_segment(const char *segment_name);
+	int claim_participant();
+	void release_stale_participants();
+
+	/**
+	 * get the topic index for a name, create the topic in the segment if needed
+	 * @return index or -1 if the segment is full
+	 */
+	int topic_index(const char *messageName);
+
+	/**
+	 * lock-free lookup of a topic index resolved before by topic_index()
+	 * @return index or -1 if not cached
+	 */
+	int cached_topic_index(const char *messageName) const;
+
+	static unsigned index_cache_slot(const char *messageName);
+
+	void set_mask_bit(std::atomic<uint32_t> &mask, bool set);
+
+	/** @return queue size of the local uORB node of a topic, 0 if there is none */
+	static unsigned local_queue_size(const char *messageName);
+
+	/** raise the queue size of the local uORB node, so that forwarded queued samples are not lost */
+	static void set_local_queue_size(const char *messageName, unsigned queue_size);
+	void notify_control_change();
+	void wakeup_participants(uint32_t mask);
+
+	static void *thread_start(void *arg);
+	void recv_thread();
+	void process_control_changes();
+	void receive_topics();
+
+	/** forward the samples of a queued topic published since the last call */
+	void receive_queued(int index, uint32_t generation, uint32_t queue_size);
+
+	static uORB::ShmChannel *_InstancePtr;
+
+	std::atomic<uORBCommunicator::IChannelRxHandler *> _RxHandler{nullptr}; ///< set from the uORB manager, read by the receive thread
+
+	shm::Segment *_segment{nullptr};
+	int _participant{-1};
+	uint32_t _participant_bit{0};
+
+	pthread_mutex_t _mutex = PTHREAD_MUTEX_INITIALIZER; ///< serializes insertions into _index_cache
+	LocalTopic _local_topics[shm::MAX_TOPICS] {};
+	IndexCacheEntry _index_cache[INDEX_CACHE_SIZE] {}; ///< keyed by orb_metadata::o_name (static string)
+
+	pthread_t _RecvThread{};
+	bool _ThreadStarted{false};
+	volatile bool _ThreadShouldExit{false};
+	uint32_t _last_control_generation{0};
+
+	uint8_t _rx_buffer[shm::MAX_PAYLOAD_SIZE] {};
+};
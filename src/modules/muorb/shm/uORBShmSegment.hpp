@@ -0,0 +1,311 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file uORBShmSegment.hpp
+ * Layout of the POSIX shared-memory segment used to bridge uORB topics between
+ * co-located processes (see uORBShmChannel.hpp).
+ *
+ * This header has no PX4 dependencies, so that companion processes can map the
+ * segment and read topics directly (see Reader).
+ *
+ * Each topic has a ring of sample slots guarded by per-slot sequence counters
+ * (seqlock): writers serialize on a per-topic spin lock, readers never block and
+ * retry if a slot was overwritten while they were reading it. Spin locks store the
+ * pid of their owner and are taken over if the owner died while holding them.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <errno.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+
+namespace uORB
+{
+namespace shm
+{
+
+static constexpr uint32_t SEGMENT_MAGIC = 0x4d48534f; ///< "OSHM"
+static constexpr uint32_t SEGMENT_VERSION = 3;
+
+static constexpr int MAX_PARTICIPANTS = 32; ///< one bit per participant in the topic masks
+static constexpr int MAX_TOPICS = 256;
+static constexpr int MAX_TOPIC_NAME_LEN = 64;
+static constexpr int MAX_PAYLOAD_SIZE = 1024; ///< larger topics are not bridged
+static constexpr int RING_SLOTS = 4;
+
+enum TopicState : uint32_t {
+	TOPIC_FREE = 0,
+	TOPIC_READY = 1,
+};
+
+struct Slot {
+	std::atomic<uint32_t> seq;  ///< 2 * generation of the contained sample, odd while it is being written
+	uint32_t length;
+	uint32_t writer;            ///< participant index of the writer
+	alignas(8) uint8_t data[MAX_PAYLOAD_SIZE];
+};
+
+struct Topic {
+	std::atomic<uint32_t> state;
+	char name[MAX_TOPIC_NAME_LEN];
+
+	std::atomic<uint32_t> publishers;   ///< bitmask of participants that advertised the topic
+	std::atomic<uint32_t> subscribers;  ///< bitmask of participants with local subscribers
+
+	std::atomic<uint32_t> write_lock;   ///< pid of the writer holding the lock, 0 if free
+	std::atomic<uint32_t> generation;   ///< number of samples written, the latest is in slots[generation % RING_SLOTS]
+	std::atomic<uint32_t> last_writer;  ///< participant index of the latest sample
+	std::atomic<uint32_t> queue_size;   ///< largest uORB queue size of the publishers, >1: readers forward every sample
+
+	Slot slots[RING_SLOTS];
+};
+
+struct Participant {
+	std::atomic<int32_t> pid;       ///< 0 if unused
+	std::atomic<uint32_t> wakeup;   ///< futex word, incremented whenever there is something to read
+};
+
+struct Segment {
+	std::atomic<uint32_t> magic;    ///< set last by the creator, once the segment is initialized
+	uint32_t version;
+
+	std::atomic<uint32_t> topic_lock;          ///< serializes topic creation, pid of the owner or 0
+	std::atomic<uint32_t> control_generation;  ///< incremented on every advertisement/subscription change
+
+	Participant participants[MAX_PARTICIPANTS];
+	Topic topics[MAX_TOPICS];
+};
+
+static_assert(ATOMIC_INT_LOCK_FREE == 2, "shared memory atomics must be lock-free");
+
+static constexpr uint32_t LOCK_OWNER_CHECK_SPINS = 1024; ///< spins between checks whether the lock owner is alive
+
+/**
+ * Take a lock shared between processes. The lock word holds the pid of the owner, so that
+ * a lock left behind by a process that died in the critical section can be taken over.
+ * This is safe for the segment's critical sections: an interrupted write_sample() has not
+ * advanced the topic generation yet, so the next writer overwrites the same slot, and an
+ * interrupted topic creation has not marked the topic ready.
+ */
+static inline void spin_lock(std::atomic<uint32_t> &lock)
+{
+	const uint32_t self = static_cast<uint32_t>(getpid());
+
+	for (uint32_t spins = 1; ; ++spins) {
+		uint32_t owner = 0;
+
+		if (lock.compare_exchange_weak(owner, self, std::memory_order_acquire, std::memory_order_relaxed)) {
+			return;
+		}
+
+		if (owner != 0 && (spins % LOCK_OWNER_CHECK_SPINS) == 0) {
+			if (kill(static_cast<pid_t>(owner), 0) != 0 && errno == ESRCH
+			    && lock.compare_exchange_strong(owner, self, std::memory_order_acquire, std::memory_order_relaxed)) {
+				// the owner died while holding the lock
+				return;
+			}
+
+			sched_yield();
+		}
+	}
+}
+
+static inline void spin_unlock(std::atomic<uint32_t> &lock)
+{
+	lock.store(0, std::memory_order_release);
+}
+
+/**
+ * Find a topic by name.
+ * @return topic index or -1 if not found
+ */
+static inline int find_topic(const Segment &segment, const char *name)
+{
+	for (int i = 0; i < MAX_TOPICS; ++i) {
+		const Topic &topic = segment.topics[i];
+
+		if (topic.state.load(std::memory_order_acquire) == TOPIC_READY
+		    && strncmp(topic.name, name, MAX_TOPIC_NAME_LEN) == 0) {
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+/**
+ * Write a sample into the topic ring. Must be called with topic.write_lock held.
+ */
+static inline void write_sample(Topic &topic, int participant, const uint8_t *data, uint32_t length)
+{
+	const uint32_t generation = topic.generation.load(std::memory_order_relaxed) + 1;
+	Slot &slot = topic.slots[generation % RING_SLOTS];
+
+	slot.seq.store(2 * generation - 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	memcpy(slot.data, data, length);
+	slot.length = length;
+	slot.writer = participant;
+
+	slot.seq.store(2 * generation, std::memory_order_release);
+	topic.last_writer.store(participant, std::memory_order_relaxed);
+	topic.generation.store(generation, std::memory_order_release);
+}
+
+/**
+ * Lock-free reader for a single topic. Usable in place (zero-copy) via begin()/end(),
+ * or with copy().
+ */
+class Reader
+{
+public:
+	explicit Reader(const Topic &topic) : _topic(topic) {}
+
+	/** @return true if a sample newer than the last one read is available */
+	bool updated() const { return _topic.generation.load(std::memory_order_acquire) != _last_generation; }
+
+	/**
+	 * Start reading the latest sample in place.
+	 * @param length returned sample length
+	 * @return pointer into the shared segment, nullptr if no sample is available.
+	 * The data is only valid if end() returns true afterwards.
+	 */
+	const uint8_t *begin(uint32_t &length)
+	{
+		_generation = _topic.generation.load(std::memory_order_acquire);
+
+		if (_generation == 0) {
+			return nullptr;
+		}
+
+		_slot = &_topic.slots[_generation % RING_SLOTS];
+		_seq = _slot->seq.load(std::memory_order_acquire);
+
+		if (_seq != 2 * _generation) {
+			// already being overwritten
+			return nullptr;
+		}
+
+		length = _slot->length;
+		return _slot->data;
+	}
+
+	/** @return true if the sample returned by begin() was not modified in the meantime */
+	bool end()
+	{
+		std::atomic_thread_fence(std::memory_order_acquire);
+
+		if (_slot->seq.load(std::memory_order_relaxed) != _seq) {
+			return false;
+		}
+
+		_last_generation = _generation;
+		return true;
+	}
+
+	/**
+	 * Copy the latest sample.
+	 * @return sample length, 0 if no consistent sample could be read
+	 */
+	uint32_t copy(uint8_t *buffer, uint32_t buffer_size)
+	{
+		for (int retry = 0; retry < RING_SLOTS; ++retry) {
+			uint32_t length = 0;
+			const uint8_t *data = begin(length);
+
+			if (!data || length > buffer_size) {
+				continue;
+			}
+
+			memcpy(buffer, data, length);
+
+			if (end()) {
+				return length;
+			}
+		}
+
+		return 0;
+	}
+
+	/**
+	 * Copy the sample of a given generation, for queued topics. It is still in the ring if it is
+	 * one of the last RING_SLOTS samples.
+	 * @param generation generation to read, <= the current generation
+	 * @param writer returned participant index of the writer
+	 * @return sample length, 0 if the sample was overwritten
+	 */
+	uint32_t copy(uint32_t generation, uint8_t *buffer, uint32_t buffer_size, uint32_t &writer) const
+	{
+		if (generation == 0) {
+			return 0;
+		}
+
+		const Slot &slot = _topic.slots[generation % RING_SLOTS];
+		const uint32_t seq = slot.seq.load(std::memory_order_acquire);
+
+		if (seq != 2 * generation) {
+			return 0;
+		}
+
+		const uint32_t length = slot.length;
+		writer = slot.writer;
+
+		if (length > buffer_size) {
+			return 0;
+		}
+
+		memcpy(buffer, slot.data, length);
+		std::atomic_thread_fence(std::memory_order_acquire);
+
+		return (slot.seq.load(std::memory_order_relaxed) == seq) ? length : 0;
+	}
+
+	uint32_t last_generation() const { return _last_generation; }
+
+private:
+	const Topic &_topic;
+	const Slot *_slot{nullptr};
+	uint32_t _generation{0};
+	uint32_t _seq{0};
+	uint32_t _last_generation{0};
+};
+
+} // namespace shm
+} // namespace uORB
@@ -260,6 +260,8 @@ private:
 		MISSION_TYPE_MISSION
 	} _mission_type{MISSION_TYPE_NONE};
 
+	MissionFeasibilityChecker _missionFeasibilityChecker;	/**< keeps per item results between checks of the same mission */
+
 	bool _inited{false};
 	bool _home_inited{false};
 	bool _need_mission_reset{false};
@@ -49,6 +49,7 @@
 #include <lib/ecl/geo/geo.h>
 #include <lib/mathlib/mathlib.h>
 #include <lib/landing_slope/Landingslope.hpp>
+#include <parameters/param.h>
 #include <systemlib/mavlink_log.h>
 #include <uORB/Subscription.hpp>
 #include <uORB/topics/position_controller_landing_status.h>
@@ -74,233 +75,244 @@ MissionFeasibilityChecker::checkMissionFeasible(const mission_s &mission,
 		failed = true;
 		warned = true;
 		mavlink_log_info(_navigator->get_mavlink_log_pub(), "Not yet ready for mission, no position lock.");
-
-	} else {
-		failed = failed || !checkDistanceToFirstWaypoint(mission, max_distance_to_1st_waypoint);
 	}
 
 	const float home_alt = _navigator->get_home_position()->alt;
 
-	// check if all mission item commands are supported
-	failed = failed || !checkMissionItemValidity(mission);
-	failed = failed || !checkDistancesBetweenWaypoints(mission, max_distance_between_waypoints);
-	failed = failed || !checkGeofence(mission, home_alt, home_valid);
-	failed = failed || !checkHomePositionAltitude(mission, home_alt, home_alt_valid, warned);
+	// a check that failed stops looking at further items, the others keep going to report all violations
+	bool check_validity = true;
+	bool check_distance_1wp = home_alt_valid && (max_distance_to_1st_waypoint > 0.0f);
+	bool check_distances = (max_distance_between_waypoints > 0.0f);
+	bool check_geofence = _navigator->get_geofence().valid();
+	bool check_home_alt = true;
+	bool check_takeoff = true;
 
-	if (_navigator->get_vstatus()->is_vtol) {
-		failed = failed || !checkVTOL(mission, home_alt, false);
+	const bool is_vtol = _navigator->get_vstatus()->is_vtol;
+	const bool is_rotary_wing = !is_vtol
+				    && (_navigator->get_vstatus()->vehicle_type == vehicle_status_s::VEHICLE_TYPE_ROTARY_WING);
+	bool check_landing = !is_rotary_wing;
 
-	} else if (_navigator->get_vstatus()->vehicle_type == vehicle_status_s::VEHICLE_TYPE_ROTARY_WING) {
-		failed = failed || !checkRotarywing(mission, home_alt);
+	if (_navigator->get_geofence().isHomeRequired() && !home_valid) {
+		mavlink_log_critical(_navigator->get_mavlink_log_pub(), "Geofence requires valid home position");
+		failed = true;
+		check_geofence = false;
+	}
 
-	} else {
-		failed = failed || !checkFixedwing(mission, home_alt, land_start_req);
+	if (check_geofence) {
+		updateItemCache(home_valid);
 	}
 
-	return !failed;
-}
+	WaypointDistanceState distance_state{};
+	TakeoffState takeoff_state{};
+	LandingState landing_state{};
 
-bool
-MissionFeasibilityChecker::checkRotarywing(const mission_s &mission, float home_alt)
-{
-	/*
-	 * Perform check and issue feedback to the user
-	 * Mission is only marked as feasible if takeoff check passes
-	 */
-	return checkTakeoff(mission, home_alt);
-}
+	mission_item_s previous{};
 
-bool
-MissionFeasibilityChecker::checkFixedwing(const mission_s &mission, float home_alt, bool land_start_req)
-{
-	/* Perform checks and issue feedback to the user for all checks */
-	bool resTakeoff = checkTakeoff(mission, home_alt);
-	bool resLanding = checkFixedWingLanding(mission, land_start_req);
+	for (size_t i = 0; i < mission.count; i++) {
+		mission_item_s missionitem{};
+		const ssize_t len = sizeof(missionitem);
 
-	/* Mission is only marked as feasible if all checks return true */
-	return (resTakeoff && resLanding);
-}
+		if (dm_read((dm_item_t)mission.dataman_id, i, &missionitem, len) != len) {
+			// not supposed to happen unless the datamanager can't access the SD card, etc.
+			mavlink_log_critical(_navigator->get_mavlink_log_pub(), "Mission rejected: Cannot access SD card");
+			_navigator->get_mission_result()->warning = true;
+			return false;
+		}
 
-bool
-MissionFeasibilityChecker::checkVTOL(const mission_s &mission, float home_alt, bool land_start_req)
-{
-	/* Perform checks and issue feedback to the user for all checks */
-	bool resTakeoff = checkTakeoff(mission, home_alt);
-	bool resLanding = checkVTOLLanding(mission, land_start_req);
+		// check if all mission item commands are supported
+		if (check_validity && !checkMissionItemValidity(missionitem, i)) {
+			check_validity = false;
+			failed = true;
+		}
 
-	/* Mission is only marked as feasible if all checks return true */
-	return (resTakeoff && resLanding);
-}
+		if (check_distance_1wp) {
+			bool done = false;
 
-bool
-MissionFeasibilityChecker::checkGeofence(const mission_s &mission, float home_alt, bool home_valid)
-{
-	if (_navigator->get_geofence().isHomeRequired() && !home_valid) {
-		mavlink_log_critical(_navigator->get_mavlink_log_pub(), "Geofence requires valid home position");
-		return false;
-	}
+			if (!checkDistanceToFirstWaypoint(missionitem, max_distance_to_1st_waypoint, done)) {
+				failed = true;
+			}
+
+			check_distance_1wp = !done;
+		}
+
+		if (check_distances && !checkDistancesBetweenWaypoints(missionitem, max_distance_between_waypoints, distance_state)) {
+			check_distances = false;
+			failed = true;
+		}
 
-	/* Check if all mission items are inside the geofence (if we have a valid geofence) */
-	if (_navigator->get_geofence().valid()) {
-		for (size_t i = 0; i < mission.count; i++) {
-			struct mission_item_s missionitem = {};
-			const ssize_t len = sizeof(missionitem);
+		if (check_geofence) {
+			ItemCache *cache = nullptr;
 
-			if (dm_read((dm_item_t)mission.dataman_id, i, &missionitem, len) != len) {
-				/* not supposed to happen unless the datamanager can't access the SD card, etc. */
-				return false;
+			if (i < ITEM_CACHE_SIZE) {
+				cache = &_item_cache[i];
+
+				if (cache->lat != missionitem.lat || cache->lon != missionitem.lon
+				    || cache->altitude != missionitem.altitude
+				    || cache->altitude_is_relative != missionitem.altitude_is_relative) {
+					cache->lat = missionitem.lat;
+					cache->lon = missionitem.lon;
+					cache->altitude = missionitem.altitude;
+					cache->altitude_is_relative = missionitem.altitude_is_relative;
+					cache->geofence_checked = false;
+				}
 			}
 
-			if (missionitem.altitude_is_relative && !home_valid) {
-				mavlink_log_critical(_navigator->get_mavlink_log_pub(), "Geofence requires valid home position");
-				return false;
+			if (!checkGeofence(missionitem, i, home_alt, home_valid, cache)) {
+				check_geofence = false;
+				failed = true;
 			}
+		}
 
-			// Geofence function checks against home altitude amsl
-			missionitem.altitude = missionitem.altitude_is_relative ? missionitem.altitude + home_alt : missionitem.altitude;
+		if (check_home_alt) {
+			bool done = false;
 
-			if (MissionBlock::item_contains_position(missionitem) && !_navigator->get_geofence().check(missionitem)) {
+			if (!checkHomePositionAltitude(missionitem, i, home_alt, home_alt_valid, warned, done)) {
+				failed = true;
+			}
 
-				mavlink_log_critical(_navigator->get_mavlink_log_pub(), "Geofence violation for waypoint %zu", i + 1);
-				return false;
+			check_home_alt = !done;
+		}
+
+		if (check_takeoff && !checkTakeoff(missionitem, previous, i, home_alt, takeoff_state)) {
+			check_takeoff = false;
+			failed = true;
+		}
+
+		if (check_landing) {
+			const bool landing_ok = is_vtol ? checkVTOLLanding(missionitem, i, landing_state)
+						: checkFixedWingLanding(missionitem, previous, i, landing_state);
+
+			if (!landing_ok) {
+				check_landing = false;
+				failed = true;
 			}
 		}
+
+		previous = missionitem;
 	}
 
-	return true;
+	if (check_takeoff && !checkTakeoffResult(takeoff_state)) {
+		failed = true;
+	}
+
+	// VTOL missions do not require a landing pattern
+	if (check_landing && !checkLandingResult(landing_state, is_vtol ? false : land_start_req, !is_vtol)) {
+		failed = true;
+	}
+
+	return !failed;
 }
 
-bool
-MissionFeasibilityChecker::checkHomePositionAltitude(const mission_s &mission, float home_alt, bool home_alt_valid,
-		bool throw_error)
+void
+MissionFeasibilityChecker::updateItemCache(bool home_valid)
 {
-	/* Check if all waypoints are above the home altitude */
-	for (size_t i = 0; i < mission.count; i++) {
-		struct mission_item_s missionitem = {};
-		const ssize_t len = sizeof(struct mission_item_s);
+	CacheContext context{};
+	context.home_lat = _navigator->get_home_position()->lat;
+	context.home_lon = _navigator->get_home_position()->lon;
+	context.home_alt = _navigator->get_home_position()->alt;
+	context.home_valid = home_valid;
 
-		if (dm_read((dm_item_t)mission.dataman_id, i, &missionitem, len) != len) {
-			_navigator->get_mission_result()->warning = true;
-			/* not supposed to happen unless the datamanager can't access the SD card, etc. */
-			return false;
-		}
+	mission_stats_entry_s stats{};
 
-		/* reject relative alt without home set */
-		if (missionitem.altitude_is_relative && !home_alt_valid && MissionBlock::item_contains_position(missionitem)) {
+	if (dm_read(DM_KEY_FENCE_POINTS, 0, &stats, sizeof(mission_stats_entry_s)) == sizeof(mission_stats_entry_s)) {
+		context.fence_update_counter = stats.update_counter;
+	}
 
-			_navigator->get_mission_result()->warning = true;
+	// the geofence parameters are part of the check as well
+	context.param_hash = param_hash_check();
 
-			if (throw_error) {
-				mavlink_log_critical(_navigator->get_mavlink_log_pub(), "Mission rejected: No home pos, WP %zu uses rel alt", i + 1);
-				return false;
+	const bool context_changed = (context.home_lat != _cache_context.home_lat)
+				     || (context.home_lon != _cache_context.home_lon)
+				     || (context.home_alt != _cache_context.home_alt)
+				     || (context.home_valid != _cache_context.home_valid)
+				     || (context.fence_update_counter != _cache_context.fence_update_counter)
+				     || (context.param_hash != _cache_context.param_hash);
 
-			} else	{
-				mavlink_log_critical(_navigator->get_mavlink_log_pub(), "Warning: No home pos, WP %zu uses rel alt", i + 1);
-				return true;
-			}
+	if (context_changed) {
+		for (ItemCache &cache : _item_cache) {
+			cache.geofence_checked = false;
 		}
 
-		/* calculate the global waypoint altitude */
-		float wp_alt = (missionitem.altitude_is_relative) ? missionitem.altitude + home_alt : missionitem.altitude;
+		_cache_context = context;
+	}
+}
 
-		if ((home_alt > wp_alt) && MissionBlock::item_contains_position(missionitem)) {
+bool
+MissionFeasibilityChecker::checkGeofence(const mission_item_s &item, size_t index, float home_alt, bool home_valid,
+		ItemCache *cache)
+{
+	if (item.altitude_is_relative && !home_valid) {
+		mavlink_log_critical(_navigator->get_mavlink_log_pub(), "Geofence requires valid home position");
+		return false;
+	}
 
-			_navigator->get_mission_result()->warning = true;
+	if (!MissionBlock::item_contains_position(item)) {
+		return true;
+	}
 
-			if (throw_error) {
-				mavlink_log_critical(_navigator->get_mavlink_log_pub(), "Mission rejected: Waypoint %zu below home", i + 1);
-				return false;
+	bool inside;
 
-			} else	{
-				mavlink_log_critical(_navigator->get_mavlink_log_pub(), "Warning: Waypoint %zu below home", i + 1);
-				return true;
-			}
+	if ((cache != nullptr) && cache->geofence_checked) {
+		inside = cache->geofence_inside;
+
+	} else {
+		// Geofence function checks against home altitude amsl
+		mission_item_s missionitem = item;
+		missionitem.altitude = missionitem.altitude_is_relative ? missionitem.altitude + home_alt : missionitem.altitude;
+
+		inside = _navigator->get_geofence().check(missionitem);
+
+		if (cache != nullptr) {
+			cache->geofence_checked = true;
+			cache->geofence_inside = inside;
 		}
 	}
 
+	if (!inside) {
+		mavlink_log_critical(_navigator->get_mavlink_log_pub(), "Geofence violation for waypoint %zu", index + 1);
+		return false;
+	}
+
 	return true;
 }
 
 bool
-MissionFeasibilityChecker::checkMissionItemValidity(const mission_s &mission)
+MissionFeasibilityChecker::checkHomePositionAltitude(const mission_item_s &item, size_t index, float home_alt,
+		bool home_alt_valid, bool throw_error, bool &done)
 {
-	// do not allow mission if we find unsupported item
-	for (size_t i = 0; i < mission.count; i++) {
-		struct mission_item_s missionitem;
-		const ssize_t len = sizeof(struct mission_item_s);
+	/* Check if all waypoints are above the home altitude, only the first violation is reported */
 
-		if (dm_read((dm_item_t)mission.dataman_id, i, &missionitem, len) != len) {
-			// not supposed to happen unless the datamanager can't access the SD card, etc.
-			mavlink_log_critical(_navigator->get_mavlink_log_pub(), "Mission rejected: Cannot access SD card");
-			return false;
-		}
+	/* reject relative alt without home set */
+	if (item.altitude_is_relative && !home_alt_valid && MissionBlock::item_contains_position(item)) {
 
-		// check if we find unsupported items and reject mission if so
-		if (missionitem.nav_cmd != NAV_CMD_IDLE &&
-		    missionitem.nav_cmd != NAV_CMD_WAYPOINT &&
-		    missionitem.nav_cmd != NAV_CMD_LOITER_UNLIMITED &&
-		    missionitem.nav_cmd != NAV_CMD_LOITER_TIME_LIMIT &&
-		    missionitem.nav_cmd != NAV_CMD_RETURN_TO_LAUNCH &&
-		    missionitem.nav_cmd != NAV_CMD_LAND &&
-		    missionitem.nav_cmd != NAV_CMD_TAKEOFF &&
-		    missionitem.nav_cmd != NAV_CMD_LOITER_TO_ALT &&
-		    missionitem.nav_cmd != NAV_CMD_VTOL_TAKEOFF &&
-		    missionitem.nav_cmd != NAV_CMD_VTOL_LAND &&
-		    missionitem.nav_cmd != NAV_CMD_DELAY &&
-		    missionitem.nav_cmd != NAV_CMD_CONDITION_GATE &&
-		    missionitem.nav_cmd != NAV_CMD_DO_JUMP &&
-		    missionitem.nav_cmd != NAV_CMD_DO_CHANGE_SPEED &&
-		    missionitem.nav_cmd != NAV_CMD_DO_SET_HOME &&
-		    missionitem.nav_cmd != NAV_CMD_DO_SET_SERVO &&
-		    missionitem.nav_cmd != NAV_CMD_DO_LAND_START &&
-		    missionitem.nav_cmd != NAV_CMD_DO_TRIGGER_CONTROL &&
-		    missionitem.nav_cmd != NAV_CMD_DO_DIGICAM_CONTROL &&
-		    missionitem.nav_cmd != NAV_CMD_IMAGE_START_CAPTURE &&
-		    missionitem.nav_cmd != NAV_CMD_IMAGE_STOP_CAPTURE &&
-		    missionitem.nav_cmd != NAV_CMD_VIDEO_START_CAPTURE &&
-		    missionitem.nav_cmd != NAV_CMD_VIDEO_STOP_CAPTURE &&
-		    missionitem.nav_cmd != NAV_CMD_DO_CONTROL_VIDEO &&
-		    missionitem.nav_cmd != NAV_CMD_DO_MOUNT_CONFIGURE &&
-		    missionitem.nav_cmd != NAV_CMD_DO_MOUNT_CONTROL &&
-		    missionitem.nav_cmd != NAV_CMD_DO_SET_ROI &&
-		    missionitem.nav_cmd != NAV_CMD_DO_SET_ROI_LOCATION &&
-		    missionitem.nav_cmd != NAV_CMD_DO_SET_ROI_WPNEXT_OFFSET &&
-		    missionitem.nav_cmd != NAV_CMD_DO_SET_ROI_NONE &&
-		    missionitem.nav_cmd != NAV_CMD_DO_SET_CAM_TRIGG_DIST &&
-		    missionitem.nav_cmd != NAV_CMD_OBLIQUE_SURVEY &&
-		    missionitem.nav_cmd != NAV_CMD_DO_SET_CAM_TRIGG_INTERVAL &&
-		    missionitem.nav_cmd != NAV_CMD_SET_CAMERA_MODE &&
-		    missionitem.nav_cmd != NAV_CMD_SET_CAMERA_ZOOM &&
-		    missionitem.nav_cmd != NAV_CMD_DO_VTOL_TRANSITION) {
-
-			mavlink_log_critical(_navigator->get_mavlink_log_pub(), "Mission rejected: item %i: unsupported cmd: %d", (int)(i + 1),
-					     (int)missionitem.nav_cmd);
+		_navigator->get_mission_result()->warning = true;
+		done = true;
+
+		if (throw_error) {
+			mavlink_log_critical(_navigator->get_mavlink_log_pub(), "Mission rejected: No home pos, WP %zu uses rel alt", index + 1);
 			return false;
+
+		} else	{
+			mavlink_log_critical(_navigator->get_mavlink_log_pub(), "Warning: No home pos, WP %zu uses rel alt", index + 1);
+			return true;
 		}
+	}
 
-		/* Check non navigation item */
-		if (missionitem.nav_cmd == NAV_CMD_DO_SET_SERVO) {
+	/* calculate the global waypoint altitude */
+	float wp_alt = (item.altitude_is_relative) ? item.altitude + home_alt : item.altitude;
 
-			/* check actuator number */
-			if (missionitem.params[0] < 0 || missionitem.params[0] > 5) {
-				mavlink_log_critical(_navigator->get_mavlink_log_pub(), "Actuator number %d is out of bounds 0..5",
-						     (int)missionitem.params[0]);
-				return false;
-			}
+	if ((home_alt > wp_alt) && MissionBlock::item_contains_position(item)) {
 
-			/* check actuator value */
-			if (missionitem.params[1] < -PWM_DEFAULT_MAX || missionitem.params[1] > PWM_DEFAULT_MAX) {
-				mavlink_log_critical(_navigator->get_mavlink_log_pub(),
-						     "Actuator value %d is out of bounds -PWM_DEFAULT_MAX..PWM_DEFAULT_MAX", (int)missionitem.params[1]);
-				return false;
-			}
-		}
-
-		// check if the mission starts with a land command while the vehicle is landed
-		if ((i == 0) && missionitem.nav_cmd == NAV_CMD_LAND && _navigator->get_land_detected()->landed) {
+		_navigator->get_mission_result()->warning = true;
+		done = true;
 
-			mavlink_log_critical(_navigator->get_mavlink_log_pub(), "Mission rejected: starts with landing");
+		if (throw_error) {
+			mavlink_log_critical(_navigator->get_mavlink_log_pub(), "Mission rejected: Waypoint %zu below home", index + 1);
 			return false;
+
+		} else	{
+			mavlink_log_critical(_navigator->get_mavlink_log_pub(), "Warning: Waypoint %zu below home", index + 1);
+			return true;
 		}
 	}
 
@@ -308,109 +320,164 @@ MissionFeasibilityChecker::checkMissionItemValidity(const mission_s &mission)
 }
 
 bool
-MissionFeasibilityChecker::checkTakeoff(const mission_s &mission, float home_alt)
+MissionFeasibilityChecker::checkMissionItemValidity(const mission_item_s &missionitem, size_t index)
 {
-	bool has_takeoff = false;
-	bool takeoff_first = false;
-	int takeoff_index = -1;
+	// check if we find unsupported items and reject mission if so
+	if (missionitem.nav_cmd != NAV_CMD_IDLE &&
+	    missionitem.nav_cmd != NAV_CMD_WAYPOINT &&
+	    missionitem.nav_cmd != NAV_CMD_LOITER_UNLIMITED &&
+	    missionitem.nav_cmd != NAV_CMD_LOITER_TIME_LIMIT &&
+	    missionitem.nav_cmd != NAV_CMD_RETURN_TO_LAUNCH &&
+	    missionitem.nav_cmd != NAV_CMD_LAND &&
+	    missionitem.nav_cmd != NAV_CMD_TAKEOFF &&
+	    missionitem.nav_cmd != NAV_CMD_LOITER_TO_ALT &&
+	    missionitem.nav_cmd != NAV_CMD_VTOL_TAKEOFF &&
+	    missionitem.nav_cmd != NAV_CMD_VTOL_LAND &&
+	    missionitem.nav_cmd != NAV_CMD_DELAY &&
+	    missionitem.nav_cmd != NAV_CMD_CONDITION_GATE &&
+	    missionitem.nav_cmd != NAV_CMD_DO_JUMP &&
+	    missionitem.nav_cmd != NAV_CMD_DO_CHANGE_SPEED &&
+	    missionitem.nav_cmd != NAV_CMD_DO_SET_HOME &&
+	    missionitem.nav_cmd != NAV_CMD_DO_SET_SERVO &&
+	    missionitem.nav_cmd != NAV_CMD_DO_LAND_START &&
+	    missionitem.nav_cmd != NAV_CMD_DO_TRIGGER_CONTROL &&
+	    missionitem.nav_cmd != NAV_CMD_DO_DIGICAM_CONTROL &&
+	    missionitem.nav_cmd != NAV_CMD_IMAGE_START_CAPTURE &&
+	    missionitem.nav_cmd != NAV_CMD_IMAGE_STOP_CAPTURE &&
+	    missionitem.nav_cmd != NAV_CMD_VIDEO_START_CAPTURE &&
+	    missionitem.nav_cmd != NAV_CMD_VIDEO_STOP_CAPTURE &&
+	    missionitem.nav_cmd != NAV_CMD_DO_CONTROL_VIDEO &&
+	    missionitem.nav_cmd != NAV_CMD_DO_MOUNT_CONFIGURE &&
+	    missionitem.nav_cmd != NAV_CMD_DO_MOUNT_CONTROL &&
+	    missionitem.nav_cmd != NAV_CMD_DO_SET_ROI &&
+	    missionitem.nav_cmd != NAV_CMD_DO_SET_ROI_LOCATION &&
+	    missionitem.nav_cmd != NAV_CMD_DO_SET_ROI_WPNEXT_OFFSET &&
+	    missionitem.nav_cmd != NAV_CMD_DO_SET_ROI_NONE &&
+	    missionitem.nav_cmd != NAV_CMD_DO_SET_CAM_TRIGG_DIST &&
+	    missionitem.nav_cmd != NAV_CMD_OBLIQUE_SURVEY &&
+	    missionitem.nav_cmd != NAV_CMD_DO_SET_CAM_TRIGG_INTERVAL &&
+	    missionitem.nav_cmd != NAV_CMD_SET_CAMERA_MODE &&
+	    missionitem.nav_cmd != NAV_CMD_SET_CAMERA_ZOOM &&
+	    missionitem.nav_cmd != NAV_CMD_DO_VTOL_TRANSITION) {
+
+		mavlink_log_critical(_navigator->get_mavlink_log_pub(), "Mission rejected: item %i: unsupported cmd: %d",
+				     (int)(index + 1), (int)missionitem.nav_cmd);
+		return false;
+	}
 
-	for (size_t i = 0; i < mission.count; i++) {
-		struct mission_item_s missionitem = {};
-		const ssize_t len = sizeof(struct mission_item_s);
+	/* Check non navigation item */
+	if (missionitem.nav_cmd == NAV_CMD_DO_SET_SERVO) {
 
-		if (dm_read((dm_item_t)mission.dataman_id, i, &missionitem, len) != len) {
-			/* not supposed to happen unless the datamanager can't access the SD card, etc. */
+		/* check actuator number */
+		if (missionitem.params[0] < 0 || missionitem.params[0] > 5) {
+			mavlink_log_critical(_navigator->get_mavlink_log_pub(), "Actuator number %d is out of bounds 0..5",
+					     (int)missionitem.params[0]);
 			return false;
 		}
 
-		// look for a takeoff waypoint
-		if (missionitem.nav_cmd == NAV_CMD_TAKEOFF) {
-			// make sure that the altitude of the waypoint is at least one meter larger than the acceptance radius
-			// this makes sure that the takeoff waypoint is not reached before we are at least one meter in the air
+		/* check actuator value */
+		if (missionitem.params[1] < -PWM_DEFAULT_MAX || missionitem.params[1] > PWM_DEFAULT_MAX) {
+			mavlink_log_critical(_navigator->get_mavlink_log_pub(),
+					     "Actuator value %d is out of bounds -PWM_DEFAULT_MAX..PWM_DEFAULT_MAX", (int)missionitem.params[1]);
+			return false;
+		}
+	}
 
-			float takeoff_alt = missionitem.altitude_is_relative
-					    ? missionitem.altitude
-					    : missionitem.altitude - home_alt;
+	// check if the mission starts with a land command while the vehicle is landed
+	if ((index == 0) && missionitem.nav_cmd == NAV_CMD_LAND && _navigator->get_land_detected()->landed) {
 
-			// check if we should use default acceptance radius
-			float acceptance_radius = _navigator->get_default_acceptance_radius();
+		mavlink_log_critical(_navigator->get_mavlink_log_pub(), "Mission rejected: starts with landing");
+		return false;
+	}
 
-			if (missionitem.acceptance_radius > NAV_EPSILON_POSITION) {
-				acceptance_radius = missionitem.acceptance_radius;
-			}
+	return true;
+}
 
-			if (takeoff_alt - 1.0f < acceptance_radius) {
-				mavlink_log_critical(_navigator->get_mavlink_log_pub(), "Mission rejected: Takeoff altitude too low!");
-				return false;
-			}
+bool
+MissionFeasibilityChecker::checkTakeoff(const mission_item_s &missionitem, const mission_item_s &previous,
+					size_t index, float home_alt, TakeoffState &state)
+{
+	// look for a takeoff waypoint
+	if (missionitem.nav_cmd == NAV_CMD_TAKEOFF) {
+		// make sure that the altitude of the waypoint is at least one meter larger than the acceptance radius
+		// this makes sure that the takeoff waypoint is not reached before we are at least one meter in the air
 
-			// tell that mission has a takeoff waypoint
-			has_takeoff = true;
+		float takeoff_alt = missionitem.altitude_is_relative
+				    ? missionitem.altitude
+				    : missionitem.altitude - home_alt;
 
-			// tell that a takeoff waypoint is the first "waypoint"
-			// mission item
-			if (i == 0) {
-				takeoff_first = true;
+		// check if we should use default acceptance radius
+		float acceptance_radius = _navigator->get_default_acceptance_radius();
 
-			} else if (takeoff_index == -1) {
-				// stores the index of the first takeoff waypoint
-				takeoff_index = i;
-			}
+		if (missionitem.acceptance_radius > NAV_EPSILON_POSITION) {
+			acceptance_radius = missionitem.acceptance_radius;
 		}
-	}
 
-	if (takeoff_index != -1) {
-		// checks if all the mission items before the first takeoff waypoint
-		// are not waypoints or position-related items;
-		// this means that, before a takeoff waypoint, one can set
-		// one of the bellow mission items
-		for (size_t i = 0; i < (size_t)takeoff_index; i++) {
-			struct mission_item_s missionitem = {};
-			const ssize_t len = sizeof(struct mission_item_s);
-
-			if (dm_read((dm_item_t)mission.dataman_id, i, &missionitem, len) != len) {
-				/* not supposed to happen unless the datamanager can't access the SD card, etc. */
-				return false;
-			}
+		if (takeoff_alt - 1.0f < acceptance_radius) {
+			mavlink_log_critical(_navigator->get_mavlink_log_pub(), "Mission rejected: Takeoff altitude too low!");
+			return false;
+		}
 
-			takeoff_first = !(missionitem.nav_cmd != NAV_CMD_IDLE &&
-					  missionitem.nav_cmd != NAV_CMD_DELAY &&
-					  missionitem.nav_cmd != NAV_CMD_DO_JUMP &&
-					  missionitem.nav_cmd != NAV_CMD_DO_CHANGE_SPEED &&
-					  missionitem.nav_cmd != NAV_CMD_DO_SET_HOME &&
-					  missionitem.nav_cmd != NAV_CMD_DO_SET_SERVO &&
-					  missionitem.nav_cmd != NAV_CMD_DO_LAND_START &&
-					  missionitem.nav_cmd != NAV_CMD_DO_TRIGGER_CONTROL &&
-					  missionitem.nav_cmd != NAV_CMD_DO_DIGICAM_CONTROL &&
-					  missionitem.nav_cmd != NAV_CMD_IMAGE_START_CAPTURE &&
-					  missionitem.nav_cmd != NAV_CMD_IMAGE_STOP_CAPTURE &&
-					  missionitem.nav_cmd != NAV_CMD_VIDEO_START_CAPTURE &&
-					  missionitem.nav_cmd != NAV_CMD_VIDEO_STOP_CAPTURE &&
-					  missionitem.nav_cmd != NAV_CMD_DO_CONTROL_VIDEO &&
-					  missionitem.nav_cmd != NAV_CMD_DO_MOUNT_CONFIGURE &&
-					  missionitem.nav_cmd != NAV_CMD_DO_MOUNT_CONTROL &&
-					  missionitem.nav_cmd != NAV_CMD_DO_SET_ROI &&
-					  missionitem.nav_cmd != NAV_CMD_DO_SET_ROI_LOCATION &&
-					  missionitem.nav_cmd != NAV_CMD_DO_SET_ROI_WPNEXT_OFFSET &&
-					  missionitem.nav_cmd != NAV_CMD_DO_SET_ROI_NONE &&
-					  missionitem.nav_cmd != NAV_CMD_DO_SET_CAM_TRIGG_DIST &&
-					  missionitem.nav_cmd != NAV_CMD_OBLIQUE_SURVEY &&
-					  missionitem.nav_cmd != NAV_CMD_DO_SET_CAM_TRIGG_INTERVAL &&
-					  missionitem.nav_cmd != NAV_CMD_SET_CAMERA_MODE &&
-					  missionitem.nav_cmd != NAV_CMD_SET_CAMERA_ZOOM &&
-					  missionitem.nav_cmd != NAV_CMD_DO_VTOL_TRANSITION);
+		// tell that mission has a takeoff waypoint
+		state.has_takeoff = true;
+
+		// tell that a takeoff waypoint is the first "waypoint"
+		// mission item
+		if (index == 0) {
+			state.takeoff_first = true;
+
+		} else if (state.takeoff_index == -1) {
+			// stores the index of the first takeoff waypoint
+			state.takeoff_index = index;
+
+			// checks if the mission item before the first takeoff waypoint
+			// is not a waypoint or position-related item;
+			// this means that, before a takeoff waypoint, one can set
+			// one of the bellow mission items
+			state.takeoff_first = !(previous.nav_cmd != NAV_CMD_IDLE &&
+						previous.nav_cmd != NAV_CMD_DELAY &&
+						previous.nav_cmd != NAV_CMD_DO_JUMP &&
+						previous.nav_cmd != NAV_CMD_DO_CHANGE_SPEED &&
+						previous.nav_cmd != NAV_CMD_DO_SET_HOME &&
+						previous.nav_cmd != NAV_CMD_DO_SET_SERVO &&
+						previous.nav_cmd != NAV_CMD_DO_LAND_START &&
+						previous.nav_cmd != NAV_CMD_DO_TRIGGER_CONTROL &&
+						previous.nav_cmd != NAV_CMD_DO_DIGICAM_CONTROL &&
+						previous.nav_cmd != NAV_CMD_IMAGE_START_CAPTURE &&
+						previous.nav_cmd != NAV_CMD_IMAGE_STOP_CAPTURE &&
+						previous.nav_cmd != NAV_CMD_VIDEO_START_CAPTURE &&
+						previous.nav_cmd != NAV_CMD_VIDEO_STOP_CAPTURE &&
+						previous.nav_cmd != NAV_CMD_DO_CONTROL_VIDEO &&
+						previous.nav_cmd != NAV_CMD_DO_MOUNT_CONFIGURE &&
+						previous.nav_cmd != NAV_CMD_DO_MOUNT_CONTROL &&
+						previous.nav_cmd != NAV_CMD_DO_SET_ROI &&
+						previous.nav_cmd != NAV_CMD_DO_SET_ROI_LOCATION &&
+						previous.nav_cmd != NAV_CMD_DO_SET_ROI_WPNEXT_OFFSET &&
+						previous.nav_cmd != NAV_CMD_DO_SET_ROI_NONE &&
+						previous.nav_cmd != NAV_CMD_DO_SET_CAM_TRIGG_DIST &&
+						previous.nav_cmd != NAV_CMD_OBLIQUE_SURVEY &&
+						previous.nav_cmd != NAV_CMD_DO_SET_CAM_TRIGG_INTERVAL &&
+						previous.nav_cmd != NAV_CMD_SET_CAMERA_MODE &&
+						previous.nav_cmd != NAV_CMD_SET_CAMERA_ZOOM &&
+						previous.nav_cmd != NAV_CMD_DO_VTOL_TRANSITION);
 		}
 	}
 
+	return true;
+}
+
+bool
+MissionFeasibilityChecker::checkTakeoffResult(const TakeoffState &state)
+{
 	if (_navigator->get_takeoff_required() && _navigator->get_land_detected()->landed) {
 		// check for a takeoff waypoint, after the above conditions have been met
 		// MIS_TAKEOFF_REQ param has to be set and the vehicle has to be landed - one can load a mission
 		// while the vehicle is flying and it does not require a takeoff waypoint
-		if (!has_takeoff) {
+		if (!state.has_takeoff) {
 			mavlink_log_critical(_navigator->get_mavlink_log_pub(), "Mission rejected: takeoff waypoint required.");
 			return false;
 
-		} else if (!takeoff_first) {
+		} else if (!state.takeoff_first) {
 			// check if the takeoff waypoint is the first waypoint item on the mission
 			// i.e, an item with position/attitude change modification
 			// if it is not, the mission should be rejected
@@ -424,194 +491,143 @@ MissionFeasibilityChecker::checkTakeoff(const mission_s &mission, float home_alt
 }
 
 bool
-MissionFeasibilityChecker::checkFixedWingLanding(const mission_s &mission, bool land_start_req)
+MissionFeasibilityChecker::checkFixedWingLanding(const mission_item_s &missionitem,
+		const mission_item_s &missionitem_previous, size_t index, LandingState &state)
 {
-	/* Go through all mission items and search for a landing waypoint
+	/* Search for a landing waypoint
 	 * if landing waypoint is found: the previous waypoint is checked to be at a feasible distance and altitude given the landing slope */
 
-	bool landing_valid = false;
-
-	bool land_start_found = false;
-	size_t do_land_start_index = 0;
-	size_t landing_approach_index = 0;
-
-	for (size_t i = 0; i < mission.count; i++) {
-		struct mission_item_s missionitem;
-		const ssize_t len = sizeof(missionitem);
-
-		if (dm_read((dm_item_t)mission.dataman_id, i, &missionitem, len) != len) {
-			/* not supposed to happen unless the datamanager can't access the SD card, etc. */
+	// if DO_LAND_START found then require valid landing AFTER
+	if (missionitem.nav_cmd == NAV_CMD_DO_LAND_START) {
+		if (state.land_start_found) {
+			mavlink_log_critical(_navigator->get_mavlink_log_pub(), "Mission rejected: more than one land start.");
 			return false;
-		}
-
-		// if DO_LAND_START found then require valid landing AFTER
-		if (missionitem.nav_cmd == NAV_CMD_DO_LAND_START) {
-			if (land_start_found) {
-				mavlink_log_critical(_navigator->get_mavlink_log_pub(), "Mission rejected: more than one land start.");
-				return false;
 
-			} else {
-				land_start_found = true;
-				do_land_start_index = i;
-			}
+		} else {
+			state.land_start_found = true;
+			state.do_land_start_index = index;
 		}
+	}
 
-		if (missionitem.nav_cmd == NAV_CMD_LAND) {
-			mission_item_s missionitem_previous {};
-
-			if (i > 0) {
-				landing_approach_index = i - 1;
-
-				if (dm_read((dm_item_t)mission.dataman_id, landing_approach_index, &missionitem_previous, len) != len) {
-					/* not supposed to happen unless the datamanager can't access the SD card, etc. */
-					return false;
-				}
-
-				if (MissionBlock::item_contains_position(missionitem_previous)) {
+	if (missionitem.nav_cmd == NAV_CMD_LAND) {
+		if (index > 0) {
+			state.landing_approach_index = index - 1;
 
-					uORB::SubscriptionData<position_controller_landing_status_s> landing_status{ORB_ID(position_controller_landing_status)};
+			if (MissionBlock::item_contains_position(missionitem_previous)) {
 
-					const bool landing_status_valid = (landing_status.get().timestamp > 0);
-					const float wp_distance = get_distance_to_next_waypoint(missionitem_previous.lat, missionitem_previous.lon,
-								  missionitem.lat, missionitem.lon);
+				uORB::SubscriptionData<position_controller_landing_status_s> landing_status{ORB_ID(position_controller_landing_status)};
 
-					if (landing_status_valid && (wp_distance > landing_status.get().flare_length)) {
-						/* Last wp is before flare region */
+				const bool landing_status_valid = (landing_status.get().timestamp > 0);
+				const float wp_distance = get_distance_to_next_waypoint(missionitem_previous.lat, missionitem_previous.lon,
+							  missionitem.lat, missionitem.lon);
 
-						const float delta_altitude = missionitem.altitude - missionitem_previous.altitude;
+				if (landing_status_valid && (wp_distance > landing_status.get().flare_length)) {
+					/* Last wp is before flare region */
 
-						if (delta_altitude < 0) {
+					const float delta_altitude = missionitem.altitude - missionitem_previous.altitude;
 
-							const float horizontal_slope_displacement = landing_status.get().horizontal_slope_displacement;
-							const float slope_angle_rad = landing_status.get().slope_angle_rad;
-							const float slope_alt_req = Landingslope::getLandingSlopeAbsoluteAltitude(wp_distance, missionitem.altitude,
-										    horizontal_slope_displacement, slope_angle_rad);
+					if (delta_altitude < 0) {
 
-							if (missionitem_previous.altitude > slope_alt_req + 1.0f) {
-								/* Landing waypoint is above altitude of slope at the given waypoint distance (with small tolerance for floating point discrepancies) */
-								mavlink_log_critical(_navigator->get_mavlink_log_pub(), "Mission rejected: adjust landing approach.");
+						const float horizontal_slope_displacement = landing_status.get().horizontal_slope_displacement;
+						const float slope_angle_rad = landing_status.get().slope_angle_rad;
+						const float slope_alt_req = Landingslope::getLandingSlopeAbsoluteAltitude(wp_distance, missionitem.altitude,
+									    horizontal_slope_displacement, slope_angle_rad);
 
-								const float wp_distance_req = Landingslope::getLandingSlopeWPDistance(missionitem_previous.altitude,
-											      missionitem.altitude, horizontal_slope_displacement, slope_angle_rad);
+						if (missionitem_previous.altitude > slope_alt_req + 1.0f) {
+							/* Landing waypoint is above altitude of slope at the given waypoint distance (with small tolerance for floating point discrepancies) */
+							mavlink_log_critical(_navigator->get_mavlink_log_pub(), "Mission rejected: adjust landing approach.");
 
-								mavlink_log_critical(_navigator->get_mavlink_log_pub(), "Move down %d m or move further away by %d m.",
-										     (int)ceilf(slope_alt_req - missionitem_previous.altitude),
-										     (int)ceilf(wp_distance_req - wp_distance));
+							const float wp_distance_req = Landingslope::getLandingSlopeWPDistance(missionitem_previous.altitude,
+										      missionitem.altitude, horizontal_slope_displacement, slope_angle_rad);
 
-								return false;
-							}
+							mavlink_log_critical(_navigator->get_mavlink_log_pub(), "Move down %d m or move further away by %d m.",
+									     (int)ceilf(slope_alt_req - missionitem_previous.altitude),
+									     (int)ceilf(wp_distance_req - wp_distance));
 
-						} else {
-							/* Landing waypoint is above last waypoint */
-							mavlink_log_critical(_navigator->get_mavlink_log_pub(), "Mission rejected: landing above last waypoint.");
 							return false;
 						}
 
 					} else {
-						/* Last wp is in flare region */
-						mavlink_log_critical(_navigator->get_mavlink_log_pub(), "Mission rejected: waypoint within landing flare.");
+						/* Landing waypoint is above last waypoint */
+						mavlink_log_critical(_navigator->get_mavlink_log_pub(), "Mission rejected: landing above last waypoint.");
 						return false;
 					}
 
-					landing_valid = true;
-
 				} else {
-					// mission item before land doesn't have a position
-					mavlink_log_critical(_navigator->get_mavlink_log_pub(), "Mission rejected: need landing approach.");
+					/* Last wp is in flare region */
+					mavlink_log_critical(_navigator->get_mavlink_log_pub(), "Mission rejected: waypoint within landing flare.");
 					return false;
 				}
 
+				state.landing_valid = true;
+
 			} else {
-				mavlink_log_critical(_navigator->get_mavlink_log_pub(), "Mission rejected: starts with land waypoint.");
+				// mission item before land doesn't have a position
+				mavlink_log_critical(_navigator->get_mavlink_log_pub(), "Mission rejected: need landing approach.");
 				return false;
 			}
 
-		} else if (missionitem.nav_cmd == NAV_CMD_RETURN_TO_LAUNCH) {
-			if (land_start_found && do_land_start_index < i) {
-				mavlink_log_critical(_navigator->get_mavlink_log_pub(),
-						     "Mission rejected: land start item before RTL item not possible.");
-				return false;
-			}
+		} else {
+			mavlink_log_critical(_navigator->get_mavlink_log_pub(), "Mission rejected: starts with land waypoint.");
+			return false;
 		}
-	}
 
-	if (land_start_req && !land_start_found) {
-		mavlink_log_critical(_navigator->get_mavlink_log_pub(), "Mission rejected: landing pattern required.");
-		return false;
-	}
-
-	if (land_start_found && (!landing_valid || (do_land_start_index > landing_approach_index))) {
-		mavlink_log_critical(_navigator->get_mavlink_log_pub(), "Mission rejected: invalid land start.");
-		return false;
+	} else if (missionitem.nav_cmd == NAV_CMD_RETURN_TO_LAUNCH) {
+		if (state.land_start_found && state.do_land_start_index < index) {
+			mavlink_log_critical(_navigator->get_mavlink_log_pub(),
+					     "Mission rejected: land start item before RTL item not possible.");
+			return false;
+		}
 	}
 
-	/* No landing waypoints or no waypoints */
 	return true;
 }
 
 bool
-MissionFeasibilityChecker::checkVTOLLanding(const mission_s &mission, bool land_start_req)
+MissionFeasibilityChecker::checkVTOLLanding(const mission_item_s &missionitem, size_t index, LandingState &state)
 {
-	/* Go through all mission items and search for a landing waypoint
-	 * if landing waypoint is found: the previous waypoint is checked to be at a feasible distance and altitude given the landing slope */
-
-	bool land_start_found = false;
-	size_t do_land_start_index = 0;
-	size_t landing_approach_index = 0;
-
-	for (size_t i = 0; i < mission.count; i++) {
-		struct mission_item_s missionitem;
-		const ssize_t len = sizeof(missionitem);
-
-		if (dm_read((dm_item_t)mission.dataman_id, i, &missionitem, len) != len) {
-			/* not supposed to happen unless the datamanager can't access the SD card, etc. */
+	// if DO_LAND_START found then require valid landing AFTER
+	if (missionitem.nav_cmd == NAV_CMD_DO_LAND_START) {
+		if (state.land_start_found) {
+			mavlink_log_critical(_navigator->get_mavlink_log_pub(), "Mission rejected: more than one land start.");
 			return false;
-		}
-
-		// if DO_LAND_START found then require valid landing AFTER
-		if (missionitem.nav_cmd == NAV_CMD_DO_LAND_START) {
-			if (land_start_found) {
-				mavlink_log_critical(_navigator->get_mavlink_log_pub(), "Mission rejected: more than one land start.");
-				return false;
 
-			} else {
-				land_start_found = true;
-				do_land_start_index = i;
-			}
+		} else {
+			state.land_start_found = true;
+			state.do_land_start_index = index;
 		}
+	}
 
-		if (missionitem.nav_cmd == NAV_CMD_LAND || missionitem.nav_cmd == NAV_CMD_VTOL_LAND) {
-			mission_item_s missionitem_previous {};
-
-			if (i > 0) {
-				landing_approach_index = i - 1;
-
-				if (dm_read((dm_item_t)mission.dataman_id, landing_approach_index, &missionitem_previous, len) != len) {
-					/* not supposed to happen unless the datamanager can't access the SD card, etc. */
-					return false;
-				}
-
+	if (missionitem.nav_cmd == NAV_CMD_LAND || missionitem.nav_cmd == NAV_CMD_VTOL_LAND) {
+		if (index > 0) {
+			state.landing_approach_index = index - 1;
 
-			} else {
-				mavlink_log_critical(_navigator->get_mavlink_log_pub(), "Mission rejected: starts with land waypoint.");
-				return false;
-			}
+		} else {
+			mavlink_log_critical(_navigator->get_mavlink_log_pub(), "Mission rejected: starts with land waypoint.");
+			return false;
+		}
 
-		} else if (missionitem.nav_cmd == NAV_CMD_RETURN_TO_LAUNCH) {
-			if (land_start_found && do_land_start_index < i) {
-				mavlink_log_critical(_navigator->get_mavlink_log_pub(),
-						     "Mission rejected: land start item before RTL item not possible.");
-				return false;
-			}
+	} else if (missionitem.nav_cmd == NAV_CMD_RETURN_TO_LAUNCH) {
+		if (state.land_start_found && state.do_land_start_index < index) {
+			mavlink_log_critical(_navigator->get_mavlink_log_pub(),
+					     "Mission rejected: land start item before RTL item not possible.");
+			return false;
 		}
 	}
 
-	if (land_start_req && !land_start_found) {
+	return true;
+}
+
+bool
+MissionFeasibilityChecker::checkLandingResult(const LandingState &state, bool land_start_req, bool landing_required)
+{
+	if (land_start_req && !state.land_start_found) {
 		mavlink_log_critical(_navigator->get_mavlink_log_pub(), "Mission rejected: landing pattern required.");
 		return false;
 	}
 
-	if (land_start_found && (do_land_start_index > landing_approach_index)) {
+	if (state.land_start_found && ((landing_required && !state.landing_valid)
+				       || (state.do_land_start_index > state.landing_approach_index))) {
 		mavlink_log_critical(_navigator->get_mavlink_log_pub(), "Mission rejected: invalid land start.");
 		return false;
 	}
@@ -621,123 +637,85 @@ MissionFeasibilityChecker::checkVTOLLanding(const mission_s &mission, bool land_
 }
 
 bool
-MissionFeasibilityChecker::checkDistanceToFirstWaypoint(const mission_s &mission, float max_distance)
+MissionFeasibilityChecker::checkDistanceToFirstWaypoint(const mission_item_s &mission_item, float max_distance,
+		bool &done)
 {
-	if (max_distance <= 0.0f) {
-		/* param not set, check is ok */
+	/* check only items with valid lat/lon, the first one decides */
+	if (!MissionBlock::item_contains_position(mission_item)) {
 		return true;
 	}
 
-	/* find first waypoint (with lat/lon) item in datamanager */
-	for (size_t i = 0; i < mission.count; i++) {
+	done = true;
 
-		struct mission_item_s mission_item {};
+	/* check distance from current position to item */
+	float dist_to_1wp = get_distance_to_next_waypoint(
+				    mission_item.lat, mission_item.lon,
+				    _navigator->get_home_position()->lat, _navigator->get_home_position()->lon);
 
-		if (!(dm_read((dm_item_t)mission.dataman_id, i, &mission_item, sizeof(mission_item_s)) == sizeof(mission_item_s))) {
-			/* error reading, mission is invalid */
-			mavlink_log_info(_navigator->get_mavlink_log_pub(), "Error reading offboard mission.");
-			return false;
-		}
+	if (dist_to_1wp < max_distance) {
 
-		/* check only items with valid lat/lon */
-		if (!MissionBlock::item_contains_position(mission_item)) {
-			continue;
-		}
-
-		/* check distance from current position to item */
-		float dist_to_1wp = get_distance_to_next_waypoint(
-					    mission_item.lat, mission_item.lon,
-					    _navigator->get_home_position()->lat, _navigator->get_home_position()->lon);
-
-		if (dist_to_1wp < max_distance) {
-
-			return true;
+		return true;
 
-		} else {
-			/* item is too far from home */
-			mavlink_log_critical(_navigator->get_mavlink_log_pub(),
-					     "First waypoint too far away: %d meters, %d max.",
-					     (int)dist_to_1wp, (int)max_distance);
+	} else {
+		/* item is too far from home */
+		mavlink_log_critical(_navigator->get_mavlink_log_pub(),
+				     "First waypoint too far away: %d meters, %d max.",
+				     (int)dist_to_1wp, (int)max_distance);
 
-			_navigator->get_mission_result()->warning = true;
-			return false;
-		}
+		_navigator->get_mission_result()->warning = true;
+		return false;
 	}
-
-	/* no waypoints found in mission, then we will not fly far away */
-	return true;
 }
 
 bool
-MissionFeasibilityChecker::checkDistancesBetweenWaypoints(const mission_s &mission, float max_distance)
+MissionFeasibilityChecker::checkDistancesBetweenWaypoints(const mission_item_s &mission_item, float max_distance,
+		WaypointDistanceState &state)
 {
-	if (max_distance <= 0.0f) {
-		/* param not set, check is ok */
+	/* check only items with valid lat/lon */
+	if (!MissionBlock::item_contains_position(mission_item)) {
 		return true;
 	}
 
-	double last_lat = (double)NAN;
-	double last_lon = (double)NAN;
-	int last_cmd = 0;
-
-	/* Go through all waypoints */
-	for (size_t i = 0; i < mission.count; i++) {
-
-		struct mission_item_s mission_item {};
-
-		if (!(dm_read((dm_item_t)mission.dataman_id, i, &mission_item, sizeof(mission_item_s)) == sizeof(mission_item_s))) {
-			/* error reading, mission is invalid */
-			mavlink_log_info(_navigator->get_mavlink_log_pub(), "Error reading offboard mission.");
-			return false;
-		}
-
-		/* check only items with valid lat/lon */
-		if (!MissionBlock::item_contains_position(mission_item)) {
-			continue;
-		}
-
-		/* Compare it to last waypoint if already available. */
-		if (PX4_ISFINITE(last_lat) && PX4_ISFINITE(last_lon)) {
+	/* Compare it to last waypoint if already available. */
+	if (PX4_ISFINITE(state.last_lat) && PX4_ISFINITE(state.last_lon)) {
 
-			/* check distance from current position to item */
-			const float dist_between_waypoints = get_distance_to_next_waypoint(
-					mission_item.lat, mission_item.lon,
-					last_lat, last_lon);
+		/* check distance from current position to item */
+		const float dist_between_waypoints = get_distance_to_next_waypoint(
+				mission_item.lat, mission_item.lon,
+				state.last_lat, state.last_lon);
 
 
-			if (dist_between_waypoints > max_distance) {
-				/* distance between waypoints is too high */
-				mavlink_log_critical(_navigator->get_mavlink_log_pub(),
-						     "Distance between waypoints too far: %d meters, %d max.",
-						     (int)dist_between_waypoints, (int)max_distance);
+		if (dist_between_waypoints > max_distance) {
+			/* distance between waypoints is too high */
+			mavlink_log_critical(_navigator->get_mavlink_log_pub(),
+					     "Distance between waypoints too far: %d meters, %d max.",
+					     (int)dist_between_waypoints, (int)max_distance);
 
-				_navigator->get_mission_result()->warning = true;
-				return false;
+			_navigator->get_mission_result()->warning = true;
+			return false;
 
-				/* do not allow waypoints that are literally on top of each other */
+			/* do not allow waypoints that are literally on top of each other */
 
-				/* and do not allow condition gates that are at the same position as a navigation waypoint */
+			/* and do not allow condition gates that are at the same position as a navigation waypoint */
 
-			} else if (dist_between_waypoints < 0.05f &&
-				   (mission_item.nav_cmd == NAV_CMD_CONDITION_GATE || last_cmd == NAV_CMD_CONDITION_GATE)) {
+		} else if (dist_between_waypoints < 0.05f &&
+			   (mission_item.nav_cmd == NAV_CMD_CONDITION_GATE || state.last_cmd == NAV_CMD_CONDITION_GATE)) {
 
-				/* Waypoints and gate are at the exact same position, which indicates an
-				 * invalid mission and makes calculating the direction from one waypoint
-				 * to another impossible. */
-				mavlink_log_critical(_navigator->get_mavlink_log_pub(),
-						     "Distance between waypoint and gate too close: %d meters",
-						     (int)dist_between_waypoints);
+			/* Waypoints and gate are at the exact same position, which indicates an
+			 * invalid mission and makes calculating the direction from one waypoint
+			 * to another impossible. */
+			mavlink_log_critical(_navigator->get_mavlink_log_pub(),
+					     "Distance between waypoint and gate too close: %d meters",
+					     (int)dist_between_waypoints);
 
-				_navigator->get_mission_result()->warning = true;
-				return false;
-			}
+			_navigator->get_mission_result()->warning = true;
+			return false;
 		}
-
-		last_lat = mission_item.lat;
-		last_lon = mission_item.lon;
-		last_cmd = mission_item.nav_cmd;
 	}
 
-	/* We ran through all waypoints and have not found any distances between waypoints that are too far. */
+	state.last_lat = mission_item.lat;
+	state.last_lon = mission_item.lon;
+	state.last_cmd = mission_item.nav_cmd;
+
 	return true;
 }
@@ -42,9 +42,13 @@
 
 #pragma once
 
+#include <math.h>
+
 #include <dataman/dataman.h>
 #include <uORB/topics/mission.h>
 
+#include "navigation.h"
+
 class Geofence;
 class Navigator;
 
@@ -53,28 +57,79 @@ class MissionFeasibilityChecker
 private:
 	Navigator *_navigator{nullptr};
 
-	/* Checks for all airframes */
-	bool checkGeofence(const mission_s &mission, float home_alt, bool home_valid);
-
-	bool checkHomePositionAltitude(const mission_s &mission, float home_alt, bool home_alt_valid, bool throw_error);
-
-	bool checkMissionItemValidity(const mission_s &mission);
-
-	bool checkDistanceToFirstWaypoint(const mission_s &mission, float max_distance);
-	bool checkDistancesBetweenWaypoints(const mission_s &mission, float max_distance);
-
-	bool checkTakeoff(const mission_s &mission, float home_alt);
+	/* state of the checks that look at more than one mission item */
+	struct WaypointDistanceState {
+		double last_lat{(double)NAN};
+		double last_lon{(double)NAN};
+		int last_cmd{0};
+	};
+
+	struct TakeoffState {
+		bool has_takeoff{false};
+		bool takeoff_first{false};
+		int takeoff_index{-1};
+	};
+
+	struct LandingState {
+		bool landing_valid{false};
+		bool land_start_found{false};
+		size_t do_land_start_index{0};
+		size_t landing_approach_index{0};
+	};
+
+	/* geofence result per mission item, reused while the item and the check context are unchanged */
+	struct ItemCache {
+		// the fields of the item the geofence result depends on
+		double lat;
+		double lon;
+		float altitude;
+		bool altitude_is_relative;
+
+		bool geofence_checked;
+		bool geofence_inside;
+	};
+
+	struct CacheContext {
+		double home_lat{0.0};
+		double home_lon{0.0};
+		float home_alt{0.f};
+		bool home_valid{false};
+		uint16_t fence_update_counter{0};
+		uint32_t param_hash{0};
+	};
+
+	/* the first items of a mission are cached, later ones are checked every time */
+	static constexpr size_t ITEM_CACHE_SIZE = (NUM_MISSIONS_SUPPORTED < 64) ? NUM_MISSIONS_SUPPORTED : 64;
+
+	ItemCache _item_cache[ITEM_CACHE_SIZE] {};
+	CacheContext _cache_context{};
+
+	/* Invalidates the cached results if the check context changed */
+	void updateItemCache(bool home_valid);
+
+	/* Checks for all airframes, called for every mission item in order */
+	bool checkGeofence(const mission_item_s &item, size_t index, float home_alt, bool home_valid, ItemCache *cache);
+
+	bool checkHomePositionAltitude(const mission_item_s &item, size_t index, float home_alt, bool home_alt_valid,
+				       bool throw_error, bool &done);
+
+	bool checkMissionItemValidity(const mission_item_s &item, size_t index);
+
+	bool checkDistanceToFirstWaypoint(const mission_item_s &item, float max_distance, bool &done);
+	bool checkDistancesBetweenWaypoints(const mission_item_s &item, float max_distance, WaypointDistanceState &state);
+
+	bool checkTakeoff(const mission_item_s &item, const mission_item_s &previous, size_t index, float home_alt,
+			  TakeoffState &state);
+	bool checkTakeoffResult(const TakeoffState &state);
 
 	/* Checks specific to fixedwing airframes */
-	bool checkFixedwing(const mission_s &mission, float home_alt, bool land_start_req);
-	bool checkFixedWingLanding(const mission_s &mission, bool land_start_req);
-
-	/* Checks specific to rotarywing airframes */
-	bool checkRotarywing(const mission_s &mission, float home_alt);
+	bool checkFixedWingLanding(const mission_item_s &item, const mission_item_s &previous, size_t index,
+				   LandingState &state);
 
 	/* Checks specific to VTOL airframes */
-	bool checkVTOL(const mission_s &mission, float home_alt, bool land_start_req);
-	bool checkVTOLLanding(const mission_s &mission, bool land_start_req);
+	bool checkVTOLLanding(const mission_item_s &item, size_t index, LandingState &state);
+
+	bool checkLandingResult(const LandingState &state, bool land_start_req, bool landing_required);
 
 public:
 	MissionFeasibilityChecker(Navigator *navigator) : _navigator(navigator) {}
@@ -85,6 +140,9 @@ public:
 
 	/*
 	 * Returns true if mission is feasible and false otherwise
+	 *
+	 * All checks run in a single pass over the mission items, every failing check reports its
+	 * violation. Geofence results of unchanged items are reused from the previous call.
 	 */
 	bool checkMissionFeasible(const mission_s &mission,
 				  float max_distance_to_1st_waypoint, float max_distance_between_waypoints,
@@ -171,6 +171,20 @@
 #define PX4IO_PAGE_PWM_INFO		7
 #define PX4IO_RATE_MAP_BASE			0	/* 0..CONFIG_ACTUATOR_COUNT bitmaps of PWM rate groups */
 
+/*
+ * Gather read, collects register ranges from several pages in one transaction.
+ *
+ * The offset of the read request holds the number of ranges (at most
+ * PX4IO_GATHER_MAX_RANGES) and the first two registers per range of the
+ * request hold the range descriptors: PX4IO_GATHER_ADDR(page, offset)
+ * followed by the register count. The request count must be the sum of
+ * the range counts and cover the descriptors. The reply carries the
+ * registers of all ranges back to back, in descriptor order.
+ */
+#define PX4IO_PAGE_GATHER		8
+#define PX4IO_GATHER_MAX_RANGES			8
+#define PX4IO_GATHER_ADDR(_page, _offset)	((uint16_t)(((_page) << 8) | (_offset)))
+
 /* setup page */
 #define PX4IO_PAGE_SETUP		50
 #define PX4IO_P_SETUP_FEATURES			0
@@ -55,6 +55,8 @@
 //#define DEBUG
 #include "px4io.h"
 
+#include <px4io_gather/px4io_gather.h>
+
 #if defined(PX4IO_PERF)
 # include <perf/perf_counter.h>
 
@@ -194,6 +196,23 @@ rx_handle_packet(void)
 		return;
 	}
 
+	if ((PKT_CODE(dma_packet) == PKT_CODE_READ) && (dma_packet.page == PX4IO_PAGE_GATHER)) {
+
+		/* it's a gather read - the reply replaces the range descriptors */
+		if (px4io_gather_serve(&dma_packet.regs[0], dma_packet.offset, PKT_COUNT(dma_packet), registers_get)) {
+#if defined(PX4IO_PERF)
+			perf_count(pc_regerr);
+#endif
+
+			dma_packet.count_code = PKT_CODE_ERROR;
+
+		} else {
+			dma_packet.count_code = PKT_COUNT(dma_packet) | PKT_CODE_SUCCESS;
+		}
+
+		return;
+	}
+
 	if (PKT_CODE(dma_packet) == PKT_CODE_READ) {
 
 		/* it's a read - get register pointer for reply */
@@ -59,6 +59,7 @@
 #include <stdlib.h>
 #include <string>
 
+#include <logger/delta_encoding.h>
 #include <logger/messages.h>
 
 #include "Replay.hpp"
@@ -279,9 +280,10 @@ Replay::readFlagBits(std::ifstream &file, uint16_t msg_size)
 
 	// handle & validate the flags
 	bool contains_appended_data = incompat_flags[0] & ULOG_INCOMPAT_FLAG0_DATA_APPENDED_MASK;
+	_contains_delta_data = incompat_flags[0] & ULOG_INCOMPAT_FLAG0_DATA_DELTA_MASK;
 	bool has_unknown_incompat_bits = false;
 
-	if (incompat_flags[0] & ~0x1) {
+	if (incompat_flags[0] & ~(ULOG_INCOMPAT_FLAG0_DATA_APPENDED_MASK | ULOG_INCOMPAT_FLAG0_DATA_DELTA_MASK)) {
 		has_unknown_incompat_bits = true;
 	}
 
@@ -609,8 +611,18 @@ Replay::nextDataMessage(std::ifstream &file, Subscription &subscription, int msg
 				if (msg_id == file_msg_id) {
 					if (message_header.msg_size == subscription.orb_meta->o_size_no_padding + 2) {
 						subscription.next_read_pos = cur_pos;
-						file.seekg(subscription.timestamp_offset, ios::cur);
-						file.read((char *)&subscription.next_timestamp, sizeof(subscription.next_timestamp));
+
+						if (_contains_delta_data) {
+							// keep the keyframe for the following DATA_DELTA messages
+							readSample(file, subscription, message_header.msg_type, message_header.msg_size - sizeof(file_msg_id));
+							memcpy(&subscription.next_timestamp, subscription.sample.data() + subscription.timestamp_offset,
+							       sizeof(subscription.next_timestamp));
+
+						} else {
+							file.seekg(subscription.timestamp_offset, ios::cur);
+							file.read((char *)&subscription.next_timestamp, sizeof(subscription.next_timestamp));
+						}
+
 						done = true;
 
 					} else { //sanity check failed!
@@ -627,6 +639,29 @@ Replay::nextDataMessage(std::ifstream &file, Subscription &subscription, int msg
 
 			break;
 
+		case (int)ULogMessageType::DATA_DELTA:
+			file.read((char *)&file_msg_id, sizeof(file_msg_id));
+
+			if (file) {
+				if (msg_id == file_msg_id) {
+					if (readSample(file, subscription, message_header.msg_type, message_header.msg_size - sizeof(file_msg_id))) {
+						subscription.next_read_pos = cur_pos;
+						memcpy(&subscription.next_timestamp, subscription.sample.data() + subscription.timestamp_offset,
+						       sizeof(subscription.next_timestamp));
+						done = true;
+
+					} else {
+						PX4_ERR("invalid delta message for %s (offset %i). Skipping",
+							subscription.orb_meta->o_name, (int)cur_pos);
+					}
+
+				} else { //not the one we are looking for
+					file.seekg(message_header.msg_size - sizeof(file_msg_id), ios::cur);
+				}
+			}
+
+			break;
+
 		case (int)ULogMessageType::REMOVE_LOGGED_MSG: //skip these
 		case (int)ULogMessageType::PARAMETER:
 		case (int)ULogMessageType::DROPOUT:
@@ -654,6 +689,33 @@ Replay::nextDataMessage(std::ifstream &file, Subscription &subscription, int msg
 	return file.good();
 }
 
+bool
+Replay::readSample(std::ifstream &file, Subscription &subscription, uint8_t msg_type, uint16_t payload_size)
+{
+	const size_t sample_size = subscription.orb_meta->o_size_no_padding;
+
+	if (msg_type == (int)ULogMessageType::DATA) {
+		subscription.sample.resize(subscription.orb_meta->o_size);
+		file.read((char *)subscription.sample.data(), sample_size);
+		return file.good();
+	}
+
+	_read_buffer.reserve(payload_size);
+	file.read((char *)_read_buffer.data(), payload_size);
+
+	if (!file || subscription.sample.empty()) { // no keyframe yet
+		return false;
+	}
+
+	if (!logger::delta::apply(subscription.sample.data(), sample_size, _read_buffer.data(), payload_size)) {
+		// wait for the next keyframe
+		subscription.sample.clear();
+		return false;
+	}
+
+	return true;
+}
+
 const orb_metadata *
 Replay::findTopic(const std::string &name)
 {
@@ -895,6 +957,13 @@ Replay::readTopicDataToBuffer(const Subscription &sub, std::ifstream &replay_fil
 	const size_t msg_read_size = sub.orb_meta->o_size_no_padding;
 	const size_t msg_write_size = sub.orb_meta->o_size;
 	_read_buffer.reserve(msg_write_size);
+
+	if (_contains_delta_data) {
+		// already reconstructed by nextDataMessage()
+		memcpy(_read_buffer.data(), sub.sample.data(), msg_read_size);
+		return;
+	}
+
 	replay_file.seekg(sub.next_read_pos + (streamoff)(ULOG_MSG_HEADER_LEN + 2)); //skip header & msg id
 	replay_file.read((char *)_read_buffer.data(), msg_read_size);
 }
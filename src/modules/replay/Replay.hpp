@@ -139,6 +139,8 @@ protected:
 
 		CompatBase *compat = nullptr;
 
+		std::vector<uint8_t> sample; ///< reconstructed current sample (only used for delta-encoded logs)
+
 		// statistics
 		int error_counter = 0;
 		int publication_counter = 0;
@@ -231,6 +233,15 @@ private:
 
 	int64_t _read_until_file_position = 1ULL << 60; ///< read limit if log contains appended data
 
+	bool _contains_delta_data{false}; ///< log may contain DATA_DELTA messages
+
+	/**
+	 * Read the payload of a DATA or DATA_DELTA message for a subscription and update subscription.sample.
+	 * The file position must be right after the msg_id.
+	 * @return false if the sample could not be reconstructed
+	 */
+	bool readSample(std::ifstream &file, Subscription &subscription, uint8_t msg_type, uint16_t payload_size);
+
 	float _accumulated_delay{0.f};
 
 	bool readFileHeader(std::ifstream &file);
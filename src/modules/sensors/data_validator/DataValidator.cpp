@@ -64,6 +64,8 @@ void DataValidator::put(uint64_t timestamp, const float val[dimensions], uint32_
 	_error_count = error_count_in;
 	_priority = priority_in;
 
+	const float event_count_inv = 1.0f / _event_count;
+
 	for (unsigned i = 0; i < dimensions; i++) {
 		if (_time_last == 0) {
 			_mean[i] = 0;
@@ -74,9 +76,8 @@ void DataValidator::put(uint64_t timestamp, const float val[dimensions], uint32_
 			float lp_val = val[i] - _lp[i];
 
 			float delta_val = lp_val - _mean[i];
-			_mean[i] += delta_val / _event_count;
+			_mean[i] += delta_val * event_count_inv;
 			_M2[i] += delta_val * (lp_val - _mean[i]);
-			_rms[i] = sqrtf(_M2[i] / (_event_count - 1));
 
 			if (fabsf(_value[i] - val[i]) < 0.000001f) {
 				_value_equal_count++;
@@ -93,24 +94,15 @@ void DataValidator::put(uint64_t timestamp, const float val[dimensions], uint32_
 	}
 
 	_time_last = timestamp;
+
+	update_confidence();
 }
 
-float DataValidator::confidence(uint64_t timestamp)
+void DataValidator::update_confidence()
 {
-
 	float ret = 1.0f;
 
-	/* check if we have any data */
-	if (_time_last == 0) {
-		_error_mask |= ERROR_FLAG_NO_DATA;
-		ret = 0.0f;
-
-	} else if (timestamp - _time_last > _timeout_interval) {
-		/* timed out - that's it */
-		_error_mask |= ERROR_FLAG_TIMEOUT;
-		ret = 0.0f;
-
-	} else if (_value_equal_count > _value_equal_count_threshold) {
+	if (_value_equal_count > _value_equal_count_threshold) {
 		/* we got the exact same sensor value N times in a row */
 		_error_mask |= ERROR_FLAG_STALE_DATA;
 		ret = 0.0f;
@@ -128,7 +120,7 @@ float DataValidator::confidence(uint64_t timestamp)
 
 	/* no critical errors */
 	if (ret > 0.0f) {
-		/* return local error density for last N measurements */
+		/* local error density for last N measurements */
 		ret = 1.0f - (_error_density / ERROR_DENSITY_WINDOW);
 
 		if (ret > 0.0f) {
@@ -136,7 +128,52 @@ float DataValidator::confidence(uint64_t timestamp)
 		}
 	}
 
-	return ret;
+	_confidence = ret;
+}
+
+float DataValidator::confidence(uint64_t timestamp)
+{
+	/* check if we have any data */
+	if (_time_last == 0) {
+		_error_mask |= ERROR_FLAG_NO_DATA;
+		return 0.0f;
+
+	} else if (timestamp - _time_last > _timeout_interval) {
+		/* timed out - that's it */
+		_error_mask |= ERROR_FLAG_TIMEOUT;
+		return 0.0f;
+
+	} else if (_confidence > 0.0f) {
+		/* no critical errors */
+		_error_mask = ERROR_FLAG_NO_ERROR;
+	}
+
+	return _confidence;
+}
+
+uint64_t DataValidator::timeout_deadline(uint64_t timestamp) const
+{
+	if (_time_last == 0 || (timestamp > _time_last && timestamp - _time_last > _timeout_interval)) {
+		/* no data or timed out, only new data changes the confidence */
+		return UINT64_MAX;
+
+	} else if (timestamp < _time_last) {
+		/* data newer than the timestamp counts as timed out until it's reached */
+		return _time_last - 1;
+	}
+
+	return _time_last + _timeout_interval;
+}
+
+float *DataValidator::rms()
+{
+	if (_event_count > 1) {
+		for (unsigned i = 0; i < dimensions; i++) {
+			_rms[i] = sqrtf(_M2[i] / (_event_count - 1));
+		}
+	}
+
+	return _rms;
 }
 
 void DataValidator::print()
@@ -148,6 +185,6 @@ void DataValidator::print()
 
 	for (unsigned i = 0; i < dimensions; i++) {
 		PX4_INFO("\tval: %8.4f, lp: %8.4f mean dev: %8.4f RMS: %8.4f conf: %8.4f", (double)_value[i],
-			 (double)_lp[i], (double)_mean[i], (double)_rms[i], (double)confidence(hrt_absolute_time()));
+			 (double)_lp[i], (double)_mean[i], (double)rms()[i], (double)confidence(hrt_absolute_time()));
 	}
 }
@@ -85,6 +85,15 @@ public:
 	 */
 	float confidence(uint64_t timestamp);
 
+	/**
+	 * Get the last timestamp for which confidence() keeps returning the same
+	 * value if no new data is put into the validator
+	 *
+	 * @param timestamp	the timestamp the confidence was last evaluated at
+	 * @return		the timestamp at which the timeout state may change next
+	 */
+	uint64_t timeout_deadline(uint64_t timestamp) const;
+
 	/**
 	 * Get the error count of this validator
 	 * @return		the error count
@@ -124,7 +133,7 @@ public:
 	 * Get the RMS values of this validator
 	 * @return		the stored RMS
 	 */
-	float *rms() { return _rms; }
+	float *rms();
 
 	/**
 	 * Print the validator value
@@ -144,7 +153,7 @@ public:
 	 *
 	 * @param threshold The number of equal values before considering the sensor stale
 	 */
-	void set_equal_value_threshold(uint32_t threshold) { _value_equal_count_threshold = threshold; }
+	void set_equal_value_threshold(uint32_t threshold) { _value_equal_count_threshold = threshold; update_confidence(); }
 
 	/**
 	 * Get the timeout value
@@ -164,6 +173,11 @@ public:
 	static constexpr uint32_t ERROR_FLAG_HIGH_ERRDENSITY = (0x00000001U << 4);
 
 private:
+	/**
+	 * Update the timeout independent part of the confidence after new data
+	 */
+	void update_confidence();
+
 	uint32_t _error_mask{ERROR_FLAG_NO_ERROR}; /**< sensor error state */
 
 	uint32_t _timeout_interval{20000}; /**< interval in which the datastream times out in us */
@@ -174,12 +188,14 @@ private:
 
 	int _error_density{0}; /**< ratio between successful reads and errors */
 
+	float _confidence{1.0f}; /**< confidence as of the last put, without the timeout check */
+
 	uint8_t _priority{0}; /**< sensor nominal priority */
 
 	float _mean[dimensions] {}; /**< mean of value */
 	float _lp[dimensions] {};   /**< low pass value */
 	float _M2[dimensions] {};   /**< RMS component value */
-	float _rms[dimensions] {};  /**< root mean square error */
+	float _rms[dimensions] {};  /**< root mean square error, computed on request */
 	float _value[dimensions] {}; /**< last value */
 
 	unsigned _value_equal_count{0}; /**< equal values in a row */
@@ -92,6 +92,7 @@ DataValidator *DataValidatorGroup::add_new_validator()
 	_last->setSibling(validator);
 	_last = validator;
 	_last->set_timeout(_timeout_interval_us);
+	_vote_pending = true;
 	return _last;
 }
 
@@ -106,6 +107,7 @@ void DataValidatorGroup::set_timeout(uint32_t timeout_interval_us)
 	}
 
 	_timeout_interval_us = timeout_interval_us;
+	_vote_pending = true;
 }
 
 void DataValidatorGroup::set_equal_value_threshold(uint32_t threshold)
@@ -117,6 +119,8 @@ void DataValidatorGroup::set_equal_value_threshold(uint32_t threshold)
 		next->set_equal_value_threshold(threshold);
 		next = next->sibling();
 	}
+
+	_vote_pending = true;
 }
 
 void DataValidatorGroup::put(unsigned index, uint64_t timestamp, const float val[3], uint32_t error_count,
@@ -129,6 +133,7 @@ void DataValidatorGroup::put(unsigned index, uint64_t timestamp, const float val
 	while (next != nullptr) {
 		if (i == index) {
 			next->put(timestamp, val, error_count, priority);
+			_vote_pending = true;
 			break;
 		}
 
@@ -139,6 +144,11 @@ void DataValidatorGroup::put(unsigned index, uint64_t timestamp, const float val
 
 float *DataValidatorGroup::get_best(uint64_t timestamp, int *index)
 {
+	/* without new data the selection can only change once a validator times out */
+	if (!_vote_pending && (timestamp >= _vote_timestamp) && (timestamp <= _vote_deadline)) {
+		*index = _curr_best;
+		return best_value();
+	}
 
 	DataValidator *next = _first;
 
@@ -150,12 +160,19 @@ float *DataValidatorGroup::get_best(uint64_t timestamp, int *index)
 	int max_priority = -1000;
 	int max_index = -1;
 	DataValidator *best = nullptr;
+	uint64_t vote_deadline = UINT64_MAX;
 
 	int i = 0;
 
 	while (next != nullptr) {
 		float confidence = next->confidence(timestamp);
 
+		const uint64_t deadline = next->timeout_deadline(timestamp);
+
+		if (deadline < vote_deadline) {
+			vote_deadline = deadline;
+		}
+
 		if (i == pre_check_best) {
 			pre_check_prio = next->priority();
 			pre_check_confidence = confidence;
@@ -219,6 +236,11 @@ float *DataValidatorGroup::get_best(uint64_t timestamp, int *index)
 		_curr_best = max_index;
 	}
 
+	_best = best;
+	_vote_pending = false;
+	_vote_timestamp = timestamp;
+	_vote_deadline = vote_deadline;
+
 	*index = max_index;
 	return (best) ? best->value() : nullptr;
 }
@@ -72,10 +72,27 @@ public:
 	/**
 	 * Get the best data triplet of the group
 	 *
+	 * The vote is only repeated if new data was put or a validator timed out
+	 * since the last call, otherwise the previous selection is returned.
+	 *
 	 * @return		pointer to the array of best values
 	 */
 	float *get_best(uint64_t timestamp, int *index);
 
+	/**
+	 * Get the index of the sensor selected by the last get_best() call
+	 *
+	 * @return		index of the best sensor or -1 if none is valid
+	 */
+	int best_index() const { return _curr_best; }
+
+	/**
+	 * Get the data of the sensor selected by the last get_best() call
+	 *
+	 * @return		pointer to the array of best values or nullptr if none is valid
+	 */
+	float *best_value() const { return (_best != nullptr) ? _best->value() : nullptr; }
+
 	/**
 	 * Get the number of failover events
 	 *
@@ -130,9 +147,15 @@ private:
 
 	uint32_t _timeout_interval_us{0}; /**< currently set timeout */
 
+	DataValidator *_best{nullptr}; /**< currently best validator */
+
 	int _curr_best{-1}; /**< currently best index */
 	int _prev_best{-1}; /**< the previous best index */
 
+	bool _vote_pending{true};   /**< new data since the last vote */
+	uint64_t _vote_timestamp{0}; /**< timestamp of the last vote */
+	uint64_t _vote_deadline{0};  /**< timestamp up to which the last vote stays valid without new data */
+
 	uint64_t _first_failover_time{0}; /**< timestamp where the first failover occured or zero if none occured */
 
 	unsigned _toggle_count{0}; /**< number of back and forth switches between two sensors */
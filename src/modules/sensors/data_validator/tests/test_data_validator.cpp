@@ -38,44 +38,44 @@
  */
 
 #include <stdint.h>
-#include <cassert>
 #include <cstdlib>
 #include <stdio.h>
 #include <math.h>
-#include <validation/data_validator.h>
-#include <validation/tests/tests_common.h>
 
+#include <gtest/gtest.h>
+
+#include "../DataValidator.hpp"
+#include "tests_common.h"
 
-void test_init()
-{
-	printf("\n--- test_init ---\n");
 
+TEST(DataValidatorTest, Init)
+{
 	uint64_t fake_timestamp = 666;
 	const uint32_t timeout_usec = 2000;//from original private value
 
 	DataValidator *validator = new DataValidator;
 	// initially there should be no siblings
-	assert(nullptr == validator->sibling());
+	EXPECT_EQ(nullptr, validator->sibling());
 	// initially we should have zero confidence
-	assert(0.0f == validator->confidence(fake_timestamp));
+	EXPECT_EQ(0.0f, validator->confidence(fake_timestamp));
 	// initially the error count should be zero
-	assert(0 == validator->error_count());
+	EXPECT_EQ(0u, validator->error_count());
 	// initially unused
-	assert(!validator->used());
+	EXPECT_FALSE(validator->used());
 	// initially no priority
-	assert(0 == validator->priority());
+	EXPECT_EQ(0, validator->priority());
 	validator->set_timeout(timeout_usec);
-	assert(validator->get_timeout() == timeout_usec);
+	EXPECT_EQ(validator->get_timeout(), timeout_usec);
 
 
 	DataValidator *sibling_validator = new DataValidator;
 	validator->setSibling(sibling_validator);
-	assert(sibling_validator == validator->sibling());
+	EXPECT_EQ(sibling_validator, validator->sibling());
 
 	//verify that with no data, confidence is zero and error mask is set
-	assert(0.0f == validator->confidence(fake_timestamp + 1));
+	EXPECT_EQ(0.0f, validator->confidence(fake_timestamp + 1));
 	uint32_t state = validator->state();
-	assert(DataValidator::ERROR_FLAG_NO_DATA == (DataValidator::ERROR_FLAG_NO_DATA & state));
+	EXPECT_TRUE(DataValidator::ERROR_FLAG_NO_DATA & state);
 
 	//verify that calling print doesn't crash tests
 	validator->print();
@@ -83,10 +83,8 @@ void test_init()
 	delete validator; //force delete
 }
 
-void test_put()
+TEST(DataValidatorTest, Put)
 {
-	printf("\n--- test_put ---\n");
-
 	uint64_t timestamp = 500;
 	const uint32_t timeout_usec = 2000;//derived from class-private value
 	float val = 3.14159f;
@@ -96,10 +94,10 @@ void test_put()
 	DataValidator *validator = new DataValidator;
 	fill_validator_with_samples(validator, sufficient_incr_value, &val, &timestamp);
 
-	assert(validator->used());
+	EXPECT_TRUE(validator->used());
 	//verify that the last value we inserted is the current validator value
 	float last_val = val - sufficient_incr_value;
-	assert(validator->value()[0] == last_val);
+	EXPECT_EQ(validator->value()[0], last_val);
 
 	// we've just provided a bunch of valid data: should be fully confident
 	float conf = validator->confidence(timestamp);
@@ -109,9 +107,9 @@ void test_put()
 		dump_validator_state(validator);
 	}
 
-	assert(1.0f == conf);
+	EXPECT_EQ(1.0f, conf);
 	// should be no errors
-	assert(0 == validator->state());
+	EXPECT_EQ(0u, validator->state());
 
 	//now check confidence much beyond the timeout window-- should timeout
 	conf = validator->confidence(timestamp + (1.1 * timeout_usec));
@@ -121,8 +119,8 @@ void test_put()
 		dump_validator_state(validator);
 	}
 
-	assert(0.0f == conf);
-	assert(DataValidator::ERROR_FLAG_TIMEOUT == (DataValidator::ERROR_FLAG_TIMEOUT & validator->state()));
+	EXPECT_EQ(0.0f, conf);
+	EXPECT_TRUE(DataValidator::ERROR_FLAG_TIMEOUT & validator->state());
 
 	delete validator; //force delete
 }
@@ -130,10 +128,8 @@ void test_put()
 /**
  * Verify that the DataValidator detects sensor data that does not vary sufficiently
  */
-void test_stale_detector()
+TEST(DataValidatorTest, StaleDetector)
 {
-	printf("\n--- test_stale_detector ---\n");
-
 	uint64_t timestamp = 500;
 	float val = 3.14159f;
 	//derived from class-private value, this is insufficient to avoid stale detection:
@@ -143,7 +139,7 @@ void test_stale_detector()
 	fill_validator_with_samples(validator, insufficient_incr_value, &val, &timestamp);
 
 	// data is stale: should have no confidence
-	assert(0.0f == validator->confidence(timestamp));
+	EXPECT_EQ(0.0f, validator->confidence(timestamp));
 
 	// should be a stale error
 	uint32_t state = validator->state();
@@ -152,7 +148,7 @@ void test_stale_detector()
 		dump_validator_state(validator);
 	}
 
-	assert(DataValidator::ERROR_FLAG_STALE_DATA == (DataValidator::ERROR_FLAG_STALE_DATA & state));
+	EXPECT_TRUE(DataValidator::ERROR_FLAG_STALE_DATA & state);
 
 	delete validator; //force delete
 }
@@ -160,9 +156,8 @@ void test_stale_detector()
 /**
  * Verify the RMS error calculated by the DataValidator for a series of samples
  */
-void test_rms_calculation()
+TEST(DataValidatorTest, RmsCalculation)
 {
-	printf("\n--- test_rms_calculation ---\n");
 	const int equal_value_count = 100; //default is private VALUE_EQUAL_COUNT_DEFAULT
 	const float mean_value = 3.14159f;
 	const uint32_t sample_count = 1000;
@@ -174,13 +169,13 @@ void test_rms_calculation()
 
 	insert_values_around_mean(validator, mean_value, sample_count, &expected_rms_err, &timestamp);
 	float *rms = validator->rms();
-	assert(nullptr != rms);
+	ASSERT_NE(nullptr, rms);
 	float calc_rms_err = rms[0];
 	float diff = fabsf(calc_rms_err - expected_rms_err);
 	float diff_frac = (diff / expected_rms_err);
 	printf("rms: %f expect: %f diff: %f frac: %f\n", (double)calc_rms_err, (double)expected_rms_err,
 	       (double)diff, (double)diff_frac);
-	assert(diff_frac < 0.03f);
+	EXPECT_LT(diff_frac, 0.03f);
 
 	delete validator; //force delete
 }
@@ -188,9 +183,10 @@ void test_rms_calculation()
 /**
  * Verify error tracking performed by DataValidator::put
  */
-void test_error_tracking()
+TEST(DataValidatorTest, ErrorTracking)
 {
-	printf("\n--- test_error_tracking ---\n");
+	srand(666);
+
 	uint64_t timestamp = 500;
 	uint64_t timestamp_incr = 5;
 	const uint32_t timeout_usec = 2000;//from original private value
@@ -225,18 +221,18 @@ void test_error_tracking()
 		validator->put(timestamp, val, error_count, priority);
 	}
 
-	assert(validator->used());
+	EXPECT_TRUE(validator->used());
 	//at this point, error_count should be less than NORETURN_ERRCOUNT
-	assert(validator->error_count() == error_count);
+	EXPECT_EQ(validator->error_count(), error_count);
 
 	// we've just provided a bunch of valid data with some errors:
 	// confidence should be reduced by the number of errors
 	float conf = validator->confidence(timestamp);
 	printf("error_count: %u validator confidence: %f\n", (uint32_t)error_count, (double)conf);
-	assert(1.0f != conf);  //we should not be fully confident
-	assert(0.0f != conf);  //neither should we be completely unconfident
+	EXPECT_NE(1.0f, conf);  //we should not be fully confident
+	EXPECT_NE(0.0f, conf);  //neither should we be completely unconfident
 	// should be no errors, even if confidence is reduced, since we didn't exceed NORETURN_ERRCOUNT
-	assert(0 == validator->state());
+	EXPECT_EQ(0u, validator->state());
 
 	// the error density will reduce the confidence by 1 - (error_density / ERROR_DENSITY_WINDOW)
 	// ERROR_DENSITY_WINDOW is currently private, but == 100.0f
@@ -249,7 +245,7 @@ void test_error_tracking()
 		dump_validator_state(validator);
 	}
 
-	assert(diff < 1E-6f);
+	EXPECT_LT(diff, 1E-6f);
 
 	//Now, insert a series of errors and ensure we trip the error detector
 	for (int i = 0; i < 250;  i++, val += sufficient_incr_value) {
@@ -261,9 +257,9 @@ void test_error_tracking()
 	}
 
 	conf = validator->confidence(timestamp);
-	assert(0.0f == conf);  // should we be completely unconfident
+	EXPECT_EQ(0.0f, conf);  // should we be completely unconfident
 	// we should have triggered the high error density detector
-	assert(DataValidator::ERROR_FLAG_HIGH_ERRDENSITY == (DataValidator::ERROR_FLAG_HIGH_ERRDENSITY & validator->state()));
+	EXPECT_TRUE(DataValidator::ERROR_FLAG_HIGH_ERRDENSITY & validator->state());
 
 
 	validator->reset_state();
@@ -278,25 +274,10 @@ void test_error_tracking()
 	}
 
 	conf = validator->confidence(timestamp);
-	assert(0.0f == conf);  // should we be completely unconfident
+	EXPECT_EQ(0.0f, conf);  // should we be completely unconfident
 	// we should have triggered the high error count detector
-	assert(DataValidator::ERROR_FLAG_HIGH_ERRCOUNT == (DataValidator::ERROR_FLAG_HIGH_ERRCOUNT & validator->state()));
+	EXPECT_TRUE(DataValidator::ERROR_FLAG_HIGH_ERRCOUNT & validator->state());
 
 	delete validator; //force delete
 
 }
-
-int main(int argc, char *argv[])
-{
-	(void)argc; // unused
-	(void)argv; // unused
-
-	srand(666);
-	test_init();
-	test_put();
-	test_stale_detector();
-	test_rms_calculation();
-	test_error_tracking();
-
-	return 0; //passed
-}
@@ -38,13 +38,14 @@
  */
 
 #include <stdint.h>
-#include <cassert>
 #include <cstdlib>
 #include <stdio.h>
 #include <math.h>
-#include <validation/data_validator.h>
-#include <validation/data_validator_group.h>
-#include <validation/tests/tests_common.h>
+
+#include <gtest/gtest.h>
+
+#include "../DataValidatorGroup.hpp"
+#include "tests_common.h"
 
 
 const uint32_t base_timeout_usec = 2000;//from original private value
@@ -62,15 +63,15 @@ DataValidatorGroup  *setup_base_group(unsigned *sibling_count)
 	unsigned num_siblings = base_num_siblings;
 
 	DataValidatorGroup *group = new DataValidatorGroup(num_siblings);
-	assert(nullptr != group);
+	EXPECT_NE(nullptr, group);
 	//verify that calling print doesn't crash the tests
 	group->print();
 	printf("\n");
 
 	//should be no failovers yet
-	assert(0 == group->failover_count());
-	assert(DataValidator::ERROR_FLAG_NO_ERROR == group->failover_state());
-	assert(-1 == group->failover_index());
+	EXPECT_EQ(0u, group->failover_count());
+	EXPECT_EQ(0u, group->failover_state());
+	EXPECT_EQ(-1, group->failover_index());
 
 	//this sets the timeout on all current members of the group, as well as members added later
 	group->set_timeout(base_timeout_usec);
@@ -106,8 +107,8 @@ void fill_one_with_valid_data(DataValidatorGroup *group, int val1_idx,  uint32_t
 
 	int best_idx = 0;
 	float *best_data = group->get_best(timestamp, &best_idx);
-	assert(last_best_val == best_data[0]);
-	assert(best_idx == val1_idx);
+	EXPECT_EQ(last_best_val, best_data[0]);
+	EXPECT_EQ(best_idx, val1_idx);
 }
 
 
@@ -139,8 +140,8 @@ void fill_two_with_valid_data(DataValidatorGroup *group, int val1_idx, int val2_
 
 	int best_idx = 0;
 	float *best_data = group->get_best(timestamp, &best_idx);
-	assert(last_best_val == best_data[0]);
-	assert(best_idx == val1_idx);
+	EXPECT_EQ(last_best_val, best_data[0]);
+	EXPECT_EQ(best_idx, val1_idx);
 
 }
 
@@ -153,7 +154,7 @@ DataValidator *add_validator_to_group(DataValidatorGroup *group)
 {
 	DataValidator *validator = group->add_new_validator();
 	//verify the previously set timeout applies to the new group member
-	assert(validator->get_timeout() == base_timeout_usec);
+	EXPECT_EQ(validator->get_timeout(), base_timeout_usec);
 	//for testing purposes, ensure this newly added member is consistent with the rest of the group
 	//TODO this is likely a bug in DataValidatorGroup
 	validator->set_equal_value_threshold(equal_value_count);
@@ -185,7 +186,7 @@ DataValidatorGroup *setup_group_with_two_validator_handles(
 }
 
 
-void test_init()
+TEST(DataValidatorGroupTest, Init)
 {
 	unsigned num_siblings = 0;
 
@@ -193,7 +194,7 @@ void test_init()
 
 	//should not yet be any best value
 	int best_index = -1;
-	assert(nullptr == group->get_best(base_timestamp, &best_index));
+	EXPECT_EQ(nullptr, group->get_best(base_timestamp, &best_index));
 
 	delete group; //force cleanup
 }
@@ -202,7 +203,7 @@ void test_init()
 /**
  * Happy path test of put method -- ensure the "best" sensor selected is the one with highest priority
  */
-void test_put()
+TEST(DataValidatorGroupTest, Put)
 {
 	unsigned num_siblings = 0;
 	DataValidator *validator1 = nullptr;
@@ -218,18 +219,18 @@ void test_put()
 	fill_two_with_valid_data(group, val1_idx, val2_idx, 500);
 	int best_idx = -1;
 	float *best_data = group->get_best(timestamp, &best_idx);
-	assert(nullptr != best_data);
+	ASSERT_NE(nullptr, best_data);
 	float best_val = best_data[0];
 
 	float *cur_val1 = validator1->value();
-	assert(nullptr != cur_val1);
+	ASSERT_NE(nullptr, cur_val1);
 	//printf("cur_val1 %p \n", cur_val1);
-	assert(best_val == cur_val1[0]);
+	EXPECT_EQ(best_val, cur_val1[0]);
 
 	float *cur_val2 = validator2->value();
-	assert(nullptr != cur_val2);
+	ASSERT_NE(nullptr, cur_val2);
 	//printf("cur_val12 %p \n", cur_val2);
-	assert(best_val == cur_val2[0]);
+	EXPECT_EQ(best_val, cur_val2[0]);
 
 	delete group; //force cleanup
 }
@@ -238,7 +239,7 @@ void test_put()
 /**
  * Verify that the DataValidatorGroup will select the sensor with the latest higher priority as "best".
  */
-void test_priority_switch()
+TEST(DataValidatorGroupTest, PrioritySwitch)
 {
 	unsigned num_siblings = 0;
 	DataValidator *validator1 = nullptr;
@@ -263,11 +264,11 @@ void test_priority_switch()
 	group->put(val1_idx, timestamp, data, error_count, 1);
 	group->put(val2_idx, timestamp, data, error_count, 100);
 	best_data = group->get_best(timestamp, &best_idx);
-	assert(new_best_val == best_data[0]);
+	EXPECT_EQ(new_best_val, best_data[0]);
 	//the new best sensor should now be the sensor with the higher priority
-	assert(best_idx == val2_idx);
+	EXPECT_EQ(best_idx, val2_idx);
 	//should not have detected a real failover
-	assert(0 == group->failover_count());
+	EXPECT_EQ(0u, group->failover_count());
 
 	delete  group; //cleanup
 }
@@ -275,7 +276,7 @@ void test_priority_switch()
 /**
  * Verify that the DataGroupValidator will prefer a sensor with no errors over a sensor with high errors
  */
-void test_simple_failover()
+TEST(DataValidatorGroupTest, SimpleFailover)
 {
 	unsigned num_siblings = 0;
 	DataValidator *validator1 = nullptr;
@@ -305,26 +306,26 @@ void test_simple_failover()
 		group->put(val2_idx, timestamp, data, 0, 10);
 	}
 
-	assert(validator1->error_count() == val1_err_count);
+	EXPECT_EQ(validator1->error_count(), val1_err_count);
 
 	//since validator1 is experiencing errors, we should see a failover to validator2
 	best_data = group->get_best(timestamp + 1, &best_idx);
-	assert(nullptr != best_data);
-	assert(new_best_val == best_data[0]);
-	assert(best_idx == val2_idx);
+	ASSERT_NE(nullptr, best_data);
+	EXPECT_EQ(new_best_val, best_data[0]);
+	EXPECT_EQ(best_idx, val2_idx);
 	//should have detected a real failover
 	printf("failover_count: %d \n", group->failover_count());
-	assert(1 == group->failover_count());
+	EXPECT_EQ(1u, group->failover_count());
 
 	//even though validator1 has encountered a bunch of errors, it hasn't failed
-	assert(DataValidator::ERROR_FLAG_NO_ERROR == validator1->state());
+	EXPECT_EQ(0u, validator1->state());
 
 	// although we failed over from one sensor to another, this is not the same thing tracked by failover_index
 	int fail_idx = group->failover_index();
-	assert(-1 == fail_idx);//no failed sensor
+	EXPECT_EQ(-1, fail_idx);//no failed sensor
 
 	//since no sensor has actually hard-failed, the group failover state is NO_ERROR
-	assert(DataValidator::ERROR_FLAG_NO_ERROR == group->failover_state());
+	EXPECT_EQ(0u, group->failover_state());
 
 
 	delete  group; //cleanup
@@ -333,7 +334,7 @@ void test_simple_failover()
 /**
  * Force once sensor to fail and ensure that we detect it
  */
-void test_sensor_failure()
+TEST(DataValidatorGroupTest, SensorFailure)
 {
 	unsigned num_siblings = 0;
 	uint64_t timestamp = base_timestamp;
@@ -346,7 +347,7 @@ void test_sensor_failure()
 
 	//now we add validators
 	DataValidator *validator  = add_validator_to_group(group);
-	assert(nullptr != validator);
+	ASSERT_NE(nullptr, validator);
 	num_siblings++;
 	int val_idx = num_siblings - 1;
 
@@ -355,31 +356,148 @@ void test_sensor_failure()
 
 	int best_idx = -1;
 	float *best_data = group->get_best(timestamp, &best_idx);
-	assert(nullptr != best_data);
+	ASSERT_NE(nullptr, best_data);
 	//printf("best_idx: %d val_idx: %d\n", best_idx, val_idx);
-	assert(best_idx == val_idx);
+	EXPECT_EQ(best_idx, val_idx);
 
 	//now force a timeout failure in the one validator, by checking confidence long past timeout
 	validator->confidence(timestamp + (1.1 * timeout_usec));
-	assert(DataValidator::ERROR_FLAG_TIMEOUT == (DataValidator::ERROR_FLAG_TIMEOUT & validator->state()));
+	EXPECT_TRUE(DataValidator::ERROR_FLAG_TIMEOUT & validator->state());
 
 	//now that the one sensor has failed, the group should detect this as well
 	int fail_idx = group->failover_index();
-	assert(val_idx == fail_idx);
+	EXPECT_EQ(val_idx, fail_idx);
 
 	delete  group;
 }
 
-int main(int argc, char *argv[])
+/**
+ * A sensor that stops sending has to be failed over from by get_best() alone, without any further put()
+ */
+TEST(DataValidatorGroupTest, TimeoutFailoverWithoutPut)
+{
+	unsigned num_siblings = 0;
+	DataValidator *validator1 = nullptr;
+	DataValidator *validator2 = nullptr;
+
+	DataValidatorGroup *group = setup_group_with_two_validator_handles(&validator1, &validator2, &num_siblings);
+	int val1_idx = (int)num_siblings - 2;
+	int val2_idx = (int)num_siblings - 1;
+
+	fill_two_with_valid_data(group, val1_idx, val2_idx, 100);
+
+	// the lower priority sensor keeps sending a bit longer
+	float data[DataValidator::dimensions] = {2.71828f};
+	const uint64_t timestamp_last = base_timestamp + base_timeout_usec / 2;
+	group->put(val2_idx, timestamp_last, data, 0, 10);
+
+	int best_idx = -1;
+	float *best_data = group->get_best(timestamp_last, &best_idx);
+	ASSERT_NE(nullptr, best_data);
+	EXPECT_EQ(best_idx, val1_idx);
+
+	// the cached vote must not outlive the timeout of the selected sensor
+	best_data = group->get_best(base_timestamp + base_timeout_usec, &best_idx);
+	EXPECT_EQ(best_idx, val1_idx);
+
+	best_data = group->get_best(base_timestamp + base_timeout_usec + 1, &best_idx);
+	ASSERT_NE(nullptr, best_data);
+	EXPECT_EQ(best_idx, val2_idx);
+	EXPECT_EQ(2.71828f, best_data[0]);
+	EXPECT_EQ(1u, group->failover_count());
+	EXPECT_TRUE(DataValidator::ERROR_FLAG_TIMEOUT & validator1->state());
+
+	// and once the second sensor times out as well there is no valid sensor left
+	best_data = group->get_best(timestamp_last + base_timeout_usec + 1, &best_idx);
+	EXPECT_EQ(nullptr, best_data);
+	EXPECT_EQ(-1, best_idx);
+	EXPECT_EQ(-1, group->best_index());
+
+	delete group;
+}
+
+/**
+ * Timestamps going backwards, both for get_best() and put(), must not reuse the previous vote
+ */
+TEST(DataValidatorGroupTest, TimestampBackwards)
+{
+	unsigned num_siblings = 0;
+	DataValidator *validator1 = nullptr;
+	DataValidator *validator2 = nullptr;
+
+	DataValidatorGroup *group = setup_group_with_two_validator_handles(&validator1, &validator2, &num_siblings);
+	int val1_idx = (int)num_siblings - 2;
+	int val2_idx = (int)num_siblings - 1;
+
+	const uint64_t timestamp = base_timestamp + 1000;
+	float data[DataValidator::dimensions] = {1.f};
+	group->put(val1_idx, timestamp, data, 0, 100);
+
+	int best_idx = -1;
+	ASSERT_NE(nullptr, group->get_best(timestamp, &best_idx));
+	EXPECT_EQ(best_idx, val1_idx);
+
+	// data newer than the requested timestamp counts as timed out
+	EXPECT_EQ(nullptr, group->get_best(timestamp - 10, &best_idx));
+	EXPECT_EQ(-1, best_idx);
+
+	ASSERT_NE(nullptr, group->get_best(timestamp, &best_idx));
+	EXPECT_EQ(best_idx, val1_idx);
+
+	// a sample older than the previous one of the same sensor is still new data
+	data[0] = 2.f;
+	group->put(val2_idx, timestamp, data, 0, 10);
+	data[0] = 3.f;
+	group->put(val1_idx, timestamp - 500, data, 0, 100);
+
+	float *best_data = group->get_best(timestamp - 500, &best_idx);
+	ASSERT_NE(nullptr, best_data);
+	EXPECT_EQ(best_idx, val1_idx);
+	EXPECT_EQ(3.f, best_data[0]);
+
+	// at the later timestamp the first sensor is still within its timeout
+	best_data = group->get_best(timestamp, &best_idx);
+	ASSERT_NE(nullptr, best_data);
+	EXPECT_EQ(best_idx, val1_idx);
+
+	delete group;
+}
+
+/**
+ * Changing the timeout has to be applied to the next get_best(), even if there was no new data
+ */
+TEST(DataValidatorGroupTest, SetTimeout)
 {
-	(void)argc; // unused
-	(void)argv; // unused
+	unsigned num_siblings = 0;
+	DataValidator *validator1 = nullptr;
+	DataValidator *validator2 = nullptr;
+
+	DataValidatorGroup *group = setup_group_with_two_validator_handles(&validator1, &validator2, &num_siblings);
+	int val1_idx = (int)num_siblings - 2;
 
-	test_init();
-	test_put();
-	test_simple_failover();
-	test_priority_switch();
-	test_sensor_failure();
+	float data[DataValidator::dimensions] = {1.f};
+	group->put(val1_idx, base_timestamp, data, 0, 100);
 
-	return 0; //passed
+	int best_idx = -1;
+	ASSERT_NE(nullptr, group->get_best(base_timestamp + 1000, &best_idx));
+	EXPECT_EQ(best_idx, val1_idx);
+
+	// shorter timeout: the same request now times out
+	group->set_timeout(500);
+	EXPECT_EQ(500u, validator1->get_timeout());
+	EXPECT_EQ(nullptr, group->get_best(base_timestamp + 1000, &best_idx));
+	EXPECT_EQ(-1, best_idx);
+
+	// longer timeout: valid again, even later
+	group->set_timeout(5000);
+	ASSERT_NE(nullptr, group->get_best(base_timestamp + 3000, &best_idx));
+	EXPECT_EQ(best_idx, val1_idx);
+	EXPECT_EQ(nullptr, group->get_best(base_timestamp + 5001, &best_idx));
+
+	// validators added later inherit the current timeout
+	DataValidator *validator3 = group->add_new_validator();
+	ASSERT_NE(nullptr, validator3);
+	EXPECT_EQ(5000u, validator3->get_timeout());
+
+	delete group;
 }
@@ -77,6 +77,7 @@ void VehicleAngularVelocity::Stop()
 {
 	// clear all registered callbacks
 	_sensor_sub.unregisterCallback();
+	_sensor_fifo_sub.unregisterCallback();
 	_sensor_selection_sub.unregisterCallback();
 
 	Deinit();
@@ -86,8 +87,17 @@ void VehicleAngularVelocity::CheckAndUpdateFilters()
 {
 	bool sample_rate_changed = false;
 
+	if (_fifo_available && (_fifo_sample_rate > 0.f)) {
+		// FIFO data: the sample rate is known from the sample interval
+		if ((fabsf(_fifo_sample_rate - _filter_sample_rate) / _filter_sample_rate) > 0.01f) {
+			PX4_DEBUG("sample rate changed: %.3f Hz -> %.3f Hz", (double)_filter_sample_rate, (double)_fifo_sample_rate);
+			_filter_sample_rate = _fifo_sample_rate;
+			sample_rate_changed = true;
+		}
+	}
+
 	// get sample rate from vehicle_imu_status publication
-	for (uint8_t i = 0; i < MAX_SENSOR_COUNT; i++) {
+	for (uint8_t i = 0; !_fifo_available && (i < MAX_SENSOR_COUNT); i++) {
 		uORB::SubscriptionData<vehicle_imu_status_s> imu_status{ORB_ID(vehicle_imu_status), i};
 
 		const float sample_rate_hz = imu_status.get().gyro_rate_hz;
@@ -104,26 +114,122 @@ void VehicleAngularVelocity::CheckAndUpdateFilters()
 		}
 	}
 
+	bool filters_changed = false;
+
 	// update software low pass filters
-	if (sample_rate_changed || (fabsf(_lp_filter_velocity.get_cutoff_freq() - _param_imu_gyro_cutoff.get()) > 0.1f)) {
-		_lp_filter_velocity.set_cutoff_frequency(_filter_sample_rate, _param_imu_gyro_cutoff.get());
-		_lp_filter_velocity.reset(_angular_velocity_prev);
+	if (sample_rate_changed || (fabsf(_lp_cutoff_velocity - _param_imu_gyro_cutoff.get()) > 0.1f)) {
+		_lp_cutoff_velocity = _param_imu_gyro_cutoff.get();
+		_filter_velocity.setLowPass(STAGE_LOW_PASS, _filter_sample_rate, _lp_cutoff_velocity);
+		filters_changed = true;
 	}
 
 	if (sample_rate_changed
-	    || (fabsf(_notch_filter_velocity.getNotchFreq() - _param_imu_gyro_nf_freq.get()) > 0.1f)
-	    || (fabsf(_notch_filter_velocity.getBandwidth() - _param_imu_gyro_nf_bw.get()) > 0.1f)
+	    || (fabsf(_notch_freq - _param_imu_gyro_nf_freq.get()) > 0.1f)
+	    || (fabsf(_notch_bandwidth - _param_imu_gyro_nf_bw.get()) > 0.1f)
 	   ) {
-		_notch_filter_velocity.setParameters(_filter_sample_rate, _param_imu_gyro_nf_freq.get(), _param_imu_gyro_nf_bw.get());
-		_notch_filter_velocity.reset(_angular_velocity_prev);
+		_notch_freq = _param_imu_gyro_nf_freq.get();
+		_notch_bandwidth = _param_imu_gyro_nf_bw.get();
+		_filter_velocity.setNotch(STAGE_NOTCH, _filter_sample_rate, _notch_freq, _notch_bandwidth);
+		filters_changed = true;
+	}
+
+	// dynamic notches are recomputed with the next update
+	if (sample_rate_changed || !(_param_imu_gyro_dnf_en.get() & DynamicNotch::EscRpm)) {
+		DisableDynamicNotches(STAGE_ESC_RPM, MAX_NUM_ESC_RPM_NOTCHES);
+	}
+
+	if (sample_rate_changed || !(_param_imu_gyro_dnf_en.get() & DynamicNotch::FFT)) {
+		DisableDynamicNotches(STAGE_FFT, MAX_NUM_FFT_NOTCHES);
+	}
+
+	if (filters_changed) {
+		_filter_velocity.reset(_angular_velocity_prev);
 	}
 
-	if (sample_rate_changed || (fabsf(_lp_filter_acceleration.get_cutoff_freq() - _param_imu_dgyro_cutoff.get()) > 0.1f)) {
-		_lp_filter_acceleration.set_cutoff_frequency(_filter_sample_rate, _param_imu_dgyro_cutoff.get());
+	if (sample_rate_changed || (fabsf(_lp_cutoff_acceleration - _param_imu_dgyro_cutoff.get()) > 0.1f)) {
+		_lp_cutoff_acceleration = _param_imu_dgyro_cutoff.get();
+		_lp_filter_acceleration.setLowPass(0, _filter_sample_rate, _lp_cutoff_acceleration);
 		_lp_filter_acceleration.reset(_angular_acceleration_prev);
 	}
 }
 
+void VehicleAngularVelocity::DisableDynamicNotches(int first_stage, int num_stages)
+{
+	for (int stage = first_stage; stage < first_stage + num_stages; stage++) {
+		for (int axis = 0; axis < 3; axis++) {
+			if (_dynamic_notch_freq[stage][axis] > 0.f) {
+				_filter_velocity.setNotch(stage, axis, _filter_sample_rate, 0.f, 0.f);
+				_dynamic_notch_freq[stage][axis] = 0.f;
+			}
+		}
+	}
+}
+
+void VehicleAngularVelocity::SetDynamicNotch(int stage, int axis, float frequency)
+{
+	// disable notches outside of the valid range
+	if (!PX4_ISFINITE(frequency) || (frequency < _param_imu_gyro_dnf_min.get())
+	    || (frequency > 0.45f * _filter_sample_rate)) {
+		frequency = 0.f;
+	}
+
+	float &current = _dynamic_notch_freq[stage][axis];
+
+	// avoid recomputing the coefficients for small changes
+	if (((frequency > 0.f) != (current > 0.f)) || (fabsf(frequency - current) > 1.f)) {
+		_filter_velocity.setNotch(stage, axis, _filter_sample_rate, frequency, _param_imu_gyro_dnf_bw.get());
+		current = frequency;
+	}
+}
+
+void VehicleAngularVelocity::DynamicNotchUpdate()
+{
+	static constexpr hrt_abstime DYNAMIC_NOTCH_TIMEOUT = 1_s;
+
+	if (_param_imu_gyro_dnf_en.get() & DynamicNotch::EscRpm) {
+		esc_status_s esc_status;
+
+		if (_esc_status_sub.update(&esc_status)) {
+			for (int i = 0; i < MAX_NUM_ESC_RPM_NOTCHES; i++) {
+				// notch at the rotor frequency on all axes
+				const float frequency = (i < esc_status.esc_count) ? abs(esc_status.esc[i].esc_rpm) / 60.f : 0.f;
+
+				for (int axis = 0; axis < 3; axis++) {
+					SetDynamicNotch(STAGE_ESC_RPM + i, axis, frequency);
+				}
+			}
+
+			_dynamic_notch_esc_rpm_timestamp = esc_status.timestamp;
+
+		} else if (hrt_elapsed_time(&_dynamic_notch_esc_rpm_timestamp) > DYNAMIC_NOTCH_TIMEOUT) {
+			DisableDynamicNotches(STAGE_ESC_RPM, MAX_NUM_ESC_RPM_NOTCHES);
+		}
+	}
+
+	if (_param_imu_gyro_dnf_en.get() & DynamicNotch::FFT) {
+		sensor_gyro_fft_s sensor_gyro_fft;
+
+		if (_sensor_gyro_fft_sub.update(&sensor_gyro_fft) && (sensor_gyro_fft.device_id == _calibration.device_id())) {
+			const float *peak_frequencies[3] {
+				sensor_gyro_fft.peak_frequencies_x,
+				sensor_gyro_fft.peak_frequencies_y,
+				sensor_gyro_fft.peak_frequencies_z,
+			};
+
+			for (int i = 0; i < MAX_NUM_FFT_NOTCHES; i++) {
+				for (int axis = 0; axis < 3; axis++) {
+					SetDynamicNotch(STAGE_FFT + i, axis, peak_frequencies[axis][i]);
+				}
+			}
+
+			_dynamic_notch_fft_timestamp = sensor_gyro_fft.timestamp;
+
+		} else if (hrt_elapsed_time(&_dynamic_notch_fft_timestamp) > DYNAMIC_NOTCH_TIMEOUT) {
+			DisableDynamicNotches(STAGE_FFT, MAX_NUM_FFT_NOTCHES);
+		}
+	}
+}
+
 void VehicleAngularVelocity::SensorBiasUpdate(bool force)
 {
 	// find corresponding estimated sensor bias
@@ -163,7 +269,8 @@ bool VehicleAngularVelocity::SensorSelectionUpdate(bool force)
 
 				if ((device_id != 0) && (device_id == sensor_selection.gyro_device_id)) {
 
-					if (_sensor_sub.ChangeInstance(i) && _sensor_sub.registerCallback()) {
+					// prefer the FIFO publication of the sensor if available
+					if (_sensor_sub.ChangeInstance(i) && (SelectSensorFifo(device_id) || _sensor_sub.registerCallback())) {
 						PX4_DEBUG("selected sensor changed %d -> %d", _calibration.device_id(), device_id);
 
 						// clear bias and corrections
@@ -186,6 +293,28 @@ bool VehicleAngularVelocity::SensorSelectionUpdate(bool force)
 	return false;
 }
 
+bool VehicleAngularVelocity::SelectSensorFifo(uint32_t device_id)
+{
+	for (uint8_t i = 0; (device_id != 0) && (i < MAX_SENSOR_COUNT); i++) {
+		uORB::SubscriptionData<sensor_gyro_fifo_s> sensor_gyro_fifo_sub{ORB_ID(sensor_gyro_fifo), i};
+
+		if (sensor_gyro_fifo_sub.get().device_id == device_id) {
+			if (_sensor_fifo_sub.ChangeInstance(i) && _sensor_fifo_sub.registerCallback()) {
+				PX4_DEBUG("using FIFO data of sensor %d", device_id);
+				_sensor_sub.unregisterCallback();
+				_fifo_available = true;
+				_fifo_sample_rate = 0.f;
+				_fifo_timestamp_last = hrt_absolute_time();
+				return true;
+			}
+		}
+	}
+
+	_sensor_fifo_sub.unregisterCallback();
+	_fifo_available = false;
+	return false;
+}
+
 void VehicleAngularVelocity::ParametersUpdate(bool force)
 {
 	// Check if parameters have changed
@@ -214,68 +343,162 @@ void VehicleAngularVelocity::Run()
 	SensorBiasUpdate(selection_updated);
 	ParametersUpdate();
 
-	// process all outstanding messages
-	sensor_gyro_s sensor_data;
-
-	while (_sensor_sub.update(&sensor_data)) {
+	DynamicNotchUpdate();
 
-		// Guard against too small (< 0.2ms) and too large (> 20ms) dt's.
-		const float dt = math::constrain(((sensor_data.timestamp_sample - _timestamp_sample_prev) / 1e6f), 0.0002f, 0.02f);
-		_timestamp_sample_prev = sensor_data.timestamp_sample;
+	// periodically check if FIFO data has become available for the selected sensor
+	if (!_fifo_available && (_calibration.device_id() != 0) && (hrt_elapsed_time(&_fifo_check_last) > 1_s)) {
+		_fifo_check_last = hrt_absolute_time();
+		SelectSensorFifo(_calibration.device_id());
+	}
 
-		// get the sensor data and correct for thermal errors (apply offsets and scale)
-		const Vector3f val{sensor_data.x, sensor_data.y, sensor_data.z};
+	if (_fifo_available) {
+		// process all outstanding FIFO messages, one block each
+		sensor_gyro_fifo_s sensor_fifo_data;
 
-		// correct for in-run bias errors
-		const Vector3f angular_velocity_raw = _calibration.Correct(val) - _bias;
+		while (_sensor_fifo_sub.update(&sensor_fifo_data)) {
+			_fifo_timestamp_last = sensor_fifo_data.timestamp_sample;
 
-		// Gyro filtering:
-		// - Apply general notch filter (IMU_GYRO_NF_FREQ)
-		// - Apply general low-pass filter (IMU_GYRO_CUTOFF)
-		// - Differentiate & apply specific angular acceleration (D-term) low-pass (IMU_DGYRO_CUTOFF)
+			const int n = math::min((int)sensor_fifo_data.samples, BLOCK_SIZE);
 
-		const Vector3f angular_velocity_notched{_notch_filter_velocity.apply(angular_velocity_raw)};
+			if ((n == 0) || !(sensor_fifo_data.dt > 0.f)) {
+				continue;
+			}
 
-		const Vector3f angular_velocity{_lp_filter_velocity.apply(angular_velocity_notched)};
+			const float sample_rate = 1e6f / sensor_fifo_data.dt;
 
-		const Vector3f angular_acceleration_raw = (angular_velocity - _angular_velocity_prev) / dt;
-		_angular_velocity_prev = angular_velocity;
-		_angular_acceleration_prev = angular_acceleration_raw;
-		const Vector3f angular_acceleration{_lp_filter_acceleration.apply(angular_acceleration_raw)};
+			if (fabsf(sample_rate - _fifo_sample_rate) > 0.01f * sample_rate) {
+				_fifo_sample_rate = sample_rate;
+				CheckAndUpdateFilters();
+			}
 
+			const enum Rotation rotation = static_cast<enum Rotation>(sensor_fifo_data.rotation);
 
-		// publish once all new samples are processed
-		if (!_sensor_sub.updated()) {
-			bool publish = true;
+			// sensor rotation, scale, calibration and in-run bias correction for the whole block
+			_calibration.CorrectFifo(sensor_fifo_data.x, sensor_fifo_data.y, sensor_fifo_data.z, n, rotation, sensor_fifo_data.scale,
+						 _bias, _velocity[0], _velocity[1], _velocity[2]);
 
-			if (_param_imu_gyro_rate_max.get() > 0) {
-				const uint64_t interval = 1e6f / _param_imu_gyro_rate_max.get();
+			float dt[BLOCK_SIZE];
 
-				if (hrt_elapsed_time(&_last_publish) < interval) {
-					publish = false;
-				}
+			for (int i = 0; i < n; i++) {
+				dt[i] = sensor_fifo_data.dt * 1e-6f;
 			}
 
-			if (publish) {
-				// Publish vehicle_angular_acceleration
-				vehicle_angular_acceleration_s v_angular_acceleration;
-				v_angular_acceleration.timestamp_sample = sensor_data.timestamp_sample;
-				angular_acceleration.copyTo(v_angular_acceleration.xyz);
-				v_angular_acceleration.timestamp = hrt_absolute_time();
-				_vehicle_angular_acceleration_pub.publish(v_angular_acceleration);
-
-				// Publish vehicle_angular_velocity
-				vehicle_angular_velocity_s v_angular_velocity;
-				v_angular_velocity.timestamp_sample = sensor_data.timestamp_sample;
-				angular_velocity.copyTo(v_angular_velocity.xyz);
-				v_angular_velocity.timestamp = hrt_absolute_time();
-				_vehicle_angular_velocity_pub.publish(v_angular_velocity);
-
-				_last_publish = v_angular_velocity.timestamp_sample;
+			_timestamp_sample_prev = sensor_fifo_data.timestamp_sample;
+
+			ProcessBlock(n, dt);
+
+			// publish once all new samples are processed
+			if (!_sensor_fifo_sub.updated() && Publish(sensor_fifo_data.timestamp_sample)) {
 				return;
 			}
 		}
+
+		// fall back to sensor_gyro if the FIFO data stops
+		if (hrt_elapsed_time(&_fifo_timestamp_last) > 100_ms) {
+			PX4_DEBUG("FIFO data timeout, using sensor_gyro");
+			_sensor_fifo_sub.unregisterCallback();
+			_sensor_sub.registerCallback();
+			_fifo_available = false;
+			_fifo_check_last = hrt_absolute_time();
+
+		} else {
+			return;
+		}
+	}
+
+	// process all outstanding messages in blocks
+	while (_sensor_sub.updated()) {
+		sensor_gyro_s sensor_data;
+		float dt[BLOCK_SIZE];
+		int n = 0;
+
+		while ((n < BLOCK_SIZE) && _sensor_sub.update(&sensor_data)) {
+			// Guard against too small (< 0.2ms) and too large (> 20ms) dt's.
+			dt[n] = math::constrain(((sensor_data.timestamp_sample - _timestamp_sample_prev) / 1e6f), 0.0002f, 0.02f);
+			_timestamp_sample_prev = sensor_data.timestamp_sample;
+
+			// get the sensor data and correct for thermal errors (apply offsets and scale)
+			const Vector3f val{sensor_data.x, sensor_data.y, sensor_data.z};
+
+			// correct for in-run bias errors
+			const Vector3f angular_velocity_raw = _calibration.Correct(val) - _bias;
+
+			for (int axis = 0; axis < 3; axis++) {
+				_velocity[axis][n] = angular_velocity_raw(axis);
+			}
+
+			n++;
+		}
+
+		if (n == 0) {
+			break;
+		}
+
+		ProcessBlock(n, dt);
+
+		// publish once all new samples are processed
+		if (!_sensor_sub.updated() && Publish(sensor_data.timestamp_sample)) {
+			return;
+		}
+	}
+}
+
+void VehicleAngularVelocity::ProcessBlock(int length, const float dt[])
+{
+	// Gyro filtering:
+	// - Apply general notch filter (IMU_GYRO_NF_FREQ)
+	// - Apply dynamic notch filters (IMU_GYRO_DNF_EN)
+	// - Apply general low-pass filter (IMU_GYRO_CUTOFF)
+	// - Differentiate & apply specific angular acceleration (D-term) low-pass (IMU_DGYRO_CUTOFF)
+	_filter_velocity.apply(_velocity[0], _velocity[1], _velocity[2], length);
+
+	for (int i = 0; i < length; i++) {
+		for (int axis = 0; axis < 3; axis++) {
+			_acceleration[axis][i] = (_velocity[axis][i] - _angular_velocity_prev(axis)) / dt[i];
+			_angular_velocity_prev(axis) = _velocity[axis][i];
+		}
+	}
+
+	_angular_acceleration_prev = Vector3f{_acceleration[0][length - 1], _acceleration[1][length - 1], _acceleration[2][length - 1]};
+
+	_lp_filter_acceleration.apply(_acceleration[0], _acceleration[1], _acceleration[2], length);
+
+	_last_block_length = length;
+}
+
+bool VehicleAngularVelocity::Publish(const hrt_abstime &timestamp_sample)
+{
+	if (_param_imu_gyro_rate_max.get() > 0) {
+		const uint64_t interval = 1e6f / _param_imu_gyro_rate_max.get();
+
+		if (hrt_elapsed_time(&_last_publish) < interval) {
+			return false;
+		}
 	}
+
+	const int last = _last_block_length - 1;
+
+	// Publish vehicle_angular_acceleration
+	vehicle_angular_acceleration_s v_angular_acceleration;
+	v_angular_acceleration.timestamp_sample = timestamp_sample;
+
+	for (int axis = 0; axis < 3; axis++) {
+		v_angular_acceleration.xyz[axis] = _acceleration[axis][last];
+	}
+
+	v_angular_acceleration.timestamp = hrt_absolute_time();
+	_vehicle_angular_acceleration_pub.publish(v_angular_acceleration);
+
+	// Publish vehicle_angular_velocity
+	vehicle_angular_velocity_s v_angular_velocity;
+	v_angular_velocity.timestamp_sample = timestamp_sample;
+	_angular_velocity_prev.copyTo(v_angular_velocity.xyz);
+	v_angular_velocity.timestamp = hrt_absolute_time();
+	_vehicle_angular_velocity_pub.publish(v_angular_velocity);
+
+	_last_publish = v_angular_velocity.timestamp_sample;
+
+	return true;
 }
 
 void VehicleAngularVelocity::PrintStatus()
@@ -284,6 +507,18 @@ void VehicleAngularVelocity::PrintStatus()
 		 _calibration.device_id(), (double)_filter_sample_rate,
 		 (double)_bias(0), (double)_bias(1), (double)_bias(2));
 
+	PX4_INFO("data: %s, filter stages: %d, dynamic notches [Hz]:", _fifo_available ? "FIFO" : "sensor_gyro",
+		 _filter_velocity.enabledStages());
+
+	for (int stage = STAGE_ESC_RPM; stage < STAGE_LOW_PASS; stage++) {
+		if (_filter_velocity.stageEnabled(stage)) {
+			PX4_INFO_RAW("  %s %d: [%.1f %.1f %.1f]\n", (stage < STAGE_FFT) ? "ESC RPM" : "FFT",
+				     (stage < STAGE_FFT) ? (stage - STAGE_ESC_RPM) : (stage - STAGE_FFT),
+				     (double)_dynamic_notch_freq[stage][0], (double)_dynamic_notch_freq[stage][1],
+				     (double)_dynamic_notch_freq[stage][2]);
+		}
+	}
+
 	_calibration.PrintStatus();
 }
 
@@ -33,11 +33,11 @@
 
 #pragma once
 
+#include <lib/conversion/rotation.h>
 #include <lib/sensor_calibration/Gyroscope.hpp>
 #include <lib/mathlib/math/Limits.hpp>
 #include <lib/matrix/matrix/math.hpp>
-#include <lib/mathlib/math/filter/LowPassFilter2pVector3f.hpp>
-#include <lib/mathlib/math/filter/NotchFilter.hpp>
+#include <lib/mathlib/math/filter/BiquadCascadeVector3f.hpp>
 #include <px4_platform_common/log.h>
 #include <px4_platform_common/module_params.h>
 #include <px4_platform_common/px4_config.h>
@@ -47,8 +47,11 @@
 #include <uORB/SubscriptionCallback.hpp>
 #include <uORB/topics/estimator_selector_status.h>
 #include <uORB/topics/estimator_sensor_bias.h>
+#include <uORB/topics/esc_status.h>
 #include <uORB/topics/parameter_update.h>
 #include <uORB/topics/sensor_gyro.h>
+#include <uORB/topics/sensor_gyro_fft.h>
+#include <uORB/topics/sensor_gyro_fifo.h>
 #include <uORB/topics/sensor_selection.h>
 #include <uORB/topics/vehicle_angular_acceleration.h>
 #include <uORB/topics/vehicle_angular_velocity.h>
@@ -71,21 +74,47 @@ private:
 	void Run() override;
 
 	void CheckAndUpdateFilters();
+	void DisableDynamicNotches(int first_stage, int num_stages);
+	void DynamicNotchUpdate();
 	void ParametersUpdate(bool force = false);
+	void ProcessBlock(int length, const float dt[]);
+	bool Publish(const hrt_abstime &timestamp_sample);
+	bool SelectSensorFifo(uint32_t device_id);
 	void SensorBiasUpdate(bool force = false);
 	bool SensorSelectionUpdate(bool force = false);
+	void SetDynamicNotch(int stage, int axis, float frequency);
 
 	static constexpr int MAX_SENSOR_COUNT = 4;
 
+	enum DynamicNotch {
+		EscRpm = (1 << 0),
+		FFT    = (1 << 1),
+	};
+
+	static constexpr int MAX_NUM_ESC_RPM_NOTCHES = 4;
+	static constexpr int MAX_NUM_FFT_NOTCHES = 4;
+
+	// angular velocity filter stages, applied in order
+	static constexpr int STAGE_NOTCH = 0;
+	static constexpr int STAGE_ESC_RPM = STAGE_NOTCH + 1;
+	static constexpr int STAGE_FFT = STAGE_ESC_RPM + MAX_NUM_ESC_RPM_NOTCHES;
+	static constexpr int STAGE_LOW_PASS = STAGE_FFT + MAX_NUM_FFT_NOTCHES;
+	static constexpr int NUM_STAGES = STAGE_LOW_PASS + 1;
+
+	static constexpr int BLOCK_SIZE = math::BiquadCascadeVector3f<NUM_STAGES>::MAX_BLOCK_SIZE;
+
 	uORB::Publication<vehicle_angular_acceleration_s> _vehicle_angular_acceleration_pub{ORB_ID(vehicle_angular_acceleration)};
 	uORB::Publication<vehicle_angular_velocity_s> _vehicle_angular_velocity_pub{ORB_ID(vehicle_angular_velocity)};
 
 	uORB::Subscription _estimator_selector_status_sub{ORB_ID(estimator_selector_status)};
 	uORB::Subscription _estimator_sensor_bias_sub{ORB_ID(estimator_sensor_bias)};
+	uORB::Subscription _esc_status_sub{ORB_ID(esc_status)};
+	uORB::Subscription _sensor_gyro_fft_sub{ORB_ID(sensor_gyro_fft)};
 	uORB::Subscription _params_sub{ORB_ID(parameter_update)};
 
 	uORB::SubscriptionCallbackWorkItem _sensor_selection_sub{this, ORB_ID(sensor_selection)};
 	uORB::SubscriptionCallbackWorkItem _sensor_sub{this, ORB_ID(sensor_gyro)};
+	uORB::SubscriptionCallbackWorkItem _sensor_fifo_sub{this, ORB_ID(sensor_gyro_fifo)};
 
 	calibration::Gyroscope _calibration{};
 
@@ -99,18 +128,41 @@ private:
 	static constexpr const float kInitialRateHz{1000.f}; /**< sensor update rate used for initialization */
 	float _filter_sample_rate{kInitialRateHz};
 
-	// angular velocity filters
-	math::LowPassFilter2pVector3f _lp_filter_velocity{kInitialRateHz, 30.f};
-	math::NotchFilter<matrix::Vector3f> _notch_filter_velocity{};
+	// FIFO data of the selected sensor is processed directly if available
+	bool _fifo_available{false};
+	float _fifo_sample_rate{0.f};
+	hrt_abstime _fifo_timestamp_last{0};
+	hrt_abstime _fifo_check_last{0};
+
+	// angular velocity filters: notch, dynamic notches and low-pass
+	math::BiquadCascadeVector3f<NUM_STAGES> _filter_velocity{};
+
+	float _lp_cutoff_velocity{0.f};
+	float _notch_freq{0.f};
+	float _notch_bandwidth{0.f};
+
+	// current dynamic notch frequencies per stage and axis (0 if disabled)
+	float _dynamic_notch_freq[NUM_STAGES][3] {};
+	hrt_abstime _dynamic_notch_esc_rpm_timestamp{0};
+	hrt_abstime _dynamic_notch_fft_timestamp{0};
 
 	// angular acceleration filter
-	math::LowPassFilter2pVector3f _lp_filter_acceleration{kInitialRateHz, 30.f};
+	math::BiquadCascadeVector3f<1> _lp_filter_acceleration{};
+	float _lp_cutoff_acceleration{0.f};
+
+	// block of samples being processed
+	float _velocity[3][BLOCK_SIZE] {};
+	float _acceleration[3][BLOCK_SIZE] {};
+	int _last_block_length{0};
 
 	DEFINE_PARAMETERS(
 		(ParamFloat<px4::params::IMU_GYRO_CUTOFF>) _param_imu_gyro_cutoff,
 		(ParamFloat<px4::params::IMU_GYRO_NF_FREQ>) _param_imu_gyro_nf_freq,
 		(ParamFloat<px4::params::IMU_GYRO_NF_BW>) _param_imu_gyro_nf_bw,
 		(ParamInt<px4::params::IMU_GYRO_RATEMAX>) _param_imu_gyro_rate_max,
+		(ParamInt<px4::params::IMU_GYRO_DNF_EN>) _param_imu_gyro_dnf_en,
+		(ParamFloat<px4::params::IMU_GYRO_DNF_BW>) _param_imu_gyro_dnf_bw,
+		(ParamFloat<px4::params::IMU_GYRO_DNF_MIN>) _param_imu_gyro_dnf_min,
 
 		(ParamFloat<px4::params::IMU_DGYRO_CUTOFF>) _param_imu_dgyro_cutoff
 	)
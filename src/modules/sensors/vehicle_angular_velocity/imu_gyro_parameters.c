@@ -121,3 +121,48 @@ PARAM_DEFINE_INT32(IMU_GYRO_RATEMAX, 0);
 * @group Sensors
 */
 PARAM_DEFINE_FLOAT(IMU_DGYRO_CUTOFF, 30.0f);
+
+/**
+* Dynamic notch filters for gyro
+*
+* Enables notch filters on the primary gyro that track varying frequencies,
+* in addition to the fixed notch (IMU_GYRO_NF_FREQ).
+* ESC RPM: one notch per motor (up to 4) at the rotor frequency reported in esc_status.
+* FFT: notches (up to 4 per axis) at the peak frequencies published by gyro_fft.
+* This only affects the signal sent to the controllers, not the estimators.
+*
+* @min 0
+* @max 3
+* @bit 0 ESC RPM
+* @bit 1 FFT
+* @group Sensors
+*/
+PARAM_DEFINE_INT32(IMU_GYRO_DNF_EN, 0);
+
+/**
+* Dynamic notch filter bandwidth for gyro
+*
+* The frequency width of the stop band of the dynamic notch filters.
+* See "IMU_GYRO_DNF_EN" to enable the filters.
+*
+* @min 5
+* @max 100
+* @unit Hz
+* @reboot_required true
+* @group Sensors
+*/
+PARAM_DEFINE_FLOAT(IMU_GYRO_DNF_BW, 15.0f);
+
+/**
+* Dynamic notch filter minimum frequency for gyro
+*
+* Dynamic notch filters are disabled below this frequency (e.g. at low motor RPM).
+* See "IMU_GYRO_DNF_EN" to enable the filters.
+*
+* @min 0
+* @max 1000
+* @unit Hz
+* @reboot_required true
+* @group Sensors
+*/
+PARAM_DEFINE_FLOAT(IMU_GYRO_DNF_MIN, 25.0f);
@@ -73,6 +73,73 @@ bool Integrator::put(const hrt_abstime &timestamp, const Vector3f &val)
 	return true;
 }
 
+bool Integrator::put(const hrt_abstime &timestamp_sample, const float dt, const matrix::Matrix3f &A,
+		     const int16_t x[], const int16_t y[], const int16_t z[], const int n)
+{
+	if ((n <= 0) || !(dt >= 1.f)) {
+		return false;
+	}
+
+	int first = 0;
+	const hrt_abstime timestamp_first = timestamp_sample - static_cast<hrt_abstime>(roundf((n - 1) * dt));
+
+	if ((_last_integration_time == 0) || (timestamp_first <= _last_integration_time)) {
+		// the first sample (re)initializes the integrator, the following ones are strictly increasing
+		put(timestamp_first, A * Vector3f{(float)x[0], (float)y[0], (float)z[0]});
+		first = 1;
+	}
+
+	if (_coning_comp_on) {
+		integrate_block<true>(timestamp_sample, dt, A, x, y, z, first, n);
+
+	} else {
+		integrate_block<false>(timestamp_sample, dt, A, x, y, z, first, n);
+	}
+
+	return (first < n);
+}
+
+template<bool coning_compensation>
+void Integrator::integrate_block(const hrt_abstime &timestamp_sample, const float dt, const matrix::Matrix3f &A,
+				 const int16_t x[], const int16_t y[], const int16_t z[], const int first, const int n)
+{
+	// work on local copies of the state, written back once after the block
+	Vector3f alpha{_alpha};
+	Vector3f beta{_beta};
+	Vector3f last_alpha{_last_alpha};
+	Vector3f last_delta_alpha{_last_delta_alpha};
+	Vector3f last_val{_last_val};
+	hrt_abstime last_integration_time = _last_integration_time;
+
+	for (int i = first; i < n; i++) {
+		// the last sample is at timestamp_sample
+		const hrt_abstime timestamp = timestamp_sample - static_cast<hrt_abstime>(roundf((n - 1 - i) * dt));
+		const Vector3f val{A * Vector3f{(float)x[i], (float)y[i], (float)z[i]}};
+
+		// trapezoidal integration, same as put()
+		const float dt_s = static_cast<float>(timestamp - last_integration_time) * 1e-6f;
+		const Vector3f delta_alpha = (val + last_val) * dt_s * 0.5f;
+		last_val = val;
+		last_integration_time = timestamp;
+
+		if (coning_compensation) {
+			beta += ((last_alpha + last_delta_alpha * (1.f / 6.f)) % delta_alpha) * 0.5f;
+			last_delta_alpha = delta_alpha;
+			last_alpha = alpha;
+		}
+
+		alpha += delta_alpha;
+	}
+
+	_alpha = alpha;
+	_beta = beta;
+	_last_alpha = last_alpha;
+	_last_delta_alpha = last_delta_alpha;
+	_last_val = last_val;
+	_last_integration_time = last_integration_time;
+	_integrated_samples += n - first;
+}
+
 bool Integrator::reset(Vector3f &integral, uint32_t &integral_dt)
 {
 	if (integral_ready()) {
@@ -75,6 +75,23 @@ public:
 		return put(timestamp, val) && reset(integral, integral_dt);
 	}
 
+	/**
+	 * Put a block of equally spaced raw samples (eg. a FIFO message) into the integral.
+	 * Equivalent to calling put() for every sample, but the samples are converted with a single matrix
+	 * and integrated (including coning corrections) in one loop.
+	 *
+	 * @param timestamp_sample	Timestamp of the last sample in the block.
+	 * @param dt			Sample interval in microseconds (at least 1 us).
+	 * @param A			Scale and rotation applied to the raw samples.
+	 * @param x			Raw X-axis samples.
+	 * @param y			Raw Y-axis samples.
+	 * @param z			Raw Z-axis samples.
+	 * @param n			Number of samples.
+	 * @return		true if data was accepted and integrated.
+	 */
+	bool put(const uint64_t &timestamp_sample, float dt, const matrix::Matrix3f &A,
+		 const int16_t x[], const int16_t y[], const int16_t z[], int n);
+
 	/**
 	 * Set reset interval during runtime. This won't reset the integrator.
 	 *
@@ -105,6 +122,10 @@ public:
 	bool reset(matrix::Vector3f &integral, uint32_t &integral_dt);
 
 private:
+	template<bool coning_compensation>
+	void integrate_block(const uint64_t &timestamp_sample, float dt, const matrix::Matrix3f &A,
+			     const int16_t x[], const int16_t y[], const int16_t z[], int first, int n);
+
 	uint64_t _last_integration_time{0}; /**< timestamp of the last integration step */
 	uint64_t _last_reset_time{0};       /**< last auto-announcement of integral value */
 
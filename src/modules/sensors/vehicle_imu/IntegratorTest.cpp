@@ -0,0 +1,193 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file IntegratorTest.cpp
+ * The block put() for FIFO samples has to match a put() per sample.
+ */
+
+#include <gtest/gtest.h>
+
+#include "Integrator.hpp"
+
+using matrix::Matrix3f;
+using matrix::Vector3f;
+
+namespace
+{
+
+static constexpr int FIFO_SAMPLES = 8;
+static constexpr float FIFO_DT = 1e6f / 6664.f; // not an integer number of microseconds
+
+struct FifoBlock {
+	uint64_t timestamp_sample; // last sample
+	int16_t x[FIFO_SAMPLES];
+	int16_t y[FIFO_SAMPLES];
+	int16_t z[FIFO_SAMPLES];
+};
+
+// coning motion (rotating rate vector in the x-y plane) with some noise
+FifoBlock make_block(uint64_t timestamp_sample, uint32_t &seed)
+{
+	FifoBlock block{};
+	block.timestamp_sample = timestamp_sample;
+
+	for (int i = 0; i < FIFO_SAMPLES; i++) {
+		seed = seed * 1103515245u + 12345u;
+		const float phase = static_cast<float>(seed % 1000) * 1e-3f + (timestamp_sample + i * FIFO_DT) * 1e-4f;
+		block.x[i] = static_cast<int16_t>(8000.f * cosf(phase));
+		block.y[i] = static_cast<int16_t>(8000.f * sinf(phase));
+		block.z[i] = static_cast<int16_t>((seed >> 16) % 400);
+	}
+
+	return block;
+}
+
+// same as VehicleIMU: scale and sensor rotation
+Matrix3f conversion()
+{
+	const float scale = 1.f / 16.4f * 3.14159265f / 180.f;
+	Matrix3f A;
+	A(0, 0) = 0.f;   A(0, 1) = -scale; A(0, 2) = 0.f;
+	A(1, 0) = scale; A(1, 1) = 0.f;    A(1, 2) = 0.f;
+	A(2, 0) = 0.f;   A(2, 1) = 0.f;    A(2, 2) = scale;
+	return A;
+}
+
+void put_per_sample(Integrator &integrator, const FifoBlock &block, const Matrix3f &A)
+{
+	for (int i = 0; i < FIFO_SAMPLES; i++) {
+		const uint64_t timestamp = block.timestamp_sample
+					   - static_cast<uint64_t>(roundf((FIFO_SAMPLES - 1 - i) * FIFO_DT));
+		integrator.put(timestamp, A * Vector3f{(float)block.x[i], (float)block.y[i], (float)block.z[i]});
+	}
+}
+
+void put_block(Integrator &integrator, const FifoBlock &block, const Matrix3f &A)
+{
+	integrator.put(block.timestamp_sample, FIFO_DT, A, block.x, block.y, block.z, FIFO_SAMPLES);
+}
+
+void expect_same_reset(Integrator &per_sample, Integrator &block, const char *step)
+{
+	Vector3f integral_per_sample{};
+	Vector3f integral_block{};
+	uint32_t integral_dt_per_sample = 0;
+	uint32_t integral_dt_block = 0;
+
+	ASSERT_EQ(per_sample.integral_ready(), block.integral_ready()) << step;
+
+	const bool reset_per_sample = per_sample.reset(integral_per_sample, integral_dt_per_sample);
+	const bool reset_block = block.reset(integral_block, integral_dt_block);
+
+	ASSERT_EQ(reset_per_sample, reset_block) << step;
+	EXPECT_EQ(integral_dt_per_sample, integral_dt_block) << step;
+
+	for (int i = 0; i < 3; i++) {
+		EXPECT_FLOAT_EQ(integral_per_sample(i), integral_block(i)) << step << " axis " << i;
+	}
+}
+
+void run_sequence(bool coning_compensation)
+{
+	const Matrix3f A = conversion();
+	Integrator per_sample{coning_compensation};
+	Integrator block{coning_compensation};
+
+	// publish after 2 FIFO blocks
+	per_sample.set_reset_samples(2 * FIFO_SAMPLES);
+	block.set_reset_samples(2 * FIFO_SAMPLES);
+	per_sample.set_reset_interval(2500);
+	block.set_reset_interval(2500);
+
+	uint32_t seed = 1;
+	uint64_t timestamp_sample = 10000000;
+
+	for (int i = 0; i < 20; i++) {
+		const FifoBlock fifo = make_block(timestamp_sample, seed);
+		put_per_sample(per_sample, fifo, A);
+		put_block(block, fifo, A);
+
+		expect_same_reset(per_sample, block, "in order");
+
+		timestamp_sample += static_cast<uint64_t>(roundf(FIFO_SAMPLES * FIFO_DT));
+	}
+}
+
+} // namespace
+
+TEST(IntegratorTest, BlockMatchesPerSample)
+{
+	run_sequence(false);
+}
+
+TEST(IntegratorTest, BlockMatchesPerSampleConing)
+{
+	run_sequence(true);
+}
+
+TEST(IntegratorTest, BlockMatchesPerSampleOutOfOrder)
+{
+	const Matrix3f A = conversion();
+
+	for (bool coning_compensation : {false, true}) {
+		Integrator per_sample{coning_compensation};
+		Integrator block{coning_compensation};
+
+		per_sample.set_reset_samples(2 * FIFO_SAMPLES);
+		block.set_reset_samples(2 * FIFO_SAMPLES);
+
+		uint32_t seed = 7;
+		uint64_t timestamp_sample = 10000000;
+
+		for (int i = 0; i < 3; i++) {
+			const FifoBlock fifo = make_block(timestamp_sample, seed);
+			put_per_sample(per_sample, fifo, A);
+			put_block(block, fifo, A);
+			expect_same_reset(per_sample, block, "before");
+			timestamp_sample += static_cast<uint64_t>(roundf(FIFO_SAMPLES * FIFO_DT));
+		}
+
+		// the first sample of the next block is older than the last integrated one, which restarts the integration
+		timestamp_sample -= 300;
+
+		for (int i = 0; i < 3; i++) {
+			const FifoBlock fifo = make_block(timestamp_sample, seed);
+			put_per_sample(per_sample, fifo, A);
+			put_block(block, fifo, A);
+			expect_same_reset(per_sample, block, "after");
+			timestamp_sample += static_cast<uint64_t>(roundf(FIFO_SAMPLES * FIFO_DT));
+		}
+	}
+}
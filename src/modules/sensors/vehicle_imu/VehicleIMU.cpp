@@ -34,6 +34,7 @@
 #include "VehicleIMU.hpp"
 
 #include <px4_platform_common/log.h>
+#include <px4_platform_common/time.h>
 
 #include <float.h>
 
@@ -50,7 +51,8 @@ VehicleIMU::VehicleIMU(int instance, uint8_t accel_index, uint8_t gyro_index, co
 	ScheduledWorkItem(MODULE_NAME, config),
 	_sensor_accel_sub(this, ORB_ID(sensor_accel), accel_index),
 	_sensor_gyro_sub(this, ORB_ID(sensor_gyro), gyro_index),
-	_instance(instance)
+	_instance(instance),
+	_sample_ring(sample_ring::imu(instance))
 {
 	const float configured_interval_us = 1e6f / _param_imu_integ_rate.get();
 
@@ -90,6 +92,8 @@ VehicleIMU::~VehicleIMU()
 
 bool VehicleIMU::Start()
 {
+	_sample_ring_released = false;
+
 	// force initial updates
 	ParametersUpdate(true);
 
@@ -104,6 +108,19 @@ void VehicleIMU::Stop()
 	// clear all registered callbacks
 	_sensor_accel_sub.unregisterCallback();
 	_sensor_gyro_sub.unregisterCallback();
+	_sensor_gyro_fifo_sub.unregisterCallback();
+
+	// the ring has a single writer, so it is unassigned by a last Run() on the work queue thread
+	if (_sample_ring && !_sample_ring_released) {
+		_release_sample_ring.store(true);
+		ScheduleNow();
+
+		for (int i = 0; (i < 100) && _release_sample_ring.load(); i++) {
+			px4_usleep(1000);
+		}
+
+		_sample_ring_released = true;
+	}
 
 	Deinit();
 }
@@ -195,6 +212,13 @@ bool VehicleIMU::UpdateIntervalAverage(IntervalAverage &intavg, const hrt_abstim
 
 void VehicleIMU::Run()
 {
+	if (_release_sample_ring.load()) {
+		ScheduleClear();
+		_sample_ring->set_device_ids(0, 0);
+		_release_sample_ring.store(false);
+		return;
+	}
+
 	// backup schedule
 	ScheduleDelayed(10_ms);
 
@@ -209,10 +233,24 @@ void VehicleIMU::Run()
 	bool update_integrator_config = false;
 	bool publish_status = false;
 
+	if (_gyro_fifo) {
+		UpdateGyroFifo(sensor_data_gap, update_integrator_config, publish_status);
+
+		// fall back to sensor_gyro if the FIFO data stops
+		if (hrt_elapsed_time(&_gyro_fifo_timestamp_last) > 100_ms) {
+			SelectGyroFifo(false);
+		}
+
+	} else if ((_gyro_calibration.device_id() != 0) && (hrt_elapsed_time(&_gyro_fifo_check_last) > 1_s)) {
+		// periodically check if FIFO data has become available for the gyro
+		_gyro_fifo_check_last = hrt_absolute_time();
+		SelectGyroFifo(true);
+	}
+
 	// integrate queued gyro
 	sensor_gyro_s gyro;
 
-	while (_sensor_gyro_sub.update(&gyro)) {
+	while (!_gyro_fifo && _sensor_gyro_sub.update(&gyro)) {
 		perf_count_interval(_gyro_update_perf, gyro.timestamp_sample);
 
 		if (_sensor_gyro_sub.get_last_generation() != _gyro_last_generation + 1) {
@@ -374,6 +412,16 @@ void VehicleIMU::Run()
 				UpdateAccelVibrationMetrics(delta_velocity_corrected);
 				UpdateGyroVibrationMetrics(delta_angle_corrected);
 
+				// shared history, timestamped at the middle of each integration interval
+				if (_sample_ring) {
+					_sample_ring->set_device_ids(_accel_calibration.device_id(), _gyro_calibration.device_id());
+
+					_sample_ring->accel.push(_last_timestamp_sample_accel - accel_integral_dt / 2,
+								 delta_velocity_corrected * accel_dt_inv);
+					_sample_ring->gyro.push(_last_timestamp_sample_gyro - gyro_integral_dt / 2,
+								delta_angle_corrected * gyro_dt_inv);
+				}
+
 				// vehicle_imu_status
 				//  publish before vehicle_imu so that error counts are available synchronously if needed
 				if (publish_status || (hrt_elapsed_time(&_status.timestamp) >= 100_ms)) {
@@ -424,6 +472,128 @@ void VehicleIMU::Run()
 	}
 }
 
+bool VehicleIMU::SelectGyroFifo(bool enable)
+{
+	if (enable) {
+		const uint32_t device_id = _gyro_calibration.device_id();
+
+		for (uint8_t i = 0; (device_id != 0) && (i < ORB_MULTI_MAX_INSTANCES); i++) {
+			uORB::SubscriptionData<sensor_gyro_fifo_s> sensor_gyro_fifo_sub{ORB_ID(sensor_gyro_fifo), i};
+
+			if ((sensor_gyro_fifo_sub.get().device_id == device_id)
+			    && _sensor_gyro_fifo_sub.ChangeInstance(i) && _sensor_gyro_fifo_sub.registerCallback()) {
+
+				PX4_DEBUG("gyro %d: using FIFO data", device_id);
+				_sensor_gyro_sub.unregisterCallback();
+				_sensor_gyro_fifo_sub.set_required_updates(1);
+				_gyro_fifo = true;
+				_gyro_fifo_timestamp_last = hrt_absolute_time();
+				break;
+			}
+		}
+
+		if (!_gyro_fifo) {
+			return false;
+		}
+
+	} else {
+		PX4_DEBUG("gyro %d: using sensor_gyro", _gyro_calibration.device_id());
+		_sensor_gyro_fifo_sub.unregisterCallback();
+		_sensor_gyro_sub.registerCallback();
+		_sensor_accel_sub.registerCallback();
+		_gyro_fifo = false;
+		_gyro_fifo_check_last = hrt_absolute_time();
+	}
+
+	// the sample interval changes, restart interval monitoring and integrator configuration
+	_gyro_interval = IntervalAverage{};
+	_gyro_last_generation = _gyro_fifo ? _sensor_gyro_fifo_sub.get_last_generation() : _sensor_gyro_sub.get_last_generation();
+	_intervals_configured = false;
+
+	return true;
+}
+
+void VehicleIMU::UpdateGyroFifo(bool &sensor_data_gap, bool &update_integrator_config, bool &publish_status)
+{
+	// sensor_gyro is still published at a lower rate, use it for temperature and error count
+	sensor_gyro_s gyro;
+
+	while (_sensor_gyro_sub.update(&gyro)) {
+		_gyro_fifo_temperature = gyro.temperature;
+
+		if (gyro.error_count != _status.gyro_error_count) {
+			publish_status = true;
+			_status.gyro_error_count = gyro.error_count;
+		}
+	}
+
+	sensor_gyro_fifo_s gyro_fifo;
+
+	while (_sensor_gyro_fifo_sub.update(&gyro_fifo)) {
+		perf_count_interval(_gyro_update_perf, gyro_fifo.timestamp_sample);
+		_gyro_fifo_timestamp_last = gyro_fifo.timestamp_sample;
+
+		if (_sensor_gyro_fifo_sub.get_last_generation() != _gyro_last_generation + 1) {
+			sensor_data_gap = true;
+			perf_count(_gyro_generation_gap_perf);
+		}
+
+		_gyro_last_generation = _sensor_gyro_fifo_sub.get_last_generation();
+
+		const int N = gyro_fifo.samples;
+
+		if ((N == 0) || !(gyro_fifo.dt > 0.f)) {
+			continue;
+		}
+
+		// the sample interval is known, no averaging needed
+		if (!_intervals_configured
+		    && (fabsf(gyro_fifo.dt - _gyro_interval.update_interval) > 0.005f * gyro_fifo.dt)) {
+
+			_gyro_interval.update_interval = gyro_fifo.dt;
+			update_integrator_config = true;
+			publish_status = true;
+			_status.gyro_rate_hz = 1e6f / gyro_fifo.dt;
+		}
+
+		_gyro_calibration.set_device_id(gyro_fifo.device_id);
+
+		const enum Rotation rotation = static_cast<enum Rotation>(gyro_fifo.rotation);
+
+		if (rotation != _gyro_fifo_rotation_enum) {
+			_gyro_fifo_rotation = get_rot_matrix(rotation);
+			_gyro_fifo_rotation_enum = rotation;
+		}
+
+		// sensor rotation and scale of the raw samples
+		const Matrix3f A = Matrix3f{_gyro_fifo_rotation} * gyro_fifo.scale;
+
+		int32_t sum[3] {};
+
+		for (int n = 0; n < N; n++) {
+			sum[0] += gyro_fifo.x[n];
+			sum[1] += gyro_fifo.y[n];
+			sum[2] += gyro_fifo.z[n];
+		}
+
+		_gyro_sum += A * Vector3f{(float)sum[0], (float)sum[1], (float)sum[2]};
+		_gyro_temperature += N * _gyro_fifo_temperature;
+		_gyro_sum_count += N;
+
+		// integrate the whole block, the last sample is at timestamp_sample
+		_gyro_integrator.put(gyro_fifo.timestamp_sample, gyro_fifo.dt, A, gyro_fifo.x, gyro_fifo.y, gyro_fifo.z, N);
+
+		_last_timestamp_sample_gyro = gyro_fifo.timestamp_sample;
+
+		// break if interval is configured and we haven't fallen behind
+		if (_intervals_configured && _gyro_integrator.integral_ready()
+		    && (hrt_elapsed_time(&gyro_fifo.timestamp) < _imu_integration_interval_us) && !sensor_data_gap) {
+
+			break;
+		}
+	}
+}
+
 void VehicleIMU::UpdateIntegratorConfiguration()
 {
 	if ((_accel_interval.update_interval > 0) && (_gyro_interval.update_interval > 0)) {
@@ -432,7 +602,8 @@ void VehicleIMU::UpdateIntegratorConfiguration()
 
 		// determine number of sensor samples that will get closest to the desired integration interval
 		const uint8_t accel_integral_samples = math::max(1.f, roundf(configured_interval_us / _accel_interval.update_interval));
-		const uint8_t gyro_integral_samples = math::max(1.f, roundf(configured_interval_us / _gyro_interval.update_interval));
+		const uint8_t gyro_integral_samples = math::constrain(roundf(configured_interval_us / _gyro_interval.update_interval),
+						      1.f, (float)UINT8_MAX);
 
 		// let the gyro set the configuration and scheduling
 		// accel integrator will be forced to reset when gyro integrator is ready
@@ -443,6 +614,19 @@ void VehicleIMU::UpdateIntegratorConfiguration()
 		_accel_integrator.set_reset_interval(roundf((accel_integral_samples - 0.5f) * _accel_interval.update_interval));
 		_gyro_integrator.set_reset_interval(roundf((gyro_integral_samples - 0.5f) * _gyro_interval.update_interval));
 
+		if (_gyro_fifo) {
+			// every FIFO message is processed, the integrator resets after gyro_integral_samples individual samples
+			_sensor_gyro_fifo_sub.set_required_updates(1);
+			_sensor_accel_sub.unregisterCallback();
+			_intervals_configured = true;
+
+			PX4_DEBUG("accel (%d), gyro FIFO (%d), accel samples: %d, gyro samples: %d, gyro interval: %.1f",
+				  _accel_calibration.device_id(), _gyro_calibration.device_id(), accel_integral_samples, gyro_integral_samples,
+				  (double)_gyro_interval.update_interval);
+
+			return;
+		}
+
 		// gyro: find largest integer multiple of gyro_integral_samples
 		for (int n = sensor_gyro_s::ORB_QUEUE_LENGTH; n > 0; n--) {
 			if (gyro_integral_samples % n == 0) {
@@ -497,6 +681,10 @@ void VehicleIMU::PrintStatus()
 			 (double)_accel_interval.update_interval, _gyro_calibration.device_id(), (double)_gyro_interval.update_interval);
 	}
 
+	if (_gyro_fifo) {
+		PX4_INFO("%d - Gyro FIFO, sample interval: %.1f us", _instance, (double)_gyro_interval.update_interval);
+	}
+
 	perf_print_counter(_accel_generation_gap_perf);
 	perf_print_counter(_gyro_generation_gap_perf);
 	perf_print_counter(_accel_update_perf);
@@ -35,11 +35,14 @@
 
 #include "Integrator.hpp"
 
+#include <lib/conversion/rotation.h>
 #include <lib/mathlib/math/Limits.hpp>
 #include <lib/matrix/matrix/math.hpp>
 #include <lib/perf/perf_counter.h>
+#include <lib/sample_ring/ImuSampleRings.hpp>
 #include <lib/sensor_calibration/Accelerometer.hpp>
 #include <lib/sensor_calibration/Gyroscope.hpp>
+#include <px4_platform_common/atomic.h>
 #include <px4_platform_common/log.h>
 #include <px4_platform_common/module_params.h>
 #include <px4_platform_common/px4_config.h>
@@ -50,6 +53,7 @@
 #include <uORB/topics/parameter_update.h>
 #include <uORB/topics/sensor_accel.h>
 #include <uORB/topics/sensor_gyro.h>
+#include <uORB/topics/sensor_gyro_fifo.h>
 #include <uORB/topics/vehicle_imu.h>
 #include <uORB/topics/vehicle_imu_status.h>
 
@@ -81,6 +85,8 @@ private:
 	};
 
 	bool UpdateIntervalAverage(IntervalAverage &intavg, const hrt_abstime &timestamp_sample);
+	bool SelectGyroFifo(bool enable);
+	void UpdateGyroFifo(bool &sensor_data_gap, bool &update_integrator_config, bool &publish_status);
 	void UpdateIntegratorConfiguration();
 	void UpdateGyroVibrationMetrics(const matrix::Vector3f &delta_angle);
 	void UpdateAccelVibrationMetrics(const matrix::Vector3f &delta_velocity);
@@ -90,6 +96,7 @@ private:
 	uORB::Subscription _params_sub{ORB_ID(parameter_update)};
 	uORB::SubscriptionCallbackWorkItem _sensor_accel_sub;
 	uORB::SubscriptionCallbackWorkItem _sensor_gyro_sub;
+	uORB::SubscriptionCallbackWorkItem _sensor_gyro_fifo_sub{this, ORB_ID(sensor_gyro_fifo)};
 
 	calibration::Accelerometer _accel_calibration{};
 	calibration::Gyroscope _gyro_calibration{};
@@ -125,8 +132,20 @@ private:
 
 	bool _intervals_configured{false};
 
+	// gyro FIFO data is integrated block by block if available
+	bool _gyro_fifo{false};
+	float _gyro_fifo_temperature{NAN};
+	Rotation _gyro_fifo_rotation_enum{ROTATION_NONE};
+	matrix::Dcmf _gyro_fifo_rotation; ///< rotation of the raw FIFO samples, cached
+	hrt_abstime _gyro_fifo_timestamp_last{0};
+	hrt_abstime _gyro_fifo_check_last{0};
+
 	const uint8_t _instance;
 
+	sample_ring::ImuSampleRing *const _sample_ring; ///< shared history of the published data, written only by this instance
+	px4::atomic_bool _release_sample_ring{false};   ///< set by Stop(), Run() unassigns the ring and clears the flag
+	bool _sample_ring_released{false};
+
 	perf_counter_t _accel_update_perf{perf_alloc(PC_INTERVAL, MODULE_NAME": accel update interval")};
 	perf_counter_t _accel_generation_gap_perf{perf_alloc(PC_COUNT, MODULE_NAME": accel data gap")};
 	perf_counter_t _gyro_update_perf{perf_alloc(PC_INTERVAL, MODULE_NAME": gyro update interval")};
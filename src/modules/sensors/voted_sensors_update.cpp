@@ -412,10 +412,17 @@ void VotedSensorsUpdate::calcAccelInconsistency()
 	Vector3f accel_all[MAX_SENSOR_COUNT] {};
 	uint8_t accel_count = 0;
 
+	// compare at a common time if possible, otherwise use the latest data of each sensor
+	const bool aligned = getAlignedSamples(&sample_ring::find_accel, _accel_device_id, _accel, accel_all);
+
 	for (int sensor_index = 0; sensor_index < MAX_SENSOR_COUNT; sensor_index++) {
 		if ((_accel_device_id[sensor_index] != 0) && (_accel.priority[sensor_index] > 0)) {
 			accel_count++;
-			accel_all[sensor_index] = Vector3f{_last_sensor_data[sensor_index].accelerometer_m_s2};
+
+			if (!aligned) {
+				accel_all[sensor_index] = Vector3f{_last_sensor_data[sensor_index].accelerometer_m_s2};
+			}
+
 			accel_mean += accel_all[sensor_index];
 		}
 	}
@@ -437,10 +444,17 @@ void VotedSensorsUpdate::calcGyroInconsistency()
 	Vector3f gyro_all[MAX_SENSOR_COUNT] {};
 	uint8_t gyro_count = 0;
 
+	// compare at a common time if possible, otherwise use the latest data of each sensor
+	const bool aligned = getAlignedSamples(&sample_ring::find_gyro, _gyro_device_id, _gyro, gyro_all);
+
 	for (int sensor_index = 0; sensor_index < MAX_SENSOR_COUNT; sensor_index++) {
 		if ((_gyro_device_id[sensor_index] != 0) && (_gyro.priority[sensor_index] > 0)) {
 			gyro_count++;
-			gyro_all[sensor_index] = Vector3f{_last_sensor_data[sensor_index].gyro_rad};
+
+			if (!aligned) {
+				gyro_all[sensor_index] = Vector3f{_last_sensor_data[sensor_index].gyro_rad};
+			}
+
 			gyro_mean += gyro_all[sensor_index];
 		}
 	}
@@ -455,3 +469,38 @@ void VotedSensorsUpdate::calcGyroInconsistency()
 		}
 	}
 }
+
+bool VotedSensorsUpdate::getAlignedSamples(const sample_ring::Vector3fRing *(*find_ring)(uint32_t),
+		const uint32_t device_id[], const SensorData &sensor, Vector3f samples[])
+{
+	const sample_ring::Vector3fRing *rings[MAX_SENSOR_COUNT] {};
+	uint64_t timestamp_aligned = UINT64_MAX;
+
+	for (int sensor_index = 0; sensor_index < MAX_SENSOR_COUNT; sensor_index++) {
+		if ((device_id[sensor_index] != 0) && (sensor.priority[sensor_index] > 0)) {
+			sample_ring::Vector3fRing::Sample latest;
+			rings[sensor_index] = find_ring(device_id[sensor_index]);
+
+			if ((rings[sensor_index] == nullptr) || !rings[sensor_index]->latest(latest)) {
+				return false;
+			}
+
+			timestamp_aligned = math::min(timestamp_aligned, latest.timestamp_sample);
+		}
+	}
+
+	for (int sensor_index = 0; sensor_index < MAX_SENSOR_COUNT; sensor_index++) {
+		if ((rings[sensor_index] != nullptr) && !rings[sensor_index]->interpolate(timestamp_aligned, samples[sensor_index])) {
+			return false;
+		}
+	}
+
+	// a ring reassigned to another device in the meantime may hold samples of that device
+	for (int sensor_index = 0; sensor_index < MAX_SENSOR_COUNT; sensor_index++) {
+		if ((rings[sensor_index] != nullptr) && (find_ring(device_id[sensor_index]) != rings[sensor_index])) {
+			return false;
+		}
+	}
+
+	return true;
+}
@@ -44,6 +44,7 @@
 
 #include <px4_platform_common/module_params.h>
 #include <drivers/drv_hrt.h>
+#include <lib/sample_ring/ImuSampleRings.hpp>
 #include <mathlib/mathlib.h>
 #include <matrix/math.hpp>
 #include <uORB/Publication.hpp>
@@ -151,6 +152,13 @@ private:
 	 */
 	void calcGyroInconsistency();
 
+	/**
+	 * Interpolates the shared sample rings of all active sensors at the newest timestamp all of them have data for
+	 * @return true if all active sensors could be aligned
+	 */
+	bool getAlignedSamples(const sample_ring::Vector3fRing *(*find_ring)(uint32_t), const uint32_t device_id[],
+			       const SensorData &sensor, matrix::Vector3f samples[]);
+
 	SensorData _accel{ORB_ID::sensor_accel};
 	SensorData _gyro{ORB_ID::sensor_gyro};
 
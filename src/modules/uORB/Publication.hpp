@@ -74,6 +74,11 @@ public:
 
 	bool unadvertise() { return (DeviceNode::unadvertise(_handle) == PX4_OK); }
 
+	/**
+	 * Check if the topic has callback subscribers, which are scheduled by every publication.
+	 */
+	bool has_callbacks() const { return advertised() && static_cast<DeviceNode *>(_handle)->has_callbacks(); }
+
 	orb_id_t get_topic() const { return get_orb_meta(_orb_id); }
 
 protected:
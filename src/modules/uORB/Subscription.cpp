@@ -37,6 +37,7 @@
  */
 
 #include "Subscription.hpp"
+#include <px4_platform_common/boot_profile.h>
 #include <px4_platform_common/defines.h>
 
 namespace uORB
@@ -67,6 +68,8 @@ bool Subscription::subscribe()
 
 				_last_generation = _node->get_initial_generation();
 
+				px4_boot_profile_subscribe(get_topic()->o_name);
+
 				return true;
 			}
 		}
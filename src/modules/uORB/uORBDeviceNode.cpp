@@ -571,6 +571,7 @@ uORB::DeviceNode::register_callback(uORB::SubscriptionCallback *callback_sub)
 		}
 
 		_callbacks.add(callback_sub);
+		_callback_count.fetch_add(1);
 		ATOMIC_LEAVE;
 		return true;
 	}
@@ -582,6 +583,10 @@ void
 uORB::DeviceNode::unregister_callback(uORB::SubscriptionCallback *callback_sub)
 {
 	ATOMIC_ENTER;
-	_callbacks.remove(callback_sub);
+
+	if (_callbacks.remove(callback_sub)) {
+		_callback_count.fetch_sub(1);
+	}
+
 	ATOMIC_LEAVE;
 }
@@ -193,6 +193,12 @@ public:
 
 	int8_t subscriber_count() const { return _subscriber_count; }
 
+	/**
+	 * Check if any subscriber registered a callback (eg a SubscriptionCallbackWorkItem).
+	 * Lock free, so it can be called from the publisher.
+	 */
+	bool has_callbacks() const { return _callback_count.load() > 0; }
+
 	/**
 	 * Returns the number of updated data relative to the parameter 'generation'
 	 * We can get the correct value regardless of wrap-around or not.
@@ -248,6 +254,7 @@ private:
 	bool _data_valid{false}; /**< At least one valid data */
 	px4::atomic<unsigned>  _generation{0};  /**< object generation count */
 	List<uORB::SubscriptionCallback *>	_callbacks;
+	px4::atomic<unsigned>  _callback_count{0}; /**< number of entries in _callbacks, for has_callbacks() */
 
 	const uint8_t _instance; /**< orb multi instance identifier */
 	bool _advertised{false};  /**< has ever been advertised (not necessarily published data yet) */
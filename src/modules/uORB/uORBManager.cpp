@@ -37,6 +37,7 @@
 #include <fcntl.h>
 
 #include <px4_platform_common/px4_config.h>
+#include <px4_platform_common/boot_profile.h>
 #include <px4_platform_common/posix.h>
 #include <px4_platform_common/tasks.h>
 
@@ -237,6 +238,8 @@ orb_advert_t uORB::Manager::orb_advertise_multi(const struct orb_metadata *meta,
 		}
 	}
 
+	px4_boot_profile_publish(meta->o_name);
+
 	return advertiser;
 }
 
@@ -255,13 +258,25 @@ int uORB::Manager::orb_unadvertise(orb_advert_t handle)
 
 int uORB::Manager::orb_subscribe(const struct orb_metadata *meta)
 {
-	return node_open(meta, false);
+	const int fd = node_open(meta, false);
+
+	if (fd >= 0) {
+		px4_boot_profile_subscribe(meta->o_name);
+	}
+
+	return fd;
 }
 
 int uORB::Manager::orb_subscribe_multi(const struct orb_metadata *meta, unsigned instance)
 {
 	int inst = instance;
-	return node_open(meta, false, &inst);
+	const int fd = node_open(meta, false, &inst);
+
+	if (fd >= 0) {
+		px4_boot_profile_subscribe(meta->o_name);
+	}
+
+	return fd;
 }
 
 int uORB::Manager::orb_unsubscribe(int fd)
@@ -0,0 +1,87 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file boot_profile.cpp
+ *
+ * Print the module startup trace.
+ */
+
+#include <px4_platform_common/px4_config.h>
+#include <px4_platform_common/boot_profile.h>
+#include <px4_platform_common/module.h>
+
+static void	usage();
+
+extern "C" {
+	__EXPORT int boot_profile_main(int argc, char *argv[]);
+}
+
+int
+boot_profile_main(int argc, char *argv[])
+{
+	if (argc > 1) {
+		usage();
+		return 1;
+	}
+
+	px4_boot_profile_print();
+
+	return 0;
+}
+
+static void
+usage()
+{
+
+	PRINT_MODULE_DESCRIPTION(
+		R"DESCR_STR(
+### Description
+
+Command-line tool to show where the boot time goes.
+
+For every module it prints when the start command was issued ('spawn'), how long the start
+command took ('start'), how long instantiating the module in its own thread took ('init'),
+how long the start command was blocked waiting for the module thread ('blocked') and when
+the module first advertised and subscribed to a topic, together with these topics.
+Publications and subscriptions are assigned to the calling task, so modules running on a
+work queue show up under the name of the work queue. Boot phases such as the parameter
+import are listed with their duration as 'init'.
+
+All times are in milliseconds since boot. The same table is written to the start of every log.
+)DESCR_STR");
+
+	PRINT_MODULE_USAGE_NAME_SIMPLE("boot_profile", "system");
+
+}
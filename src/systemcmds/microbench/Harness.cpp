@@ -0,0 +1,263 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include "Harness.hpp"
+
+#include <px4_platform_common/log.h>
+#include <drivers/drv_hrt.h>
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+namespace microbench
+{
+
+static int compare_float(const void *a, const void *b)
+{
+	const float fa = *static_cast<const float *>(a);
+	const float fb = *static_cast<const float *>(b);
+	return (fa > fb) - (fa < fb);
+}
+
+// nearest-rank percentile of a sorted array
+static float percentile(const float *sorted, unsigned n, unsigned p)
+{
+	unsigned rank = (p * n + 99) / 100;
+	return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+Harness::Harness(unsigned warmup, unsigned repetitions, const char *filter) :
+	_warmup(warmup),
+	_repetitions(repetitions),
+	_filter(filter)
+{
+	_samples = new float[_repetitions];
+}
+
+Harness::~Harness()
+{
+	delete[] _samples;
+}
+
+bool Harness::enabled(const char *name) const
+{
+	return _filter == nullptr || strstr(name, _filter) != nullptr;
+}
+
+uint64_t Harness::now_ns()
+{
+#if defined(__PX4_POSIX)
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#else
+	return hrt_absolute_time() * 1000ULL;
+#endif
+}
+
+void Harness::add_result(const char *name, float *samples, unsigned num_samples, unsigned batch)
+{
+	if (num_samples == 0) {
+		return;
+	}
+
+	if (_num_results >= MAX_RESULTS) {
+		PX4_ERR("too many results, dropping %s", name);
+		return;
+	}
+
+	qsort(samples, num_samples, sizeof(float), compare_float);
+
+	double sum = 0.0;
+
+	for (unsigned i = 0; i < num_samples; i++) {
+		sum += samples[i];
+	}
+
+	Result &res = _results[_num_results++];
+	strncpy(res.name, name, sizeof(res.name) - 1);
+	res.name[sizeof(res.name) - 1] = '\0';
+	res.samples = num_samples;
+	res.batch = batch;
+	res.min_ns = samples[0];
+	res.mean_ns = (float)(sum / num_samples);
+	res.p50_ns = percentile(samples, num_samples, 50);
+	res.p90_ns = percentile(samples, num_samples, 90);
+	res.p99_ns = percentile(samples, num_samples, 99);
+	res.max_ns = samples[num_samples - 1];
+}
+
+void Harness::print_results() const
+{
+	PX4_INFO_RAW("%-40s %8s %10s %10s %10s %10s %10s %10s\n", "benchmark [ns/op]", "samples",
+		     "min", "mean", "p50", "p90", "p99", "max");
+
+	for (unsigned i = 0; i < _num_results; i++) {
+		const Result &r = _results[i];
+		PX4_INFO_RAW("%-40s %8u %10.1f %10.1f %10.1f %10.1f %10.1f %10.1f\n", r.name, (unsigned)r.samples,
+			     (double)r.min_ns, (double)r.mean_ns, (double)r.p50_ns, (double)r.p90_ns, (double)r.p99_ns, (double)r.max_ns);
+	}
+}
+
+int Harness::write_json(const char *path) const
+{
+	FILE *fp = fopen(path, "w");
+
+	if (fp == nullptr) {
+		PX4_ERR("failed to open %s", path);
+		return -1;
+	}
+
+	fprintf(fp, "{\"version\": 1, \"benchmarks\": [\n");
+
+	for (unsigned i = 0; i < _num_results; i++) {
+		const Result &r = _results[i];
+		fprintf(fp, "{\"name\": \"%s\", \"samples\": %u, \"batch\": %u, \"min_ns\": %.1f, \"mean_ns\": %.1f, "
+			"\"p50_ns\": %.1f, \"p90_ns\": %.1f, \"p99_ns\": %.1f, \"max_ns\": %.1f}%s\n",
+			r.name, (unsigned)r.samples, (unsigned)r.batch, (double)r.min_ns, (double)r.mean_ns,
+			(double)r.p50_ns, (double)r.p90_ns, (double)r.p99_ns, (double)r.max_ns,
+			(i + 1 < _num_results) ? "," : "");
+	}
+
+	fprintf(fp, "]}\n");
+
+	const bool failed = ferror(fp);
+	fclose(fp);
+
+	if (failed) {
+		PX4_ERR("failed to write %s", path);
+		return -1;
+	}
+
+	return 0;
+}
+
+// extract "key": <number> from a single JSON object line
+static bool parse_number(const char *line, const char *key, float &value)
+{
+	const char *p = strstr(line, key);
+
+	if (p == nullptr) {
+		return false;
+	}
+
+	p = strchr(p + strlen(key), ':');
+
+	if (p == nullptr) {
+		return false;
+	}
+
+	char *end = nullptr;
+	value = strtof(p + 1, &end);
+	return end != p + 1;
+}
+
+static bool parse_name(const char *line, char *name, size_t len)
+{
+	const char *p = strstr(line, "\"name\"");
+
+	if (p == nullptr || (p = strchr(p + 6, '"')) == nullptr) {
+		return false;
+	}
+
+	const char *end = strchr(++p, '"');
+
+	if (end == nullptr || (size_t)(end - p) >= len) {
+		return false;
+	}
+
+	memcpy(name, p, end - p);
+	name[end - p] = '\0';
+	return true;
+}
+
+int Harness::compare(const char *path, float tolerance) const
+{
+	FILE *fp = fopen(path, "r");
+
+	if (fp == nullptr) {
+		PX4_ERR("failed to open baseline %s", path);
+		return -1;
+	}
+
+	bool compared[MAX_RESULTS] {};
+	int regressions = 0;
+	char line[512];
+
+	PX4_INFO_RAW("%-40s %10s %10s %8s\n", "benchmark (p50) [ns/op]", "baseline", "current", "change");
+
+	while (fgets(line, sizeof(line), fp)) {
+		char name[Result::NAME_LEN];
+		float baseline_p50;
+
+		if (!parse_name(line, name, sizeof(name)) || !parse_number(line, "\"p50_ns\"", baseline_p50)) {
+			continue;
+		}
+
+		for (unsigned i = 0; i < _num_results; i++) {
+			const Result &r = _results[i];
+
+			if (strcmp(r.name, name) != 0) {
+				continue;
+			}
+
+			compared[i] = true;
+
+			const float change = (baseline_p50 > 0.f) ? (r.p50_ns - baseline_p50) / baseline_p50 : 0.f;
+			const bool regressed = change > tolerance;
+
+			if (regressed) {
+				regressions++;
+			}
+
+			PX4_INFO_RAW("%-40s %10.1f %10.1f %+7.1f%%%s\n", r.name, (double)baseline_p50, (double)r.p50_ns,
+				     (double)(change * 100.f), regressed ? "  REGRESSION" : "");
+			break;
+		}
+	}
+
+	fclose(fp);
+
+	for (unsigned i = 0; i < _num_results; i++) {
+		if (!compared[i]) {
+			PX4_INFO_RAW("%-40s %10s %10.1f\n", _results[i].name, "-", (double)_results[i].p50_ns);
+		}
+	}
+
+	return regressions;
+}
+
+} // namespace microbench
@@ -0,0 +1,163 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file Harness.hpp
+ *
+ * Benchmark harness: warmup, repeated timed samples, percentile statistics,
+ * JSON output and comparison against a stored baseline.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace microbench
+{
+
+struct Result {
+	static constexpr size_t NAME_LEN = 48;
+
+	char name[NAME_LEN];
+	uint32_t samples;
+	uint32_t batch;      ///< operations timed per sample
+	float min_ns;        ///< all statistics are per operation
+	float mean_ns;
+	float p50_ns;
+	float p90_ns;
+	float p99_ns;
+	float max_ns;
+};
+
+class Harness
+{
+public:
+	static constexpr unsigned MAX_RESULTS = 96;
+
+	Harness(unsigned warmup, unsigned repetitions, const char *filter);
+	~Harness();
+
+	Harness(const Harness &) = delete;
+	Harness &operator=(const Harness &) = delete;
+
+	bool valid() const { return _samples != nullptr; }
+
+	unsigned repetitions() const { return _repetitions; }
+
+	/**
+	 * Check if a benchmark is selected by the name filter (substring match).
+	 */
+	bool enabled(const char *name) const;
+
+	/**
+	 * Time op(). Each sample measures @p batch consecutive calls, so that
+	 * operations shorter than the clock resolution still resolve.
+	 */
+	template<typename F>
+	void run(const char *name, F &&op, unsigned batch = 1)
+	{
+		if (!enabled(name)) {
+			return;
+		}
+
+		for (unsigned i = 0; i < _warmup * batch; i++) {
+			op();
+		}
+
+		for (unsigned r = 0; r < _repetitions; r++) {
+			const uint64_t t0 = now_ns();
+
+			for (unsigned i = 0; i < batch; i++) {
+				op();
+			}
+
+			_samples[r] = (float)(now_ns() - t0) / batch;
+		}
+
+		add_result(name, _samples, _repetitions, batch);
+	}
+
+	/**
+	 * Add externally measured samples (e.g. latencies across threads).
+	 * @p samples is sorted in place.
+	 */
+	void add_result(const char *name, float *samples, unsigned num_samples, unsigned batch = 1);
+
+	/**
+	 * Scratch buffer with room for repetitions() samples, for use with add_result().
+	 */
+	float *sample_buffer() { return _samples; }
+
+	void print_results() const;
+
+	/**
+	 * Write results as JSON. The file contains one benchmark object per line,
+	 * which is also the format read back by compare().
+	 */
+	int write_json(const char *path) const;
+
+	/**
+	 * Compare the median of each result against a baseline JSON file.
+	 * @param tolerance allowed relative slowdown, e.g. 0.1 for 10%
+	 * @return number of regressions, or -1 if the baseline cannot be read
+	 */
+	int compare(const char *path, float tolerance) const;
+
+	/**
+	 * Monotonic time in nanoseconds. On POSIX this is the host clock, not the
+	 * (possibly lockstepped) simulation time returned by hrt_absolute_time().
+	 */
+	static uint64_t now_ns();
+
+	/**
+	 * Keep a value alive so the compiler cannot remove the benchmarked code.
+	 */
+	template<typename T>
+	static inline void do_not_optimize(const T &value)
+	{
+		asm volatile("" : : "r,m"(value) : "memory");
+	}
+
+private:
+	const unsigned _warmup;
+	const unsigned _repetitions;
+	const char *_filter;
+
+	float *_samples{nullptr};
+
+	Result _results[MAX_RESULTS] {};
+	unsigned _num_results{0};
+};
+
+} // namespace microbench
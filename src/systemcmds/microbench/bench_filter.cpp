@@ -0,0 +1,117 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file bench_filter.cpp
+ *
+ * Filters used in the rate control path.
+ */
+
+#include "benchmarks.hpp"
+
+#include <lib/mathlib/math/filter/BiquadCascadeVector3f.hpp>
+#include <lib/mathlib/math/filter/LowPassFilter2p.hpp>
+#include <lib/mathlib/math/filter/LowPassFilter2pVector3f.hpp>
+#include <lib/mathlib/math/filter/NotchFilter.hpp>
+
+namespace microbench
+{
+
+void bench_filter(Harness &harness)
+{
+	static constexpr float SAMPLE_FREQ = 8000.f;
+
+	float sample = 0.f;
+
+	math::LowPassFilter2p lpf{SAMPLE_FREQ, 80.f};
+
+	harness.run("filter_lpf2p", [&]() {
+		sample = lpf.apply(sample + 0.1f);
+		Harness::do_not_optimize(sample);
+	}, 100);
+
+	math::LowPassFilter2pVector3f lpf_vec{SAMPLE_FREQ, 80.f};
+	matrix::Vector3f sample_vec{0.1f, 0.2f, 0.3f};
+
+	harness.run("filter_lpf2p_vector3f", [&]() {
+		sample_vec = lpf_vec.apply(sample_vec + matrix::Vector3f{0.1f, 0.1f, 0.1f});
+		Harness::do_not_optimize(sample_vec(0));
+	}, 100);
+
+	math::NotchFilter<float> notch;
+	notch.setParameters(SAMPLE_FREQ, 120.f, 20.f);
+
+	harness.run("filter_notch", [&]() {
+		sample = notch.apply(sample + 0.1f);
+		Harness::do_not_optimize(sample);
+	}, 100);
+
+	math::NotchFilter<matrix::Vector3f> notch_vec;
+	notch_vec.setParameters(SAMPLE_FREQ, 120.f, 20.f);
+
+	harness.run("filter_notch_vector3f", [&]() {
+		sample_vec = notch_vec.apply(sample_vec + matrix::Vector3f{0.1f, 0.1f, 0.1f});
+		Harness::do_not_optimize(sample_vec(0));
+	}, 100);
+
+	// notch + low-pass on a FIFO sized block, reported per block
+	static constexpr int BLOCK_SIZE = 32;
+	math::BiquadCascadeVector3f<2> cascade;
+	cascade.setNotch(0, SAMPLE_FREQ, 120.f, 20.f);
+	cascade.setLowPass(1, SAMPLE_FREQ, 80.f);
+
+	float block[3][BLOCK_SIZE] {};
+
+	harness.run("filter_biquad_cascade2_block32", [&]() {
+		for (int i = 0; i < BLOCK_SIZE; i++) {
+			block[0][i] += 0.1f;
+		}
+
+		cascade.apply(block[0], block[1], block[2], BLOCK_SIZE);
+		Harness::do_not_optimize(block[0][0]);
+	}, 10);
+
+	math::NotchFilter<matrix::Vector3f> notch_ref;
+	notch_ref.setParameters(SAMPLE_FREQ, 120.f, 20.f);
+	math::LowPassFilter2pVector3f lpf_ref{SAMPLE_FREQ, 80.f};
+
+	harness.run("filter_notch_lpf2p_vector3f_block32", [&]() {
+		for (int i = 0; i < BLOCK_SIZE; i++) {
+			sample_vec = lpf_ref.apply(notch_ref.apply(sample_vec + matrix::Vector3f{0.1f, 0.1f, 0.1f}));
+		}
+
+		Harness::do_not_optimize(sample_vec(0));
+	}, 10);
+}
+
+} // namespace microbench
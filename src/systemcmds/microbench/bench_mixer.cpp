@@ -0,0 +1,141 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file bench_mixer.cpp
+ *
+ * MixerGroup::mix() for typical multirotor mixer configurations, both with the
+ * compiled mixer program and with the list of mixers (suffix _list).
+ */
+
+#include "benchmarks.hpp"
+
+#include <px4_platform_common/log.h>
+#include <lib/mixer/MixerGroup.hpp>
+
+#include <stdio.h>
+#include <string.h>
+
+namespace microbench
+{
+
+static float controls[8] {0.1f, -0.2f, 0.05f, 0.6f, 0.f, 0.3f, -0.3f, 0.5f};
+
+static int control_callback(uintptr_t handle, uint8_t control_group, uint8_t control_index, float &control)
+{
+	if (control_index >= sizeof(controls) / sizeof(controls[0])) {
+		control = 0.f;
+		return -1;
+	}
+
+	// vary the inputs slightly so that the mixer cannot settle on a fixed path
+	controls[control_index] = -controls[control_index];
+	control = controls[control_index];
+	return 0;
+}
+
+static void bench_mixer_group(Harness &harness, const char *name, const char *config, bool compiled)
+{
+	if (!harness.enabled(name)) {
+		return;
+	}
+
+	MixerGroup mixer_group;
+	unsigned buflen = strlen(config);
+
+	if (mixer_group.load_from_buf(control_callback, 0, config, buflen) != 0) {
+		PX4_ERR("%s: failed to load mixer", name);
+		return;
+	}
+
+	if (compiled && !mixer_group.compile()) {
+		PX4_ERR("%s: failed to compile mixer", name);
+		return;
+	}
+
+	float outputs[16];
+
+	harness.run(name, [&]() {
+		unsigned n = mixer_group.mix(outputs, sizeof(outputs) / sizeof(outputs[0]));
+		Harness::do_not_optimize(n);
+		Harness::do_not_optimize(outputs[0]);
+	}, 100);
+}
+
+static void bench_mixer_config(Harness &harness, const char *name, const char *config)
+{
+	char name_list[64];
+	snprintf(name_list, sizeof(name_list), "%s_list", name);
+
+	bench_mixer_group(harness, name, config, true);
+	bench_mixer_group(harness, name_list, config, false);
+}
+
+void bench_mixer(Harness &harness)
+{
+	bench_mixer_config(harness, "mixer_quad_x",
+			   "R: 4x 10000 10000 10000 0\n");
+
+	bench_mixer_config(harness, "mixer_octo_x",
+			   "R: 8x 10000 10000 10000 0\n");
+
+	bench_mixer_config(harness, "mixer_quad_x_4_simple",
+			   "R: 4x 10000 10000 10000 0\n"
+			   "M: 1\n"
+			   "S: 0 0 10000 10000 0 -10000 10000\n"
+			   "M: 1\n"
+			   "S: 0 1 10000 10000 0 -10000 10000\n"
+			   "M: 1\n"
+			   "S: 0 2 10000 10000 0 -10000 10000\n"
+			   "M: 1\n"
+			   "S: 0 3 10000 10000 0 -10000 10000\n");
+
+	bench_mixer_config(harness, "mixer_fw_aux",
+			   "Z:\n"
+			   "M: 2\n"
+			   "S: 0 0 -6000 -6000 0 -10000 10000\n"
+			   "S: 0 1 6500 6500 0 -10000 10000\n"
+			   "M: 2\n"
+			   "S: 0 0 -6000 -6000 0 -10000 10000\n"
+			   "S: 0 1 -6500 -6500 0 -10000 10000\n"
+			   "M: 1\n"
+			   "S: 0 2 10000 10000 0 -10000 10000\n"
+			   "M: 1\n"
+			   "S: 0 3 0 20000 -10000 -10000 10000\n"
+			   "M: 1\n"
+			   "S: 3 5 10000 10000 0 -10000 10000\n"
+			   "M: 1\n"
+			   "S: 3 6 10000 10000 0 -10000 10000\n");
+}
+
+} // namespace microbench
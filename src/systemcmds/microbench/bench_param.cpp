@@ -0,0 +1,90 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file bench_param.cpp
+ *
+ * Parameter lookup by name and value access.
+ */
+
+#include "benchmarks.hpp"
+
+#include <parameters/param.h>
+
+namespace microbench
+{
+
+void bench_param(Harness &harness)
+{
+	const unsigned count = param_count();
+
+	if (count == 0) {
+		return;
+	}
+
+	// lookup cost depends on the position in the (sorted) parameter table
+	const char *name_first = param_name(param_for_index(0));
+	const char *name_middle = param_name(param_for_index(count / 2));
+	const char *name_last = param_name(param_for_index(count - 1));
+
+	harness.run("param_find_first", [&]() {
+		param_t p = param_find_no_notification(name_first);
+		Harness::do_not_optimize(p);
+	}, 100);
+
+	harness.run("param_find_middle", [&]() {
+		param_t p = param_find_no_notification(name_middle);
+		Harness::do_not_optimize(p);
+	}, 100);
+
+	harness.run("param_find_last", [&]() {
+		param_t p = param_find_no_notification(name_last);
+		Harness::do_not_optimize(p);
+	}, 100);
+
+	harness.run("param_find_missing", [&]() {
+		param_t p = param_find_no_notification("MICROBENCH_NONE");
+		Harness::do_not_optimize(p);
+	}, 100);
+
+	// int32 and float values have the same size, the type does not matter for timing
+	const param_t param = param_for_index(count / 2);
+
+	harness.run("param_get", [&]() {
+		int32_t val;
+		param_get(param, &val);
+		Harness::do_not_optimize(val);
+	}, 100);
+}
+
+} // namespace microbench
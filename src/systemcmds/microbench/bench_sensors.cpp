@@ -0,0 +1,104 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file bench_sensors.cpp
+ *
+ * Sensor voting as done by the sensors module, 4 instances of 4 sensor types.
+ */
+
+#include "benchmarks.hpp"
+
+#include <modules/sensors/data_validator/DataValidatorGroup.hpp>
+
+namespace microbench
+{
+
+void bench_sensors(Harness &harness)
+{
+	static constexpr int SENSOR_TYPES = 4; // accel, gyro, mag, baro
+	static constexpr int INSTANCES = 4;
+	static constexpr uint64_t SAMPLE_INTERVAL_US = 125; // 8 kHz
+
+	DataValidatorGroup *groups[SENSOR_TYPES] {};
+
+	for (auto &group : groups) {
+		group = new DataValidatorGroup(1);
+
+		for (int i = 1; i < INSTANCES; i++) {
+			group->add_new_validator();
+		}
+	}
+
+	uint64_t timestamp = 1;
+	float sample[3] {0.1f, 0.2f, 9.81f};
+
+	const auto put_all = [&]() {
+		timestamp += SAMPLE_INTERVAL_US;
+
+		for (int i = 0; i < 3; i++) {
+			sample[i] += 0.001f;
+		}
+
+		for (auto &group : groups) {
+			for (int i = 0; i < INSTANCES; i++) {
+				group->put(i, timestamp, sample, 0, (i == 0) ? 100 : 50);
+			}
+		}
+	};
+
+	// new data from every instance, then select the best of each type
+	harness.run("sensors_put_vote_4x4", [&]() {
+		put_all();
+
+		for (auto &group : groups) {
+			int index = -1;
+			Harness::do_not_optimize(group->get_best(timestamp, &index));
+		}
+	}, 10);
+
+	// repeated selection without new data
+	harness.run("sensors_vote_4x4", [&]() {
+		for (auto &group : groups) {
+			int index = -1;
+			Harness::do_not_optimize(group->get_best(timestamp, &index));
+		}
+	}, 10);
+
+	for (auto &group : groups) {
+		delete group;
+	}
+}
+
+} // namespace microbench
@@ -0,0 +1,114 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file bench_uorb.cpp
+ *
+ * uORB publish/copy across message and queue sizes.
+ */
+
+#include "benchmarks.hpp"
+
+#include <px4_platform_common/log.h>
+#include <uORB/Subscription.hpp>
+#include <uORB/topics/orb_test.h>
+#include <uORB/topics/orb_test_large.h>
+#include <uORB/topics/orb_test_medium.h>
+
+#include <stdio.h>
+#include <string.h>
+
+namespace microbench
+{
+
+static void bench_topic(Harness &harness, const orb_metadata *meta, const char *label, unsigned queue_size)
+{
+	uint8_t data[sizeof(orb_test_large_s)] {};
+	static_assert(sizeof(orb_test_large_s) >= sizeof(orb_test_medium_s), "buffer too small");
+
+	char name_publish[Result::NAME_LEN];
+	char name_copy[Result::NAME_LEN];
+	char name_update[Result::NAME_LEN];
+	snprintf(name_publish, sizeof(name_publish), "uorb_%s_q%u_publish", label, queue_size);
+	snprintf(name_copy, sizeof(name_copy), "uorb_%s_q%u_copy", label, queue_size);
+	snprintf(name_update, sizeof(name_update), "uorb_%s_q%u_publish_update", label, queue_size);
+
+	if (!harness.enabled(name_publish) && !harness.enabled(name_copy) && !harness.enabled(name_update)) {
+		return;
+	}
+
+	// a new instance is used, so the queue size is not constrained by earlier publishers of the topic
+	int instance = 0;
+	orb_advert_t handle = orb_advertise_multi_queue(meta, data, &instance, queue_size);
+
+	if (handle == nullptr) {
+		PX4_WARN("uorb_%s_q%u: advertise failed, skipping", label, queue_size);
+		return;
+	}
+
+	uORB::Subscription sub{meta, (uint8_t)instance};
+	sub.subscribe();
+
+	harness.run(name_publish, [&]() {
+		data[0]++;
+		orb_publish(meta, handle, data);
+	}, 100);
+
+	harness.run(name_copy, [&]() {
+		sub.copy(data);
+		Harness::do_not_optimize(data[0]);
+	}, 100);
+
+	// full producer/consumer path: publish followed by an update check and copy
+	harness.run(name_update, [&]() {
+		data[0]++;
+		orb_publish(meta, handle, data);
+		bool updated = sub.update(data);
+		Harness::do_not_optimize(updated);
+	}, 100);
+
+	orb_unadvertise(handle);
+}
+
+void bench_uorb(Harness &harness)
+{
+	static constexpr unsigned queue_sizes[] {1, 4, 16};
+
+	for (unsigned queue_size : queue_sizes) {
+		bench_topic(harness, ORB_ID(orb_multitest), "small", queue_size);
+		bench_topic(harness, ORB_ID(orb_test_medium_multi), "medium", queue_size);
+		bench_topic(harness, ORB_ID(orb_test_large), "large", queue_size);
+	}
+}
+
+} // namespace microbench
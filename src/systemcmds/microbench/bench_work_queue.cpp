@@ -0,0 +1,200 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file bench_work_queue.cpp
+ *
+ * WorkQueue schedule-to-run latency and uORB callback fan-out latency.
+ */
+
+#include "benchmarks.hpp"
+
+#include <px4_platform_common/atomic.h>
+#include <px4_platform_common/log.h>
+#include <px4_platform_common/px4_work_queue/WorkItem.hpp>
+#include <uORB/SubscriptionCallback.hpp>
+#include <uORB/topics/orb_test.h>
+
+#include <stdio.h>
+
+namespace microbench
+{
+
+static constexpr uint64_t RUN_TIMEOUT_NS = 100 * 1000 * 1000;
+
+class LatencyWorkItem : public px4::WorkItem
+{
+public:
+	LatencyWorkItem(const px4::wq_config_t &config, px4::atomic_int &runs) :
+		WorkItem("microbench", config),
+		_runs(runs)
+	{}
+
+	void Run() override { _runs.fetch_add(1); }
+
+private:
+	px4::atomic_int &_runs;
+};
+
+class CallbackWorkItem : public px4::WorkItem
+{
+public:
+	CallbackWorkItem(const px4::wq_config_t &config, px4::atomic_int &runs, uint8_t instance) :
+		WorkItem("microbench_cb", config),
+		_sub(this, ORB_ID(orb_multitest), instance),
+		_runs(runs)
+	{}
+
+	bool init() { return _sub.registerCallback(); }
+
+	void Run() override
+	{
+		orb_test_s data;
+		_sub.update(&data);
+		_runs.fetch_add(1);
+	}
+
+private:
+	uORB::SubscriptionCallbackWorkItem _sub;
+	px4::atomic_int &_runs;
+};
+
+// busy wait (the work queue threads run at higher priority) until all items have run
+static bool wait_for_runs(px4::atomic_int &runs, int expected)
+{
+	const uint64_t start = Harness::now_ns();
+
+	while (runs.load() < expected) {
+		if (Harness::now_ns() - start > RUN_TIMEOUT_NS) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+template<typename Trigger>
+static void measure_latency(Harness &harness, const char *name, px4::atomic_int &runs, int items, Trigger &&trigger)
+{
+	static constexpr unsigned WARMUP = 10;
+	float *samples = harness.sample_buffer();
+
+	for (unsigned r = 0; r < WARMUP + harness.repetitions(); r++) {
+		runs.store(0);
+		const uint64_t t0 = Harness::now_ns();
+		trigger();
+
+		if (!wait_for_runs(runs, items)) {
+			PX4_ERR("%s: timeout waiting for work queue", name);
+			return;
+		}
+
+		if (r >= WARMUP) {
+			samples[r - WARMUP] = (float)(Harness::now_ns() - t0);
+		}
+	}
+
+	harness.add_result(name, samples, harness.repetitions());
+}
+
+static void bench_schedule_latency(Harness &harness)
+{
+	const char *name = "wq_schedule_to_run";
+
+	if (!harness.enabled(name)) {
+		return;
+	}
+
+	px4::atomic_int runs{0};
+	LatencyWorkItem item{px4::wq_configurations::test1, runs};
+
+	measure_latency(harness, name, runs, 1, [&]() { item.ScheduleNow(); });
+}
+
+static void bench_callback_fanout(Harness &harness, int num_items)
+{
+	static constexpr int MAX_ITEMS = 8;
+
+	char name[Result::NAME_LEN];
+	snprintf(name, sizeof(name), "wq_callback_fanout_%d", num_items);
+
+	if (!harness.enabled(name) || num_items > MAX_ITEMS) {
+		return;
+	}
+
+	orb_test_s data{};
+	int instance = 0;
+	orb_advert_t handle = orb_advertise_multi(ORB_ID(orb_multitest), &data, &instance);
+
+	if (handle == nullptr) {
+		PX4_WARN("%s: advertise failed, skipping", name);
+		return;
+	}
+
+	px4::atomic_int runs{0};
+	CallbackWorkItem *items[MAX_ITEMS] {};
+	bool ok = true;
+
+	// all items share one queue, so the measurement covers the serialized dispatch of every subscriber
+	for (int i = 0; i < num_items; i++) {
+		items[i] = new CallbackWorkItem(px4::wq_configurations::test1, runs, instance);
+		ok = ok && items[i] && items[i]->init();
+	}
+
+	if (ok) {
+		measure_latency(harness, name, runs, num_items, [&]() {
+			data.val++;
+			orb_publish(ORB_ID(orb_multitest), handle, &data);
+		});
+
+	} else {
+		PX4_ERR("%s: callback registration failed", name);
+	}
+
+	for (int i = 0; i < num_items; i++) {
+		delete items[i];
+	}
+
+	orb_unadvertise(handle);
+}
+
+void bench_work_queue(Harness &harness)
+{
+	bench_schedule_latency(harness);
+
+	bench_callback_fanout(harness, 1);
+	bench_callback_fanout(harness, 4);
+	bench_callback_fanout(harness, 8);
+}
+
+} // namespace microbench
@@ -0,0 +1,198 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file microbench_main.cpp
+ *
+ * Microbenchmarks for the uORB, WorkQueue, parameter, mixer, filter and sensor voting hot paths.
+ */
+
+#include "benchmarks.hpp"
+
+#include <px4_platform_common/px4_config.h>
+#include <px4_platform_common/getopt.h>
+#include <px4_platform_common/log.h>
+#include <px4_platform_common/module.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+using namespace microbench;
+
+static void usage(const char *reason);
+
+extern "C" __EXPORT int microbench_main(int argc, char *argv[]);
+
+struct Suite {
+	const char *name;
+	void (*run)(Harness &harness);
+};
+
+static constexpr Suite suites[] {
+	{"uorb", bench_uorb},
+	{"wq", bench_work_queue},
+	{"param", bench_param},
+	{"mixer", bench_mixer},
+	{"filter", bench_filter},
+	{"sensors", bench_sensors},
+};
+
+int microbench_main(int argc, char *argv[])
+{
+	int myoptind = 1;
+	int ch;
+	const char *myoptarg = nullptr;
+
+	unsigned repetitions = 1000;
+	unsigned warmup = 10;
+	const char *filter = nullptr;
+	const char *json_path = nullptr;
+	const char *baseline_path = nullptr;
+	float tolerance = 0.1f;
+
+	while ((ch = px4_getopt(argc, argv, "r:w:f:j:b:t:", &myoptind, &myoptarg)) != EOF) {
+		switch (ch) {
+		case 'r':
+			repetitions = strtoul(myoptarg, nullptr, 0);
+			break;
+
+		case 'w':
+			warmup = strtoul(myoptarg, nullptr, 0);
+			break;
+
+		case 'f':
+			filter = myoptarg;
+			break;
+
+		case 'j':
+			json_path = myoptarg;
+			break;
+
+		case 'b':
+			baseline_path = myoptarg;
+			break;
+
+		case 't':
+			tolerance = strtof(myoptarg, nullptr) / 100.f;
+			break;
+
+		default:
+			usage(nullptr);
+			return 1;
+		}
+	}
+
+	if (repetitions == 0 || repetitions > 100000 || tolerance < 0.f) {
+		usage("invalid argument");
+		return 1;
+	}
+
+	const char *suite_name = (myoptind < argc) ? argv[myoptind] : "all";
+	bool found = false;
+
+	Harness harness{warmup, repetitions, filter};
+
+	if (!harness.valid()) {
+		PX4_ERR("alloc failed");
+		return 1;
+	}
+
+	for (const Suite &suite : suites) {
+		if (strcmp(suite_name, "all") == 0 || strcmp(suite_name, suite.name) == 0) {
+			suite.run(harness);
+			found = true;
+		}
+	}
+
+	if (!found) {
+		usage("unknown suite");
+		return 1;
+	}
+
+	harness.print_results();
+
+	if (json_path && harness.write_json(json_path) != 0) {
+		return 1;
+	}
+
+	if (baseline_path) {
+		const int regressions = harness.compare(baseline_path, tolerance);
+
+		if (regressions < 0) {
+			return 1;
+
+		} else if (regressions > 0) {
+			PX4_ERR("%d regression(s) above %.1f%%", regressions, (double)(tolerance * 100.f));
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+static void usage(const char *reason)
+{
+	if (reason) {
+		PX4_WARN("%s", reason);
+	}
+
+	PRINT_MODULE_DESCRIPTION(
+		R"DESCR_STR(
+### Description
+Microbenchmarks for hot paths: uORB publish/copy across message and queue sizes,
+WorkQueue schedule-to-run latency and uORB callback fan-out, parameter lookup,
+mixers, filters and sensor voting.
+
+Each benchmark runs a number of warmup iterations followed by the timed repetitions.
+Short operations are timed in batches and reported per operation. The results
+(min, mean, 50th/90th/99th percentile and max in ns) can be written as JSON and
+compared against a previously stored JSON file. The comparison uses the median and
+the command fails if any benchmark is slower than the baseline by more than the tolerance.
+
+On POSIX the host monotonic clock is used, independent of lockstep simulation time.
+
+### Examples
+Store a baseline, then compare a later build against it:
+$ microbench -j baseline.json
+$ microbench -b baseline.json -t 15
+)DESCR_STR");
+
+	PRINT_MODULE_USAGE_NAME_SIMPLE("microbench", "command");
+	PRINT_MODULE_USAGE_ARG("all|uorb|wq|param|mixer|filter|sensors", "Benchmark suite (default all)", true);
+	PRINT_MODULE_USAGE_PARAM_INT('r', 1000, 1, 100000, "Number of repetitions", true);
+	PRINT_MODULE_USAGE_PARAM_INT('w', 10, 0, 1000, "Number of warmup iterations", true);
+	PRINT_MODULE_USAGE_PARAM_STRING('f', nullptr, nullptr, "Only run benchmarks containing this string", true);
+	PRINT_MODULE_USAGE_PARAM_STRING('j', nullptr, "<file>", "Write results as JSON", true);
+	PRINT_MODULE_USAGE_PARAM_STRING('b', nullptr, "<file>", "Compare against baseline JSON", true);
+	PRINT_MODULE_USAGE_PARAM_FLOAT('t', 10.f, 0.f, 1000.f, "Allowed slowdown against baseline in %", true);
+}
@@ -117,6 +117,10 @@ usage(const char *reason)
 ### Description
 Load or append mixer files to the ESC driver.
 
+`load` atomically replaces the mixer if the driver supports it, the outputs keep running with the previous
+mixer until the new one is loaded. If a precompiled binary mixer (the mixer file name with a `b` appended,
+eg. `quad_x.main.mixb`) exists next to the mixer file, it is used instead of parsing the text file.
+
 Note that the driver must support the used ioctl's, which is the case on NuttX, but for example not on RPi.
 )DESCR_STR");
 
@@ -129,6 +133,45 @@ Note that the driver must support the used ioctl's, which is the case on NuttX,
 	PRINT_MODULE_USAGE_ARG("<file:dev> <file>", "Output device (eg. /dev/pwm_output0) and mixer file", false);
 }
 
+/**
+ * Atomically replace the mixer on the device, preferring the binary (precompiled)
+ * variant of the mixer file (<file>b, eg. quad_x.main.mixb) if there is one.
+ * @return 0 on success, -ENOTTY if the device does not support it, other <0 if the
+ * file or the mixer could not be loaded (the mixer on the device is unchanged then)
+ */
+static int
+replace(int dev, const char *fname, char *buf, unsigned buflen)
+{
+	char binary_fname[64];
+	int len = -1;
+
+	if (snprintf(binary_fname, sizeof(binary_fname), "%sb", fname) < (int)sizeof(binary_fname)) {
+		len = load_mixer_file_binary(binary_fname, buf, buflen);
+	}
+
+	if (len < 0) {
+		if (load_mixer_file(fname, buf, buflen) < 0) {
+			return -ENOENT;
+		}
+
+		len = strlen(buf);
+	}
+
+	mixer_buffer_s mixer{buf, (unsigned)len};
+	int ret = px4_ioctl(dev, MIXERIOCREPLACE, (unsigned long)&mixer);
+
+#if defined(__PX4_NUTTX)
+
+	if (ret == -1) {
+		// the error is returned through errno
+		ret = -errno;
+	}
+
+#endif
+
+	return ret;
+}
+
 static int
 load(const char *devname, const char *fname, bool append)
 {
@@ -143,23 +186,41 @@ load(const char *devname, const char *fname, bool append)
 		return 1;
 	}
 
-	/* reset mixers on the device, but not if appending */
+	char buf[2048];
+
 	if (!append) {
+		/* swap the mixers without interrupting the outputs if the device supports it */
+		const int ret = replace(dev, fname, &buf[0], sizeof(buf));
+
+		if (ret != -ENOTTY) {
+			px4_close(dev);
+
+			if (ret < 0) {
+				// keep the current mixer, do not fall back to a reset
+				PX4_ERR("can't replace mixer on %s with %s (%i)", devname, fname, ret);
+				return 1;
+			}
+
+			return 0;
+		}
+
+		/* otherwise reset mixers on the device, but not if appending */
 		if (px4_ioctl(dev, MIXERIOCRESET, 0)) {
 			PX4_ERR("can't reset mixers on %s", devname);
+			px4_close(dev);
 			return 1;
 		}
 	}
 
-	char buf[2048];
-
 	if (load_mixer_file(fname, &buf[0], sizeof(buf)) < 0) {
 		PX4_ERR("can't load mixer file: %s", fname);
+		px4_close(dev);
 		return 1;
 	}
 
 	/* Pass the buffer to the device */
 	int ret = px4_ioctl(dev, MIXERIOCLOADBUF, (unsigned long)buf);
+	px4_close(dev);
 
 	if (ret < 0) {
 		PX4_ERR("failed to load mixers from %s", fname);
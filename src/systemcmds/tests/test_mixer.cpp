@@ -99,6 +99,7 @@ public:
 
 private:
 	bool mixerTest();
+	bool compiledTest();
 	bool loadIOPass();
 	bool loadVTOL1Test();
 	bool loadVTOL2Test();
@@ -106,6 +107,7 @@ private:
 	bool loadComplexTest();
 	bool loadAllTest();
 	bool load_mixer(const char *filename, unsigned expected_count, bool verbose = false);
+	bool load_binary_mixer(const char *filename);
 	bool load_mixer(const char *filename, const char *buf, unsigned loaded, unsigned expected_count,
 			const unsigned chunk_size, bool verbose);
 
@@ -121,6 +123,7 @@ bool MixerTest::run_tests()
 	ut_run_test(loadComplexTest);
 	ut_run_test(loadAllTest);
 	ut_run_test(mixerTest);
+	ut_run_test(compiledTest);
 
 	return (_tests_failed == 0);
 }
@@ -200,7 +203,15 @@ bool MixerTest::loadAllTest()
 					return false;
 				}
 
-				bool ret = load_mixer(buf, 0);
+				const size_t name_len = strlen(result->d_name);
+				bool ret;
+
+				if (name_len > 5 && strcmp(&result->d_name[name_len - 5], ".mixb") == 0) {
+					ret = load_binary_mixer(buf);
+
+				} else {
+					ret = load_mixer(buf, 0);
+				}
 
 				if (!ret) {
 					PX4_ERR("Error testing mixer %s", buf);
@@ -245,6 +256,57 @@ bool MixerTest::load_mixer(const char *filename, unsigned expected_count, bool v
 	return true;
 }
 
+bool MixerTest::load_binary_mixer(const char *filename)
+{
+	// the binary mixer needs to be identical to the text mixer it was generated from
+	char text_filename[PATH_MAX];
+	strncpy(text_filename, filename, sizeof(text_filename) - 1);
+	text_filename[sizeof(text_filename) - 1] = '\0';
+	text_filename[strlen(text_filename) - 1] = '\0'; // strip the trailing 'b'
+
+	char buf[2048];
+
+	if (load_mixer_file(text_filename, &buf[0], sizeof(buf)) < 0) {
+		PX4_ERR("no text mixer for %s", filename);
+		return false;
+	}
+
+	unsigned loaded = strlen(buf);
+	MixerGroup text_group;
+	text_group.load_from_buf(mixer_callback, 0, &buf[0], loaded);
+
+	int len = load_mixer_file_binary(filename, &buf[0], sizeof(buf));
+	ut_assert_true(len > 0);
+
+	mixer_group.reset();
+	ut_compare("binary mixer load", mixer_group.load_from_binary(mixer_callback, 0, (const uint8_t *)buf, len), 0);
+	ut_compare("check number of mixers loaded (binary)", mixer_group.count(), text_group.count());
+
+	// a corrupted binary mixer must be rejected
+	buf[len - 1] ^= 0x55;
+	MixerGroup corrupted_group;
+	ut_assert_true(corrupted_group.load_from_binary(mixer_callback, 0, (const uint8_t *)buf, len) != 0);
+	ut_compare("no mixers loaded (corrupted)", corrupted_group.count(), 0);
+
+	for (unsigned i = 0; i < 10; i++) {
+		for (unsigned j = 0; j < output_max; j++) {
+			actuator_controls[j] = -1.f + 0.2f * ((i + j) % 11);
+		}
+
+		float text_outputs[output_max * 2] {};
+		float binary_outputs[output_max * 2] {};
+		const unsigned text_count = text_group.mix(text_outputs, output_max * 2);
+		const unsigned binary_count = mixer_group.mix(binary_outputs, output_max * 2);
+		ut_compare("number of outputs", binary_count, text_count);
+
+		for (unsigned j = 0; j < text_count; j++) {
+			ut_compare_float("binary mixer output", binary_outputs[j], text_outputs[j], 1e-6f);
+		}
+	}
+
+	return true;
+}
+
 bool MixerTest::load_mixer(const char *filename, const char *buf, unsigned loaded, unsigned expected_count,
 			   const unsigned chunk_size, bool verbose)
 {
@@ -570,6 +632,81 @@ bool MixerTest::mixerTest()
 	return true;
 }
 
+/*
+ * Fixed-wing style group: aileron, elevons (two inputs with mixed signs),
+ * a null output, and outputs whose scalers clip (asymmetric limits,
+ * offsets and input scalers with their own limits).
+ */
+static const char compiled_test_mixer[] =
+	"M: 1\n"
+	"S: 0 0  10000  10000      0 -10000  10000\n"
+	"M: 2\n"
+	"O:       8000   6000    500  -7000   9000\n"
+	"S: 0 0  -6000  -6000      0 -10000  10000\n"
+	"S: 0 1   6000   6000      0 -10000  10000\n"
+	"M: 2\n"
+	"O:      10000  10000      0  -5000   5000\n"
+	"S: 0 0   7000   9000   1000  -8000   6000\n"
+	"S: 0 1 -10000 -10000      0  -3000   3000\n"
+	"Z:\n"
+	"M: 1\n"
+	"O:      10000  10000  -2000 -10000   2000\n"
+	"S: 0 3  10000  10000      0 -10000  10000\n"
+	"M: 3\n"
+	"O:       5000  15000      0  -8000   8000\n"
+	"S: 0 2  10000  10000      0 -10000  10000\n"
+	"S: 0 4   5000   5000      0 -10000  10000\n"
+	"S: 0 5  -5000  -5000   2000 -10000  10000\n";
+
+bool MixerTest::compiledTest()
+{
+	MixerGroup group;
+	unsigned buflen = strlen(compiled_test_mixer);
+	group.load_from_buf(mixer_callback, 0, compiled_test_mixer, buflen);
+
+	ut_compare("all mixers loaded", group.count(), 6);
+	ut_assert("no text left over", buflen == 0);
+	ut_assert("group compiles", group.compile());
+
+	should_prearm = false;
+
+	// sweep every control past +-1 so both the control and the output scalers clip
+	const int steps = 30;
+	const float range = 1.5f;
+
+	for (int step = 0; step <= steps; step++) {
+		for (unsigned i = 0; i < output_max; i++) {
+			// offset each control so the inputs are not all equal
+			const int k = (step + 7 * i) % (steps + 1);
+			actuator_controls[i] = -range + 2.f * range * k / steps;
+		}
+
+		float list_outputs[output_max];
+		float compiled_outputs[output_max];
+
+		group.decompile();
+		const unsigned list_mixed = group.mix(list_outputs, output_max);
+
+		ut_assert("group compiles", group.compile());
+		const unsigned compiled_mixed = group.mix(compiled_outputs, output_max);
+
+		ut_compare("mixed output count", compiled_mixed, list_mixed);
+
+		for (unsigned i = 0; i < list_mixed; i++) {
+			const bool same = (list_outputs[i] == compiled_outputs[i])
+					  || (isnan(list_outputs[i]) && isnan(compiled_outputs[i]));
+
+			if (!same) {
+				PX4_ERR("step %d output %u: list %.6f, compiled %.6f", step, i,
+					(double)list_outputs[i], (double)compiled_outputs[i]);
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
 static int
 mixer_callback(uintptr_t handle, uint8_t control_group, uint8_t control_index, float &control)
 {